@@ -381,6 +381,30 @@ clixon_stats_module_get(clicon_handle h,
     return retval;
 }
 
+/*! Get clixon state data cache stats per registered state data callback
+ * @param[in]     h       Clicon handle
+ * @param[in,out] cb      Cligen buf
+ * @retval        0       OK
+ * @retval       -1       Error
+ * @see statedata_callback_reg_fn
+ */
+static int
+clixon_stats_statecache_get(clicon_handle h,
+                            cbuf         *cb)
+{
+    statedata_callback_t *sc = NULL;
+
+    while ((sc = statedata_callback_each(h, sc)) != NULL) {
+        cprintf(cb, "<state-cache xmlns=\"%s\"><path>%s</path><callback>%s</callback>"
+                "<ttl>%u</ttl><entries>%d</entries>"
+                "<hit>%" PRIu64 "</hit><miss>%" PRIu64 "</miss></state-cache>",
+                CLIXON_LIB_NS, sc->sc_path, sc->sc_fnstr,
+                sc->sc_ttl, sc->sc_cachenr,
+                sc->sc_hit, sc->sc_miss);
+    }
+    return 0;
+}
+
 /*! Loads all or part of a specified configuration to target configuration
  * 
  * @param[in]  h       Clicon handle 
@@ -1348,6 +1372,8 @@ from_client_stats(clicon_handle h,
         goto done;
     if (clixon_stats_datastore_get(h, "startup", cbret) < 0)
         goto done;
+    if (clixon_stats_statecache_get(h, cbret) < 0)
+        goto done;
     ym = NULL;
     while ((ym = yn_each(clicon_config_yang(h), ym)) != NULL) {    
         if (clixon_stats_module_get(h, ym, cbret) < 0)
@@ -1462,6 +1488,7 @@ from_client_process_control(clicon_handle  h,
 
 /*! Clixon hello to check liveness
  *
+ * The binary encoding capability is returned if offered by the client and enabled
  * @param[in]  h       Clixon handle
  * @param[in]  x       Incoming XML of hello request
  * @param[in]  ce      Client entry (from)
@@ -1477,6 +1504,9 @@ from_client_hello(clicon_handle       h,
 {
     int      retval = -1;
     char    *val;
+    cxobj   *xcaps;
+    cxobj   *xc;
+    int      binary = 0;
 
     if ((val = xml_find_type_value(x, "cl", "transport", CX_ATTR)) != NULL){
         if ((ce->ce_transport = strdup(val)) == NULL){
@@ -1490,8 +1520,22 @@ from_client_hello(clicon_handle       h,
             goto done;
         }
     }
-    cprintf(cbret, "<hello xmlns=\"%s\"><session-id>%u</session-id></hello>",
-            NETCONF_BASE_NAMESPACE, ce->ce_id);
+    if (clicon_option_bool(h, "CLICON_IPC_BINARY") &&
+        clicon_sock_family(h) == AF_UNIX &&
+        (xcaps = xml_find_type(x, NULL, "capabilities", CX_ELMNT)) != NULL){
+        xc = NULL;
+        while ((xc = xml_child_each(xcaps, xc, CX_ELMNT)) != NULL)
+            if ((val = xml_body(xc)) != NULL &&
+                strcmp(val, CLIXON_IPC_BINARY_CAPABILITY) == 0)
+                binary++;
+    }
+    cprintf(cbret, "<hello xmlns=\"%s\">", NETCONF_BASE_NAMESPACE);
+    if (binary){
+        ce->ce_binary = 1;
+        cprintf(cbret, "<capabilities><capability>%s</capability></capabilities>",
+                CLIXON_IPC_BINARY_CAPABILITY);
+    }
+    cprintf(cbret, "<session-id>%u</session-id></hello>", ce->ce_id);
     retval = 0;
  done:
     return retval;
@@ -1541,6 +1585,12 @@ from_client_msg(clicon_handle        h,
         clicon_err(OE_XML, errno, "cbuf_new");
         goto done;
     }
+    /* Binary encoding only if negotiated in hello */
+    if (!ce->ce_binary && clicon_msg_bin_p(msg)){
+        if (netconf_malformed_message(cbret, "Binary encoding not negotiated") < 0)
+            goto done;
+        goto reply;
+    }
     /* Decode msg from client -> xml top (ct) and session id 
      * Bind is a part of the decode function
      */
@@ -726,6 +726,9 @@ candidate_commit(clicon_handle h,
     if (xmldb_copy(h, db, "running") < 0)
         goto done;
     xmldb_modified_set(h, db, 0); /* reset dirty bit */
+    /* Cached state may be derived from configuration */
+    if (statedata_callback_invalidate(h, NULL) < 0)
+        goto done;
     /* Here pointers to old (source) tree are obsolete */
     if (td->td_dvec){
         td->td_dlen = 0;
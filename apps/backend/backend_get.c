@@ -489,6 +489,244 @@ get_nacm_and_reply(clicon_handle h,
     return retval;
 }
 
+/*! Print a datastore view as the data element of a get reply
+ *
+ * @param[in]  dv       Datastore view, see xmldb_get_view
+ * @param[in]  depth    Nr of levels to print, -1 is all, 0 is none
+ * @param[in]  attrs    Attributes of data element, eg " a=\"b\"", or NULL
+ * @param[out] cbret    Return xml tree, eg <rpc-reply>..., <rpc-error.. 
+ * @retval     0        OK
+ * @retval    -1        Error
+ */
+static int
+get_view_data(xmldb_view *dv,
+              int32_t     depth,
+              char       *attrs,
+              cbuf       *cbret)
+{
+    int    retval = -1;
+    cxobj *xc;
+    int    empty = 1;
+
+    if (depth == 0)
+        goto ok;
+    cprintf(cbret, "<%s%s", NETCONF_OUTPUT_DATA, attrs?attrs:"");
+    if (dv->dv_xt != NULL){
+        xc = NULL;
+        while ((xc = xml_child_each(dv->dv_xt, xc, CX_ELMNT)) != NULL)
+            if (xmldb_view_filter(xc, dv) == 1){
+                empty = 0;
+                break;
+            }
+    }
+    if (empty)
+        cprintf(cbret, "/>");
+    else {
+        cprintf(cbret, ">");
+        if (clixon_xml2cbuf_filter(cbret, dv->dv_xt, 0, 0, depth, 1,
+                                   xmldb_view_filter, dv) < 0)
+            goto done;
+        cprintf(cbret, "</%s>", NETCONF_OUTPUT_DATA);
+    }
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Get config and reply by serializing directly from the datastore cache
+ *
+ * No copy of the result is made, instead the selected nodes are marked in the cache and
+ * printed with a filter. Only if no NACM read rules apply, see get_common.
+ * @param[in]  h        Clicon handle 
+ * @param[in]  db       Database name
+ * @param[in]  xpath    XPath point to object to get
+ * @param[in]  nsc      Namespace context of xpath
+ * @param[in]  wdef     With-defaults mode, report-all or explicit
+ * @param[in]  depth    Nr of levels to print, -1 is all, 0 is none
+ * @param[in]  genstr   Generation attribute of reply, or NULL
+ * @param[out] cbret    Return xml tree, eg <rpc-reply>..., <rpc-error.. 
+ * @retval     0        OK
+ * @retval    -1        Error
+ * @see xmldb_get_view
+ */
+static int
+get_config_view(clicon_handle     h,
+                char             *db,
+                char             *xpath,
+                cvec             *nsc,
+                withdefaults_type wdef,
+                int32_t           depth,
+                char             *genstr,
+                cbuf             *cbret)
+{
+    int        retval = -1;
+    xmldb_view dv = {0,};
+    cbuf      *cbmsg = NULL;
+    cbuf      *cba = NULL;
+    cxobj     *xerr = NULL;
+    int        ret;
+
+    if ((ret = xmldb_get_view(h, db, nsc, xpath?xpath:"/", wdef, &dv, &xerr)) < 0){
+        if ((cbmsg = cbuf_new()) == NULL){
+            clicon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+        cprintf(cbmsg, "Get %s datastore: %s", db, clicon_err_reason);
+        if (netconf_operation_failed(cbret, "application", cbuf_get(cbmsg)) < 0)
+            goto done;
+        goto ok;
+    }
+    if (ret == 0){ /* Datastore could not be bound to yang */
+        if (clixon_xml2cbuf(cbret, xerr, 0, 0, -1, 0) < 0)
+            goto done;
+        goto ok;
+    }
+    if ((cba = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (genstr)
+        cprintf(cba, " %s:generation=\"%s\" xmlns:%s=\"%s\"",
+                CLIXON_LIB_PREFIX, genstr, CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    cprintf(cbret, "<rpc-reply xmlns=\"%s\">", NETCONF_BASE_NAMESPACE);
+    if (get_view_data(&dv, depth, cbuf_get(cba), cbret) < 0)
+        goto done;
+    cprintf(cbret, "</rpc-reply>");
+ ok:
+    retval = 0;
+ done:
+    xmldb_view_clear(&dv);
+    if (xerr)
+        xml_free(xerr);
+    if (cba)
+        cbuf_free(cba);
+    if (cbmsg)
+        cbuf_free(cbmsg);
+    return retval;
+}
+
+/*! Get a page of a config list using a cursor, or the number of entries of the list
+ *
+ * Keyset pagination from the datastore cache, see xmldb_get_view_list
+ * The reply has the cursor of the last entry as attribute of the data element if there are
+ * more entries, or the number of entries if count is set.
+ * If NACM is enabled, a copy of the page is made on which NACM read rules are applied,
+ * which means a page may have fewer entries than limit.
+ * @param[in]  h        Clicon handle 
+ * @param[in]  db       Database name
+ * @param[in]  ylist    Yang of list or leaf-list
+ * @param[in]  xpath    XPath to list
+ * @param[in]  nsc      Namespace context of xpath
+ * @param[in]  wdef     With-defaults mode
+ * @param[in]  cursor   Cursor from previous reply, or NULL or empty string for first page
+ * @param[in]  count    If set, reply with nr of entries only
+ * @param[in]  offset   Entries to skip
+ * @param[in]  limit    Max nr of entries, 0 is unbounded
+ * @param[in]  depth    Nr of levels to print, -1 is all, 0 is none
+ * @param[in]  username User name for NACM access
+ * @param[out] cbret    Return xml tree, eg <rpc-reply>..., <rpc-error.. 
+ * @retval     0        OK
+ * @retval    -1        Error
+ */
+static int
+get_list_cursor(clicon_handle     h,
+                char             *db,
+                yang_stmt        *ylist,
+                char             *xpath,
+                cvec             *nsc,
+                withdefaults_type wdef,
+                char             *cursor,
+                int               count,
+                uint32_t          offset,
+                uint32_t          limit,
+                int32_t           depth,
+                char             *username,
+                cbuf             *cbret)
+{
+    int        retval = -1;
+    xmldb_view dv = {0,};
+    cbuf      *cbmsg = NULL;
+    cbuf      *cba = NULL;
+    char      *next = NULL;
+    uint32_t   total = 0;
+    cxobj     *xret = NULL;
+    cxobj    **xvec = NULL;
+    size_t     xlen;
+    int        ret;
+
+    if (clicon_datastore_cache(h) == DATASTORE_NOCACHE ||
+        (wdef != WITHDEFAULTS_REPORT_ALL && wdef != WITHDEFAULTS_EXPLICIT)){
+        if (netconf_operation_not_supported(cbret, "application",
+             "list-pagination cursor and count require datastore cache and with-defaults report-all or explicit") < 0)
+            goto done;
+        goto ok;
+    }
+    if ((ret = xmldb_get_view_list(h, db, nsc, xpath, ylist, wdef, cursor, offset, limit,
+                                   &dv, &next, &total)) < 0){
+        if ((cbmsg = cbuf_new()) == NULL){
+            clicon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+        cprintf(cbmsg, "Get %s datastore: %s", db, clicon_err_reason);
+        if (netconf_operation_failed(cbret, "application", cbuf_get(cbmsg)) < 0)
+            goto done;
+        goto ok;
+    }
+    if (ret == 0){
+        if (netconf_bad_attribute(cbret, "application", "cursor",
+                                  "Invalid cursor or list-pagination target") < 0)
+            goto done;
+        goto ok;
+    }
+    if ((cba = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (count){
+        cprintf(cbret, "<rpc-reply xmlns=\"%s\"><%s %s:count=\"%u\" xmlns:%s=\"%s\"/></rpc-reply>",
+                NETCONF_BASE_NAMESPACE, NETCONF_OUTPUT_DATA,
+                CLIXON_LIB_PREFIX, total, CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+        goto ok;
+    }
+    if (clicon_nacm_cache(h) == NULL){
+        if (next)
+            cprintf(cba, " %s:cursor=\"%s\" xmlns:%s=\"%s\"",
+                    CLIXON_LIB_PREFIX, next, CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+        cprintf(cbret, "<rpc-reply xmlns=\"%s\">", NETCONF_BASE_NAMESPACE);
+        if (get_view_data(&dv, depth, cbuf_get(cba), cbret) < 0)
+            goto done;
+        cprintf(cbret, "</rpc-reply>");
+    }
+    else {
+        /* NACM prunes the result, make a copy of the page */
+        if (xmldb_view_copy(&dv, &xret) < 0)
+            goto done;
+        if (next &&
+            xml_add_attr(xret, "cursor", next, CLIXON_LIB_PREFIX, CLIXON_LIB_NS) < 0)
+            goto done;
+        if (xpath_vec(xret, nsc, "%s", &xvec, &xlen, xpath) < 0)
+            goto done;
+        if (get_nacm_and_reply(h, xret, xvec, xlen, xpath, nsc, username, depth, cbret) < 0)
+            goto done;
+    }
+ ok:
+    retval = 0;
+ done:
+    xmldb_view_clear(&dv);
+    if (xvec)
+        free(xvec);
+    if (xret)
+        xml_free(xret);
+    if (next)
+        free(next);
+    if (cba)
+        cbuf_free(cba);
+    if (cbmsg)
+        cbuf_free(cbmsg);
+    return retval;
+}
+
 /*! Help function for parsing restconf query parameter and setting netconf attribute
  *
  * If not "unbounded", parse and set a numeric value
@@ -556,13 +794,15 @@ list_pagination_hdr(clicon_handle h,
  * as the list-paginaiton API
  * @param[in]  h       Clicon handle 
  * @param[in]  ce      Client entry, for locking
- * @param[in]  xe      Request: <rpc><xn></rpc> 
+ * @param[in]  xe      list-pagination element of request, or NULL
  * @param[in]  content Get config/state/both
  * @param[in]  db      Database name
  * @param[in]  xpath   XPath point to object to get
  * @param[in]  nsc     Namespace context of xpath
  * @param[in]  username
  * @param[in]  wdef   With-defaults parameter, see RFC 6243
+ * @param[in]  cursor  Clixon extension: keyset pagination cursor, or NULL
+ * @param[in]  count   Clixon extension: reply with nr of list entries only
  * @param[out] cbret   Return xml tree, eg <rpc-reply>..., <rpc-error.. 
  * @retval     0       OK
  * @retval    -1       Error
@@ -582,6 +822,8 @@ get_list_pagination(clicon_handle        h,
                     cvec                *nsc,
                     char                *username,
                     withdefaults_type    wdef,
+                    char                *cursor,
+                    int                  count,
                     cbuf                *cbret
                     )
 {
@@ -647,7 +889,8 @@ get_list_pagination(clicon_handle        h,
             goto ok;
         }
     }
-    if ((ret = list_pagination_hdr(h, xe, &offset, &limit, cbret)) < 0)
+    ret = 1;
+    if (xe && (ret = list_pagination_hdr(h, xe, &offset, &limit, cbret)) < 0)
         goto done;
 #ifdef NOTYET
     /* direction */
@@ -672,6 +915,18 @@ get_list_pagination(clicon_handle        h,
 #endif
     if (ret == 0)
         goto ok;
+    /* Keyset pagination using cursor, or count */
+    if (cursor != NULL || count){
+        if (!list_config){
+            if (netconf_operation_not_supported(cbret, "application", "list-pagination cursor and count are only supported for config lists") < 0)
+                goto done;
+            goto ok;
+        }
+        if (get_list_cursor(h, db, ylist, xpath, nsc, wdef, cursor, count, offset, limit,
+                            depth, username, cbret) < 0)
+            goto done;
+        goto ok;
+    }
     /* Read config */
     switch (content){
     case CONTENT_CONFIG:    /* config data only */
@@ -858,6 +1113,8 @@ get_common(clicon_handle        h,
     char           *xpath0;
     cbuf           *cbreason = NULL;
     int             list_pagination = 0;
+    char           *cursor = NULL;
+    int             count = 0;
     cxobj         **xvec = NULL;
     size_t          xlen;
     cxobj          *xfind;
@@ -865,6 +1122,9 @@ get_common(clicon_handle        h,
     uint32_t        limit = 0;
     withdefaults_type wdef;
     char             *wdefstr;
+    uint64_t          generation = 0;
+    int               genreply = 0;
+    char              genstr[32];
 
 #ifdef NETCONF_DEFAULT_RETRIEVAL_REPORT_ALL
     /* Clixon 6.0 backward compatibly for NETCONF get/get-config behavior */
@@ -911,6 +1171,29 @@ get_common(clicon_handle        h,
             goto ok;
         }
     }
+    /* Clixon extension: generation, reply only if config has changed since generation */
+    if (content == CONTENT_CONFIG &&
+        (attr = xml_find_value(xe, "generation")) != NULL){
+        if ((ret = parse_uint64(attr, &generation, &reason)) < 0){
+            clicon_err(OE_XML, errno, "parse_uint64");
+            goto done;
+        }
+        if (ret == 0){
+            if (netconf_bad_attribute(cbret, "application",
+                                      "generation", "Unrecognized value of generation attribute") < 0)
+                goto done;
+            goto ok;
+        }
+        genreply = (generation != xmldb_generation_get(h, db));
+        snprintf(genstr, sizeof(genstr), "%" PRIu64, xmldb_generation_get(h, db));
+        if (!genreply){
+            cprintf(cbret, "<rpc-reply xmlns=\"%s\"><%s %s:generation=\"%s\" %s:unchanged=\"true\" xmlns:%s=\"%s\"/></rpc-reply>",
+                    NETCONF_BASE_NAMESPACE, NETCONF_OUTPUT_DATA,
+                    CLIXON_LIB_PREFIX, genstr, CLIXON_LIB_PREFIX,
+                    CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+            goto ok;
+        }
+    }
     if ((wdefstr = xml_find_body(xe, "with-defaults")) != NULL) 
         wdef = withdefaults_str2int(wdefstr);
     /* Check if list pagination */
@@ -929,6 +1212,13 @@ get_common(clicon_handle        h,
             goto ok;
         list_pagination = (offset != 0 || limit != 0);
     }
+    /* Clixon extensions: list-pagination cursor and count */
+    if ((cursor = xml_find_value(xe, "cursor")) != NULL)
+        list_pagination = 1;
+    if ((attr = xml_find_value(xe, "count")) != NULL && strcmp(attr, "true") == 0){
+        count = 1;
+        list_pagination = 1;
+    }
     /* Sanity check for list pagination: path must be a list/leaf-list, if it is,
      * check config/state
      */
@@ -937,10 +1227,21 @@ get_common(clicon_handle        h,
                                 xfind,
                                 content, db,
                                 depth, yspec, xpath, nsc, username, wdef,
+                                cursor, count,
                                 cbret) < 0)
             goto done;
         goto ok;
     }
+    /* Config only without NACM: serialize directly from datastore cache without copy */
+    if (content == CONTENT_CONFIG &&
+        clicon_datastore_cache(h) != DATASTORE_NOCACHE &&
+        (wdef == WITHDEFAULTS_REPORT_ALL || wdef == WITHDEFAULTS_EXPLICIT) &&
+        clicon_nacm_cache(h) == NULL &&
+        !clicon_option_bool(h, "CLICON_NACM_DISABLED_ON_EMPTY")){
+        if (get_config_view(h, db, xpath, nsc, wdef, depth, genreply?genstr:NULL, cbret) < 0)
+            goto done;
+        goto ok;
+    }
     /* Read configuration */
     switch (content){
     case CONTENT_CONFIG:    /* config data only */
@@ -1045,6 +1346,10 @@ get_common(clicon_handle        h,
         goto done;
     if (filter_xpath_again(h, yspec, xret, xvec, xlen, xpath, nsc) < 0)
         goto done;
+    /* Generation of the returned config, for client caching */
+    if (genreply &&
+        xml_add_attr(xret, "generation", genstr, CLIXON_LIB_PREFIX, CLIXON_LIB_NS) < 0)
+        goto done;
     if (get_nacm_and_reply(h, xret, xvec, xlen, xpath, nsc, username, depth, cbret) < 0)
         goto done;
  ok:
@@ -807,6 +807,9 @@ main(int    argc,
                             clicon_option_str(h, "CLICON_BACKEND_REGEXP")) < 0)
         goto done;
 
+    /* Load all yang modules from yang cache if enabled and valid, then parsing is skipped */
+    if (yang_spec_cache_load(h, "backend", yspec) < 0)
+        goto done;
     /* Load Yang modules
      * 1. Load a yang module as a specific absolute filename */
     if ((str = clicon_yang_main_file(h)) != NULL)
@@ -838,6 +841,9 @@ main(int    argc,
     if (clicon_option_bool(h, "CLICON_XMLDB_MODSTATE") &&
         yang_spec_parse_module(h, "ietf-yang-library", NULL, yspec)< 0)
         goto done;
+    /* Write yang cache if enabled and not loaded from it */
+    if (yang_spec_cache_done(h, "backend", yspec) < 0)
+        goto done;
     /* Check restconf start/stop from backend */
     if (clicon_option_bool(h, "CLICON_BACKEND_RESTCONF_PROCESS")){
         if (backend_plugin_restconf_register(h, yspec) < 0)
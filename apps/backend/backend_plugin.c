@@ -313,9 +313,141 @@ clixon_plugin_statedata_one(clixon_plugin_t *cp,
     goto done;
 }
 
+/*! Call one registered state data callback (routed on schema path)
+ *
+ * @param[in]  sc      State data callback
+ * @param[in]  h       clicon handle
+ * @param[in]  nsc     namespace context for xpath
+ * @param[in]  xpath   String with XPATH syntax. or NULL for all
+ * @param[out] xp      If retval=1, state tree created and returned: <config>...
+ * @retval    -1       Fatal error
+ * @retval     0       Statedata callback failed. no XML tree returned
+ * @retval     1       OK
+ * @see clixon_plugin_statedata_one  for the corresponding plugin callback
+ */
+static int
+statedata_callback_one(statedata_callback_t *sc,
+                       clicon_handle         h,
+                       cvec                 *nsc,
+                       char                 *xpath,
+                       cxobj               **xp)
+{
+    int    retval = -1;
+    cxobj *x = NULL;
+    void  *wh = NULL;
+
+    if ((x = xml_new(DATASTORE_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+        goto done;
+    if (plugin_context_check(h, &wh, sc->sc_fnstr, __FUNCTION__) < 0)
+        goto done;
+    if (sc->sc_callback(h, nsc, xpath, x) < 0){
+        if (plugin_context_check(h, &wh, sc->sc_fnstr, __FUNCTION__) < 0)
+            goto done;
+        if (clicon_errno < 0) 
+            clicon_log(LOG_WARNING, "%s: Internal error: State callback %s returned -1 but did not make a clicon_err call",
+                       __FUNCTION__, sc->sc_fnstr);
+        goto fail;  /* Dont quit here on user callbacks */
+    }
+    if (plugin_context_check(h, &wh, sc->sc_fnstr, __FUNCTION__) < 0)
+        goto done;
+    *xp = x;
+    x = NULL;
+    retval = 1;
+ done:
+    if (x)
+        xml_free(x);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Bind, sort and merge state data from one callback into the result tree
+ *
+ * @param[in]     h       clicon handle
+ * @param[in]     yspec   Yang spec
+ * @param[in]     name    Name of plugin or callback, for error messages
+ * @param[in]     ret     Return value of callback: 0 means callback failed
+ * @param[in]     x       State XML tree from callback (is consumed), or NULL
+ * @param[in,out] xret    State XML tree is merged with existing tree.
+ * @retval       -1       Error
+ * @retval        0       Statedata callback failed (xret set with netconf-error)
+ * @retval        1       OK
+ */
+static int
+statedata_merge(clicon_handle h,
+                yang_stmt    *yspec,
+                const char   *name,
+                int           ret,
+                cxobj        *x,
+                cxobj       **xret)
+{
+    int    retval = -1;
+    cbuf  *cberr = NULL; 
+    cxobj *xerr = NULL;
+
+    if (ret == 0){
+        if ((cberr = cbuf_new()) == NULL){
+            clicon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+        /* error reason should be in clicon_err_reason */
+        cprintf(cberr, "Internal error, state callback in plugin %s returned invalid XML: %s",
+                name, clicon_err_reason);
+        if (netconf_operation_failed_xml(&xerr, "application", cbuf_get(cberr)) < 0)
+            goto done;
+        xml_free(*xret);
+        *xret = xerr;
+        xerr = NULL;
+        goto fail;
+    }
+    if (x == NULL || xml_child_nr(x) == 0)
+        goto ok;
+    clicon_debug_xml(CLIXON_DBG_DETAIL, x, "%s %s STATE:", __FUNCTION__, name);
+    /* XXX: ret == 0 invalid yang binding should be handled as internal error */
+    if ((ret = xml_bind_yang(h, x, YB_MODULE, yspec, &xerr)) < 0)
+        goto done;
+    if (ret == 0){
+        if (clixon_netconf_internal_error(xerr,
+                                          ". Internal error, state callback returned invalid XML from plugin: ",
+                                          (char*)name) < 0)
+            goto done;
+        xml_free(*xret);
+        *xret = xerr;
+        xerr = NULL;
+        goto fail;
+    }
+    if (xml_sort_recurse(x) < 0)
+        goto done;
+    /* Remove global defaults and empty non-presence containers */
+    /* XXX: only for state data and according to with-defaults setting */
+    if (xml_defaults_nopresence(x, 2) < 0)
+        goto done;
+    if ((ret = netconf_trymerge(x, yspec, xret)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+ ok:
+    retval = 1;
+ done:
+    if (x)
+        xml_free(x);
+    if (xerr)
+        xml_free(xerr);
+    if (cberr)
+        cbuf_free(cberr);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
 /*! Go through all backend statedata callbacks and collect state data
  * This is internal system call, plugin is invoked (does not call) this function
- * Backend plugins can register 
+ * Backend plugins can provide state data in two ways:
+ * 1. The ca_statedata plugin callback, which is called on every request
+ * 2. Callbacks registered with statedata_callback_register() on a schema subtree, which
+ *    are only called if the subtree intersects the (canonical) xpath of the request
  * @param[in]     h       clicon handle
  * @param[in]     yspec   Yang spec
  * @param[in]     nsc     Namespace context
@@ -335,74 +467,50 @@ clixon_plugin_statedata_all(clicon_handle   h,
                             withdefaults_type wdef,
                             cxobj         **xret)
 {
-    int              retval = -1;
-    int              ret;
-    cxobj           *x = NULL;
-    clixon_plugin_t *cp = NULL;
-    cbuf            *cberr = NULL; 
-    cxobj           *xerr = NULL;
+    int                   retval = -1;
+    int                   ret;
+    cxobj                *x = NULL;
+    clixon_plugin_t      *cp = NULL;
+    statedata_callback_t *sc = NULL;
     
     clicon_debug(CLIXON_DBG_DETAIL, "%s", __FUNCTION__);
     while ((cp = clixon_plugin_each(h, cp)) != NULL) {
+        x = NULL;
         if ((ret = clixon_plugin_statedata_one(cp, h, nsc, xpath, &x)) < 0)
             goto done;
-        if (ret == 0){
-            if ((cberr = cbuf_new()) == NULL){
-                clicon_err(OE_UNIX, errno, "cbuf_new");
-                goto done;
-            }
-            /* error reason should be in clicon_err_reason */
-            cprintf(cberr, "Internal error, state callback in plugin %s returned invalid XML: %s",
-                    clixon_plugin_name_get(cp), clicon_err_reason);
-            if (netconf_operation_failed_xml(&xerr, "application", cbuf_get(cberr)) < 0)
-                goto done;
-            xml_free(*xret);
-            *xret = xerr;
-            xerr = NULL;
+        ret = statedata_merge(h, yspec, clixon_plugin_name_get(cp), ret, x, xret);
+        x = NULL; /* consumed */
+        if (ret < 0)
+            goto done;
+        if (ret == 0)
             goto fail;
-        }
-        if (x == NULL)
-            continue;
-        if (xml_child_nr(x) == 0){
-            xml_free(x);
-            x = NULL;
+    } /* while plugin */
+    while ((sc = statedata_callback_each(h, sc)) != NULL) {
+        if ((ret = statedata_callback_match(sc, yspec, nsc, xpath)) < 0)
+            goto done;
+        if (ret == 0){
+            clicon_debug(CLIXON_DBG_DETAIL, "%s skip %s %s", __FUNCTION__, sc->sc_fnstr, sc->sc_path);
             continue;
         }
-        clicon_debug_xml(CLIXON_DBG_DETAIL, x, "%s %s STATE:", __FUNCTION__, clixon_plugin_name_get(cp));
-        /* XXX: ret == 0 invalid yang binding should be handled as internal error */
-        if ((ret = xml_bind_yang(h, x, YB_MODULE, yspec, &xerr)) < 0)
+        x = NULL;
+        /* Serve from cache if fresh, identical requests within ttl call the callback once */
+        if ((ret = statedata_cache_get(sc, xpath, &x)) < 0)
             goto done;
         if (ret == 0){
-            if (clixon_netconf_internal_error(xerr,
-                                              ". Internal error, state callback returned invalid XML from plugin: ",
-                                              clixon_plugin_name_get(cp)) < 0)
+            if ((ret = statedata_callback_one(sc, h, nsc, xpath, &x)) < 0)
+                goto done;
+            if (ret == 1 && statedata_cache_set(sc, xpath, x) < 0)
                 goto done;
-            xml_free(*xret);
-            *xret = xerr;
-            xerr = NULL;
-            goto fail;
         }
-        if (xml_sort_recurse(x) < 0)
-            goto done;
-        /* Remove global defaults and empty non-presence containers */
-        /* XXX: only for state data and according to with-defaults setting */
-        if (xml_defaults_nopresence(x, 2) < 0)
-            goto done;
-        if ((ret = netconf_trymerge(x, yspec, xret)) < 0)
+        ret = statedata_merge(h, yspec, sc->sc_fnstr, ret, x, xret);
+        x = NULL; /* consumed */
+        if (ret < 0)
             goto done;
         if (ret == 0)
             goto fail;
-        if (x){
-            xml_free(x);
-            x = NULL;
-        }
-    } /* while plugin */
+    }
     retval = 1;
  done:
-    if (xerr)
-        xml_free(xerr);
-    if (cberr)
-        cbuf_free(cberr);
     if (x)
         xml_free(x);
     return retval;
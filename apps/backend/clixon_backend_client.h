@@ -67,6 +67,7 @@ struct client_entry{
                                            "cl:", where cl is ensured to be declared ie by
                                            netconf-monitoring state */
     char                 *ce_source_host; /* Host identifier of the NETCONF client */
+    int                   ce_binary;  /* Binary encoding negotiated in hello, see CLICON_IPC_BINARY */
     struct timeval        ce_time;    /* Time at the server at which the session was established. */
     uint32_t              ce_in_rpcs ;       /* Number of correct <rpc> messages received. */
     uint32_t              ce_in_bad_rpcs;    /* Not correct <rpc> messages */
@@ -1328,13 +1328,133 @@ yang2cli_post(clicon_handle h,
     return retval;
 }
 
+/*! Lazy autocli state: top-level yang nodes whose cligen syntax is not yet generated
+ * Stored in handle as "autocli-lazy"
+ * @see yang2cli_lazy
+ */
+typedef struct {
+    char       *al_treename; /* Name of autocli tree, eg basemodel */
+    int         al_len;      /* Length of al_vec */
+    yang_stmt **al_vec;      /* Pending top-level yang nodes, entries set to NULL when generated */
+} autocli_lazy;
+
+/*! Free lazy autocli state
+ */
+static int
+autocli_lazy_free(autocli_lazy *al)
+{
+    if (al->al_treename)
+        free(al->al_treename);
+    if (al->al_vec)
+        free(al->al_vec);
+    free(al);
+    return 0;
+}
+
+/*! Generate clispec for a module or a top-level node and merge it into a parse-tree
+ * 
+ * @param[in]  h         Clixon handle
+ * @param[in]  ymod      YANG module
+ * @param[in]  ys        Top-level node of ymod, or NULL for the complete module
+ * @param[in]  treename  Name of tree
+ * @param[in]  printgen  Log the generated CLIgen syntax
+ * @param[in]  cb        Work buffer
+ * @param[in]  pt0       Parse-tree to merge the generated syntax into
+ * @retval     0         OK
+ * @retval    -1         Error
+ */
+static int
+yang2cli_module(clicon_handle h,
+                yang_stmt    *ymod,
+                yang_stmt    *ys,
+                char         *treename,
+                int           printgen,
+                cbuf         *cb,
+                parse_tree   *pt0)
+{
+    int         retval = -1;
+    parse_tree *pt = NULL;
+    char       *prefix;
+    cg_obj     *co;
+    int         i;
+    int         config;
+
+    cbuf_reset(cb);
+    if (ys == NULL){
+        if (yang2cli_stmt(h, ymod, 0, cb) < 0)
+            goto done;
+    }
+    else if (yang2cli_stmt(h, ys, 1, cb) < 0)
+        goto done;
+    if (cbuf_len(cb) == 0)
+        goto ok;
+    /* Note Tie-break of same top-level symbol: prefix is NYI
+     * Needs to move cligen_parse_str() call here instead of later
+     */
+    if ((prefix = yang_find_myprefix(ymod)) == NULL){
+        clicon_err(OE_YANG, 0, "Module %s lacks prefix", yang_argument_get(ymod)); /* shouldnt happen */
+        goto done;
+    }
+    if ((pt = pt_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "pt_new");
+        goto done;
+    }
+    /* Parse the buffer using cligen parser. load cli syntax */
+    if (cligen_parse_str(cli_cligen(h), cbuf_get(cb), "yang2cli", pt, NULL) < 0){
+        fprintf(stderr, "%s\n", cbuf_get(cb));
+        goto done;
+    }
+    /* Add prefix: assume new are appended */
+    for (i=0; i<pt_len_get(pt); i++){
+        if ((co = pt_vec_i_get(pt, i)) != NULL)
+            co_prefix_set(co, prefix);
+    }
+    /* Post-processing, iterate over the generated cligen parse-tree with corresponding yang
+     * Note cannot do it inline in yang2cli above since:
+     * 1. labels cannot be set on "empty"
+     * 2. a; <a>, fn() cannot be set properly
+     */
+    config = 1;
+    if (yang2cli_post(h, NULL, pt, 0, ymod, NULL, &config) < 0){
+        goto done;
+    }
+    /* Resolve the expand callback functions in the generated syntax.
+     * This "should" only be GENERATE_EXPAND_XMLDB
+     * handle=NULL for global namespace, this means expand callbacks must be in
+     * CLICON namespace, not in a cli frontend plugin.
+     */
+    if (cligen_expandv_str2fn(pt, (expandv_str2fn_t*)clixon_str2fn, NULL) < 0)     
+        goto done;
+    clicon_debug(1, "%s Generated auto-cli for %s %s", __FUNCTION__, yang_argument_get(ymod),
+                 ys?yang_argument_get(ys):"");
+    if (printgen)
+        clicon_log(LOG_NOTICE, "%s: Top-level cli-spec %s:\n%s",
+                   __FUNCTION__, treename, cbuf_get(cb));
+    else
+        clicon_debug(CLIXON_DBG_DETAIL, "%s: Top-level cli-spec %s:\n%s",
+                     __FUNCTION__, treename, cbuf_get(cb));
+    if (cligen_parsetree_merge(pt0, NULL, pt) < 0){
+        clicon_err(OE_YANG, errno, "cligen_parsetree_merge");
+        goto done;
+    }
+ ok:
+    retval = 0;
+ done:
+    if (pt)
+        pt_free(pt, 1);
+    return retval;
+}
+
 /*! Generate clispec for all modules in yspec (except excluded)
  * 
+ * If CLICON_CLI_AUTOCLI_LAZY is set, only register the (empty) tree and the top-level
+ * nodes of all enabled modules. Their syntax is then generated on demand by yang2cli_lazy()
  * @param[in]  h         Clixon handle
  * @param[in]  yspec     Top-level Yang statement of type Y_SPEC
  * @param[in]  treename  Name of tree
- * @param[in]  xautocli  Autocli config tree (instance of clixon-autocli.yang)
  * @param[in]  printgen  Log the generated CLIgen syntax
+ * @retval     0         OK
+ * @retval    -1         Error
  * @note Tie-break of same top-level symbol: prefix is NYI
  */
 int
@@ -1345,15 +1465,13 @@ yang2cli_yspec(clicon_handle      h,
 {
     int             retval = -1;
     parse_tree     *pt0 = NULL;
-    parse_tree     *pt = NULL;
     yang_stmt      *ymod;
+    yang_stmt      *ys;
     pt_head        *ph;
     int             enable;
     cbuf           *cb = NULL;
-    char           *prefix;
-    cg_obj         *co;
-    int             i;
-    int             config;
+    autocli_lazy   *al = NULL;
+    int             lazy;
     
     if ((pt0 = pt_new()) == NULL){
         clicon_err(OE_UNIX, errno, "pt_new");
@@ -1363,6 +1481,19 @@ yang2cli_yspec(clicon_handle      h,
         clicon_err(OE_XML, errno, "cbuf_new");
         goto done;
     }
+    /* Printgen logs the complete syntax, therefore generate everything */
+    lazy = clicon_option_bool(h, "CLICON_CLI_AUTOCLI_LAZY") && !printgen;
+    if (lazy){
+        if ((al = malloc(sizeof(*al))) == NULL){
+            clicon_err(OE_UNIX, errno, "malloc");
+            goto done;
+        }
+        memset(al, 0, sizeof(*al));
+        if ((al->al_treename = strdup(treename)) == NULL){
+            clicon_err(OE_UNIX, errno, "strdup");
+            goto done;
+        }
+    }
     /* Traverse YANG, loop through all modules and generate CLI */
     ymod = NULL;
     while ((ymod = yn_each(yspec, ymod)) != NULL){
@@ -1373,80 +1504,46 @@ yang2cli_yspec(clicon_handle      h,
             goto done;
         if (!enable)
             continue;
-        cbuf_reset(cb);
-        if (yang2cli_stmt(h, ymod, 0, cb) < 0)
-            goto done;
-        if (cbuf_len(cb) == 0)
+        if (!lazy){
+            if (yang2cli_module(h, ymod, NULL, treename, printgen, cb, pt0) < 0)
+                goto done;
             continue;
-        /* Note Tie-break of same top-level symbol: prefix is NYI
-         * Needs to move cligen_parse_str() call here instead of later
-         */
-        if ((prefix = yang_find_myprefix(ymod)) == NULL){
-            clicon_err(OE_YANG, 0, "Module %s lacks prefix", yang_argument_get(ymod)); /* shouldnt happen */
-            goto done;
-        }
-        if ((pt = pt_new()) == NULL){
-            clicon_err(OE_UNIX, errno, "pt_new");
-            goto done;
-        }
-
-        /* Parse the buffer using cligen parser. load cli syntax */
-        if (cligen_parse_str(cli_cligen(h), cbuf_get(cb), "yang2cli", pt, NULL) < 0){
-            fprintf(stderr, "%s\n", cbuf_get(cb));
-            goto done;
-        }
-        /* Add prefix: assume new are appended */
-        for (i=0; i<pt_len_get(pt); i++){
-            if ((co = pt_vec_i_get(pt, i)) != NULL)
-                co_prefix_set(co, prefix);
         }
-        /* Post-processing, iterate over the generated cligen parse-tree with corresponding yang
-         * Note cannot do it inline in yang2cli above since:
-         * 1. labels cannot be set on "empty"
-         * 2. a; <a>, fn() cannot be set properly
-         */
-        config = 1;
-        if (yang2cli_post(h, NULL, pt, 0, ymod, NULL, &config) < 0){
-            goto done;
-        }
-        //      pt_print(stderr,pt);
-        clicon_debug(1, "%s Generated auto-cli for %s", __FUNCTION__, yang_argument_get(ymod));
-        if (printgen)
-            clicon_log(LOG_NOTICE, "%s: Top-level cli-spec %s:\n%s",
-                       __FUNCTION__, treename, cbuf_get(cb));
-        else
-            clicon_debug(CLIXON_DBG_DETAIL, "%s: Top-level cli-spec %s:\n%s",
-                         __FUNCTION__, treename, cbuf_get(cb));
-        if (cligen_parsetree_merge(pt0, NULL, pt) < 0){
-            clicon_err(OE_YANG, errno, "cligen_parsetree_merge");
-            goto done;
+        /* Lazy: register top-level nodes that may generate syntax, see yang2cli_stmt */
+        ys = NULL;
+        while ((ys = yn_each(ymod, ys)) != NULL){
+            switch (yang_keyword_get(ys)){
+            case Y_CONTAINER:
+            case Y_LIST:
+            case Y_CHOICE:
+            case Y_LEAF_LIST:
+            case Y_LEAF:
+                if ((al->al_vec = realloc(al->al_vec, (al->al_len+1)*sizeof(yang_stmt*))) == NULL){
+                    clicon_err(OE_UNIX, errno, "realloc");
+                    goto done;
+                }
+                al->al_vec[al->al_len++] = ys;
+                break;
+            default:
+                break;
+            }
         }
-        pt_free(pt, 1);
-        pt = NULL;
     } /* ymod */
-    /* Resolve the expand callback functions in the generated syntax.
-     * This "should" only be GENERATE_EXPAND_XMLDB
-     * handle=NULL for global namespace, this means expand callbacks must be in
-     * CLICON namespace, not in a cli frontend plugin.
-     */
-    if (cligen_expandv_str2fn(pt0, (expandv_str2fn_t*)clixon_str2fn, NULL) < 0)     
-        goto done;
     /* Append cligen tree and name it */
     if ((ph = cligen_ph_add(cli_cligen(h), treename)) == NULL)
         goto done;
     if (cligen_ph_parsetree_set(ph, pt0) < 0)
         goto done;
     pt0 = NULL;
-#if 0
-    if (printgen){
-        clicon_log(LOG_NOTICE, "%s: Top-level cli-spec %s", __FUNCTION__, treename);
-        pt_print1(stderr, pt0, 0);
+    if (al){
+        if (clicon_ptr_set(h, "autocli-lazy", al) < 0)
+            goto done;
+        al = NULL;
     }
-#endif
     retval = 0;
  done:
-    if (pt)
-        pt_free(pt, 1);
+    if (al)
+        autocli_lazy_free(al);
     if (pt0)
         pt_free(pt0, 1);
     if (cb)
@@ -1454,6 +1551,118 @@ yang2cli_yspec(clicon_handle      h,
     return retval;
 }
 
+/*! Check if a top-level yang node generates a command with name as first word
+ *
+ * @param[in]  ys    Top-level yang node, or choice/case below it
+ * @param[in]  name  Command word
+ * @retval     1     Match
+ * @retval     0     No match
+ */
+static int
+yang2cli_lazy_match(yang_stmt *ys,
+                    char      *name)
+{
+    yang_stmt *yc;
+
+    switch (yang_keyword_get(ys)){
+    case Y_CHOICE:
+    case Y_CASE:
+        yc = NULL;
+        while ((yc = yn_each(ys, yc)) != NULL)
+            if (yang2cli_lazy_match(yc, name))
+                return 1;
+        return 0;
+    default:
+        return strcmp(yang_argument_get(ys), name) == 0;
+    }
+}
+
+/*! Generate pending lazy autocli syntax used by a command
+ *
+ * Syntax of a top-level yang node is generated and merged into the autocli tree if its name
+ * is one of the words of the command. Generated syntax is kept in the tree.
+ * @param[in]  h    Clixon handle
+ * @param[in]  cmd  Command line, or NULL to generate all pending syntax
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @see yang2cli_yspec  where top-level nodes are registered if CLICON_CLI_AUTOCLI_LAZY is set
+ */
+int
+yang2cli_lazy(clicon_handle h,
+              char         *cmd)
+{
+    int           retval = -1;
+    autocli_lazy *al = NULL;
+    pt_head      *ph;
+    parse_tree   *pt0;
+    cbuf         *cb = NULL;
+    char        **vec = NULL;
+    int           nvec = 0;
+    yang_stmt    *ys;
+    int           i;
+    int           j;
+    int           pending = 0;
+
+    if (clicon_ptr_get(h, "autocli-lazy", (void**)&al) < 0 || al == NULL)
+        goto ok;
+    if ((ph = cligen_ph_find(cli_cligen(h), al->al_treename)) == NULL ||
+        (pt0 = cligen_ph_parsetree_get(ph)) == NULL){
+        clicon_err(OE_PLUGIN, 0, "autocli tree %s not found", al->al_treename);
+        goto done;
+    }
+    if (cmd != NULL &&
+        (vec = clicon_strsep(cmd, " \t", &nvec)) == NULL)
+        goto done;
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    for (i=0; i<al->al_len; i++){
+        if ((ys = al->al_vec[i]) == NULL)
+            continue;
+        if (cmd != NULL){
+            for (j=0; j<nvec; j++)
+                if (yang2cli_lazy_match(ys, vec[j]))
+                    break;
+            if (j == nvec){
+                pending++;
+                continue;
+            }
+        }
+        if (yang2cli_module(h, yang_parent_get(ys), ys, al->al_treename, 0, cb, pt0) < 0)
+            goto done;
+        al->al_vec[i] = NULL;
+    }
+    if (pending == 0){
+        clicon_ptr_del(h, "autocli-lazy");
+        autocli_lazy_free(al);
+    }
+ ok:
+    retval = 0;
+ done:
+    if (vec)
+        free(vec);
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Check if there is lazy autocli syntax not yet generated
+ *
+ * @param[in]  h    Clixon handle
+ * @retval     1    Yes, there is pending syntax
+ * @retval     0    No
+ */
+int
+yang2cli_lazy_pending(clicon_handle h)
+{
+    autocli_lazy *al = NULL;
+
+    if (clicon_ptr_get(h, "autocli-lazy", (void**)&al) < 0 || al == NULL)
+        return 0;
+    return 1;
+}
+
 /*! Init yang2cli
  *
  * Initialize CLIgen generation from YANG models.
@@ -1466,3 +1675,20 @@ yang2cli_init(clicon_handle h)
 {
     return 0;
 }
+
+/*! Exit yang2cli
+ *
+ * Free pending lazy autocli state, if any
+ * @param[in]  h      Clixon handle
+ */
+int
+yang2cli_exit(clicon_handle h)
+{
+    autocli_lazy *al = NULL;
+
+    if (clicon_ptr_get(h, "autocli-lazy", (void**)&al) == 0 && al != NULL){
+        clicon_ptr_del(h, "autocli-lazy");
+        autocli_lazy_free(al);
+    }
+    return 0;
+}
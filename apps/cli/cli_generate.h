@@ -57,6 +57,9 @@
  * Prototypes
  */
 int yang2cli_yspec(clicon_handle h, yang_stmt *yspec, char *treename, int printgen);
+int yang2cli_lazy(clicon_handle h, char *cmd);
+int yang2cli_lazy_pending(clicon_handle h);
 int yang2cli_init(clicon_handle h);
+int yang2cli_exit(clicon_handle h);
 
 #endif  /* _CLI_GENERATE_H_ */
@@ -171,6 +171,8 @@ cli_terminate(clicon_handle h)
         clixon_exit_set(1);
     if (clicon_data_get(h, "session-transport", NULL) == 0)
         clicon_rpc_close_session(h); 
+    yang2cli_exit(h);
+    expand_dbvar_cache_free(h);
     if ((yspec = clicon_dbspec_yang(h)) != NULL)
         ys_free(yspec);
     if ((yspec = clicon_config_yang(h)) != NULL)
@@ -711,6 +713,9 @@ main(int    argc,
         goto done;
     clicon_dbspec_yang_set(h, yspec);
     
+    /* Load all yang modules from yang cache if enabled and valid, then parsing is skipped */
+    if (yang_spec_cache_load(h, "cli", yspec) < 0)
+        goto done;
     /* Load Yang modules
      * 1. Load a yang module as a specific absolute filename */
     if ((str = clicon_yang_main_file(h)) != NULL){
@@ -741,6 +746,9 @@ main(int    argc,
     if (netconf_module_load(h) < 0)
         goto done;
     
+    /* Write yang cache if enabled and not loaded from it */
+    if (yang_spec_cache_done(h, "cli", yspec) < 0)
+        goto done;
     /* Here all modules are loaded 
      * Compute and set canonical namespace context
      */
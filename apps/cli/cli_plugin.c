@@ -591,8 +591,33 @@ clicon_parse(clicon_handle  h,
             fprintf(f, "No such parse-tree registered: %s\n", modename);
             goto done;
         }
+        /* Lazy autocli: generate syntax of top-level nodes named in the command */
+        if (yang2cli_lazy(h, cmd) < 0)
+            goto done;
         if (cliread_parse(ch, cmd, pt, &match_obj, &cvv, &callbacks, result, &reason) < 0)
             goto done;
+        /* The command may not name its top-level node, eg compressed syntax or edit-mode
+         * Then generate all pending syntax and try again */
+        if (*result == CG_NOMATCH && yang2cli_lazy_pending(h)){
+            if (reason){
+                free(reason);
+                reason = NULL;
+            }
+            if (cvv){
+                cvec_free(cvv);
+                cvv = NULL;
+            }
+            if (callbacks)
+                co_callbacks_free(&callbacks);
+            if (match_obj){
+                co_free(match_obj, 0);
+                match_obj = NULL;
+            }
+            if (yang2cli_lazy(h, NULL) < 0)
+                goto done;
+            if (cliread_parse(ch, cmd, pt, &match_obj, &cvv, &callbacks, result, &reason) < 0)
+                goto done;
+        }
         /* Debug command and result code */
         clicon_debug(1, "%s result:%d command: \"%s\"", __FUNCTION__, *result, cmd);
         switch (*result) {
@@ -780,6 +805,9 @@ clicon_cliread(clicon_handle h,
         free(promptstr);
     }
     cligen_ph_active_set_byname(cli_cligen(h), mode->csm_name);
+    /* Lazy autocli: completion may descend into any syntax, generate all pending */
+    if (yang2cli_lazy(h, NULL) < 0)
+        goto done;
 
     clicon_err_reset();
     if (cliread(cli_cligen(h), stringp) < 0){
@@ -166,6 +166,151 @@ xpath_append(cbuf      *cb0,
     return retval;
 }
 
+/* Max number of entries in the expand_dbvar cache before it is flushed */
+#define EXPAND_CACHE_MAX 64
+
+/*! Entry of the expand_dbvar completion cache
+ * @see expand_dbvar_cache_set
+ */
+typedef struct {
+    uint64_t ee_generation; /* Datastore generation of the cached values */
+    cvec    *ee_values;     /* Expanded values */
+} expand_entry;
+
+/*! expand_dbvar completion cache, stored in handle as "cli-expand-cache"
+ * Keyed by datastore and xpath (from api-path)
+ */
+typedef struct {
+    clicon_hash_t *ec_hash; /* Hash of expand_entry */
+    int            ec_len;  /* Number of entries in hash */
+} expand_cache;
+
+/*! Free all entries of the expand_dbvar completion cache
+ *
+ * @param[in]  h   Clixon handle
+ * @retval     0   OK
+ * @retval    -1   Error
+ */
+int
+expand_dbvar_cache_free(clicon_handle h)
+{
+    int           retval = -1;
+    expand_cache *ec = NULL;
+    expand_entry *ee;
+    char        **keys = NULL;
+    size_t        klen = 0;
+    int           i;
+
+    if (clicon_ptr_get(h, "cli-expand-cache", (void**)&ec) < 0 || ec == NULL)
+        goto ok;
+    if (clicon_hash_keys(ec->ec_hash, &keys, &klen) < 0)
+        goto done;
+    for (i=0; i<klen; i++)
+        if ((ee = clicon_hash_value(ec->ec_hash, keys[i], NULL)) != NULL &&
+            ee->ee_values)
+            cvec_free(ee->ee_values);
+    clicon_hash_free(ec->ec_hash);
+    free(ec);
+    clicon_ptr_del(h, "cli-expand-cache");
+ ok:
+    retval = 0;
+ done:
+    if (keys)
+        free(keys);
+    return retval;
+}
+
+/*! Get cached expand_dbvar values
+ *
+ * @param[in]  h   Clixon handle
+ * @param[in]  key Cache key: datastore and xpath
+ * @retval     ee  Cache entry, valid until next expand_dbvar_cache_set
+ * @retval     NULL Not found
+ */
+static expand_entry *
+expand_dbvar_cache_get(clicon_handle h,
+                       char         *key)
+{
+    expand_cache *ec = NULL;
+
+    if (clicon_ptr_get(h, "cli-expand-cache", (void**)&ec) < 0 || ec == NULL)
+        return NULL;
+    return clicon_hash_value(ec->ec_hash, key, NULL);
+}
+
+/*! Set cached expand_dbvar values
+ *
+ * @param[in]  h          Clixon handle
+ * @param[in]  key        Cache key: datastore and xpath
+ * @param[in]  generation Datastore generation of the values
+ * @param[in]  commands   Expanded values, copied
+ * @param[in]  i0         Offset into commands of first value
+ * @retval     0          OK
+ * @retval    -1          Error
+ */
+static int
+expand_dbvar_cache_set(clicon_handle h,
+                       char         *key,
+                       uint64_t      generation,
+                       cvec         *commands,
+                       int           i0)
+{
+    int           retval = -1;
+    expand_cache *ec = NULL;
+    expand_entry *ee0;
+    expand_entry  ee = {0,};
+    int           i;
+
+    if (clicon_ptr_get(h, "cli-expand-cache", (void**)&ec) < 0 || ec == NULL ||
+        ec->ec_len >= EXPAND_CACHE_MAX){
+        if (expand_dbvar_cache_free(h) < 0)
+            goto done;
+        if ((ec = malloc(sizeof(*ec))) == NULL){
+            clicon_err(OE_UNIX, errno, "malloc");
+            goto done;
+        }
+        memset(ec, 0, sizeof(*ec));
+        if ((ec->ec_hash = clicon_hash_init()) == NULL){
+            free(ec);
+            goto done;
+        }
+        if (clicon_ptr_set(h, "cli-expand-cache", ec) < 0){
+            clicon_hash_free(ec->ec_hash);
+            free(ec);
+            goto done;
+        }
+    }
+    if ((ee.ee_values = cvec_new(0)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_new");
+        goto done;
+    }
+    for (i=i0; i<cvec_len(commands); i++)
+        if (cvec_append_var(ee.ee_values, cvec_i(commands, i)) == NULL){
+            clicon_err(OE_UNIX, errno, "cvec_append_var");
+            goto done;
+        }
+    ee.ee_generation = generation;
+    if ((ee0 = clicon_hash_value(ec->ec_hash, key, NULL)) != NULL){
+        if (ee0->ee_values)
+            cvec_free(ee0->ee_values);
+    }
+    else
+        ec->ec_len++;
+    if (clicon_hash_add(ec->ec_hash, key, &ee, sizeof(ee)) == NULL){
+        if (ee0 != NULL){
+            clicon_hash_del(ec->ec_hash, key);
+            ec->ec_len--;
+        }
+        goto done;
+    }
+    ee.ee_values = NULL;
+    retval = 0;
+ done:
+    if (ee.ee_values)
+        cvec_free(ee.ee_values);
+    return retval;
+}
+
 /*! Completion callback intended for automatically generated data model
  *
  * Returns an expand-type list of commands as used by cligen 'expand' 
@@ -179,6 +324,8 @@ xpath_append(cbuf      *cb0,
  * @param[out]  commands vector of function pointers to callback functions
  * @param[out]  helptxt  vector of pointers to helptexts
  * @see cli_expand_var_generate  This is where arg is generated
+ * @note Values are cached per datastore and xpath, and only re-read from the backend if the
+ *       generation of the datastore has changed
  */
 int
 expand_dbvar(void   *h, 
@@ -214,6 +361,10 @@ expand_dbvar(void   *h,
     cbuf            *cbxpath = NULL;
     yang_stmt       *ypath;
     yang_stmt       *ytype;
+    cbuf            *cbkey = NULL;
+    expand_entry    *ee;
+    uint64_t         generation = 0;
+    int              i0;
     
     if (argv == NULL || cvec_len(argv) != 2){
         clicon_err(OE_PLUGIN, EINVAL, "requires arguments: <db> <xmlkeyfmt>");
@@ -308,9 +459,24 @@ expand_dbvar(void   *h,
         if (xpath_append(cbxpath, yang_argument_get(ypath), y, nsc) < 0)
             goto done;
     }
+    /* Completion cache: only get configuration if datastore changed since cached values */
+    if ((cbkey = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cbkey, "%s %s", dbstr, cbuf_get(cbxpath));
+    if ((ee = expand_dbvar_cache_get(h, cbuf_get(cbkey))) != NULL)
+        generation = ee->ee_generation;
     /* Get configuration based on cbxpath */
-    if (clicon_rpc_get_config(h, NULL, dbstr, cbuf_get(cbxpath), nsc, NULL, &xt) < 0) 
+    if (clicon_rpc_get_config_generation(h, NULL, dbstr, cbuf_get(cbxpath), nsc, NULL,
+                                         &generation, &xt) < 0) 
         goto done;
+    if (xt == NULL){ /* Unchanged since cached generation */
+        cv = NULL;
+        while (ee && (cv = cvec_each(ee->ee_values, cv)) != NULL)
+            cvec_add_string(commands, NULL, cv_string_get(cv));
+        goto ok;
+    }
     if ((xe = xpath_first(xt, NULL, "/rpc-error")) != NULL){
         clixon_netconf_error(xe, "Get configuration", NULL);
         goto ok; 
@@ -323,6 +489,7 @@ expand_dbvar(void   *h,
      * but for ordered-by system, check the whole list
      */
     bodystr0 = NULL;
+    i0 = cvec_len(commands);
     for (i = 0; i < xlen; i++) {
         x = xvec[i];
         if (xml_type(x) == CX_BODY)
@@ -353,9 +520,13 @@ expand_dbvar(void   *h,
             cvec_add_string(commands, NULL, bodystr);
         }
     }
+    if (expand_dbvar_cache_set(h, cbuf_get(cbkey), generation, commands, i0) < 0)
+        goto done;
  ok:
     retval = 0;
   done:
+    if (cbkey)
+        cbuf_free(cbkey);
     if (cbxpath)
         cbuf_free(cbxpath);
     if (xerr)
@@ -1184,6 +1355,7 @@ cli_pagination(clicon_handle h,
                                          limit*i,  /* offset */
                                          limit,    /* limit */
                                          NULL, NULL, NULL, /* nyi */
+                                         NULL, 0,  /* cursor, count */
                                          &xret) < 0){
             goto done;
         }
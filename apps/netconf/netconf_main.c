@@ -45,6 +45,7 @@
 #include <unistd.h>
 #include <stdarg.h>
 #include <errno.h>
+#include <ctype.h>
 #include <signal.h>
 #include <fcntl.h>
 #include <time.h>
@@ -187,17 +188,167 @@ netconf_hello_msg(clicon_handle h,
     return retval;
 }
 
+/*! Reply of pipelined rpc has arrived from backend, send it to client
+ *
+ * @param[in]  h     Clixon handle
+ * @param[in]  xret  Reply from backend, or NULL if cancelled
+ * @param[in]  arg   Copy of incoming <rpc> with attributes only
+ * @retval     0     OK
+ * @retval    -1    Error
+ * @see netconf_rpc_pipeline
+ */
+static int
+netconf_rpc_pipeline_cb(clicon_handle h,
+                        cxobj        *xret,
+                        void         *arg)
+{
+    int                  retval = -1;
+    cxobj               *xrpc = (cxobj *)arg;
+    cbuf                *cbret = NULL;
+    cxobj               *xc;
+    netconf_framing_type framing;
+
+    if (xret == NULL)
+        goto ok;
+    framing = clicon_data_int_get(h, "netconf-framing");
+    if ((xc = xml_child_i(xret, 0)) != NULL){
+        /* Copy attributes from incoming request to reply. Skip already present (dont overwrite) */
+        if (netconf_add_request_attr(xrpc, xc) < 0)
+            goto done;
+        if ((cbret = cbuf_new()) == NULL){ 
+            clicon_err(OE_XML, errno, "cbuf_new");
+            goto done;
+        }
+        if (clixon_xml2cbuf(cbret, xc, 0, 0, -1, 0) < 0)
+            goto done;
+        if (netconf_output_encap(framing, cbret) < 0)
+            goto done;
+        if (netconf_output(1, cbret, "rpc-reply") < 0)
+            goto done;
+    }
+ ok:
+    retval = 0;
+ done:
+    if (cbret)
+        cbuf_free(cbret);
+    xml_free(xrpc);
+    return retval;
+}
+
+/*! Pipeline a netconf rpc to backend without waiting for the reply
+ *
+ * Only edit-config with default options is pipelined, see CLICON_NETCONF_PIPELINE.
+ * The reply is sent to the client from netconf_rpc_pipeline_cb. Replies keep the order
+ * of the requests since a non-pipelined rpc waits for all outstanding replies first.
+ * @param[in]  h       Clixon handle
+ * @param[in]  xrpc    Incoming message on the form <rpc>...
+ * @param[in]  raw     Text of xrpc to forward as is, or NULL, see netconf_rpc_raw
+ * @param[in]  rawlen  Length of raw
+ * @retval     1     Pipelined
+ * @retval     0     Not pipelined, process synchronously
+ * @retval    -1     Error
+ */
+static int
+netconf_rpc_pipeline(clicon_handle h,
+                     cxobj        *xrpc,
+                     char         *raw,
+                     size_t        rawlen)
+{
+    int    retval = -1;
+    cxobj *xe;
+    cxobj *xa;
+    cxobj *xa2;
+    cxobj *xattrs = NULL;
+    char  *username;
+    int    ret;
+
+    if (xml_child_nr_type(xrpc, CX_ELMNT) != 1 ||
+        (xe = xml_child_i_type(xrpc, 0, CX_ELMNT)) == NULL ||
+        strcmp(xml_name(xe), "edit-config") != 0 ||
+        xml_find_type(xe, NULL, "test-option", CX_ELMNT) != NULL ||
+        xml_find_type(xe, NULL, "error-option", CX_ELMNT) != NULL)
+        goto notpipelined;
+    /* Keep attributes of request for the reply */
+    if ((xattrs = xml_new("rpc", NULL, CX_ELMNT)) == NULL)
+        goto done;
+    xa = NULL;
+    while ((xa = xml_child_each(xrpc, xa, CX_ATTR)) != NULL){
+        if ((xa2 = xml_dup(xa)) == NULL)
+            goto done;
+        if (xml_addsub(xattrs, xa2) < 0)
+            goto done;
+    }
+    /* Tag username as in netconf_rpc_dispatch */
+    if ((username = clicon_username_get(h)) != NULL){
+        if (xml_add_attr(xrpc, "username", username, CLIXON_LIB_PREFIX, CLIXON_LIB_NS) < 0)
+            goto done;
+    }
+    ret = clicon_rpc_netconf_raw_async(h, xrpc, raw, rawlen, netconf_rpc_pipeline_cb, xattrs, NULL);
+    if ((xa = xml_find(xrpc, "username")) != NULL)
+        xml_purge(xa);
+    if (ret < 0)
+        goto done;
+    xattrs = NULL;
+    retval = 1;
+ done:
+    if (xattrs)
+        xml_free(xattrs);
+    return retval;
+ notpipelined:
+    retval = 0;
+    goto done;
+}
+
+/*! Get text of incoming rpc to forward to the backend as is, not re-serialized from tree
+ *
+ * Not if the rpc element is prefixed, or if it has attributes that clash with the
+ * username attribute added when forwarding. Leading whitespace is skipped.
+ * @param[in]     xrpc  Incoming message on the form <rpc>...
+ * @param[in]     str   Text of the incoming message that xrpc is parsed from, or NULL
+ * @param[in,out] lenp  Length of str, on return length of rpc text
+ * @retval        raw   Start of rpc text in str
+ * @retval        NULL  Not applicable, forward tree
+ * @see clicon_rpc_netconf_raw
+ */
+static char *
+netconf_rpc_raw(cxobj  *xrpc,
+                char   *str,
+                size_t *lenp)
+{
+    cxobj *xa = NULL;
+    char  *prefix;
+
+    if (str == NULL || xml_prefix(xrpc) != NULL)
+        return NULL;
+    while ((xa = xml_child_each(xrpc, xa, CX_ATTR)) != NULL){
+        if (strcmp(xml_name(xa), "username") == 0)
+            return NULL;
+        if ((prefix = xml_prefix(xa)) != NULL && strcmp(prefix, "xmlns") == 0 &&
+            strcmp(xml_name(xa), CLIXON_LIB_PREFIX) == 0)
+            return NULL;
+    }
+    while (*lenp > 0 && isspace(*str)){
+        str++;
+        (*lenp)--;
+    }
+    return str;
+}
+
 /*! Process incoming Netconf RPC netconf message 
- * @param[in]   h     Clixon handle
- * @param[in]   xreq  XML tree containing netconf RPC message
- * @param[in]   yspec YANG spec
- * @param[out]  eof   Set to 1 if pending close socket
- * @retval      0     OK
- * @retval     -1     Error
+ * @param[in]   h      Clixon handle
+ * @param[in]   xreq   XML tree containing netconf RPC message
+ * @param[in]   str    Text of message that xreq is parsed from, or NULL
+ * @param[in]   len    Length of str
+ * @param[in]   yspec  YANG spec
+ * @param[out]  eof    Set to 1 if pending close socket
+ * @retval      0      OK
+ * @retval     -1      Error
  */
 static int
 netconf_rpc_message(clicon_handle h,
                     cxobj        *xrpc,
+                    char         *str,
+                    size_t        len,
                     yang_stmt    *yspec,
                     int          *eof)
 {
@@ -207,6 +358,7 @@ netconf_rpc_message(clicon_handle h,
     cbuf                *cbret = NULL;
     cxobj               *xc;
     netconf_framing_type framing;
+    char                *raw;
 
     framing = clicon_data_int_get(h, "netconf-framing");
     if (_netconf_hello_nr == 0 &&
@@ -234,6 +386,20 @@ netconf_rpc_message(clicon_handle h,
     if (ret > 0 &&
         (ret = xml_yang_validate_rpc(h, xrpc, 0, &xret)) < 0) 
         goto done;
+    /* Before username attribute is added */
+    raw = netconf_rpc_raw(xrpc, str, &len);
+    if (clicon_option_int(h, "CLICON_NETCONF_PIPELINE") > 0){
+        if (ret > 0){
+            if ((ret = netconf_rpc_pipeline(h, xrpc, raw, len)) < 0)
+                goto done;
+            if (ret == 1)
+                goto ok;
+            ret = 1;
+        }
+        /* Not pipelined: earlier replies are sent first */
+        if (clicon_rpc_async_flush(h) < 0)
+            goto done;
+    }
     if (ret == 0){
         if (netconf_add_request_attr(xrpc, xret) < 0)
             goto done;
@@ -249,7 +415,7 @@ netconf_rpc_message(clicon_handle h,
             goto done;
         goto ok;
     }
-    if (netconf_rpc_dispatch(h, xrpc, &xret, eof) < 0)
+    if (netconf_rpc_dispatch(h, xrpc, raw, len, &xret, eof) < 0)
         goto done;
 
     /* Is there a return message in xret? */
@@ -299,6 +465,8 @@ netconf_rpc_message(clicon_handle h,
  * Identify what netconf message it is
  * @param[in]   h     Clixon handle
  * @param[in]   xreq  XML tree containing netconf
+ * @param[in]   str   Text of message that xreq is parsed from, or NULL
+ * @param[in]   len   Length of str
  * @param[in]   yspec YANG spec
  * @param[out]  eof   Set to 1 if pending close socket
  * @retval      0     OK
@@ -307,6 +475,8 @@ netconf_rpc_message(clicon_handle h,
 static int
 netconf_input_packet(clicon_handle h,
                      cxobj        *xreq,
+                     char         *str,
+                     size_t        len,
                      yang_stmt    *yspec,
                      int          *eof)
 {
@@ -343,7 +513,7 @@ netconf_input_packet(clicon_handle h,
                 goto done;
             goto ok;
         }
-        if (netconf_rpc_message(h, xreq, yspec, eof) < 0)
+        if (netconf_rpc_message(h, xreq, str, len, yspec, eof) < 0)
             goto done;
     }
     else if (strcmp(rpcname, "hello") == 0){
@@ -370,10 +540,11 @@ netconf_input_packet(clicon_handle h,
     return retval;
 }
 
-/*! Process incoming frame, ie a char message framed by ]]>]]>
+/*! Process incoming frame, ie a char message framed by ]]>]]> or chunked framing
  * Parse string to xml, check only one netconf message within a frame
+ * The packet buffer is parsed in place and its text may be forwarded to the backend as is
  * @param[in]   h    Clixon handle
- * @param[in]   cb   Packet buffer
+ * @param[in]   cb   Packet buffer, a null character is appended
  * @param[out]  eof  Set to 1 if pending close socket
  * @retval      0    OK
  * @retval     -1    Fatal error
@@ -395,7 +566,7 @@ netconf_input_frame(clicon_handle h,
                     int          *eof)
 {
     int        retval = -1;
-    char      *str = NULL;
+    size_t     len;
     cxobj     *xtop = NULL; /* Request (in) */
     cxobj     *xreq = NULL;
     cxobj     *xret = NULL; /* Return (out) */
@@ -408,12 +579,8 @@ netconf_input_frame(clicon_handle h,
     clicon_debug(CLIXON_DBG_MSG, "Recv ext: %s", cbuf_get(cb));
     framing = clicon_data_int_get(h, "netconf-framing");
     yspec = clicon_dbspec_yang(h);
-    if ((str = strdup(cbuf_get(cb))) == NULL){
-        clicon_err(OE_UNIX, errno, "strdup");
-        goto done;
-    }
     /* Special case:  */
-    if (strlen(str) == 0){
+    if ((len = cbuf_len(cb)) == 0){
         if ((cbret = cbuf_new()) == NULL){ 
             clicon_err(OE_UNIX, errno, "cbuf_new");
             goto done;
@@ -426,8 +593,13 @@ netconf_input_frame(clicon_handle h,
             goto done;
         goto ok;
     }
+    /* Second null character, parse message in place */
+    if (cbuf_append_buf(cb, "", 1) < 0){
+        clicon_err(OE_UNIX, errno, "cbuf_append_buf");
+        goto done;
+    }
     /* Parse incoming XML message */
-    if ((ret = clixon_xml_parse_string(str, YB_RPC, yspec, &xtop, &xret)) < 0){ 
+    if ((ret = clixon_xml_parse_buf(cbuf_get(cb), len, YB_RPC, yspec, &xtop, &xret)) < 0){ 
         if ((cbret = cbuf_new()) == NULL){ 
             clicon_err(OE_UNIX, errno, "cbuf_new");
             goto done;
@@ -489,13 +661,11 @@ netconf_input_frame(clicon_handle h,
         clicon_err(OE_XML, EFAULT, "No xml req (shouldnt happen)");
         goto done;
     }
-    if (netconf_input_packet(h, xreq, yspec, eof) < 0)
+    if (netconf_input_packet(h, xreq, cbuf_get(cb), len, yspec, eof) < 0)
         goto done;
  ok:
     retval = 0;
  done:
-    if (str)
-        free(str);
     if (xtop)
         xml_free(xtop);
     if (xret)
@@ -505,6 +675,59 @@ netconf_input_frame(clicon_handle h,
     return retval;
 }
 
+/*! Frame a block of input with end-of-message framing ]]>]]>, RFC6242 Sec 4.3
+ *
+ * Text is appended to the message buffer in blocks, not character by character.
+ * The trailer is removed at end-of-frame. Null characters are skipped (eg from terminals)
+ * @param[in]     buf    Input block
+ * @param[in]     len    Length of buf
+ * @param[in,out] state  Trailer detection state, see detect_endtag
+ * @param[in]     cb     Message buffer, text is appended
+ * @param[out]    np     Number of characters of buf consumed
+ * @retval        1      End-of-frame, message in cb, rest of buf is not consumed
+ * @retval        0      All of buf consumed, no end-of-frame
+ * @retval       -1      Error
+ * @see netconf_input_chunked_buf  for chunked framing
+ */
+static int
+netconf_input_eom_buf(char   *buf,
+                      size_t  len,
+                      int    *state,
+                      cbuf   *cb,
+                      size_t *np)
+{
+    int    retval = -1;
+    size_t i;
+    size_t start = 0;
+    int    eom = 0;
+
+    for (i=0; i<len && !eom; i++){
+        if (buf[i] == '\0'){
+            if (i > start && cbuf_append_buf(cb, buf + start, i - start) < 0){
+                clicon_err(OE_UNIX, errno, "cbuf_append_buf");
+                goto done;
+            }
+            start = i + 1;
+            continue;
+        }
+        if (detect_endtag("]]>]]>", buf[i], state)){
+            *state = 0;
+            eom++;
+        }
+    }
+    if (i > start && cbuf_append_buf(cb, buf + start, i - start) < 0){
+        clicon_err(OE_UNIX, errno, "cbuf_append_buf");
+        goto done;
+    }
+    /* Remove trailer, may have been appended in an earlier block */
+    if (eom && cbuf_trunc(cb, cbuf_len(cb) - strlen("]]>]]>")) < 0)
+        goto done;
+    *np = i;
+    retval = eom;
+ done:
+    return retval;
+}
+
 /*! Get netconf message: detect end-of-msg 
  * @param[in]   s    Socket where input arrived. read from this.
  * @param[in]   arg  Clixon handle.
@@ -521,15 +744,16 @@ netconf_input_cb(int   s,
                  void *arg)
 {
     int            retval = -1;
-    unsigned char  buf[BUFSIZ]; /* from stdio.h, typically 8K */
+    char           buf[BUFSIZ]; /* from stdio.h, typically 8K */
+    char          *p;
     clicon_handle  h = arg;
     cbuf          *cb=NULL;
     void          *ptr;
     size_t         cdatlen = 0;
     clicon_hash_t *cdat = clicon_data(h); /* Save cbuf between calls if not done */
     int            poll;
-    int            i;
-    int            len;
+    ssize_t        len;
+    size_t         n;
     int            frame_state;
     size_t         frame_size;
     int            ret;
@@ -562,7 +786,6 @@ netconf_input_cb(int   s,
             goto done;
         }
     }
-    memset(buf, 0, sizeof(buf));
     while (1){
         if ((len = read(s, buf, sizeof(buf))) < 0){
             if (errno == ECONNRESET)
@@ -579,46 +802,28 @@ netconf_input_cb(int   s,
             clixon_exit_set(1);     
             goto ok;
         }
-        for (i=0; i<len; i++){
-            if (buf[i] == 0)
-                continue; /* Skip NULL chars (eg from terminals) */
+        /* Frame the block, the framing may change after a hello message within the block */
+        p = buf;
+        while (len > 0){
             if (clicon_data_int_get(h, "netconf-framing") == NETCONF_SSH_CHUNKED){
                 /* Track chunked framing defined in RFC6242 */
-                if ((ret = netconf_input_chunked_framing(buf[i], &frame_state, &frame_size)) < 0)
+                if ((ret = netconf_input_chunked_buf(p, len, &frame_state, &frame_size, cb, &n)) < 0)
                     goto done;
-                switch (ret){
-                case 1: /* chunk-data */
-                    cprintf(cb, "%c", buf[i]);
-                    break;
-                case 2: /* end-of-data */
-                    /* Somewhat complex error-handling:
-                     * Ignore packet errors, UNLESS an explicit termination request (eof)
-                     */
-                    if (netconf_input_frame(h, cb, &eof) < 0 &&
-                        !ignore_packet_errors) 
-                        goto done; 
-                    if (eof)
-                        goto done;
-                    cbuf_reset(cb);
-                    break;
-                default:
-                    break;
-                }
             }
-            else{
-                cprintf(cb, "%c", buf[i]);
-                if (detect_endtag("]]>]]>", buf[i], &frame_state)){
-                    frame_state = 0;
-                    /* OK, we have an xml string from a client */
-                    /* Remove trailer */
-                    *(((char*)cbuf_get(cb)) + cbuf_len(cb) - strlen("]]>]]>")) = '\0';
-                    if (netconf_input_frame(h, cb, &eof) < 0 &&
-                        !ignore_packet_errors) // default is to ignore errors
-                        goto done; 
-                    if (eof)
-                        goto done;
-                    cbuf_reset(cb);
-                }
+            else if ((ret = netconf_input_eom_buf(p, len, &frame_state, cb, &n)) < 0)
+                goto done;
+            p += n;
+            len -= n;
+            if (ret == 1){ /* end-of-data */
+                /* Somewhat complex error-handling:
+                 * Ignore packet errors, UNLESS an explicit termination request (eof)
+                 */
+                if (netconf_input_frame(h, cb, &eof) < 0 &&
+                    !ignore_packet_errors) // default is to ignore errors
+                    goto done; 
+                if (eof)
+                    goto done;
+                cbuf_reset(cb);
             }
         }
         /* poll==1 if more, poll==0 if none */
@@ -952,6 +1157,9 @@ main(int    argc,
         clixon_plugins_load(h, CLIXON_PLUGIN_INIT, dir, NULL) < 0)
         goto done;
     
+    /* Load all yang modules from yang cache if enabled and valid, then parsing is skipped */
+    if (yang_spec_cache_load(h, "netconf", yspec) < 0)
+        goto done;
     /* Load Yang modules
      * 1. Load a yang module as a specific absolute filename */
     if ((str = clicon_yang_main_file(h)) != NULL){
@@ -978,6 +1186,9 @@ main(int    argc,
     /* Add netconf yang spec, used by netconf client and as internal protocol */
     if (netconf_module_load(h) < 0)
         goto done;
+    /* Write yang cache if enabled and not loaded from it */
+    if (yang_spec_cache_done(h, "netconf", yspec) < 0)
+        goto done;
     /* Here all modules are loaded 
      * Compute and set canonical namespace context
      */
@@ -998,6 +1209,13 @@ main(int    argc,
     if (clicon_hello_req(h, "cl:netconf", NULL, &id) < 0)
         goto done;
     clicon_session_id_set(h, id);
+    /* Pipelined requests use the same backend session, so that locks apply */
+    if (clicon_option_int(h, "CLICON_NETCONF_PIPELINE") > 0){
+        if (clicon_rpc_async_shared_set(h, 1) < 0)
+            goto done;
+        if (clicon_rpc_async_window_set(h, clicon_option_int(h, "CLICON_NETCONF_PIPELINE")) < 0)
+            goto done;
+    }
     
     /* Send hello to northbound client 
      * Note that this is a violation of RDFC 6241 Sec 8.1:
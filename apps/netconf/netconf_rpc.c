@@ -306,6 +306,8 @@ CLIXON addition:
  *
  * @param[in]  h       clicon handle
  * @param[in]  xn      Sub-tree (under xorig) at <rpc>...</rpc> level.
+ * @param[in]  raw     Text of <rpc> to forward as is, or NULL
+ * @param[in]  rawlen  Length of raw
  * @param[out] xret    Return XML, error or OK
  * @retval     0       OK, xret points to valid return, either ok or rpc-error
  * @retval    -1       Error
@@ -318,6 +320,8 @@ CLIXON addition:
 static int
 netconf_edit_config(clicon_handle h,
                     cxobj        *xn, 
+                    char         *raw,
+                    size_t        rawlen,
                     cxobj       **xret)
 {
     int                 retval = -1;
@@ -343,7 +347,7 @@ netconf_edit_config(clicon_handle h,
                             NETCONF_BASE_NAMESPACE);
         goto ok;
     }
-    if (clicon_rpc_netconf_xml(h, xml_parent(xn), xret, NULL) < 0)
+    if (clicon_rpc_netconf_raw(h, xml_parent(xn), raw, rawlen, xret) < 0)
         goto done;
  ok:
     retval = 0;
@@ -683,14 +687,19 @@ netconf_application_rpc(clicon_handle h,
  * error.
  * @param[in]  h       clicon handle
  * @param[in]  xn      Sub-tree (under xorig) at <rpc>...</rpc> level.
+ * @param[in]  raw     Text of xn to forward to backend as is, or NULL to serialize xn
+ * @param[in]  rawlen  Length of raw
  * @param[out] xret    Return XML, error or OK
  * @param[out] eof     Set to 1 if pending close socket
  * @retval     0       OK, can also be netconf error 
  * @retval    -1       Error, fatal
+ * @note raw must be the unmodified text of xn and not have a username attribute
  */
 int
 netconf_rpc_dispatch(clicon_handle h,
                      cxobj        *xn, 
+                     char         *raw,
+                     size_t        rawlen,
                      cxobj       **xret,
                      int          *eof)
 {
@@ -725,7 +734,7 @@ netconf_rpc_dispatch(clicon_handle h,
             strcmp(xml_name(xe), "discard-changes") == 0 ||
             strcmp(xml_name(xe), "action") == 0
             ){
-            if (clicon_rpc_netconf_xml(h, xml_parent(xe), xret, NULL) < 0)
+            if (clicon_rpc_netconf_raw(h, xml_parent(xe), raw, rawlen, xret) < 0)
                 goto done;      
         }
         else if (strcmp(xml_name(xe), "get-config") == 0){
@@ -733,7 +742,7 @@ netconf_rpc_dispatch(clicon_handle h,
                 goto done;
         }
         else if (strcmp(xml_name(xe), "edit-config") == 0){
-            if (netconf_edit_config(h, xe, xret) < 0)
+            if (netconf_edit_config(h, xe, raw, rawlen, xret) < 0)
                 goto done;
         }
         else if (strcmp(xml_name(xe), "get") == 0){
@@ -742,7 +751,7 @@ netconf_rpc_dispatch(clicon_handle h,
         }
         else if (strcmp(xml_name(xe), "close-session") == 0){
             *eof = 1; /* Pending close */
-            if (clicon_rpc_netconf_xml(h, xml_parent(xe), xret, NULL) < 0)
+            if (clicon_rpc_netconf_raw(h, xml_parent(xe), raw, rawlen, xret) < 0)
                 goto done;      
         }
         /* RFC 5277 :notification */
@@ -45,6 +45,8 @@
 int 
 netconf_rpc_dispatch(clicon_handle h,
                      cxobj        *xn, 
+                     char         *raw,
+                     size_t        rawlen,
                      cxobj       **xret,
                      int          *eof);
 
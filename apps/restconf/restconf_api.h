@@ -48,4 +48,8 @@ int restconf_reply_send(void *req, int code, cbuf *cb, int head);
 
 cbuf *restconf_get_indata(void *req);
 
+int restconf_reply_async(void *req);
+int restconf_reply_defer(void *req, uint32_t id);
+int restconf_reply_resume(void *req);
+
 #endif /* _RESTCONF_API_H_ */
@@ -240,3 +240,37 @@ restconf_get_indata(void *req0)
         cprintf(cb, "%c", c);
     return cb;
 }
+
+/*! Check if the reply of a request can be deferred until an asynchronous backend reply
+ * @param[in]  req   Fastcgi request handle
+ * @retval     0     No, fastcgi requests are handled synchronously
+ */
+int
+restconf_reply_async(void *req0)
+{
+    return 0;
+}
+
+/*! Defer reply of request, not supported in fastcgi
+ * @param[in]  req   Fastcgi request handle
+ * @param[in]  id    Message-id of outstanding backend request
+ * @retval    -1     Error
+ */
+int
+restconf_reply_defer(void    *req0,
+                     uint32_t id)
+{
+    clicon_err(OE_RESTCONF, ENOTSUP, "Deferred reply not supported in fcgi");
+    return -1;
+}
+
+/*! Resume deferred reply, not supported in fastcgi
+ * @param[in]  req   Fastcgi request handle
+ * @retval    -1     Error
+ */
+int
+restconf_reply_resume(void *req0)
+{
+    clicon_err(OE_RESTCONF, ENOTSUP, "Deferred reply not supported in fcgi");
+    return -1;
+}
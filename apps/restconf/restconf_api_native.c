@@ -63,6 +63,9 @@
 #include "restconf_lib.h"
 #include "restconf_api.h"  /* Virtual api */
 #include "restconf_native.h"
+#ifdef HAVE_LIBNGHTTP2
+#include "restconf_nghttp2.h"
+#endif
 
 /*! Add HTTP header field name and value to reply
  * @param[in]  req   request handle
@@ -185,3 +188,75 @@ restconf_get_indata(void *req0)
     return cb;
 }
 
+
+/*! Check if the reply of a request can be deferred until an asynchronous backend reply
+ *
+ * Only http/2 streams are deferred since other streams of the connection may proceed.
+ * @param[in]  req   Request handle
+ * @retval     1     Yes, use restconf_reply_defer and restconf_reply_resume
+ * @retval     0     No, handle request synchronously
+ */
+int
+restconf_reply_async(void *req0)
+{
+#ifdef HAVE_LIBNGHTTP2
+    restconf_stream_data *sd = (restconf_stream_data *)req0;
+
+    if (sd && sd->sd_conn &&
+        sd->sd_conn->rc_proto == HTTP_2 &&
+        sd->sd_upgrade2 == 0)
+        return 1;
+#endif
+    return 0;
+}
+
+/*! Defer reply of request until an outstanding backend request has completed
+ *
+ * @param[in]  req   Request handle
+ * @param[in]  id    Message-id of outstanding backend request
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see restconf_reply_resume
+ */
+int
+restconf_reply_defer(void    *req0,
+                     uint32_t id)
+{
+    restconf_stream_data *sd = (restconf_stream_data *)req0;
+
+    if (sd == NULL || id == 0){
+        clicon_err(OE_CFG, EINVAL, "sd is NULL or id is 0");
+        return -1;
+    }
+    sd->sd_async_id = id;
+    return 0;
+}
+
+/*! Send deferred reply of request
+ *
+ * Reply code, headers and body have been set by restconf_reply_header / restconf_reply_send
+ * @param[in]  req   Request handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @note the request may be freed on return
+ * @see restconf_reply_defer
+ */
+int
+restconf_reply_resume(void *req0)
+{
+    int                   retval = -1;
+    restconf_stream_data *sd = (restconf_stream_data *)req0;
+
+    if (sd == NULL){
+        clicon_err(OE_CFG, EINVAL, "sd is NULL");
+        goto done;
+    }
+    sd->sd_async_id = 0;
+#ifdef HAVE_LIBNGHTTP2
+    if (http2_reply_resume(sd) < 0)
+        goto done;
+#endif
+    retval = 0;
+ done:
+    return retval;
+}
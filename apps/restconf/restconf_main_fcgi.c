@@ -473,6 +473,9 @@ main(int    argc,
         goto done;
     clixon_plugin_api_get(cp)->ca_extension = restconf_main_extension_cb;
 
+    /* Load all yang modules from yang cache if enabled and valid, then parsing is skipped */
+    if (yang_spec_cache_load(h, "restconf", yspec) < 0)
+        goto done;
     /* Load Yang modules
      * 1. Load a yang module as a specific absolute filename */
     if ((str = clicon_yang_main_file(h)) != NULL){
@@ -520,6 +523,9 @@ main(int    argc,
         yang_spec_parse_module(h, "clixon-rfc5277", NULL, yspec)< 0)
         goto done;
 
+    /* Write yang cache if enabled and not loaded from it */
+    if (yang_spec_cache_done(h, "restconf", yspec) < 0)
+        goto done;
     /* Here all modules are loaded 
      * Compute and set canonical namespace context
      */
@@ -119,6 +119,7 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <string.h>
 #include <syslog.h>
 #include <pwd.h>
@@ -126,6 +127,7 @@
 #include <assert.h>
 #include <signal.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <sys/resource.h>
@@ -179,6 +181,12 @@
 
 static int             session_id_context = 1;
 
+/* Worker processes, only used by supervisor process if workers > 1
+ * @see restconf_workers_run
+ */
+static pid_t          *_worker_pids = NULL;
+static int             _worker_nr = 0;
+
 /*! Set restconf native handle
  *
  * @param[in]  h     Clicon handle
@@ -553,9 +561,23 @@ restconf_accept_client(int   fd,
     h = rsock->rs_h;
     len = sizeof(from);
     if ((s = accept(rsock->rs_ss, &from, &len)) < 0){
+        /* Listening socket is non-blocking and may be shared with other workers
+         * which may have accepted the connection already */
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED){
+            clicon_debug(1, "%s accept: %s", __FUNCTION__, strerror(errno));
+            retval = 0;
+            goto done;
+        }
         clicon_err(OE_UNIX, errno, "accept");
         goto done;
     }
+    /* Accepted socket does not inherit O_NONBLOCK on Linux. Writes must not block on a
+     * client that does not read, see restconf_conn_write */
+    if (fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) < 0){
+        clicon_err(OE_UNIX, errno, "fcntl");
+        close(s);
+        goto done;
+    }
     switch (from.sa_family){
     case AF_INET:{
         struct sockaddr_in *in = (struct sockaddr_in *)&from;
@@ -608,6 +630,7 @@ restconf_native_terminate(clicon_handle h)
     restconf_conn          *rc;
 
     clicon_debug(1, "%s", __FUNCTION__);
+    clicon_rpc_async_close(h);
     if ((rn = restconf_native_handle_get(h)) != NULL){
         while ((rsock = rn->rn_sockets) != NULL){
             while ((rc = rsock->rs_conns) != NULL){
@@ -972,6 +995,9 @@ restconf_clixon_init(clicon_handle h,
         goto done;
     clixon_plugin_api_get(cp)->ca_extension = restconf_main_extension_cb;
 
+    /* Load all yang modules from yang cache if enabled and valid, then parsing is skipped */
+    if (yang_spec_cache_load(h, "restconf", yspec) < 0)
+        goto done;
     /* Load Yang modules
      * 1. Load a yang module as a specific absolute filename */
     if ((str = clicon_yang_main_file(h)) != NULL){
@@ -1017,6 +1043,9 @@ restconf_clixon_init(clicon_handle h,
         yang_spec_parse_module(h, "clixon-rfc5277", NULL, yspec)< 0)
         goto done;
 
+    /* Write yang cache if enabled and not loaded from it */
+    if (yang_spec_cache_done(h, "restconf", yspec) < 0)
+        goto done;
     /* Here all modules are loaded 
      * Compute and set canonical namespace context
      */
@@ -1101,6 +1130,152 @@ restconf_sig_term(int arg)
     clixon_exit_set(1); 
 }
 
+/*! Signal terminates supervisor process, forward it to all workers
+ *
+ * Set exit flag and let workers terminate; supervisor exits when all workers are reaped
+ * @see restconf_workers_run
+ */
+static void
+restconf_sig_term_supervisor(int arg)
+{
+    int i;
+
+    clixon_exit_set(1); 
+    for (i=0; i<_worker_nr; i++)
+        if (_worker_pids[i] > 0)
+            kill(_worker_pids[i], SIGTERM);
+}
+
+/*! Prepare a newly forked worker process
+ *
+ * Close inherited backend socket and session so that each worker opens its own backend 
+ * session. Only the first worker serves call-home sockets.
+ * @param[in]  h      Clicon handle
+ * @param[in]  i      Worker index, 0 is first
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+restconf_worker_init(clicon_handle h,
+                     int           i)
+{
+    int                     retval = -1;
+    restconf_native_handle *rn;
+    restconf_socket        *rsock;
+    int                     s;
+
+    if (set_signal(SIGTERM, restconf_sig_term, NULL) < 0 ||
+        set_signal(SIGINT, restconf_sig_term, NULL) < 0){
+        clicon_err(OE_DAEMON, errno, "Setting signal");
+        goto done;
+    }
+    if ((s = clicon_client_socket_get(h)) >= 0){
+        close(s);
+        clicon_client_socket_set(h, -1);
+    }
+    clicon_session_id_del(h);
+    if (i > 0 && (rn = restconf_native_handle_get(h)) != NULL){
+        if ((rsock = rn->rn_sockets) != NULL)
+            do {
+                if (rsock->rs_callhome)
+                    restconf_callhome_timer_unreg(rsock);
+                rsock = NEXTQ(restconf_socket *, rsock);
+            } while (rsock && rsock != rn->rn_sockets);
+    }
+    clicon_log(LOG_NOTICE, "%s native worker %d %u Started", __PROGRAM__, i, getpid());
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Fork worker processes sharing the listening sockets and supervise them
+ *
+ * The kernel distributes incoming connections between the workers, each running its own
+ * event loop. The calling process becomes a supervisor which restarts workers that
+ * terminate and forwards termination signals to the workers.
+ * @param[in]  h      Clicon handle
+ * @param[in]  nr     Number of workers
+ * @retval     1      Worker process: continue to event loop
+ * @retval     0      Supervisor process: all workers terminated
+ * @retval    -1      Error
+ */
+static int
+restconf_workers_run(clicon_handle h,
+                     int           nr)
+{
+    int    retval = -1;
+    pid_t  pid;
+    int    status;
+    int    i;
+
+    if ((_worker_pids = calloc(nr, sizeof(pid_t))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    _worker_nr = nr;
+    /* Without SA_RESTART so that waitpid is interrupted */
+    if (set_signal_flags(SIGTERM, 0, restconf_sig_term_supervisor, NULL) < 0 ||
+        set_signal_flags(SIGINT, 0, restconf_sig_term_supervisor, NULL) < 0){
+        clicon_err(OE_DAEMON, errno, "Setting signal");
+        goto done;
+    }
+    i = 0;
+    while (!clixon_exit_get()){
+        if (i < nr){ /* Start (or restart) worker i */
+            if ((pid = fork()) < 0){
+                clicon_err(OE_UNIX, errno, "fork");
+                goto done;
+            }
+            if (pid == 0){ /* worker */
+                free(_worker_pids);
+                _worker_pids = NULL;
+                _worker_nr = 0;
+                if (restconf_worker_init(h, i) < 0)
+                    goto done;
+                retval = 1;
+                goto done;
+            }
+            _worker_pids[i] = pid;
+            for (i=0; i<nr; i++) /* Next worker slot to start */
+                if (_worker_pids[i] == 0)
+                    break;
+            continue;
+        }
+        if ((pid = waitpid(-1, &status, 0)) < 0){
+            if (errno == EINTR)
+                continue;
+            clicon_err(OE_UNIX, errno, "waitpid");
+            goto done;
+        }
+        for (i=0; i<nr; i++)
+            if (_worker_pids[i] == pid)
+                break;
+        if (i == nr)
+            continue;
+        _worker_pids[i] = 0;
+        if (clixon_exit_get())
+            break;
+        clicon_log(LOG_WARNING, "%s worker %d pid %u terminated (status %d), restarting",
+                   __FUNCTION__, i, pid, status);
+        sleep(1); /* Avoid busy restart if worker fails immediately */
+    }
+    /* Terminate: reap remaining workers */
+    for (i=0; i<nr; i++){
+        if (_worker_pids[i] > 0){
+            kill(_worker_pids[i], SIGTERM);
+            if (waitpid(_worker_pids[i], &status, 0) < 0 && errno != ECHILD)
+                clicon_debug(1, "%s waitpid: %s", __FUNCTION__, strerror(errno));
+            _worker_pids[i] = 0;
+        }
+    }
+    _worker_nr = 0;
+    free(_worker_pids);
+    _worker_pids = NULL;
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Usage help routine
  *
  * @param[in]  argv0  command line
@@ -1145,6 +1320,10 @@ main(int    argc,
     int             ret;
     cxobj          *xrestconf = NULL;
     char           *inline_config = NULL;
+    cxobj          *x;
+    char           *bstr;
+    int             workers;
+    cvec           *nsc = NULL;
 
     /* In the startup, logs to stderr & debug flag set later */
     clicon_log_init(__PROGRAM__, LOG_INFO, logdst);
@@ -1324,12 +1503,27 @@ main(int    argc,
      */
     clicon_data_set(h, "session-transport", "cl:restconf");
 
+    /* Multi-process mode: fork workers sharing the listening sockets */
+    if ((nsc = xml_nsctx_init(NULL, CLIXON_RESTCONF_NS)) == NULL)
+        goto done;
+    if ((x = xpath_first(xrestconf, nsc, "workers")) != NULL &&
+        (bstr = xml_body(x)) != NULL &&
+        (workers = atoi(bstr)) > 1){
+        if ((ret = restconf_workers_run(h, workers)) < 0)
+            goto done;
+        if (ret == 0){ /* supervisor: all workers terminated */
+            retval = 0;
+            goto done;
+        }
+    }
     /* Main event loop */ 
     if (clixon_event_loop(h) < 0)
         goto done;
     retval = 0;
  done:
     clicon_debug(1, "restconf_main_openssl done");
+    if (nsc)
+        cvec_free(nsc);
     if (xrestconf)
         xml_free(xrestconf);
     restconf_native_terminate(h);
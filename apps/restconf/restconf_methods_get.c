@@ -66,6 +66,206 @@
 /* Forward */
 static int api_data_pagination(clicon_handle h, void *req, char *api_path, int pi, cvec *qvec, int pretty, restconf_media media_out);
 
+/*! Generate GET reply from backend get reply
+ *
+ * @param[in]  h         Clixon handle
+ * @param[in]  req       Generic Www handle
+ * @param[in]  xret      Reply from backend, <data> or <rpc-error>
+ * @param[in]  xpath     XPath of request
+ * @param[in]  nsc       Namespace context of xpath
+ * @param[in]  pretty    Set to 1 for pretty-printed xml/json output
+ * @param[in]  media_out Output media
+ * @param[in]  head      If 1 is HEAD, otherwise GET
+ * @retval     0         OK
+ * @retval    -1         Error
+ * @see api_data_get2
+ */
+static int
+api_data_get_reply(clicon_handle  h,
+                   void          *req,
+                   cxobj         *xret,
+                   char          *xpath,
+                   cvec          *nsc,
+                   int            pretty,
+                   restconf_media media_out,
+                   int            head)
+{
+    int        retval = -1;
+    cbuf      *cbx = NULL;
+    cxobj     *xerr = NULL; /* malloced */
+    cxobj     *xe = NULL;   /* not malloced */
+    cxobj    **xvec = NULL;
+    size_t     xlen;
+    int        i;
+    cxobj     *x;
+    cvec      *nscd = NULL;
+
+    /* We get return via netconf which is complete tree from root 
+     * We need to cut that tree to only the object.
+     */
+#if 0 /* DEBUG */
+    if (clicon_debug_get())
+        clicon_debug_xml(1, xret, "%s xret:", __FUNCTION__);
+#endif
+    /* Check if error return  */
+    if ((xe = xpath_first(xret, NULL, "//rpc-error")) != NULL){
+        if (api_return_err(h, req, xe, pretty, media_out, 0) < 0)
+            goto done;
+        goto ok;
+    }
+    /* Normal return, no error */
+    if ((cbx = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (xpath==NULL || strcmp(xpath,"/")==0){ /* Special case: data root */
+        switch (media_out){
+        case YANG_DATA_XML:
+            if (clixon_xml2cbuf(cbx, xret, 0, pretty, -1, 0) < 0) /* Dont print top object?  */
+                goto done;
+            break;
+        case YANG_DATA_JSON:
+            if (clixon_json2cbuf(cbx, xret, pretty, 0, 0) < 0)
+                goto done;
+            break;
+        default:
+            break;
+        }
+    }
+    else{
+        if (xpath_vec(xret, nsc, "%s", &xvec, &xlen, xpath) < 0){
+            if (netconf_operation_failed_xml(&xerr, "application", clicon_err_reason) < 0)
+                goto done;
+            if (api_return_err0(h, req, xerr, pretty, media_out, 0) < 0)
+                goto done;
+            goto ok;
+        }
+        /* Check if not exists */
+        if (xlen == 0){
+            /* 4.3: If a retrieval request for a data resource represents an 
+               instance that does not exist, then an error response containing 
+               a "404 Not Found" status-line MUST be returned by the server.  
+               The error-tag value "invalid-value" is used in this case. */
+            if (netconf_invalid_value_xml(&xerr, "application", "Instance does not exist") < 0)
+                goto done;
+            /* override invalid-value default 400 with 404 */
+            if (api_return_err0(h, req, xerr, pretty, media_out, 404) < 0)
+                goto done;
+            goto ok;
+        }
+        switch (media_out){
+        case YANG_DATA_XML:
+            for (i=0; i<xlen; i++){
+                x = xvec[i];
+                if (xml_nsctx_node(x, &nscd) < 0)
+                    goto done;
+                if (xmlns_set_all(x, nscd) < 0)
+                    goto done;
+                if (nscd){
+                    cvec_free(nscd);
+                    nscd = NULL;
+                }
+                if (clixon_xml2cbuf(cbx, x, 0, pretty, -1, 0) < 0) /* Dont print top object?  */
+                    goto done;
+            }
+            break;
+        case YANG_DATA_JSON:
+            /* In: <x xmlns="urn:example:clixon">0</x>
+             * Out: {"example:x": {"0"}}
+             */
+            if (xml2json_cbuf_vec(cbx, xvec, xlen, pretty, 0) < 0)
+                goto done;
+            break;
+        default:
+            break;
+        }
+    }
+    clicon_debug(1, "%s cbuf:%s", __FUNCTION__, cbuf_get(cbx));
+    if (restconf_reply_header(req, "Content-Type", "%s", restconf_media_int2str(media_out)) < 0)
+        goto done;
+    if (restconf_reply_header(req, "Cache-Control", "no-cache") < 0)
+        goto done;
+    if (restconf_reply_send(req, 200, cbx, head) < 0)
+        goto done;
+    cbx = NULL;
+ ok:
+    retval = 0;
+ done:
+    if (nscd)
+        cvec_free(nscd);
+    if (cbx)
+        cbuf_free(cbx);
+    if (xerr)
+        xml_free(xerr);
+    if (xvec)
+        free(xvec);
+    return retval;
+}
+
+/* State of a GET request waiting for an asynchronous backend reply
+ * @see api_data_get_async_cb
+ */
+typedef struct {
+    void          *ga_req;       /* Generic Www handle */
+    char          *ga_xpath;     /* XPath of request */
+    cvec          *ga_nsc;       /* Namespace context of xpath */
+    int            ga_pretty;    /* Pretty-print */
+    restconf_media ga_media_out; /* Output media */
+    int            ga_head;      /* HEAD, not GET */
+} api_get_async;
+
+/*! Free GET async state
+ */
+static int
+api_get_async_free(api_get_async *ga)
+{
+    if (ga->ga_xpath)
+        free(ga->ga_xpath);
+    if (ga->ga_nsc)
+        xml_nsctx_free(ga->ga_nsc);
+    free(ga);
+    return 0;
+}
+
+/*! Asynchronous backend get reply has arrived, send the deferred reply
+ *
+ * @param[in]  h     Clixon handle
+ * @param[in]  xret  Reply from backend, <data> or <rpc-error>, or NULL if cancelled
+ * @param[in]  arg   GET async state
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see clicon_rpc_get_async
+ */
+static int
+api_data_get_async_cb(clicon_handle h,
+                      cxobj        *xret,
+                      void         *arg)
+{
+    int            retval = -1;
+    api_get_async *ga = (api_get_async *)arg;
+    cxobj         *xerr = NULL;
+
+    clicon_debug(1, "%s", __FUNCTION__);
+    if (xret == NULL) /* Cancelled, eg stream closed */
+        goto ok;
+    if (api_data_get_reply(h, ga->ga_req, xret, ga->ga_xpath, ga->ga_nsc,
+                           ga->ga_pretty, ga->ga_media_out, ga->ga_head) < 0){
+        if (netconf_operation_failed_xml(&xerr, "application", clicon_err_reason) < 0)
+            goto done;
+        if (api_return_err0(h, ga->ga_req, xerr, ga->ga_pretty, ga->ga_media_out, 0) < 0)
+            goto done;
+    }
+    if (restconf_reply_resume(ga->ga_req) < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    if (xerr)
+        xml_free(xerr);
+    api_get_async_free(ga);
+    return retval;
+}
+
 /*! Generic GET (both HEAD and GET)
  * According to restconf 
  * @param[in]  h        Clixon handle
@@ -106,15 +306,10 @@ api_data_get2(clicon_handle  h,
 {
     int        retval = -1;
     char      *xpath = NULL;
-    cbuf      *cbx = NULL;
     yang_stmt *yspec;
     cxobj     *xret = NULL;
     cxobj     *xerr = NULL; /* malloced */
-    cxobj     *xe = NULL;   /* not malloced */
-    cxobj    **xvec = NULL;
-    size_t     xlen;
     int        i;
-    cxobj     *x;
     int        ret;
     cvec      *nsc = NULL;
     char      *attr; /* attribute value string */
@@ -124,7 +319,8 @@ api_data_get2(clicon_handle  h,
     cxobj     *xbot = NULL;
     yang_stmt *y = NULL;
     char      *defaults = NULL;
-    cvec      *nscd = NULL;
+    api_get_async *ga = NULL;
+    uint32_t   id = 0;
     
     clicon_debug(1, "%s", __FUNCTION__);
     if ((yspec = clicon_dbspec_yang(h)) == NULL){
@@ -158,7 +354,8 @@ api_data_get2(clicon_handle  h,
             (yang_keyword_get(y) == Y_LIST || yang_keyword_get(y) == Y_LEAF_LIST) &&
             (cvec_find(qvec, "where")     || cvec_find(qvec, "sort-by") ||
              cvec_find(qvec, "direction") || cvec_find(qvec, "offset") ||
-             cvec_find(qvec, "limit")     || cvec_find(qvec, "sublist-limit"))){
+             cvec_find(qvec, "limit")     || cvec_find(qvec, "sublist-limit") ||
+             cvec_find(qvec, "cursor")    || cvec_find(qvec, "count"))){
             if (api_data_pagination(h, req, api_path, 0, qvec, pretty, media_out) < 0)
                 goto done;
             goto ok;
@@ -201,123 +398,60 @@ api_data_get2(clicon_handle  h,
     }
 
     clicon_debug(1, "%s path:%s", __FUNCTION__, xpath);
-    ret = clicon_rpc_get(h, xpath, nsc, content, depth, defaults, &xret);
-
-    if (ret < 0){
-        if (netconf_operation_failed_xml(&xerr, "protocol", clicon_err_reason) < 0)
-            goto done;
-        if (api_return_err0(h, req, xerr, pretty, media_out, 0) < 0)
-            goto done;
-        goto ok;
-    }
-    /* We get return via netconf which is complete tree from root 
-     * We need to cut that tree to only the object.
-     */
-#if 0 /* DEBUG */
-    if (clicon_debug_get())
-        clicon_debug_xml(1, xret, "%s xret:", __FUNCTION__);
-#endif
-    /* Check if error return  */
-    if ((xe = xpath_first(xret, NULL, "//rpc-error")) != NULL){
-        if (api_return_err(h, req, xe, pretty, media_out, 0) < 0)
+    if (restconf_reply_async(req)){
+        /* Send request asynchronously and defer reply until backend replies */
+        if ((ga = malloc(sizeof(*ga))) == NULL){
+            clicon_err(OE_UNIX, errno, "malloc");
             goto done;
-        goto ok;
-    }
-    /* Normal return, no error */
-    if ((cbx = cbuf_new()) == NULL){
-        clicon_err(OE_UNIX, errno, "cbuf_new");
-        goto done;
-    }
-    if (xpath==NULL || strcmp(xpath,"/")==0){ /* Special case: data root */
-        switch (media_out){
-        case YANG_DATA_XML:
-            if (clixon_xml2cbuf(cbx, xret, 0, pretty, -1, 0) < 0) /* Dont print top object?  */
-                goto done;
-            break;
-        case YANG_DATA_JSON:
-            if (clixon_json2cbuf(cbx, xret, pretty, 0, 0) < 0)
-                goto done;
-            break;
-        default:
-            break;
         }
-    }
-    else{
-        if (xpath_vec(xret, nsc, "%s", &xvec, &xlen, xpath) < 0){
-            if (netconf_operation_failed_xml(&xerr, "application", clicon_err_reason) < 0)
+        memset(ga, 0, sizeof(*ga));
+        ga->ga_req = req;
+        ga->ga_pretty = pretty;
+        ga->ga_media_out = media_out;
+        ga->ga_head = head;
+        if (clicon_rpc_get_async(h, xpath, nsc, content, depth, defaults,
+                                 api_data_get_async_cb, ga, &id) < 0){
+            api_get_async_free(ga);
+            ga = NULL;
+            if (netconf_operation_failed_xml(&xerr, "protocol", clicon_err_reason) < 0)
                 goto done;
             if (api_return_err0(h, req, xerr, pretty, media_out, 0) < 0)
                 goto done;
             goto ok;
         }
-        /* Check if not exists */
-        if (xlen == 0){
-            /* 4.3: If a retrieval request for a data resource represents an 
-               instance that does not exist, then an error response containing 
-               a "404 Not Found" status-line MUST be returned by the server.  
-               The error-tag value "invalid-value" is used in this case. */
-            if (netconf_invalid_value_xml(&xerr, "application", "Instance does not exist") < 0)
-                goto done;
-            /* override invalid-value default 400 with 404 */
-            if (api_return_err0(h, req, xerr, pretty, media_out, 404) < 0)
-                goto done;
-            goto ok;
-        }
-        switch (media_out){
-        case YANG_DATA_XML:
-            for (i=0; i<xlen; i++){
-                x = xvec[i];
-                if (xml_nsctx_node(x, &nscd) < 0)
-                    goto done;
-                if (xmlns_set_all(x, nscd) < 0)
-                    goto done;
-                if (nscd){
-                    cvec_free(nscd);
-                    nscd = NULL;
-                }
-                if (clixon_xml2cbuf(cbx, x, 0, pretty, -1, 0) < 0) /* Dont print top object?  */
-                    goto done;
-            }
-            break;
-        case YANG_DATA_JSON:
-            /* In: <x xmlns="urn:example:clixon">0</x>
-             * Out: {"example:x": {"0"}}
-             */
-            if (xml2json_cbuf_vec(cbx, xvec, xlen, pretty, 0) < 0)
-                goto done;
-            break;
-        default:
-            break;
-        }
+        /* Transfer ownership of xpath and nsc to callback */
+        ga->ga_xpath = xpath;
+        xpath = NULL;
+        ga->ga_nsc = nsc;
+        nsc = NULL;
+        if (restconf_reply_defer(req, id) < 0)
+            goto done;
+        goto ok;
     }
-    clicon_debug(1, "%s cbuf:%s", __FUNCTION__, cbuf_get(cbx));
-    if (restconf_reply_header(req, "Content-Type", "%s", restconf_media_int2str(media_out)) < 0)
-        goto done;
-    if (restconf_reply_header(req, "Cache-Control", "no-cache") < 0)
-        goto done;
-    if (restconf_reply_send(req, 200, cbx, head) < 0)
+    ret = clicon_rpc_get(h, xpath, nsc, content, depth, defaults, &xret);
+    if (ret < 0){
+        if (netconf_operation_failed_xml(&xerr, "protocol", clicon_err_reason) < 0)
+            goto done;
+        if (api_return_err0(h, req, xerr, pretty, media_out, 0) < 0)
+            goto done;
+        goto ok;
+    }
+    if (api_data_get_reply(h, req, xret, xpath, nsc, pretty, media_out, head) < 0)
         goto done;
-    cbx = NULL;
  ok:
     retval = 0;
  done:
     clicon_debug(1, "%s retval:%d", __FUNCTION__, retval);
     if (xpath)
         free(xpath);
-    if (nscd)
-        cvec_free(nscd);
     if (nsc)
         xml_nsctx_free(nsc);
     if (xtop)
         xml_free(xtop);
-    if (cbx)
-        cbuf_free(cbx);
     if (xret)
         xml_free(xret);
     if (xerr)
         xml_free(xerr);
-    if (xvec)
-        free(xvec);
     return retval;
 }
 
@@ -374,6 +508,8 @@ api_data_pagination(clicon_handle  h,
     char      *direction;
     char      *sort;
     char      *where;
+    char      *cursor = NULL;
+    int        count = 0;
     char      *ns;
     
     clicon_debug(1, "%s", __FUNCTION__);
@@ -485,9 +621,27 @@ api_data_pagination(clicon_handle  h,
     direction = cvec_find_str(qvec, "direction");
     sort = cvec_find_str(qvec, "sort-by");
     where = cvec_find_str(qvec, "where");
+    /* Clixon extensions: keyset pagination cursor and count
+     * The cursor is percent-encoded key values, re-encode the cursor query value
+     * since it is decoded with the other query parameters */
+    if ((attr = cvec_find_str(qvec, "cursor")) != NULL &&
+        uri_percent_encode(&cursor, "%s", attr) < 0)
+        goto done;
+    if ((attr = cvec_find_str(qvec, "count")) != NULL){
+        if (strcmp(attr, "true") == 0)
+            count = 1;
+        else if (strcmp(attr, "false") != 0){
+            if (netconf_bad_attribute_xml(&xerr, "application",
+                                          "count", "Unrecognized value of count attribute") < 0)
+                goto done;
+            if (api_return_err0(h, req, xerr, pretty, media_out, 0) < 0)
+                goto done;
+            goto ok;
+        }
+    }
     if (clicon_rpc_get_pageable_list(h, "running", xpath, nsc, content,
                                      depth, NULL, offset, limit, direction, sort, where, 
-                                     &xret) < 0){
+                                     cursor, count, &xret) < 0){
         if (netconf_operation_failed_xml(&xerr, "protocol", clicon_err_reason) < 0)
             goto done;
         if ((xe = xpath_first(xerr, NULL, "rpc-error")) == NULL){
@@ -556,6 +710,13 @@ api_data_pagination(clicon_handle  h,
         goto done;
     if (restconf_reply_header(req, "Cache-Control", "no-cache") < 0)
         goto done;
+    /* Clixon extensions: cursor of next page and nr of list entries */
+    if ((attr = xml_find_value(xret, "cursor")) != NULL &&
+        restconf_reply_header(req, "Clixon-Cursor", "%s", attr) < 0)
+        goto done;
+    if ((attr = xml_find_value(xret, "count")) != NULL &&
+        restconf_reply_header(req, "Clixon-Count", "%s", attr) < 0)
+        goto done;
     if (restconf_reply_send(req, 200, cbx, 0 /* XXX head */) < 0)
         goto done;
     cbx = NULL; /* is consumed by above */
@@ -563,6 +724,8 @@ api_data_pagination(clicon_handle  h,
     retval = 0;
  done:
     clicon_debug(1, "%s retval:%d", __FUNCTION__, retval);
+    if (cursor)
+        free(cursor);
     if (cbrpc)
         cbuf_free(cbrpc);
     if (xpath)
@@ -79,6 +79,7 @@
 
 /* Forward */
 static int restconf_idle_cb(int fd, void *arg);
+static int restconf_connection_write(int s, void *arg);
 
 /*!
  * @param[in]  rc       Restconf connection handle 
@@ -143,6 +144,8 @@ restconf_stream_find(restconf_conn *rc,
 int
 restconf_stream_free(restconf_stream_data *sd)
 {
+    if (sd->sd_async_id != 0 && sd->sd_conn) /* Discard reply of outstanding backend request */
+        clicon_rpc_async_cancel(sd->sd_conn->rc_h, sd->sd_async_id);
     if (sd->sd_fd != -1) {
         close(sd->sd_fd);
     }
@@ -220,6 +223,8 @@ restconf_conn_free(restconf_conn *rc)
         if (sd)
             restconf_stream_free(sd);
     }
+    if (rc->rc_outp_buf)
+        cbuf_free(rc->rc_outp_buf);
     /* Free connect from server sock */
     if ((rsock = rc->rc_socket) != NULL &&
         (rc1 = rsock->rs_conns) != NULL){
@@ -362,66 +367,57 @@ restconf_connection_sanity(clicon_handle         h,
     return retval;
 }
 
-/* Write buf to socket
- * see also this function in restcont_api_openssl.c
- * @param[in]  h        Clixon handle
+/*! Write as much as possible of a buffer to a non-blocking socket, do not block
+ *
+ * @param[in]  rc       Connection struct
  * @param[in]  buf      Buffer to write
  * @param[in]  buflen   Length of buffer
- * @param[in]  rc       Connection struct
- * @param[in]  callfn   For debug
- * @retval  1  OK
+ * @param[out] np       Number of bytes written, less than buflen if socket would block
+ * @retval  1  OK, see np
  * @retval  0  OK, but socket write returned error, caller should close rc
  * @retval -1  Error
+ * @note For SSL, a write that would block must be retried with the same data, this is
+ *       ensured by always retrying from the head of the output queue and by setting
+ *       SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER
+ * @see restconf_conn_outp_wait  to wait for socket to be writable again
  */
-static int
-native_buf_write(clicon_handle    h,
-                 char            *buf,
-                 size_t           buflen,
-                 restconf_conn   *rc,
-                 const char      *callfn)                
+int
+restconf_conn_write(restconf_conn *rc,
+                    char          *buf,
+                    size_t         buflen,
+                    size_t        *np)
 {
     int     retval = -1;
     ssize_t len;
-    ssize_t totlen = 0;
+    size_t  totlen = 0;
     int     er;
-    SSL    *ssl;
+    int     sslerr;
 
     if (rc == NULL){
         clicon_err(OE_RESTCONF, EINVAL, "rc is NULL");
         goto done;
     }
-    ssl = rc->rc_ssl;
-    /* Two problems with debugging buffers that this fixes:
-     * 1. they are not "strings" in the sense they are not NULL-terminated
-     * 2. they are often very long
-     */
-    if (clicon_debug_get()) { 
-        char *dbgstr = NULL;
-        size_t sz;
-        sz = buflen>256?256:buflen; /* Truncate to 256 */
-        if ((dbgstr = malloc(sz+1)) == NULL){
-            clicon_err(OE_UNIX, errno, "malloc");
-            goto done;
-        }
-        memcpy(dbgstr, buf, sz);
-        dbgstr[sz] = '\0';
-        clicon_debug(1, "%s %s buflen:%zu buf:\n%s", __FUNCTION__, callfn, buflen, dbgstr);
-        free(dbgstr);
-    }
     while (totlen < buflen){
-        if (ssl){
-            if ((len = SSL_write(ssl, buf+totlen, buflen-totlen)) <= 0){
+        if (rc->rc_ssl){
+            if ((len = SSL_write(rc->rc_ssl, buf+totlen, buflen-totlen)) <= 0){
                 er = errno;
-                switch (SSL_get_error(ssl, len)){
+                sslerr = SSL_get_error(rc->rc_ssl, len);
+                switch (sslerr){
+                case SSL_ERROR_WANT_WRITE:           /* 3 */
+                case SSL_ERROR_WANT_READ:            /* 2 eg renegotiation */
+                    clicon_debug(1, "%s SSL_write would block sslerr:%d", __FUNCTION__, sslerr);
+                    goto wouldblock;
+                    break;
                 case SSL_ERROR_SYSCALL:              /* 5 */
                     if (er == ECONNRESET || /* Connection reset by peer */
                         er == EPIPE) {      /* Reading end of socket is closed */
                         goto closed; /* Close socket and ssl */
                     }
                     else if (er == EAGAIN){
+                        /* Same as want_write above, but different behaviour on different 
+                         * platforms or ssl lib versions */
                         clicon_debug(1, "%s write EAGAIN", __FUNCTION__);
-                        usleep(10000);
-                        continue;
+                        goto wouldblock;
                     }
                     else{
                         clicon_err(OE_RESTCONF, er, "SSL_write %d", er);
@@ -441,7 +437,9 @@ native_buf_write(clicon_handle    h,
                 switch (errno){
                 case EAGAIN:     /* Operation would block */
                     clicon_debug(1, "%s write EAGAIN", __FUNCTION__);
-                    usleep(10000);
+                    goto wouldblock;
+                    break;
+                case EINTR:
                     continue;
                     break;
                     //          case EBADF: // XXX if this happens there is some larger error
@@ -458,6 +456,166 @@ native_buf_write(clicon_handle    h,
         }
         totlen += len;
     } /* while */
+ wouldblock:
+    *np = totlen;
+    retval = 1;
+ done:
+    return retval;
+ closed:
+    retval = 0;
+    goto done;
+}
+
+/*! Number of bytes queued for output but not yet written to socket
+ *
+ * @param[in]  rc       Connection struct
+ * @retval     n        Number of bytes in output queue
+ */
+size_t
+restconf_conn_outp_pending(restconf_conn *rc)
+{
+    if (rc->rc_outp_buf == NULL)
+        return 0;
+    return cbuf_len(rc->rc_outp_buf) - rc->rc_outp_offset;
+}
+
+/*! Stop reading input from a connection until its output is drained
+ *
+ * This propagates backpressure from a slow reader back to the client, both for http/1
+ * (pipelined requests stay in the socket) and http/2 (no frames are received, thus
+ * no window updates are consumed)
+ * @param[in]  rc       Connection struct
+ * @see restconf_connection_write  where input is resumed
+ */
+static int
+restconf_conn_inp_pause(restconf_conn *rc)
+{
+    if (!rc->rc_inp_paused){
+        clicon_debug(1, "%s %d", __FUNCTION__, rc->rc_s);
+        clixon_event_unreg_fd(rc->rc_s, restconf_connection);
+        rc->rc_inp_paused = 1;
+    }
+    return 0;
+}
+
+/*! Wait for socket to be writable by registering a write callback in the event loop
+ *
+ * Called when a socket write would block. For http/2 input is also paused, since nghttp2
+ * keeps its own outbound queue and stops requesting data from the data sources.
+ * @param[in]  rc       Connection struct
+ * @retval     0        OK
+ * @retval    -1        Error
+ * @see restconf_connection_write  the write callback
+ */
+int
+restconf_conn_outp_wait(restconf_conn *rc)
+{
+    int retval = -1;
+
+    if (!rc->rc_outp_wait){
+        if (clixon_event_reg_fd_write(rc->rc_s, restconf_connection_write, (void*)rc,
+                                      "restconf client output") < 0)
+            goto done;
+        rc->rc_outp_wait = 1;
+    }
+    if (rc->rc_proto == HTTP_2)
+        restconf_conn_inp_pause(rc);
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Append data to connection output queue and wait for socket to be writable
+ *
+ * @param[in]  rc       Connection struct
+ * @param[in]  buf      Buffer to queue
+ * @param[in]  buflen   Length of buffer
+ * @retval     0        OK
+ * @retval    -1        Error
+ */
+static int
+restconf_conn_outp_enqueue(restconf_conn *rc,
+                           char          *buf,
+                           size_t         buflen)
+{
+    int retval = -1;
+
+    if (rc->rc_outp_buf == NULL &&
+        (rc->rc_outp_buf = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (cbuf_append_buf(rc->rc_outp_buf, buf, buflen) < 0){
+        clicon_err(OE_UNIX, errno, "cbuf_append_buf");
+        goto done;
+    }
+    clicon_debug(1, "%s queued:%zu", __FUNCTION__, restconf_conn_outp_pending(rc));
+    if (restconf_conn_outp_wait(rc) < 0)
+        goto done;
+    if (restconf_conn_outp_pending(rc) > RESTCONF_OUTP_HIGHWATER)
+        restconf_conn_inp_pause(rc);
+    retval = 0;
+ done:
+    return retval;
+}
+
+/* Write buf to socket
+ *
+ * Write as much as possible without blocking, queue the rest on the connection and
+ * register a callback for when the socket is writable again.
+ * If output is already queued, all data is queued to preserve order.
+ * see also this function in restcont_api_openssl.c
+ * @param[in]  h        Clixon handle
+ * @param[in]  buf      Buffer to write
+ * @param[in]  buflen   Length of buffer
+ * @param[in]  rc       Connection struct
+ * @param[in]  callfn   For debug
+ * @retval  1  OK, written or queued
+ * @retval  0  OK, but socket write returned error, caller should close rc
+ * @retval -1  Error
+ * @see restconf_connection_write  where queued output is written
+ */
+static int
+native_buf_write(clicon_handle    h,
+                 char            *buf,
+                 size_t           buflen,
+                 restconf_conn   *rc,
+                 const char      *callfn)                
+{
+    int     retval = -1;
+    size_t  n = 0;
+    int     ret;
+
+    if (rc == NULL){
+        clicon_err(OE_RESTCONF, EINVAL, "rc is NULL");
+        goto done;
+    }
+    /* Two problems with debugging buffers that this fixes:
+     * 1. they are not "strings" in the sense they are not NULL-terminated
+     * 2. they are often very long
+     */
+    if (clicon_debug_get()) { 
+        char *dbgstr = NULL;
+        size_t sz;
+        sz = buflen>256?256:buflen; /* Truncate to 256 */
+        if ((dbgstr = malloc(sz+1)) == NULL){
+            clicon_err(OE_UNIX, errno, "malloc");
+            goto done;
+        }
+        memcpy(dbgstr, buf, sz);
+        dbgstr[sz] = '\0';
+        clicon_debug(1, "%s %s buflen:%zu buf:\n%s", __FUNCTION__, callfn, buflen, dbgstr);
+        free(dbgstr);
+    }
+    if (restconf_conn_outp_pending(rc) == 0){
+        if ((ret = restconf_conn_write(rc, buf, buflen, &n)) < 0)
+            goto done;
+        if (ret == 0)
+            goto closed;
+    }
+    if (n < buflen &&
+        restconf_conn_outp_enqueue(rc, buf+n, buflen-n) < 0)
+        goto done;
     retval = 1;
  done:
     clicon_debug(1, "%s retval:%d", __FUNCTION__, retval);
@@ -541,7 +699,7 @@ http1_native_clear_input(clicon_handle         h,
  * @param[in]  rc    Restconf connection handle 
  * @param[in]  buf   Input buffer
  * @param[in]  sz    Size of input buffer
- * @param[out] np    Bytes read
+ * @param[out] np    Bytes read, -1 if nothing to read, wait for next input event
  * @param[out] again    If set, read data again, do not continue processing
  * @retval     -1    Error
  * @retval     0     OK
@@ -567,8 +725,7 @@ read_ssl(restconf_conn *rc,
              * with SOCK_NONBLOCK
              */
             clicon_debug(1, "%s SSL_read SSL_ERROR_WANT_READ", __FUNCTION__);
-            usleep(1000);
-            *again = 1;
+            *np = -1; /* Return to event loop which calls again when more data is available */
             break;
         case SSL_ERROR_ZERO_RETURN:
             *np = 0; /* should already be zero */
@@ -590,7 +747,7 @@ read_ssl(restconf_conn *rc,
  * @param[in]  rc       Restconf connection handle 
  * @param[in]  buf      Input buffer
  * @param[in]  sz       Size of input buffer
- * @param[out] np       Bytes read
+ * @param[out] np       Bytes read, -1 if nothing to read, wait for next input event
  * @param[out] again    If set, read data again, do not continue processing
  * @retval     -1       Error
  * @retval     0        Socket closed, quit
@@ -619,8 +776,7 @@ read_regular(restconf_conn *rc,
             break;
         case EAGAIN:
             clicon_debug(1, "%s read EAGAIN", __FUNCTION__);
-            usleep(1000);
-            *again = 1;
+            /* Return to event loop which calls again when more data is available */
             break;
         default:;
             clicon_err(OE_XML, errno, "read");
@@ -774,6 +930,11 @@ restconf_http1_process(restconf_conn *rc,
         cvec_free(sd->sd_qvec);
         sd->sd_qvec = NULL;
     }
+    if (ret != 0 && rc->rc_exit && restconf_conn_outp_pending(rc)){
+        /* Server-initiated exit but reply is queued: close when written */
+        restconf_conn_inp_pause(rc);
+        goto ok;
+    }
     if (ret == 0 || rc->rc_exit){  /* Server-initiated exit */
         if (restconf_close_ssl_socket(rc, __FUNCTION__, 0) < 0)
             goto done;
@@ -960,6 +1121,8 @@ restconf_connection(int   s,
     while (readmore) {
         clicon_debug(1, "%s readmore", __FUNCTION__);
         readmore = 0;
+        if (rc->rc_inp_paused) /* Wait until output is drained */
+            break;
         /* Example: curl -Ssik -u wilma:bar -X GET https://localhost/restconf/data/example:x */
         if (rc->rc_ssl){
             if (read_ssl(rc, buf, sizeof(buf), &n, &readmore) < 0)
@@ -974,6 +1137,8 @@ restconf_connection(int   s,
         clicon_debug(1, "%s read:%zd", __FUNCTION__, n);
         if (readmore)
             continue;
+        if (n < 0) /* Would block, wait for next input event */
+            goto ok;
         if (n == 0){
             clicon_debug(1, "%s n=0 closing socket", __FUNCTION__);
             if (restconf_close_ssl_socket(rc, __FUNCTION__, 0) < 0)
@@ -1019,6 +1184,94 @@ restconf_connection(int   s,
     return retval;
 } /* restconf_connection */
 
+/*! Socket is writable: write queued output to socket
+ *
+ * Registered when a write would block. When all output is written, the callback is 
+ * unregistered, http/2 frame output is resumed, and input is resumed if it was paused
+ * @param[in]   s    Socket which is writable
+ * @param[in]   arg  Restconf connection
+ * @retval      0    OK
+ * @retval     -1    Error
+ * @see restconf_conn_outp_wait  where this callback is registered
+ */
+static int
+restconf_connection_write(int   s,
+                          void *arg)
+{
+    int            retval = -1;
+    restconf_conn *rc;
+    cbuf          *cb;
+    size_t         n = 0;
+    int            ret;
+#ifdef HAVE_LIBNGHTTP2
+    nghttp2_error  ngerr;
+#endif
+
+    clicon_debug(1, "%s %d", __FUNCTION__, s);
+    if ((rc = (restconf_conn*)arg) == NULL){
+        clicon_err(OE_RESTCONF, EINVAL, "arg is NULL");
+        goto done;
+    }
+    if ((cb = rc->rc_outp_buf) != NULL && restconf_conn_outp_pending(rc) > 0){
+        if ((ret = restconf_conn_write(rc,
+                                       cbuf_get(cb) + rc->rc_outp_offset,
+                                       restconf_conn_outp_pending(rc),
+                                       &n)) < 0)
+            goto done;
+        if (ret == 0){
+            if (restconf_close_ssl_socket(rc, __FUNCTION__, 0) < 0)
+                goto done;
+            goto ok;
+        }
+        gettimeofday(&rc->rc_t, NULL); /* activity timer */
+        rc->rc_outp_offset += n;
+        if (restconf_conn_outp_pending(rc) > 0) /* Wait for next write event */
+            goto ok;
+        cbuf_reset(cb);
+        rc->rc_outp_offset = 0;
+    }
+    /* Output queue drained */
+    clixon_event_unreg_fd_write(rc->rc_s, restconf_connection_write);
+    rc->rc_outp_wait = 0;
+#ifdef HAVE_LIBNGHTTP2
+    /* Resume http/2 frame output, may re-register this callback via session_send_callback */
+    if (rc->rc_proto == HTTP_2 && rc->rc_ngsession &&
+        nghttp2_session_want_write(rc->rc_ngsession)){
+        clicon_err_reset();
+        if ((ngerr = nghttp2_session_send(rc->rc_ngsession)) != 0){
+            if (clicon_errno)
+                goto done;
+            if (restconf_close_ssl_socket(rc, __FUNCTION__, 0) < 0)
+                goto done;
+            goto ok;
+        }
+        if (rc->rc_outp_wait)
+            goto ok;
+    }
+#endif
+    if (rc->rc_exit && rc->rc_proto != HTTP_2){ /* Deferred server-initiated exit */
+        if (restconf_close_ssl_socket(rc, __FUNCTION__, 0) < 0)
+            goto done;
+        goto ok;
+    }
+    if (rc->rc_inp_paused){
+        clicon_debug(1, "%s %d resume input", __FUNCTION__, rc->rc_s);
+        rc->rc_inp_paused = 0;
+        if (clixon_event_reg_fd(rc->rc_s, restconf_connection, (void*)rc, "restconf client socket") < 0)
+            goto done;
+        /* Data may already be buffered by SSL, then there will be no input event */
+        if (rc->rc_ssl && SSL_pending(rc->rc_ssl) > 0){
+            if (restconf_connection(rc->rc_s, rc) < 0)
+                goto done;
+        }
+    }
+ ok:
+    retval = 0;
+ done:
+    clicon_debug(1, "%s retval %d", __FUNCTION__, retval);
+    return retval;
+}
+
 /*----------------------------- Close socket ------------------------------*/
 
 /*! Close Restconf native connection socket and unregister callback
@@ -1042,6 +1295,10 @@ restconf_connection_close1(restconf_conn *rc)
         goto done;
     }
     clixon_event_unreg_fd(rc->rc_s, restconf_connection);
+    if (rc->rc_outp_wait){
+        clixon_event_unreg_fd_write(rc->rc_s, restconf_connection_write);
+        rc->rc_outp_wait = 0;
+    }
     /* re-set timer */
     if (rc->rc_callhome){
         if (rsock->rs_periodic)
@@ -1243,6 +1500,9 @@ restconf_ssl_accept_client(clicon_handle    h,
          */
         /* X509_CHECK_FLAG_NO_WILDCARDS disables wildcard expansion */
         SSL_set_hostflags(rc->rc_ssl, X509_CHECK_FLAG_NO_WILDCARDS);
+        /* Writes that would block are retried from the connection output queue,
+         * which may be reallocated, see restconf_conn_write */
+        SSL_set_mode(rc->rc_ssl, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
 #if 0
         /* XXX This code is kept for the time being just for reference, it does not belong here.
          * If you want to restrict client certs to a specific set.
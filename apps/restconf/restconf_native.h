@@ -64,6 +64,15 @@ extern "C" {
 #ifndef _RESTCONF_NATIVE_H_
 #define _RESTCONF_NATIVE_H_
 
+/*
+ * Constants
+ */
+/* If more than this number of bytes are queued for output on a connection, stop reading
+ * input from that connection until the output queue is drained.
+ * Only a slow client is affected, other connections continue to be served.
+ */
+#define RESTCONF_OUTP_HIGHWATER (256*1024)
+
 /*
  * Types
  */
@@ -92,6 +101,7 @@ typedef struct  {
     void                 *sd_req;       /* Lib-specific request */
     int                   sd_upgrade2;  /* Upgrade to http/2 */
     uint8_t              *sd_settings2; /* Settings for upgrade to http/2 request */
+    uint32_t              sd_async_id;  /* Outstanding async backend request (message-id), or 0 */
 } restconf_stream_data;
 
 typedef struct restconf_socket restconf_socket;
@@ -121,6 +131,10 @@ typedef struct restconf_conn {
     restconf_socket      *rc_socket;    /* Backpointer to restconf_socket needed for callhome */
     struct timeval        rc_t;         /* Timestamp of last read/write activity, used by callhome
                                            idle-timeout algorithm */
+    cbuf                 *rc_outp_buf;  /* Output queue: data not yet written since socket would block */
+    size_t                rc_outp_offset; /* Offset of first unwritten byte in rc_outp_buf */
+    int                   rc_outp_wait; /* Write callback registered, wait for socket to be writable */
+    int                   rc_inp_paused; /* Input callback unregistered until output is drained */
 } restconf_conn;
 
 /* Restconf per socket handle
@@ -180,6 +194,9 @@ int               ssl_x509_name_oneline(SSL *ssl, char **oneline);
 int               restconf_close_ssl_socket(restconf_conn *rc, const char *callfn, int sslerr0);
 int               restconf_connection_sanity(clicon_handle h, restconf_conn *rc, restconf_stream_data *sd);
 restconf_native_handle *restconf_native_handle_get(clicon_handle h);
+int               restconf_conn_write(restconf_conn *rc, char *buf, size_t buflen, size_t *np);
+size_t            restconf_conn_outp_pending(restconf_conn *rc);
+int               restconf_conn_outp_wait(restconf_conn *rc);
 int               restconf_connection(int s, void *arg);
 int               restconf_ssl_accept_client(clicon_handle h, int s, restconf_socket *rsock, restconf_conn  **rcp);
 int               restconf_idle_timer_unreg(restconf_conn *rc);
@@ -157,6 +157,10 @@ nghttp2_print_headers(nghttp2_nv *nva,
  * If it cannot send any single byte without blocking,
  * it must return :enum:`NGHTTP2_ERR_WOULDBLOCK`.  
  * For other errors, it must return :enum:`NGHTTP2_ERR_CALLBACK_FAILURE`.
+ * On would-block, a write callback is registered in the event loop which resumes with
+ * nghttp2_session_send() when the socket is writable, see restconf_connection_write.
+ * Since nghttp2 then stops pulling data from restconf_sd_read, a slow client does not
+ * block the process.
  */
 static ssize_t
 session_send_callback(nghttp2_session *session,
@@ -165,90 +169,30 @@ session_send_callback(nghttp2_session *session,
                       int              flags,
                       void            *user_data)
 {
-    int            retval = NGHTTP2_ERR_CALLBACK_FAILURE;
+    ssize_t        retval = NGHTTP2_ERR_CALLBACK_FAILURE;
     restconf_conn *rc = (restconf_conn *)user_data;
-    int            er;
-    ssize_t        len;
-    ssize_t        totlen = 0;
-    int            s;
-    int            sslerr;
+    size_t         totlen = 0;
+    int            ret;
     
     clicon_debug(1, "%s buflen:%zu", __FUNCTION__, buflen);
-    s = rc->rc_s;
-    while (totlen < buflen){
-        if (rc->rc_ssl){
-            if ((len = SSL_write(rc->rc_ssl, buf+totlen, buflen-totlen)) <= 0){
-                er = errno;
-                sslerr = SSL_get_error(rc->rc_ssl, len);
-                clicon_debug(1, "%s errno:%d sslerr:%d", __FUNCTION__, er, sslerr);
-                switch (sslerr){
-                case SSL_ERROR_WANT_WRITE:           /* 3 */
-                    clicon_debug(1, "%s write SSL_ERROR_WANT_WRITE", __FUNCTION__);
-                    usleep(1000);
-                    continue;
-                    break;
-                case SSL_ERROR_SYSCALL:              /* 5 */
-                    if (er == ECONNRESET || /* Connection reset by peer */
-                        er == EPIPE) {      /* Reading end of socket is closed */
-                        goto done; /* Cleanup in http2_recv() */
-                    }
-                    else if (er == EAGAIN){
-                        /* same as want_write above, but different behaviour on different 
-                         * platforms, linux here, freebsd want_write, or possibly differnt
-                         * ssl lib versions?
-                         */
-                        clicon_debug(1, "%s write EAGAIN", __FUNCTION__);
-                        usleep(1000);
-                        continue;
-                    }
-                    else{
-                        clicon_err(OE_RESTCONF, er, "SSL_write %d", sslerr);
-                        goto done;
-                    }
-                    break;
-                default:
-                    clicon_err(OE_SSL, 0, "SSL_write");
-                    goto done;
-                    break;
-                }
-                goto done;
-            }
-        }
-        else{
-            if ((len = write(s, buf+totlen, buflen-totlen)) < 0){
-                if (errno == EAGAIN){
-                    clicon_debug(1, "%s write EAGAIN", __FUNCTION__);
-                    usleep(10000);
-                    continue;
-                }
-#if 1
-                else if (errno == ECONNRESET) {/* Connection reset by peer */
-                    close(s);
-                    // XXXUnclear why this is commented, maybe should call
-                    // restconf_connection_close?
-                    //  clixon_event_unreg_fd(s, restconf_connection);
-
-                    goto ok; /* Close socket and ssl */
-                }
-#endif
-                else{
-                    clicon_err(OE_UNIX, errno, "write");
-                    goto done;
-                }
-            }
-            assert(len != 0);
-        }
-        totlen += len;
-    } /* while */
- ok:
-    retval = 0;
+    /* Eg http/1 upgrade reply still queued, keep order */
+    if (restconf_conn_outp_pending(rc) > 0)
+        goto wouldblock;
+    if ((ret = restconf_conn_write(rc, (char*)buf, buflen, &totlen)) < 0)
+        goto done;
+    if (ret == 0) /* Cleanup in http2_recv() */
+        goto done;
+    if (totlen == 0)
+        goto wouldblock;
+    retval = totlen;
  done:
-    if (retval < 0){
-        clicon_debug(1, "%s retval:%d", __FUNCTION__, retval);
-        return retval;
-    }
-    clicon_debug(1, "%s retval:%zd", __FUNCTION__, totlen);
-    return retval == 0 ? totlen : retval;
+    clicon_debug(1, "%s retval:%zd", __FUNCTION__, retval);
+    return retval;
+ wouldblock:
+    if (restconf_conn_outp_wait(rc) < 0)
+        goto done;
+    retval = NGHTTP2_ERR_WOULDBLOCK;
+    goto done;
 }
 
 /*! Invoked when |session| wants to receive data from the remote peer.  
@@ -456,6 +400,45 @@ restconf_submit_response(nghttp2_session      *session,
     return retval;
 }
 
+/*! Submit reply of a processed request to nghttp2
+ *
+ * @param[in]  session    nghttp2 session
+ * @param[in]  rc         Restconf connection
+ * @param[in]  stream_id  Stream id
+ * @param[in]  sd         Restconf stream data with reply code, headers and body
+ * @retval     0          OK
+ * @retval    -1          Error
+ */
+static int
+restconf_nghttp2_reply(nghttp2_session      *session,
+                       restconf_conn        *rc,
+                       int32_t               stream_id,
+                       restconf_stream_data *sd)
+{
+    int retval = -1;
+
+    /* If body, add a content-length header 
+     *    A server MUST NOT send a Content-Length header field in any response
+     * with a status code of 1xx (Informational) or 204 (No Content).  A
+     * server MUST NOT send a Content-Length header field in any 2xx
+     * (Successful) response to a CONNECT request (Section 4.3.6 of
+     * [RFC7231]).
+     */
+    if (sd->sd_code != 204 && sd->sd_code > 199 && sd->sd_body_len)
+        if (restconf_reply_header(sd, "Content-Length", "%zu", sd->sd_body_len) < 0)
+            goto done;  
+    if (sd->sd_code){
+        if (restconf_submit_response(session, rc, stream_id, sd) < 0)
+            goto done;
+    }
+    else {
+        /* 500 Internal server error ? */
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Simulate a received request in an upgrade scenario by talking the http/1 parameters
  */
 int
@@ -485,23 +468,48 @@ http2_exec(restconf_conn        *rc,
     }
     if (restconf_param_del_all(rc->rc_h) < 0) // XXX
         goto done;
+    /* Reply is deferred until the backend replies, @see http2_reply_resume */
+    if (sd->sd_async_id != 0)
+        goto ok;
+    if (restconf_nghttp2_reply(session, rc, stream_id, sd) < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    clicon_debug(1, "%s retval:%d", __FUNCTION__, retval);
+    return retval;
+}
 
-    /* If body, add a content-length header 
-     *    A server MUST NOT send a Content-Length header field in any response
-     * with a status code of 1xx (Informational) or 204 (No Content).  A
-     * server MUST NOT send a Content-Length header field in any 2xx
-     * (Successful) response to a CONNECT request (Section 4.3.6 of
-     * [RFC7231]).
-     */
-    if (sd->sd_code != 204 && sd->sd_code > 199 && sd->sd_body_len)
-        if (restconf_reply_header(sd, "Content-Length", "%zu", sd->sd_body_len) < 0)
-            goto done;  
-    if (sd->sd_code){
-        if (restconf_submit_response(session, rc, stream_id, sd) < 0)
-            goto done;
+/*! Send a deferred reply when an asynchronous backend request has completed
+ *
+ * The stream reply (code, headers, body) has been set by the request handler. Submit it
+ * and send it on the connection. Other streams are not affected.
+ * @param[in]  sd   Restconf stream data
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @see restconf_reply_resume
+ */
+int
+http2_reply_resume(restconf_stream_data *sd)
+{
+    int            retval = -1;
+    restconf_conn *rc = sd->sd_conn;
+    nghttp2_error  ngerr;
+
+    clicon_debug(1, "%s %d", __FUNCTION__, sd->sd_stream_id);
+    if (rc->rc_ngsession == NULL){
+        clicon_err(OE_RESTCONF, EINVAL, "No nghttp2 session"); 
+        goto done;
     }
-    else {
-        /* 500 Internal server error ? */
+    if (restconf_nghttp2_reply(rc->rc_ngsession, rc, sd->sd_stream_id, sd) < 0)
+        goto done;
+    clicon_err_reset();
+    if ((ngerr = nghttp2_session_send(rc->rc_ngsession)) != 0){
+        if (clicon_errno) 
+            goto done;
+        /* Not fatal error, close connection */
+        if (restconf_close_ssl_socket(rc, __FUNCTION__, 0) < 0)
+            goto done;
     }
     retval = 0;
  done:
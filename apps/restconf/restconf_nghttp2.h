@@ -46,5 +46,6 @@ int http2_exec(restconf_conn *rc, restconf_stream_data *sd, nghttp2_session *ses
 int http2_recv(restconf_conn *rc, const unsigned char *buf, size_t n);
 int http2_send_server_connection(restconf_conn *rc);
 int http2_session_init(restconf_conn *rc);
+int http2_reply_resume(restconf_stream_data *sd);
 
 #endif /* _RESTCONF_NGHTTP2_H_ */
@@ -480,6 +480,9 @@ main(int    argc,
         goto done;
     clicon_dbspec_yang_set(h, yspec);   
 
+    /* Load all yang modules from yang cache if enabled and valid, then parsing is skipped */
+    if (yang_spec_cache_load(h, "snmp", yspec) < 0)
+        goto done;
     /* Load Yang modules
      * 1. Load a yang module as a specific absolute filename */
     if ((str = clicon_yang_main_file(h)) != NULL){
@@ -506,6 +509,9 @@ main(int    argc,
     /* Add netconf yang spec, used by netconf client and as internal protocol */
     if (netconf_module_load(h) < 0)
         goto done;
+    /* Write yang cache if enabled and not loaded from it */
+    if (yang_spec_cache_done(h, "snmp", yspec) < 0)
+        goto done;
     /* Here all modules are loaded 
      * Compute and set canonical namespace context
      */
@@ -75,6 +75,14 @@
  */
 #define XML_EXPLICIT_INDEX
 
+/*! Minimum number of new list entries under one parent in an edit for a bulk insert
+ * If an edit adds at least this many entries of a list ordered-by system under the same
+ * parent, they are sorted once and merged with the existing children in a single pass,
+ * instead of a binary search and a move of the child vector for each entry.
+ * See text_modify and xml_insert_bulk. Undefine to disable.
+ */
+#define XML_INSERT_BULK 32
+
 /*! Let state data be ordered-by system
  * RFC 7950 is cryptic about this
  * It says in 7.7.7:
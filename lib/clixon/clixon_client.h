@@ -41,6 +41,7 @@
  */
 typedef void *clixon_handle;
 typedef void *clixon_client_handle;
+typedef void *clixon_client_plan;
 
 /* Connection type as parameter to connect 
  */
@@ -83,6 +84,18 @@ int   clixon_client_get_uint8(clixon_client_handle ch, uint8_t *rval, const char
 int   clixon_client_get_uint16(clixon_client_handle ch, uint16_t *rval, const char *xnamespace, const char *xpath);
 int   clixon_client_get_uint32(clixon_client_handle ch, uint32_t *rval, const char *xnamespace, const char *xpath);
 int   clixon_client_get_uint64(clixon_client_handle ch, uint64_t *rval, const char *xnamespace, const char *xpath);
+
+/* Read plans: read many values in one request */
+clixon_client_plan clixon_client_plan_new(const char *xnamespace, int cache);
+int   clixon_client_plan_add(clixon_client_plan cp, const char *xpath);
+int   clixon_client_plan_read(clixon_client_handle ch, clixon_client_plan cp);
+int   clixon_client_plan_str(clixon_client_plan cp, int i, char **rval);
+int   clixon_client_plan_bool(clixon_client_plan cp, int i, int *rval);
+int   clixon_client_plan_uint8(clixon_client_plan cp, int i, uint8_t *rval);
+int   clixon_client_plan_uint16(clixon_client_plan cp, int i, uint16_t *rval);
+int   clixon_client_plan_uint32(clixon_client_plan cp, int i, uint32_t *rval);
+int   clixon_client_plan_uint64(clixon_client_plan cp, int i, uint64_t *rval);
+int   clixon_client_plan_free(clixon_client_plan cp);
     
 /* Access functions */
 int   clixon_client_socket_get(clixon_client_handle ch);
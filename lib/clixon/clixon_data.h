@@ -57,6 +57,10 @@ typedef struct {
     cxobj    *de_xml;      /* cache */
     int       de_modified; /* Dirty since loaded/copied/committed/etc XXX:nocache? */
     int       de_empty;    /* Empty on read from file, xmldb_readfile and xmldb_put sets it */
+    int       de_defaults; /* Cache is yang bound and default values expanded, see xmldb_get_cache
+                            * 1: updated on edited nodes, 2: some defaults conditional on when,
+                            * updated in the whole tree, see xmldb_put */
+    int       de_bound;    /* Cache is yang bound, kept when a zerocopy read removes defaults */
 } db_elmnt;
 
 /*
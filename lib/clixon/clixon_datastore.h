@@ -38,6 +38,17 @@
 #ifndef _CLIXON_DATASTORE_H
 #define _CLIXON_DATASTORE_H
 
+/*
+ * Types
+ */
+/* Read-only view of a datastore cache, see xmldb_get_view */
+typedef struct {
+    cxobj            *dv_xt;   /* Top of datastore cache, not a copy */
+    cxobj           **dv_vec;  /* Selected nodes, marked with XML_FLAG_MARK */
+    size_t            dv_len;  /* Length of dv_vec */
+    withdefaults_type dv_wdef; /* With-defaults mode */
+} xmldb_view;
+
 /*
  * Prototypes
  * API
@@ -56,6 +67,14 @@ int xmldb_get0(clicon_handle h, const char *db, yang_bind yb,
                cxobj **xtop, modstate_diff_t *msd, cxobj **xerr); 
 int xmldb_get0_clear(clicon_handle h, cxobj *x);
 int xmldb_get0_free(clicon_handle h, cxobj **xp);
+int xmldb_get_view(clicon_handle h, const char *db, cvec *nsc, const char *xpath,
+                   withdefaults_type wdef, xmldb_view *dv, cxobj **xerr);
+int xmldb_view_filter(cxobj *x, void *arg);
+int xmldb_view_clear(xmldb_view *dv);
+int xmldb_view_copy(xmldb_view *dv, cxobj **xtp);
+int xmldb_get_view_list(clicon_handle h, const char *db, cvec *nsc, const char *xpath,
+                        yang_stmt *y, withdefaults_type wdef, char *cursor,
+                        uint32_t offset, uint32_t limit, xmldb_view *dv, char **next, uint32_t *count);
 int xmldb_put(clicon_handle h, const char *db, enum operation_type op, cxobj *xt, char *username, cbuf *cbret); /* in clixon_datastore_write.[ch] */
 int xmldb_copy(clicon_handle h, const char *from, const char *to);
 int xmldb_lock(clicon_handle h, const char *db, uint32_t id);
@@ -75,6 +94,8 @@ cxobj *xmldb_cache_get(clicon_handle h, const char *db);
 int xmldb_modified_get(clicon_handle h, const char *db);
 int xmldb_modified_set(clicon_handle h, const char *db, int value);
 int xmldb_empty_get(clicon_handle h, const char *db);
+uint64_t xmldb_generation_get(clicon_handle h, const char *db);
+int xmldb_generation_incr(clicon_handle h, const char *db);
 int xmldb_dump(clicon_handle h, FILE *f, cxobj *xt);
 int xmldb_print(clicon_handle h, FILE *f);
 int xmldb_rename(clicon_handle h, const char *db, const char *newdb, const char *suffix);
@@ -45,5 +45,6 @@ int clicon_file_dirent(const char *dir, struct dirent **ent,
 int clicon_files_recursive(const char *dir, const char *regexp, cvec *cvv);
 int clicon_file_copy(char *src, char *target);
 int clicon_file_cbuf(const char *filename, cbuf *cb);
+int clicon_file_read(FILE *fp, char **bufp, size_t *lenp);
 
 #endif /* _CLIXON_FILE_H_ */
@@ -213,5 +213,6 @@ int netconf_framing_postamble(netconf_framing_type framing, cbuf *cb);
 int netconf_output(int s, cbuf *xf, char *msg);
 int netconf_output_encap(netconf_framing_type framing, cbuf *cb);
 int netconf_input_chunked_framing(char ch, int *state, size_t *size);
+int netconf_input_chunked_buf(char *buf, size_t len, int *state, size_t *size, cbuf *cb, size_t *np);
 
 #endif /* _CLIXON_NETCONF_LIB_H */
@@ -387,6 +387,8 @@ struct clixon_plugin_api{
  * Macros
  */
 #define upgrade_callback_register(h, cb, ns, arg) upgrade_callback_reg_fn((h), (cb), #cb, (ns), (arg))
+#define statedata_callback_register(h, cb, path) statedata_callback_reg_fn((h), (cb), #cb, (path), 0)
+#define statedata_callback_register_ttl(h, cb, path, ttl) statedata_callback_reg_fn((h), (cb), #cb, (path), (ttl))
 
 typedef struct clixon_plugin_api clixon_plugin_api;
 
@@ -418,6 +420,29 @@ typedef struct {
     char         *rc_name;      /* Xml/json tag/name */
 } rpc_callback_t;
 
+/*
+ * State data callbacks for backend plugins.
+ * State data callbacks are explicitly registered in the plugin_init() function
+ * with a YANG schema path and a function.
+ * The callback is only made if the xpath of a get request intersects the schema subtree,
+ * as opposed to the ca_statedata plugin callback which is made on every get request.
+ * With a non-zero ttl, the state is cached per requested xpath during ttl milliseconds.
+ */
+typedef struct statedata_cache statedata_cache_t; /* Defined in clixon_plugin.c */
+
+typedef struct {
+    qelem_t         sc_qelem;     /* List header */
+    plgstatedata_t *sc_callback;  /* State data callback */
+    const char     *sc_fnstr;     /* Stringified fn name for debug */
+    char           *sc_path;      /* Schema path, eg /ietf-interfaces:interfaces-state */
+    cvec           *sc_steps;     /* Parsed path: name is module name, value is node name */
+    uint32_t        sc_ttl;       /* Time-to-live of cached state in ms, 0: no caching */
+    statedata_cache_t *sc_cache;  /* Cached state per xpath */
+    int             sc_cachenr;   /* Number of cache entries */
+    uint64_t        sc_hit;       /* Number of requests served from cache */
+    uint64_t        sc_miss;      /* Number of requests calling the callback */
+} statedata_callback_t;
+
 /*
  * Prototypes
  */
@@ -475,6 +500,14 @@ int action_callback_call(clicon_handle h, cxobj *xe, cbuf *cbret, void *arg, voi
 int upgrade_callback_reg_fn(clicon_handle h, clicon_upgrade_cb cb, const char *strfn, const char *ns, void *arg);
 int upgrade_callback_call(clicon_handle h, cxobj *xt, char *ns, uint16_t op, uint32_t from, uint32_t to, cbuf *cbret);
 
+/* state data callback API */
+int statedata_callback_reg_fn(clicon_handle h, plgstatedata_t *cb, const char *fnstr, const char *path, uint32_t ttl);
+statedata_callback_t *statedata_callback_each(clicon_handle h, statedata_callback_t *scprev);
+int statedata_callback_match(statedata_callback_t *sc, yang_stmt *yspec, cvec *nsc, char *xpath);
+int statedata_callback_invalidate(clicon_handle h, const char *path);
+int statedata_cache_get(statedata_callback_t *sc, char *xpath, cxobj **xp);
+int statedata_cache_set(statedata_callback_t *sc, char *xpath, cxobj *x);
+
 const int clixon_auth_type_str2int(char *auth_type);
 const char *clixon_auth_type_int2str(clixon_auth_type_t auth_type);
 int              clixon_plugin_module_init(clicon_handle h);
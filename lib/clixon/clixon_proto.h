@@ -40,6 +40,17 @@
 #ifndef _CLIXON_PROTO_H_
 #define _CLIXON_PROTO_H_
 
+/*
+ * Constants
+ */
+/* Start of body of a message in binary encoding, see clicon_msg_encode_bin.
+ * XML never starts with a null character. Eight bytes including terminating null.
+ */
+#define CLIXON_MSG_BIN_MARKER "\0CLXBIN"
+
+/* Capability in internal hello to use binary encoding, see CLICON_IPC_BINARY */
+#define CLIXON_IPC_BINARY_CAPABILITY "http://clicon.org/ipc-binary"
+
 /*
  * Types
  */
@@ -58,6 +69,9 @@ char *format_int2str(enum format_enum showas);
 enum format_enum format_str2int(char *str);
 
 struct clicon_msg *clicon_msg_encode(uint32_t id, const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+struct clicon_msg *clicon_msg_encode_raw(uint32_t id, const char *head, const char *body, size_t len);
+struct clicon_msg *clicon_msg_encode_bin(uint32_t id, cxobj *xml);
+int clicon_msg_bin_p(struct clicon_msg *msg);
 int clicon_msg_decode(struct clicon_msg *msg, yang_stmt *yspec, uint32_t *id, cxobj **xml, cxobj **xerr);
 
 int clicon_connect_unix(clicon_handle h, char *sockpath);
@@ -42,12 +42,28 @@
 #ifndef _CLIXON_PROTO_CLIENT_H_
 #define _CLIXON_PROTO_CLIENT_H_
 
+/*
+ * Types
+ */
+/*! Asynchronous reply callback
+ * @param[in]  h     Clicon handle
+ * @param[in]  xret  Reply tree, freed by caller after callback. NULL if request is cancelled
+ * @param[in]  arg   Argument given when request was sent
+ * @see clicon_rpc_netconf_async
+ */
+typedef int (clicon_rpc_async_cb)(clicon_handle h, cxobj *xret, void *arg);
+
+/*
+ * Prototypes
+ */
 int clicon_rpc_connect(clicon_handle h, int *sock0);
 int clicon_rpc_msg(clicon_handle h, struct clicon_msg *msg, cxobj **xret0);
 int clicon_rpc_msg_persistent(clicon_handle h, struct clicon_msg *msg, cxobj **xret0, int *sock0);
 int clicon_rpc_netconf(clicon_handle h, char *xmlst, cxobj **xret, int *sp);
 int clicon_rpc_netconf_xml(clicon_handle h, cxobj *xml, cxobj **xret, int *sp);
+int clicon_rpc_netconf_raw(clicon_handle h, cxobj *xml, char *raw, size_t len, cxobj **xret);
 int clicon_rpc_get_config(clicon_handle h, char *username, char *db, char *xpath, cvec *nsc, char *defaults, cxobj **xret);
+int clicon_rpc_get_config_generation(clicon_handle h, char *username, char *db, char *xpath, cvec *nsc, char *defaults, uint64_t *generation, cxobj **xret);
 int clicon_rpc_edit_config(clicon_handle h, char *db, enum operation_type op, 
                            char *xml);
 int clicon_rpc_copy_config(clicon_handle h, char *db1, char *db2);
@@ -59,7 +75,7 @@ int clicon_rpc_get_pageable_list(clicon_handle h, char *datastore, char *xpath,
                                  cvec *nsc, netconf_content content, int32_t depth, char *defaults,
                                  uint32_t offset, uint32_t limit,
                                  char *direction, char *sort, char *where,
-                                 cxobj **xt);
+                                 char *cursor, int count, cxobj **xt);
 int clicon_rpc_close_session(clicon_handle h);
 int clicon_rpc_kill_session(clicon_handle h, uint32_t session_id);
 int clicon_rpc_validate(clicon_handle h, char *db);
@@ -70,5 +86,15 @@ int clicon_rpc_debug(clicon_handle h, int level);
 int clicon_rpc_restconf_debug(clicon_handle h, int level);
 int clicon_hello_req(clicon_handle h, char *transport, char *source_host, uint32_t *id);
 int clicon_rpc_restart_plugin(clicon_handle h, char *plugin);
+int clicon_rpc_netconf_async(clicon_handle h, char *op, clicon_rpc_async_cb *fn, void *arg, uint32_t *idp);
+int clicon_rpc_netconf_xml_async(clicon_handle h, cxobj *xml, clicon_rpc_async_cb *fn, void *arg, uint32_t *idp);
+int clicon_rpc_netconf_raw_async(clicon_handle h, cxobj *xml, char *raw, size_t len, clicon_rpc_async_cb *fn, void *arg, uint32_t *idp);
+int clicon_rpc_get_async(clicon_handle h, char *xpath, cvec *nsc, netconf_content content, int32_t depth, char *defaults, clicon_rpc_async_cb *fn, void *arg, uint32_t *idp);
+int clicon_rpc_async_wait(clicon_handle h, uint32_t id, cxobj **xret);
+int clicon_rpc_async_flush(clicon_handle h);
+int clicon_rpc_async_window_set(clicon_handle h, int window);
+int clicon_rpc_async_shared_set(clicon_handle h, int shared);
+int clicon_rpc_async_cancel(clicon_handle h, uint32_t id);
+int clicon_rpc_async_close(clicon_handle h);
 
 #endif  /* _CLIXON_PROTO_CLIENT_H_ */
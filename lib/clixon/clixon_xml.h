@@ -199,6 +199,7 @@ enum format_enum{
 #define XML_FLAG_DEFAULT   0x40 /* Added when a value is set as default @see xml_default */
 #define XML_FLAG_TOP       0x80 /* Top datastore symbol */
 #define XML_FLAG_BODYKEY  0x100 /* Text parsing key to be translated from body to key */
+#define XML_FLAG_CACHE_DIRTY 0x200 /* Datastore cache: defaults of children may be stale, see xmldb_put */
 
 /*
  * Prototypes
@@ -299,6 +300,10 @@ int       clicon_debug_xml(int dbglevel, cxobj *x, const char *format, ...)  __a
 int       xml_search_index_p(cxobj *x);
 
 int       xml_search_vector_get(cxobj *x, char *name, clixon_xvec **xvec);
+int       xml_search_vector_build(cxobj *x, char *name, clixon_xvec **xvec);
+int       xml_search_index_attach(cxobj *xp, cxobj *xc);
+int       xml_search_index_detach(cxobj *xp, cxobj *xc);
+int       xml_search_index_reset(cxobj *x);
 int       xml_search_child_insert(cxobj *xp, cxobj *x);
 int       xml_search_child_rm(cxobj *xp, cxobj *x);
 cxobj    *xml_child_index_each(cxobj *xparent, char *name, cxobj *xprev, enum cxobj_type type);
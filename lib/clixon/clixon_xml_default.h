@@ -50,6 +50,8 @@ typedef enum yang_class yang_class;
  * Prototypes
  */
 int xml_default_recurse(cxobj *xn, int state);
+int xml_default_node(cxobj *xn, yang_stmt *yspec, int state);
+int xml_default_when(yang_stmt *yn);
 int xml_global_defaults(clicon_handle h, cxobj *xn, cvec *nsc, const char *xpath, yang_stmt *yspec, int state);
 int xml_defaults_nopresence(cxobj *xn, int purge);
 int xml_add_default_tag(cxobj *x, uint16_t flags);
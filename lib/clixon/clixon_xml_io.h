@@ -40,6 +40,12 @@
 #ifndef _CLIXON_XML_IO_H_
 #define _CLIXON_XML_IO_H_
 
+/*
+ * Types
+ */
+/* Filter function for clixon_xml2cbuf_filter: -1 error, 0 skip element, 1 print element */
+typedef int (xml2cbuf_filter_t)(cxobj *x, void *arg);
+
 /*
  * Prototypes
  */
@@ -47,9 +53,13 @@ int   clixon_xml2file(FILE *f, cxobj *xn, int level, int pretty, clicon_output_c
 int   xml_print(FILE *f, cxobj *xn);
 int   xml_dump(FILE  *f, cxobj *x);
 int   clixon_xml2cbuf(cbuf *cb, cxobj *x, int level, int prettyprint, int32_t depth, int skiptop);
+int   clixon_xml2cbuf_filter(cbuf *cb, cxobj *x, int level, int prettyprint, int32_t depth, int skiptop,
+                             xml2cbuf_filter_t *fn, void *arg);
 int   xmltree2cbuf(cbuf *cb, cxobj *x, int level);
+int   xml_parse_fast(int val);
 int   clixon_xml_parse_file(FILE *f, yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xerr);
 int   clixon_xml_parse_string(const char *str, yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xerr);
+int   clixon_xml_parse_buf(char *buf, size_t len, yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xerr);
 int   clixon_xml_parse_va(yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xerr, 
                         const char *format, ...)  __attribute__ ((format (printf, 5, 6)));
 int   clixon_xml_attr_copy(cxobj *xin, cxobj *xout, char *name);
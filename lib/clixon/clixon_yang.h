@@ -70,6 +70,10 @@
                                       * Transformed to ANYDATA but some code may need to check
                                       * why it is an ANYDATA
                                       */
+#define YANG_FLAG_CACHE_LOADED 0x80  /* Only on yspec: modules loaded from yang cache, parsing of
+                                      * modules is skipped, see yang_spec_cache_load */
+#define YANG_FLAG_DESC_CACHE  0x100  /* Descendant name bloom filter computed,
+                                      * see yang_descendant_maybe */
 
 /*
  * Types
@@ -167,6 +171,7 @@ enum yang_class{
 typedef enum yang_class yang_class;
 
 struct xml;
+struct xpath_prog;
 
 /* This is the external handle type exposed in the API.
  * The internal struct is defined in clixon_yang_internal.h */
@@ -228,6 +233,8 @@ char      *yang_when_xpath_get(yang_stmt *ys);
 int        yang_when_xpath_set(yang_stmt *ys, char *xpath);
 cvec      *yang_when_nsc_get(yang_stmt *ys);
 int        yang_when_nsc_set(yang_stmt *ys, cvec *nsc);
+struct xpath_prog *yang_xpath_prog_get(yang_stmt *ys);
+int        yang_xpath_prog_set(yang_stmt *ys, struct xpath_prog *prog);
 const char *yang_filename_get(yang_stmt *ys);
 int        yang_filename_set(yang_stmt *ys, const char *filename);
 int        yang_linenum_get(yang_stmt *ys);
@@ -259,6 +266,7 @@ yang_stmt *yang_find(yang_stmt *yn, int keyword, const char *argument);
 int        yang_match(yang_stmt *yn, int keyword, char *argument);
 yang_stmt *yang_find_datanode(yang_stmt *yn, char *argument);
 yang_stmt *yang_find_schemanode(yang_stmt *yn, char *argument);
+int        yang_descendant_maybe(yang_stmt *ys, char *name);
 char      *yang_find_myprefix(yang_stmt *ys);
 char      *yang_find_mynamespace(yang_stmt *ys);
 int        yang_find_prefix_by_namespace(yang_stmt *ys, char *ns, char **prefix);
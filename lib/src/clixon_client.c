@@ -37,6 +37,8 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
 #include <unistd.h>
 #include <syslog.h>
 #include <string.h>
@@ -458,7 +460,9 @@ clixon_xml_bottom(cxobj  *xtop,
  * @param[in]  sock      Socket
  * @param[in]  namespace Default namespace used for non-prefixed entries in xpath. (Alt use nsc)
  * @param[in]  xpath     XPath
+ * @param[in,out] generation  If set, generation of cached data, set to generation of returned data
  * @param[out] xdata     XML data tree (may or may not include the intended data)
+ *                       NULL if generation is set and data has not changed
  * @retval     0         OK
  * @retval     -1        Error
  * @note configurable netconf framing type, now hardwired to 0
@@ -467,6 +471,7 @@ static int
 clixon_client_get_xdata(int         sock,
                         const char *namespace,
                         const char *xpath,
+                        uint64_t   *generation,
                         cxobj     **xdata)
 {
     int          retval = -1;
@@ -477,6 +482,7 @@ clixon_client_get_xdata(int         sock,
     const char  *db = "running";
     cvec        *nsc = NULL; 
     int          eof = 0;
+    char        *genstr;
     
     clicon_debug(1, "%s", __FUNCTION__);
     if ((msg = cbuf_new()) == NULL){
@@ -491,7 +497,12 @@ clixon_client_get_xdata(int         sock,
     cprintf(msg, " xmlns:%s=\"%s\"",
             NETCONF_BASE_PREFIX, NETCONF_BASE_NAMESPACE);
     cprintf(msg, " %s", NETCONF_MESSAGE_ID_ATTR);
-    cprintf(msg, "><get-config><source><%s/></source>", db);
+    cprintf(msg, "><get-config");
+    /* Clixon extension, only get data if changed since generation */
+    if (generation)
+        cprintf(msg, " %s:generation=\"%" PRIu64 "\" xmlns:%s=\"%s\"",
+                CLIXON_LIB_PREFIX, *generation, CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    cprintf(msg, "><source><%s/></source>", db);
     if (xpath && strlen(xpath)){
         cprintf(msg, "<%s:filter %s:type=\"xpath\" xmlns=\"%s\" %s:select=\"%s\"",
                 NETCONF_BASE_PREFIX,
@@ -530,6 +541,18 @@ clixon_client_get_xdata(int         sock,
         if (xml_rm(xd) < 0)
             goto done;
     }
+    if (generation){
+        if ((genstr = xml_find_type_value(xd, NULL, "generation", CX_ATTR)) != NULL &&
+            parse_uint64(genstr, generation, NULL) <= 0){
+            clicon_err(OE_XML, EINVAL, "Invalid generation: %s", genstr);
+            xml_free(xd);
+            goto done;
+        }
+        if (xml_find_type_value(xd, NULL, "unchanged", CX_ATTR) != NULL){
+            xml_free(xd);
+            xd = NULL;
+        }
+    }
     *xdata = xd;
     retval = 0;
  done:
@@ -566,7 +589,7 @@ clixon_client_get_body_val(int         sock,
         clicon_err(OE_XML, EINVAL, "Expected val");
         goto done;
     }
-    if (clixon_client_get_xdata(sock, namespace, xpath, &xdata) < 0)
+    if (clixon_client_get_xdata(sock, namespace, xpath, NULL, &xdata) < 0)
         goto done;
     if (xdata == NULL){
         clicon_err(OE_XML, EINVAL, "No xml obj found"); 
@@ -823,6 +846,393 @@ clixon_client_get_uint64(clixon_client_handle  ch,
     return retval;
 }
 
+/*
+ * Read plans
+ * A read plan is a set of xpaths that are read from the backend in one request.
+ * Values are then extracted from the result locally. If caching is enabled, the
+ * result is kept and the backend only returns data if running has changed since
+ * last read, as given by the running datastore generation.
+ */
+
+/*! Internal structure of a read plan
+ */
+struct clixon_client_plan{
+    char     *cp_namespace;  /* Default namespace of xpaths */
+    cvec     *cp_nsc;        /* Namespace context for local xpath evaluation */
+    char    **cp_xpaths;     /* Vector of xpaths */
+    int       cp_len;        /* Length of xpath vector */
+    cbuf     *cp_select;     /* Union of all xpaths, sent as filter */
+    int       cp_cache;      /* Keep data and only re-read if changed */
+    uint64_t  cp_generation; /* Generation of cached data, 0 if none */
+    cxobj    *cp_xdata;      /* Data from last read */
+};
+
+/*! Create a read plan
+ *
+ * @param[in]  namespace Default namespace used for non-prefixed entries in xpaths
+ * @param[in]  cache     If set, keep data between reads and only re-read if running has changed
+ * @retval     cp        Read plan, free with clixon_client_plan_free
+ * @retval     NULL      Error
+ * @code
+ *   clixon_client_plan cp;
+ *   uint32_t           u32;
+ *   int                i;
+ *   cp = clixon_client_plan_new("urn:example:clixon", 1);
+ *   i = clixon_client_plan_add(cp, "/table/parameter[name='a']/value");
+ *   ...
+ *   if (clixon_client_plan_read(ch, cp) < 0)
+ *      err;
+ *   if (clixon_client_plan_uint32(cp, i, &u32) == 1)
+ *      ...
+ *   clixon_client_plan_free(cp);
+ * @endcode
+ */
+clixon_client_plan
+clixon_client_plan_new(const char *namespace,
+                       int         cache)
+{
+    struct clixon_client_plan *cp = NULL;
+
+    if (namespace == NULL){
+        clicon_err(OE_XML, EINVAL, "Expected namespace");
+        goto done;
+    }
+    if ((cp = malloc(sizeof(*cp))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(cp, 0, sizeof(*cp));
+    cp->cp_cache = cache;
+    if ((cp->cp_namespace = strdup(namespace)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto err;
+    }
+    if ((cp->cp_nsc = xml_nsctx_init(NULL, (char*)namespace)) == NULL)
+        goto err;
+    if ((cp->cp_select = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto err;
+    }
+ done:
+    return cp;
+ err:
+    clixon_client_plan_free(cp);
+    cp = NULL;
+    goto done;
+}
+
+/*! Add an xpath to a read plan
+ *
+ * @param[in]  cp     Read plan
+ * @param[in]  xpath  XPath to a leaf
+ * @retval     i      Index of xpath, used when extracting its value
+ * @retval    -1      Error
+ */
+int
+clixon_client_plan_add(clixon_client_plan cp0,
+                       const char        *xpath)
+{
+    struct clixon_client_plan *cp = (struct clixon_client_plan *)cp0;
+    char                     **xv;
+
+    if (cp == NULL || xpath == NULL){
+        clicon_err(OE_XML, EINVAL, "Expected plan and xpath");
+        return -1;
+    }
+    if ((xv = realloc(cp->cp_xpaths, (cp->cp_len+1)*sizeof(char*))) == NULL){
+        clicon_err(OE_UNIX, errno, "realloc");
+        return -1;
+    }
+    cp->cp_xpaths = xv;
+    if ((cp->cp_xpaths[cp->cp_len] = strdup(xpath)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        return -1;
+    }
+    cprintf(cp->cp_select, "%s%s", cp->cp_len?" | ":"", xpath);
+    /* Plan is changed, cached data is no longer valid */
+    cp->cp_generation = 0;
+    return cp->cp_len++;
+}
+
+/*! Read all xpaths of a read plan from the backend in one request
+ *
+ * @param[in]  ch     Clixon client handle
+ * @param[in]  cp     Read plan
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+int
+clixon_client_plan_read(clixon_client_handle ch,
+                        clixon_client_plan   cp0)
+{
+    int                          retval = -1;
+    struct clixon_client_handle *cch = chandle(ch);
+    struct clixon_client_plan   *cp = (struct clixon_client_plan *)cp0;
+    cxobj                       *xdata = NULL;
+    uint64_t                     generation;
+
+    clicon_debug(1, "%s", __FUNCTION__);
+    if (cp == NULL || cp->cp_len == 0){
+        clicon_err(OE_XML, EINVAL, "Expected plan with xpaths");
+        goto done;
+    }
+    generation = cp->cp_generation;
+    if (clixon_client_get_xdata(cch->cch_socket, cp->cp_namespace, cbuf_get(cp->cp_select),
+                                cp->cp_cache?&generation:NULL,
+                                &xdata) < 0)
+        goto done;
+    if (xdata != NULL){ /* NULL means unchanged since last read */
+        if (cp->cp_xdata)
+            xml_free(cp->cp_xdata);
+        cp->cp_xdata = xdata;
+        cp->cp_generation = cp->cp_cache?generation:0;
+    }
+    retval = 0;
+ done:
+    clicon_debug(1, "%s retval:%d", __FUNCTION__, retval);
+    return retval;
+}
+
+/*! Get body of xpath i in a read plan from last read
+ *
+ * @param[in]  cp     Read plan
+ * @param[in]  i      Index of xpath as returned by clixon_client_plan_add
+ * @param[out] val    Body, valid until next read
+ * @retval     1      OK
+ * @retval     0      Not found
+ * @retval    -1      Error
+ */
+static int
+clixon_client_plan_body(struct clixon_client_plan *cp,
+                        int                        i,
+                        char                     **val)
+{
+    cxobj *x;
+
+    if (cp == NULL || i < 0 || i >= cp->cp_len){
+        clicon_err(OE_XML, EINVAL, "Invalid plan or index");
+        return -1;
+    }
+    if (cp->cp_xdata == NULL){
+        clicon_err(OE_XML, ENOENT, "Plan not read");
+        return -1;
+    }
+    if ((x = xpath_first(cp->cp_xdata, cp->cp_nsc, "%s", cp->cp_xpaths[i])) == NULL ||
+        (*val = xml_body(x)) == NULL)
+        return 0;
+    return 1;
+}
+
+/*! Read plan get string
+ * @param[in]  cp     Read plan
+ * @param[in]  i      Index of xpath as returned by clixon_client_plan_add
+ * @param[out] rval   Return value string, valid until next read
+ * @retval     1      OK
+ * @retval     0      Not found
+ * @retval    -1      Error
+ */
+int
+clixon_client_plan_str(clixon_client_plan cp,
+                       int                i,
+                       char             **rval)
+{
+    return clixon_client_plan_body((struct clixon_client_plan *)cp, i, rval);
+}
+
+/*! Read plan get boolean
+ * @param[in]  cp     Read plan
+ * @param[in]  i      Index of xpath as returned by clixon_client_plan_add
+ * @param[out] rval   Return value
+ * @retval     1      OK
+ * @retval     0      Not found
+ * @retval    -1      Error, also if value is invalid
+ */
+int
+clixon_client_plan_bool(clixon_client_plan cp,
+                        int                i,
+                        int               *rval)
+{
+    int      retval = -1;
+    char    *val = NULL;
+    char    *reason = NULL;
+    uint8_t  val0 = 0;
+    int      ret;
+
+    if ((ret = clixon_client_plan_body((struct clixon_client_plan *)cp, i, &val)) <= 0){
+        retval = ret;
+        goto done;
+    }
+    if ((ret = parse_bool(val, &val0, &reason)) < 0){
+        clicon_err(OE_XML, errno, "parse_bool");
+        goto done;
+    }
+    if (ret == 0){
+        clicon_err(OE_XML, EINVAL, "%s", reason);
+        goto done;
+    }
+    *rval = (int)val0;
+    retval = 1;
+ done:
+    if (reason)
+        free(reason);
+    return retval;
+}
+
+/*! Read plan get uint8
+ * @see clixon_client_plan_bool
+ */
+int
+clixon_client_plan_uint8(clixon_client_plan cp,
+                         int                i,
+                         uint8_t           *rval)
+{
+    int   retval = -1;
+    char *val = NULL;
+    char *reason = NULL;
+    int   ret;
+
+    if ((ret = clixon_client_plan_body((struct clixon_client_plan *)cp, i, &val)) <= 0){
+        retval = ret;
+        goto done;
+    }
+    if ((ret = parse_uint8(val, rval, &reason)) < 0){
+        clicon_err(OE_XML, errno, "parse_uint8");
+        goto done;
+    }
+    if (ret == 0){
+        clicon_err(OE_XML, EINVAL, "%s", reason);
+        goto done;
+    }
+    retval = 1;
+ done:
+    if (reason)
+        free(reason);
+    return retval;
+}
+
+/*! Read plan get uint16
+ * @see clixon_client_plan_bool
+ */
+int
+clixon_client_plan_uint16(clixon_client_plan cp,
+                          int                i,
+                          uint16_t          *rval)
+{
+    int   retval = -1;
+    char *val = NULL;
+    char *reason = NULL;
+    int   ret;
+
+    if ((ret = clixon_client_plan_body((struct clixon_client_plan *)cp, i, &val)) <= 0){
+        retval = ret;
+        goto done;
+    }
+    if ((ret = parse_uint16(val, rval, &reason)) < 0){
+        clicon_err(OE_XML, errno, "parse_uint16");
+        goto done;
+    }
+    if (ret == 0){
+        clicon_err(OE_XML, EINVAL, "%s", reason);
+        goto done;
+    }
+    retval = 1;
+ done:
+    if (reason)
+        free(reason);
+    return retval;
+}
+
+/*! Read plan get uint32
+ * @see clixon_client_plan_bool
+ */
+int
+clixon_client_plan_uint32(clixon_client_plan cp,
+                          int                i,
+                          uint32_t          *rval)
+{
+    int   retval = -1;
+    char *val = NULL;
+    char *reason = NULL;
+    int   ret;
+
+    if ((ret = clixon_client_plan_body((struct clixon_client_plan *)cp, i, &val)) <= 0){
+        retval = ret;
+        goto done;
+    }
+    if ((ret = parse_uint32(val, rval, &reason)) < 0){
+        clicon_err(OE_XML, errno, "parse_uint32");
+        goto done;
+    }
+    if (ret == 0){
+        clicon_err(OE_XML, EINVAL, "%s", reason);
+        goto done;
+    }
+    retval = 1;
+ done:
+    if (reason)
+        free(reason);
+    return retval;
+}
+
+/*! Read plan get uint64
+ * @see clixon_client_plan_bool
+ */
+int
+clixon_client_plan_uint64(clixon_client_plan cp,
+                          int                i,
+                          uint64_t          *rval)
+{
+    int   retval = -1;
+    char *val = NULL;
+    char *reason = NULL;
+    int   ret;
+
+    if ((ret = clixon_client_plan_body((struct clixon_client_plan *)cp, i, &val)) <= 0){
+        retval = ret;
+        goto done;
+    }
+    if ((ret = parse_uint64(val, rval, &reason)) < 0){
+        clicon_err(OE_XML, errno, "parse_uint64");
+        goto done;
+    }
+    if (ret == 0){
+        clicon_err(OE_XML, EINVAL, "%s", reason);
+        goto done;
+    }
+    retval = 1;
+ done:
+    if (reason)
+        free(reason);
+    return retval;
+}
+
+/*! Free a read plan
+ * @param[in]  cp     Read plan
+ */
+int
+clixon_client_plan_free(clixon_client_plan cp0)
+{
+    struct clixon_client_plan *cp = (struct clixon_client_plan *)cp0;
+    int                        i;
+
+    if (cp == NULL)
+        return 0;
+    if (cp->cp_namespace)
+        free(cp->cp_namespace);
+    if (cp->cp_nsc)
+        xml_nsctx_free(cp->cp_nsc);
+    for (i=0; i<cp->cp_len; i++)
+        free(cp->cp_xpaths[i]);
+    if (cp->cp_xpaths)
+        free(cp->cp_xpaths);
+    if (cp->cp_select)
+        cbuf_free(cp->cp_select);
+    if (cp->cp_xdata)
+        xml_free(cp->cp_xdata);
+    free(cp);
+    return 0;
+}
+
 /* Access functions */
 /*! Client-api get uint64
  * @param[in]  ch     Clixon client handle
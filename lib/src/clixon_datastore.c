@@ -42,6 +42,7 @@
 #endif
 
 #include <stdlib.h>
+#include <inttypes.h>
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
@@ -170,6 +171,8 @@ xmldb_disconnect(clicon_handle h)
             if (de->de_xml){
                 xml_free(de->de_xml);
                 de->de_xml = NULL;
+                de->de_defaults = 0;
+                de->de_bound = 0;
             }
         }
     retval = 0;
@@ -237,8 +240,13 @@ xmldb_copy(clicon_handle h,
         if (de2)
             de0 = *de2;
         de0.de_xml = x2; /* The new tree */
+        /* Default values are copied with the tree */
+        de0.de_defaults = (x2 != NULL && de1 != NULL) ? de1->de_defaults : 0;
+        de0.de_bound = (x2 != NULL && de1 != NULL) ? de1->de_bound : 0;
     }
     clicon_db_elmnt_set(h, to, &de0);
+    if (xmldb_generation_incr(h, to) < 0)
+        goto done;
 
     /* Copy the files themselves (above only in-memory cache) */
     if (xmldb_db2file(h, from, &fromfile) < 0)
@@ -425,6 +433,8 @@ xmldb_clear(clicon_handle h,
         if ((xt = de->de_xml) != NULL){
             xml_free(xt);
             de->de_xml = NULL;
+            de->de_defaults = 0;
+            de->de_bound = 0;
         }
     }
     return 0;
@@ -448,6 +458,8 @@ xmldb_delete(clicon_handle h,
     clicon_debug(CLIXON_DBG_DETAIL, "%s %s", __FUNCTION__, db);
     if (xmldb_clear(h, db) < 0)
         goto done;
+    if (xmldb_generation_incr(h, db) < 0)
+        goto done;
     if (xmldb_db2file(h, db, &filename) < 0)
         goto done;
     if (lstat(filename, &sb) == 0)
@@ -483,8 +495,12 @@ xmldb_create(clicon_handle h,
         if ((xt = de->de_xml) != NULL){
             xml_free(xt);
             de->de_xml = NULL;
+            de->de_defaults = 0;
+            de->de_bound = 0;
         }
     }
+    if (xmldb_generation_incr(h, db) < 0)
+        goto done;
     if (xmldb_db2file(h, db, &filename) < 0)
         goto done;
     if ((fd = open(filename, O_CREAT|O_WRONLY, S_IRWXU)) == -1) {
@@ -602,6 +618,61 @@ xmldb_modified_set(clicon_handle h,
     return 0;
 }
 
+/*! Get generation of datastore, a number which changes on every write of the datastore
+ *
+ * A client may cache data read from a datastore and only re-read it if the
+ * generation has changed.
+ * The first generation is seeded by the time so that generations of different
+ * processes (eg after backend restart) do not coincide.
+ * @param[in]  h     Clicon handle
+ * @param[in]  db    Database name
+ * @retval     gen   Generation
+ * @see xmldb_generation_incr
+ */
+uint64_t
+xmldb_generation_get(clicon_handle h,
+                     const char   *db)
+{
+    char           key[64];
+    char          *val = NULL;
+    char           buf[32];
+    uint64_t       gen = 0;
+    struct timeval tv;
+
+    snprintf(key, sizeof(key), "xmldb-generation-%s", db);
+    if (clicon_data_get(h, key, &val) < 0 ||
+        val == NULL ||
+        parse_uint64(val, &gen, NULL) <= 0){
+        gettimeofday(&tv, NULL);
+        gen = (uint64_t)tv.tv_sec << 32;
+        snprintf(buf, sizeof(buf), "%" PRIu64, gen);
+        clicon_data_set(h, key, buf);
+    }
+    return gen;
+}
+
+/*! Increment generation of datastore, called when the datastore is written
+ *
+ * @param[in]  h     Clicon handle
+ * @param[in]  db    Database name
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see xmldb_generation_get
+ */
+int
+xmldb_generation_incr(clicon_handle h,
+                      const char   *db)
+{
+    char     key[64];
+    char     buf[32];
+    uint64_t gen;
+
+    gen = xmldb_generation_get(h, db) + 1;
+    snprintf(key, sizeof(key), "xmldb-generation-%s", db);
+    snprintf(buf, sizeof(buf), "%" PRIu64, gen);
+    return clicon_data_set(h, key, buf);
+}
+
 /* Print the datastore meta-info to file
  */
 int
@@ -667,6 +738,10 @@ xmldb_rename(clicon_handle h,
         clicon_err(OE_UNIX, errno, "rename: %s", strerror(errno));
         goto done;
     };
+    if (xmldb_generation_incr(h, db) < 0)
+        goto done;
+    if (newdb && xmldb_generation_incr(h, newdb) < 0)
+        goto done;
     retval = 0;
  done:
     if (cb)
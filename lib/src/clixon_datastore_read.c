@@ -80,6 +80,7 @@
 #include "clixon_xml_map.h"
 #include "clixon_xml_default.h"
 #include "clixon_xml_io.h"
+#include "clixon_xml_bin.h"
 #include "clixon_xml_nsctx.h"
 #include "clixon_datastore.h"
 #include "clixon_datastore_read.h"
@@ -480,6 +481,7 @@ xmldb_readfile(clicon_handle    h,
     cxobj           *xmodfile = NULL;
     cxobj           *x;
     yang_stmt       *yspec1 = NULL;
+    int              bound = 0;       /* Tree from file is bound and sorted */
 
     if (yb != YB_MODULE && yb != YB_NONE){
         clicon_err(OE_XML, EINVAL, "yb is %d but should be module or none", yb);
@@ -507,28 +509,42 @@ xmldb_readfile(clicon_handle    h,
      *   config*
      * </config>
      * ret == 0 should not happen with YB_NONE. Binding is done later */
-    if (strcmp(format, "json")==0){
-        if (clixon_json_parse_file(fp, 1, YB_NONE, yspec, &x0, xerr) < 0) 
+    if (strcmp(format, "binary")==0){
+        /* Top-level is "config", already bound and sorted unless yang has changed */
+        if ((ret = clixon_bin_parse_file(fp, yspec, &x0)) < 0)
             goto done;
+        bound = ret;
+        if (x0 == NULL &&
+            (x0 = xml_new(DATASTORE_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+            goto done;
+        /* Mounted yangs are not resolved by the binary format */
+        if (clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT"))
+            bound = 0;
     }
     else {
-        if (clixon_xml_parse_file(fp, YB_NONE, yspec, &x0, xerr) < 0){
-            goto done;
+        if (strcmp(format, "json")==0){
+            if (clixon_json_parse_file(fp, 1, YB_NONE, yspec, &x0, xerr) < 0) 
+                goto done;
+        }
+        else {
+            if (clixon_xml_parse_file(fp, YB_NONE, yspec, &x0, xerr) < 0){
+                goto done;
+            }
+        }
+        /* Always assert a top-level called "config". 
+         * To ensure that, deal with two cases:
+         * 1. File is empty <top/> -> rename top-level to "config" 
+         */
+        if (xml_child_nr(x0) == 0){ 
+            if (xml_name_set(x0, DATASTORE_TOP_SYMBOL) < 0)
+                goto done;     
+        }
+        /* 2. File is not empty <top><config>...</config></top> -> replace root */
+        else{ 
+            /* There should only be one element and called config */
+            if (singleconfigroot(x0, &x0) < 0)
+                goto done;
         }
-    }
-    /* Always assert a top-level called "config". 
-     * To ensure that, deal with two cases:
-     * 1. File is empty <top/> -> rename top-level to "config" 
-     */
-    if (xml_child_nr(x0) == 0){ 
-        if (xml_name_set(x0, DATASTORE_TOP_SYMBOL) < 0)
-            goto done;     
-    }
-    /* 2. File is not empty <top><config>...</config></top> -> replace root */
-    else{ 
-        /* There should only be one element and called config */
-        if (singleconfigroot(x0, &x0) < 0)
-            goto done;
     }
     /* Purge all top-level body objects */
     x = NULL;
@@ -619,13 +635,16 @@ xmldb_readfile(clicon_handle    h,
             }
         } /* if msdiff */
         /* xml looks like: <top><config><x>... actually YB_MODULE_NEXT 
+         * A binary file is bound and sorted already, unless the yang has changed
          */
-        if ((ret = xml_bind_yang(h, x0, YB_MODULE, yspec1?yspec1:yspec, xerr)) < 0)
-            goto done;
-        if (ret == 0)
-            goto fail;
-        if (xml_sort_recurse(x0) < 0)
-            goto done;
+        if (!bound || yspec1){
+            if ((ret = xml_bind_yang(h, x0, YB_MODULE, yspec1?yspec1:yspec, xerr)) < 0)
+                goto done;
+            if (ret == 0)
+                goto fail;
+            if (xml_sort_recurse(x0) < 0)
+                goto done;
+        }
     }
     if (xp){
         *xp = x0;
@@ -815,46 +834,32 @@ xmldb_get_nocache(clicon_handle    h,
     goto done;
 }
 
-/*! Get content of database using xpath. return a set of matching sub-trees
- * The function returns a minimal tree that includes all sub-trees that match
- * xpath.
- * This is a clixon datastore plugin of the the xmldb api
+/*! Get the datastore cache, read it from file if not present
+ *
+ * If bound to YANG modules, default values are expanded in the cache the first time.
+ * They are then kept up-to-date incrementally by xmldb_put.
  * @param[in]  h      Clicon handle
- * @param[in]  db     Name of database to search in (filename including dir path
+ * @param[in]  db     Name of datastore
  * @param[in]  yb     How to bind yang to XML top-level when parsing
- * @param[in]  nsc    External XML namespace context, or NULL
- * @param[in]  xpath  String with XPATH syntax. or NULL for all
- * @param[in]  wdef   With-defaults parameter, see RFC 6243
- * @param[out] xtop   Single return XML tree. Free with xml_free()
+ * @param[out] x0tp   Top of datastore cache, do not free
  * @param[out] msdiff If set, return modules-state differences
  * @param[out] xerr   XML error if retval is 0
- * @retval     -1     General error, check specific clicon_errno, clicon_suberrno
- * @retval     0      Parse OK but yang assigment not made (or only partial) and xerr set
  * @retval     1      OK
- * @note Use of 1 for OK
- * @see xmldb_get  the generic API function
+ * @retval     0      Parse OK but yang assigment not made (or only partial) and xerr set
+ * @retval    -1      Error
  */
 static int
-xmldb_get_cache(clicon_handle     h,
-                const char       *db, 
-                yang_bind         yb,
-                cvec             *nsc,
-                const char       *xpath,
-                withdefaults_type wdef,
-                cxobj           **xtop,
-                modstate_diff_t  *msdiff,
-                cxobj           **xerr)
-
+xmldb_cache_load(clicon_handle     h,
+                 const char       *db,
+                 yang_bind         yb,
+                 cxobj           **x0tp,
+                 modstate_diff_t  *msdiff,
+                 cxobj           **xerr)
 {
     int        retval = -1;
     yang_stmt *yspec;
-    cxobj     *x0t = NULL; /* (cached) top of tree */
-    cxobj     *x0;
-    cxobj    **xvec = NULL;
-    size_t     xlen;
-    int        i;
+    cxobj     *x0t = NULL;
     db_elmnt  *de = NULL;
-    cxobj     *x1t = NULL;
     db_elmnt   de0 = {0,};
     int        ret;
 
@@ -877,24 +882,94 @@ xmldb_get_cache(clicon_handle     h,
         if (de)
             de0.de_id = de->de_id;
         clicon_db_elmnt_set(h, db, &de0); /* Content is copied */
+        de = clicon_db_elmnt_get(h, db);
     } /* x0t == NULL */
     else
         x0t = de->de_xml;
 
-    if (yb == YB_MODULE && !xml_spec(x0t)){
-        if ((ret = xml_bind_yang(h, x0t, YB_MODULE, yspec, xerr)) < 0)
+    /* Expand default values in the cache once, they are then kept up-to-date
+     * incrementally by xmldb_put, and not removed by readers
+     */
+    if (yb == YB_MODULE && !de->de_defaults){
+        /* Still bound if defaults were only removed by a zerocopy read */
+        if (de->de_bound)
+            ret = 1;
+        else if ((ret = xml_bind_yang(h, x0t, YB_MODULE, yspec, xerr)) < 0)
             goto done;
         if (ret == 0)
             ; /* XXX */
         else {
+            de->de_bound = 1;
             /* Add default global values (to make xpath below include defaults) */
-            if (xml_global_defaults(h, x0t, nsc, xpath, yspec, 0) < 0)
+            if (xml_default_node(x0t, yspec, 0) < 0)
                 goto done;
             /* Add default recursive values */
             if (xml_default_recurse(x0t, 0) < 0)
                 goto done;
+            /* A when condition may refer outside of the edited nodes */
+            de->de_defaults = xml_default_when(yspec) ? 2 : 1;
         }
     }
+    *x0tp = x0t;
+    retval = 1;
+ done:
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Get content of database using xpath. return a set of matching sub-trees
+ * The function returns a minimal tree that includes all sub-trees that match
+ * xpath.
+ * This is a clixon datastore plugin of the the xmldb api
+ * @param[in]  h      Clicon handle
+ * @param[in]  db     Name of database to search in (filename including dir path
+ * @param[in]  yb     How to bind yang to XML top-level when parsing
+ * @param[in]  nsc    External XML namespace context, or NULL
+ * @param[in]  xpath  String with XPATH syntax. or NULL for all
+ * @param[in]  wdef   With-defaults parameter, see RFC 6243
+ * @param[out] xtop   Single return XML tree. Free with xml_free()
+ * @param[out] msdiff If set, return modules-state differences
+ * @param[out] xerr   XML error if retval is 0
+ * @retval     -1     General error, check specific clicon_errno, clicon_suberrno
+ * @retval     0      Parse OK but yang assigment not made (or only partial) and xerr set
+ * @retval     1      OK
+ * @note Use of 1 for OK
+ * @note Default values are expanded in the cache on first read and kept there, they are
+ *       updated by xmldb_put only in the edited subtrees
+ * @see xmldb_get  the generic API function
+ */
+static int
+xmldb_get_cache(clicon_handle     h,
+                const char       *db, 
+                yang_bind         yb,
+                cvec             *nsc,
+                const char       *xpath,
+                withdefaults_type wdef,
+                cxobj           **xtop,
+                modstate_diff_t  *msdiff,
+                cxobj           **xerr)
+
+{
+    int        retval = -1;
+    yang_stmt *yspec;
+    cxobj     *x0t = NULL; /* (cached) top of tree */
+    cxobj     *x0;
+    cxobj    **xvec = NULL;
+    size_t     xlen;
+    int        i;
+    cxobj     *x1t = NULL;
+    int        ret;
+
+    if ((yspec = clicon_dbspec_yang(h)) == NULL){
+        clicon_err(OE_YANG, ENOENT, "No yang spec");
+        goto done;
+    }
+    if ((ret = xmldb_cache_load(h, db, yb, &x0t, msdiff, xerr)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
     /* Here x0t looks like: <config>...</config> */
     /* Given the xpath, return a vector of matches in xvec 
      * Can we do everything in one go?
@@ -941,9 +1016,7 @@ xmldb_get_cache(clicon_handle     h,
         if (xml_apply(x1t, CX_ELMNT, (xml_applyfn_t*)xml_flag_reset, (void*)(XML_FLAG_MARK|XML_FLAG_CHANGE)) < 0)
             goto done;
     }
-    /* Original tree: Remove global defaults and empty non-presence containers */
-    if (xml_defaults_nopresence(x0t, 2) < 0)
-        goto done;
+    /* With-defaults handling is made on the copy only, ie proportional to the result */
     switch (wdef){
     case WITHDEFAULTS_REPORT_ALL:
         break;
@@ -1068,6 +1141,11 @@ xmldb_get_zerocopy(clicon_handle    h,
     } /* x0t == NULL */
     else
         x0t = de->de_xml;
+    /* Defaults are modified in place, and removed in xmldb_get0_clear.
+     * Binding is kept, a later copying read only expands defaults again, see xmldb_get_cache
+     */
+    if ((de = clicon_db_elmnt_get(h, db)) != NULL)
+        de->de_defaults = 0;
 
     /* Here xt looks like: <config>...</config> */
     if (xpath_vec(x0t, nsc, "%s", &xvec, &xlen, xpath?xpath:"/") < 0)
@@ -1335,3 +1413,468 @@ xmldb_get0_free(clicon_handle    h,
     return 0;
 }
 
+/*! Get a read-only view of a datastore cache for serialization without copying
+ *
+ * Nodes matching xpath are marked with XML_FLAG_MARK, and their ancestors with
+ * XML_FLAG_CHANGE, in the cache itself. No tree is copied.
+ * Print the view with clixon_xml2cbuf_filter() and xmldb_view_filter() and then release it
+ * with xmldb_view_clear(), before the datastore is modified.
+ * With-defaults modes supported are report-all and explicit.
+ * @param[in]  h      Clicon handle
+ * @param[in]  db     Name of datastore
+ * @param[in]  nsc    External XML namespace context, or NULL
+ * @param[in]  xpath  String with XPATH syntax. or NULL for all
+ * @param[in]  wdef   With-defaults parameter, see RFC 6243
+ * @param[out] dv     View, release with xmldb_view_clear
+ * @param[out] xerr   XML error if retval is 0
+ * @retval     1      OK
+ * @retval     0      Parse OK but yang assigment not made (or only partial) and xerr set
+ * @retval    -1      Error
+ * @code
+ *   xmldb_view dv = {0,};
+ *   if ((ret = xmldb_get_view(h, "running", nsc, "/", WITHDEFAULTS_EXPLICIT, &dv, &xerr)) < 0)
+ *      err;
+ *   if (ret == 1 && clixon_xml2cbuf_filter(cb, dv.dv_xt, 0, 0, -1, 1, xmldb_view_filter, &dv) < 0)
+ *      err;
+ *   xmldb_view_clear(&dv);
+ * @endcode
+ * @note Requires the datastore cache, see xmldb_get_cache for the copying variant
+ */
+int
+xmldb_get_view(clicon_handle     h,
+               const char       *db,
+               cvec             *nsc,
+               const char       *xpath,
+               withdefaults_type wdef,
+               xmldb_view       *dv,
+               cxobj           **xerr)
+{
+    int        retval = -1;
+    cxobj     *x0t = NULL;
+    cxobj    **xvec = NULL;
+    size_t     xlen;
+    int        i;
+    int        j;
+    int        ret;
+
+    if (dv == NULL){
+        clicon_err(OE_DB, EINVAL, "dv is NULL");
+        goto done;
+    }
+    if (clicon_datastore_cache(h) == DATASTORE_NOCACHE){
+        clicon_err(OE_DB, EINVAL, "Datastore view requires cache");
+        goto done;
+    }
+    if (wdef != WITHDEFAULTS_REPORT_ALL && wdef != WITHDEFAULTS_EXPLICIT){
+        clicon_err(OE_DB, EINVAL, "With-defaults mode not supported in datastore view");
+        goto done;
+    }
+    if ((ret = xmldb_cache_load(h, db, YB_MODULE, &x0t, NULL, xerr)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    if (xpath_vec(x0t, nsc, "%s", &xvec, &xlen, xpath?xpath:"/") < 0)
+        goto done;
+    j = 0;
+    for (i=0; i<xlen; i++){
+        /* Explicit: matching default values or non-presence containers are not selected */
+        if (wdef == WITHDEFAULTS_EXPLICIT &&
+            (ret = xml_defaults_nopresence(xvec[i], 0)) != 0){
+            if (ret < 0)
+                goto done;
+            continue;
+        }
+        xml_flag_set(xvec[i], XML_FLAG_MARK);
+        xml_apply_ancestor(xvec[i], (xml_applyfn_t*)xml_flag_set, (void*)XML_FLAG_CHANGE);
+        xvec[j++] = xvec[i];
+    }
+    dv->dv_xt = x0t;
+    dv->dv_vec = xvec;
+    dv->dv_len = j;
+    dv->dv_wdef = wdef;
+    xvec = NULL;
+    retval = 1;
+ done:
+    if (xvec)
+        free(xvec);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Filter function for printing a datastore view, see xmldb_get_view
+ *
+ * Elements below a selected node are printed according to the with-defaults mode.
+ * Elements that are not selected are printed only if they are ancestors of a selected
+ * node, or if they are the key of such a list ancestor.
+ * @param[in]  x     XML element
+ * @param[in]  arg   Datastore view (xmldb_view*)
+ * @retval     1     Print element
+ * @retval     0     Skip element and its sub-tree
+ * @retval    -1     Error
+ * @see clixon_xml2cbuf_filter
+ */
+int
+xmldb_view_filter(cxobj *x,
+                  void  *arg)
+{
+    xmldb_view *dv = (xmldb_view *)arg;
+    cxobj      *xp;
+    yang_stmt  *yp;
+    yang_stmt  *y;
+    cg_var     *cvi;
+
+    xp = xml_parent(x);
+    if (xp == dv->dv_xt && !xml_flag(xp, XML_FLAG_MARK|XML_FLAG_CHANGE))
+        return 0; /* Nothing selected */
+    if (xml_flag(xp, XML_FLAG_CHANGE) && !xml_flag(xp, XML_FLAG_MARK)){
+        /* Parent is an ancestor of a selection only */
+        if (xml_flag(x, XML_FLAG_MARK|XML_FLAG_CHANGE))
+            return 1;
+        if ((yp = xml_spec(xp)) != NULL &&
+            yang_keyword_get(yp) == Y_LIST){
+            /* Use Y_LIST cache, see ys_populate_list() */
+            cvi = NULL;
+            while ((cvi = cvec_each(yang_cvec_get(yp), cvi)) != NULL)
+                if (strcmp(xml_name(x), cv_string_get(cvi)) == 0)
+                    return 1;
+        }
+        return 0;
+    }
+    /* Parent is selected or below a selection */
+    if (dv->dv_wdef == WITHDEFAULTS_EXPLICIT){
+        if (xml_flag(x, XML_FLAG_DEFAULT))
+            return 0;
+        if ((y = xml_spec(x)) != NULL &&
+            yang_keyword_get(y) == Y_CONTAINER &&
+            yang_find(y, Y_PRESENCE, NULL) == NULL)
+            return xml_defaults_nopresence(x, 0) == 1 ? 0 : 1;
+    }
+    return 1;
+}
+
+/*! Release a datastore view, reset flags in the cache
+ *
+ * Only the selected nodes and their ancestors are visited
+ * @param[in]  dv    Datastore view, see xmldb_get_view
+ * @retval     0     OK
+ */
+int
+xmldb_view_clear(xmldb_view *dv)
+{
+    int i;
+
+    if (dv == NULL)
+        return 0;
+    for (i=0; i<dv->dv_len; i++){
+        xml_flag_reset(dv->dv_vec[i], XML_FLAG_MARK);
+        xml_apply_ancestor(dv->dv_vec[i], (xml_applyfn_t*)xml_flag_reset, (void*)XML_FLAG_CHANGE);
+    }
+    if (dv->dv_vec)
+        free(dv->dv_vec);
+    memset(dv, 0, sizeof(*dv));
+    return 0;
+}
+
+/*! Copy a datastore view into a new tree, for callers that need to modify the result
+ *
+ * The copy contains the selected nodes, their ancestors and the keys of ancestor lists,
+ * as given by xmldb_get0.
+ * @param[in]  dv    Datastore view, see xmldb_get_view
+ * @param[out] xtp   Copy of view. Free with xml_free
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+int
+xmldb_view_copy(xmldb_view *dv,
+                cxobj     **xtp)
+{
+    int    retval = -1;
+    cxobj *x1t = NULL;
+    int    i;
+
+    if ((x1t = xml_new(xml_name(dv->dv_xt), NULL, CX_ELMNT)) == NULL)
+        goto done;
+    xml_flag_set(x1t, XML_FLAG_TOP);
+    xml_spec_set(x1t, xml_spec(dv->dv_xt));
+    for (i=0; i<dv->dv_len; i++)
+        if (xml_copy_from_bottom(dv->dv_xt, dv->dv_vec[i], x1t) < 0)
+            goto done;
+    if (dv->dv_wdef == WITHDEFAULTS_EXPLICIT &&
+        xml_defaults_nopresence(x1t, 2) < 0)
+        goto done;
+    *xtp = x1t;
+    x1t = NULL;
+    retval = 0;
+ done:
+    if (x1t)
+        xml_free(x1t);
+    return retval;
+}
+
+/*! Encode the keys of a list or leaf-list entry as an opaque pagination cursor
+ *
+ * Cursor is percent-encoded key values separated by ","
+ * @param[in]  x       List or leaf-list entry
+ * @param[out] cursor  Cursor, malloced, free with free()
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see xmldb_cursor_decode
+ */
+static int
+xmldb_cursor_encode(cxobj *x,
+                    char **cursor)
+{
+    int        retval = -1;
+    yang_stmt *y;
+    cbuf      *cb = NULL;
+    cg_var    *cvi;
+    char      *enc = NULL;
+    char      *val;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    y = xml_spec(x);
+    if (yang_keyword_get(y) == Y_LEAF_LIST){
+        if (uri_percent_encode(&enc, "%s", xml_body(x)?xml_body(x):"") < 0)
+            goto done;
+        cprintf(cb, "%s", enc);
+    }
+    else {
+        cvi = NULL;
+        while ((cvi = cvec_each(yang_cvec_get(y), cvi)) != NULL) {
+            val = xml_find_body(x, cv_string_get(cvi));
+            if (uri_percent_encode(&enc, "%s", val?val:"") < 0)
+                goto done;
+            cprintf(cb, "%s%s", cbuf_len(cb)?",":"", enc);
+            free(enc);
+            enc = NULL;
+        }
+    }
+    if ((*cursor = strdup(cbuf_get(cb))) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    retval = 0;
+ done:
+    if (enc)
+        free(enc);
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Decode an opaque pagination cursor into key values of a list or leaf-list
+ *
+ * @param[in]  y       Yang of list or leaf-list
+ * @param[in]  cursor  Cursor, see xmldb_cursor_encode
+ * @param[out] cvk     Keys and values as k1=foo, k2=bar, "." for leaf-list. Free with cvec_free
+ * @retval     1       OK
+ * @retval     0       Invalid cursor
+ * @retval    -1       Error
+ */
+static int
+xmldb_cursor_decode(yang_stmt *y,
+                    char      *cursor,
+                    cvec     **cvk)
+{
+    int     retval = -1;
+    char  **vec = NULL;
+    int     nvec;
+    int     i;
+    cvec   *cvv = NULL;
+    cvec   *ycvk;
+    cg_var *cv;
+    char   *str = NULL;
+
+    if ((vec = clicon_strsep(cursor, ",", &nvec)) == NULL)
+        goto done;
+    ycvk = yang_cvec_get(y);
+    if (yang_keyword_get(y) == Y_LEAF_LIST ? nvec != 1 : nvec != cvec_len(ycvk))
+        goto fail;
+    if ((cvv = cvec_new(0)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_new");
+        goto done;
+    }
+    for (i=0; i<nvec; i++){
+        if (uri_percent_decode(vec[i], &str) < 0)
+            goto done;
+        if ((cv = cvec_add(cvv, CGV_STRING)) == NULL){
+            clicon_err(OE_UNIX, errno, "cvec_add");
+            goto done;
+        }
+        cv_name_set(cv, yang_keyword_get(y) == Y_LEAF_LIST ? "." : cv_string_get(cvec_i(ycvk, i)));
+        cv_string_set(cv, str);
+        free(str);
+        str = NULL;
+    }
+    *cvk = cvv;
+    cvv = NULL;
+    retval = 1;
+ done:
+    if (str)
+        free(str);
+    if (cvv)
+        cvec_free(cvv);
+    if (vec)
+        free(vec);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Get a view of a page of entries of a config list from the datastore cache
+ *
+ * Keyset pagination: the page starts after the entry given by an opaque cursor, or at
+ * offset, and is found using binary search in the sorted child vector of the list parent.
+ * No other entries of the list are visited. The next cursor is returned if there are
+ * entries after the page.
+ * Print and release the view as in xmldb_get_view
+ * @param[in]  h       Clicon handle
+ * @param[in]  db      Name of datastore
+ * @param[in]  nsc     External XML namespace context
+ * @param[in]  xpath   Path to list or leaf-list, no predicate in last step
+ * @param[in]  y       Yang of list or leaf-list
+ * @param[in]  wdef    With-defaults parameter, see RFC 6243
+ * @param[in]  cursor  Cursor of last seen entry, or NULL or empty string for first page
+ * @param[in]  offset  Entries to skip (after cursor if given)
+ * @param[in]  limit   Max nr of entries, 0 means unbounded
+ * @param[out] dv      View, release with xmldb_view_clear
+ * @param[out] next    Cursor of last entry if more entries exist, or NULL. Free with free()
+ * @param[out] count   Total nr of entries in list
+ * @retval     1       OK
+ * @retval     0       Invalid cursor or xpath
+ * @retval    -1       Error
+ * @see xmldb_get_view
+ */
+int
+xmldb_get_view_list(clicon_handle     h,
+                    const char       *db,
+                    cvec             *nsc,
+                    const char       *xpath,
+                    yang_stmt        *y,
+                    withdefaults_type wdef,
+                    char             *cursor,
+                    uint32_t          offset,
+                    uint32_t          limit,
+                    xmldb_view       *dv,
+                    char            **next,
+                    uint32_t         *count)
+{
+    int        retval = -1;
+    cxobj     *x0t = NULL;
+    cxobj     *xp;
+    cxobj    **xvec = NULL;
+    size_t     xlen;
+    char      *ppath = NULL;
+    char      *p;
+    cvec      *cvk = NULL;
+    int        start;
+    int        pos;
+    int        end;
+    int        last;
+    int        i;
+    int        ret;
+    int        level = 0;
+    char       quote = 0;
+
+    if (dv == NULL || xpath == NULL || y == NULL){
+        clicon_err(OE_DB, EINVAL, "dv, xpath or y is NULL");
+        goto done;
+    }
+    if (clicon_datastore_cache(h) == DATASTORE_NOCACHE){
+        clicon_err(OE_DB, EINVAL, "Datastore view requires cache");
+        goto done;
+    }
+    /* Split xpath into path to parent and last step */
+    if ((ppath = strdup(xpath)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    p = NULL;
+    for (i=0; ppath[i]; i++){
+        if (quote){
+            if (ppath[i] == quote)
+                quote = 0;
+        }
+        else if (ppath[i] == '\'' || ppath[i] == '"')
+            quote = ppath[i];
+        else if (ppath[i] == '[')
+            level++;
+        else if (ppath[i] == ']')
+            level--;
+        else if (ppath[i] == '/' && level == 0)
+            p = &ppath[i];
+    }
+    if (p == NULL || p[1] == '\0' || strchr(p, '[') != NULL)
+        goto fail;
+    *p = '\0';
+    if (cursor && strlen(cursor) && (ret = xmldb_cursor_decode(y, cursor, &cvk)) < 1){
+        if (ret < 0)
+            goto done;
+        goto fail;
+    }
+    if ((ret = xmldb_cache_load(h, db, YB_MODULE, &x0t, NULL, NULL)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    xp = x0t;
+    if (strlen(ppath)){
+        if (xpath_vec(x0t, nsc, "%s", &xvec, &xlen, ppath) < 0)
+            goto done;
+        if (xlen > 1){
+            clicon_err(OE_DB, EINVAL, "List pagination of %s: list parent is not unique", xpath);
+            goto done;
+        }
+        xp = xlen ? xvec[0] : NULL;
+    }
+    dv->dv_xt = x0t;
+    dv->dv_wdef = wdef;
+    if (count)
+        *count = 0;
+    if (next)
+        *next = NULL;
+    if (xp == NULL)
+        goto ok;
+    if (clixon_xml_find_cursor(xp, y, cvk, &start, &pos, &end) < 0)
+        goto done;
+    if (count)
+        *count = end - start;
+    pos = (end - pos > offset) ? pos + offset : end;
+    last = end;
+    if (limit && end - pos > limit)
+        end = pos + limit;
+    if (end > pos){
+        if ((dv->dv_vec = calloc(end - pos, sizeof(cxobj *))) == NULL){
+            clicon_err(OE_UNIX, errno, "calloc");
+            goto done;
+        }
+        for (i=pos; i<end; i++){
+            dv->dv_vec[dv->dv_len++] = xml_child_i(xp, i);
+            xml_flag_set(xml_child_i(xp, i), XML_FLAG_MARK);
+        }
+        xml_apply_ancestor(dv->dv_vec[0], (xml_applyfn_t*)xml_flag_set, (void*)XML_FLAG_CHANGE);
+        /* More entries after this page */
+        if (next && end < last &&
+            xmldb_cursor_encode(xml_child_i(xp, end-1), next) < 0)
+            goto done;
+    }
+ ok:
+    retval = 1;
+ done:
+    if (ppath)
+        free(ppath);
+    if (cvk)
+        cvec_free(cvk);
+    if (xvec)
+        free(xvec);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
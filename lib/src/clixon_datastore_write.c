@@ -70,6 +70,7 @@
 #include "clixon_data.h"
 #include "clixon_xpath_ctx.h"
 #include "clixon_xpath.h"
+#include "clixon_xpath_compile.h"
 #include "clixon_json.h"
 #include "clixon_nacm.h"
 #include "clixon_netconf_lib.h"
@@ -78,6 +79,7 @@
 #include "clixon_yang_schema_mount.h"
 #include "clixon_xml_nsctx.h"
 #include "clixon_xml_io.h"
+#include "clixon_xml_bin.h"
 #include "clixon_xml_default.h"
 #include "clixon_xml_map.h"
 #include "clixon_datastore.h"
@@ -287,7 +289,6 @@ check_when_condition(cxobj              *x0p,
 {
     int       retval = -1;
     char      *xpath = NULL;
-    cvec      *nsc = NULL;
     int        nr;
     yang_stmt *y = NULL;
     cbuf      *cberr = NULL;
@@ -296,13 +297,12 @@ check_when_condition(cxobj              *x0p,
     if ((y = y0) != NULL ||
         (y = (yang_stmt*)xml_spec(x1)) != NULL){
         if ((xpath = yang_when_xpath_get(y)) != NULL){ 
-            nsc = yang_when_nsc_get(y);
             x1p = xml_parent(x1);
-            if ((nr = xpath_vec_bool(x1p, nsc, "%s", xpath)) < 0) /* Try request */
+            if ((nr = xpath_prog_yang_bool(y, x1p)) < 0) /* Try request */
                 goto done;
             if (nr == 0){
                 /* Try existing tree */
-                if ((nr = xpath_vec_bool(x0p, nsc, "%s", xpath)) < 0)
+                if ((nr = xpath_prog_yang_bool(y, x0p)) < 0)
                     goto done;
                 if (nr == 0){
                     if ((cberr = cbuf_new()) == NULL){
@@ -428,6 +428,74 @@ choice_delete_other(cxobj     *x0,
     return retval;
 }
 
+/*! Check if new entries of a list can be inserted in bulk by the parent
+ *
+ * The list should be ordered by system: the entries are then placed by sorting only
+ * @param[in]  yc   Yang of child
+ * @retval     1    Yes, see xml_insert_bulk
+ * @retval     0    No
+ */
+static int
+text_modify_bulk_p(yang_stmt *yc)
+{
+    if (yc == NULL || yang_keyword_get(yc) != Y_LIST)
+        return 0;
+#ifndef STATE_ORDERED_BY_SYSTEM
+    if (yang_config_ancestor(yc) == 0)
+        return 0;
+#endif
+    if (yang_find(yc, Y_ORDERED_BY, "user") != NULL)
+        return 0;
+    return 1;
+}
+
+/*! Check if a node in the datastore cache is only a default value, ie it is not set
+ *
+ * A default leaf, or a non-presence container with only such nodes. As opposed to
+ * xml_defaults_nopresence, stop at the first set node.
+ * @param[in]  x    XML node
+ * @retval     1    Default value, not set
+ * @retval     0    Set
+ * @see text_modify_empty
+ */
+static int
+text_modify_isdefault(cxobj *x)
+{
+    yang_stmt *y;
+    cxobj     *xc;
+
+    if (xml_flag(x, XML_FLAG_DEFAULT))
+        return 1;
+    if ((y = xml_spec(x)) == NULL ||
+        yang_keyword_get(y) != Y_CONTAINER ||
+        yang_find(y, Y_PRESENCE, NULL) != NULL)
+        return 0;
+    xc = NULL;
+    while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL)
+        if (!text_modify_isdefault(xc))
+            return 0;
+    return 1;
+}
+
+/*! Check if no child of a node in the datastore cache is set, ie all are default values
+ *
+ * @param[in]  x    XML node, eg top of datastore
+ * @retval     1    Empty or only default values
+ * @retval     0    Some child is set
+ * @see text_modify_isdefault
+ */
+static int
+text_modify_empty(cxobj *x)
+{
+    cxobj *xc;
+
+    xc = NULL;
+    while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL)
+        if (!text_modify_isdefault(xc))
+            return 0;
+    return 1;
+}
+
 /*! Modify a base tree x0 with x1 with yang spec y according to operation op
  * @param[in]  h        Clicon handle
  * @param[in]  x0       Base xml tree (can be NULL in add scenarios)
@@ -441,6 +509,8 @@ choice_delete_other(cxobj     *x0,
  * @param[in]  xnacm    NACM XML tree (only if !permit)
  * @param[in]  permit   If set, no NACM tests using xnacm required
  * @param[out] cbret    Initialized cligen buffer. Contains return XML if retval is 0.
+ * @param[out] x0newp   If not NULL and a new node is created, it is not inserted in x0p but
+ *                      returned here for the caller to insert, see xml_insert_bulk
  * @retval    -1        Error
  * @retval     0        Failed (cbret set)
  * @retval     1        OK
@@ -463,7 +533,8 @@ text_modify(clicon_handle       h,
             char               *username,
             cxobj              *xnacm,
             int                 permit,
-            cbuf               *cbret)
+            cbuf               *cbret,
+            cxobj             **x0newp)
 {
     int        retval = -1;
     char      *opstr = NULL;
@@ -489,11 +560,25 @@ text_modify(clicon_handle       h,
     char      *restype;
     int        ismount = 0;
     yang_stmt *mount_yspec = NULL;
+    cxobj    **x0bulk = NULL; /* New list entries to insert in one pass */
+    int        nbulk = 0;
+    cxobj     *x0new;
+    cxobj    **x0bulkp;
 
     if (x1 == NULL){
         clicon_err(OE_XML, EINVAL, "x1 is missing");
         goto done;
     }
+    /* Default values in the datastore cache are not set: edit as if they do not exist.
+     * They are added again by xmldb_put, also if the edit fails
+     */
+    if (x0 && text_modify_isdefault(x0)){
+        if (xml_purge(x0) < 0)
+            goto done;
+        x0 = NULL;
+        xml_flag_set(x0p, XML_FLAG_CACHE_DIRTY);
+        xml_apply_ancestor(x0p, (xml_applyfn_t*)xml_flag_set, (void*)XML_FLAG_CACHE_DIRTY);
+    }
     if ((ret = check_when_condition(x0p, x1, y0, cbret)) < 0)
         goto done;
     if (ret == 0)
@@ -894,7 +979,20 @@ text_modify(clicon_handle       h,
                 if (match_base_child(x0, x1c, yc, &x0c) < 0)
                     goto done;
                 x0vec[i++] = x0c; /* != NULL if x0c is matching x1c */
+#ifdef XML_INSERT_BULK
+                if (x0c == NULL && text_modify_bulk_p(yc))
+                    nbulk++;
+#endif
             }
+#ifdef XML_INSERT_BULK
+            /* Many new list entries: insert them after the second pass in one merge */
+            if (nbulk >= XML_INSERT_BULK &&
+                (x0bulk = calloc(nbulk, sizeof(cxobj *))) == NULL){
+                clicon_err(OE_UNIX, errno, "calloc");
+                goto done;
+            }
+#endif
+            nbulk = 0;
             /* Second pass: Loop through children of the x1 modification tree again
              * Now potentially modify x0:s children 
              * Here x0vec contains one-to-one matching nodes of x1:s children.
@@ -908,6 +1006,9 @@ text_modify(clicon_handle       h,
                     if (clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT"))
                         yc = xml_spec(x1c);
                 }
+                /* New list entry is returned in x0new instead of inserted */
+                x0new = NULL;
+                x0bulkp = (x0bulk && x0c == NULL && text_modify_bulk_p(yc)) ? &x0new : NULL;
                 if (clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT")){
                     /* Check if xc is unresolved mountpoint, ie no yang mount binding yet */
                     if ((ismount = xml_yang_mount_get(h, x1c, NULL, &mount_yspec)) < 0)
@@ -918,23 +1019,34 @@ text_modify(clicon_handle       h,
                     else{
                         if ((ret = text_modify(h, x0c, x0, x0t, x1c, x1t,
                                                yc, op,
-                                               username, xnacm, permit, cbret)) < 0)
+                                               username, xnacm, permit, cbret, x0bulkp)) < 0)
                             goto done;
                     }
                 }
                 else if ((ret = text_modify(h, x0c, x0, x0t, x1c, x1t,
                                             yc, op,
-                                            username, xnacm, permit, cbret)) < 0)
+                                            username, xnacm, permit, cbret, x0bulkp)) < 0)
                     goto done;
+                if (x0new)
+                    x0bulk[nbulk++] = x0new;
                 /* If xml return - ie netconf error xml tree, then stop and return OK */
                 if (ret == 0)
                     goto fail;
             }
+            if (nbulk && xml_insert_bulk(x0, x0bulk, nbulk) < 0)
+                goto done;
+            nbulk = 0;
+            /* Defaults of children may need update, see xmldb_defaults_update */
+            xml_flag_set(x0, XML_FLAG_CACHE_DIRTY);
             if (changed){
 #ifdef XML_PARENT_CANDIDATE
                 xml_parent_candidate_set(x0, NULL);
 #endif
-                if (xml_insert(x0p, x0, insert, keystr, nscx1) < 0)
+                if (x0newp){ /* Caller inserts */
+                    *x0newp = x0;
+                    x0 = NULL;
+                }
+                else if (xml_insert(x0p, x0, insert, keystr, nscx1) < 0)
                     goto done;
             }
             break;
@@ -960,6 +1072,8 @@ text_modify(clicon_handle       h,
             break;
         } /* CONTAINER switch op */
     } /* else Y_CONTAINER  */
+    /* Defaults of children may need update, see xmldb_defaults_update */
+    xml_flag_set(x0p, XML_FLAG_CACHE_DIRTY);
     retval = 1;
  done:
     if (valstr)
@@ -979,6 +1093,11 @@ text_modify(clicon_handle       h,
         xml_purge(x0);
     if (x0vec)
         free(x0vec);
+    if (x0bulk){
+        for (i=0; i<nbulk; i++)
+            xml_purge(x0bulk[i]);
+        free(x0bulk);
+    }
     return retval;
  fail: /* cbret set */
     retval = 0;
@@ -1037,7 +1156,7 @@ text_modify_top(clicon_handle       h,
         goto fail;
     /* Special case if incoming x1t is empty, top-level only <config/> */
     if (xml_child_nr_type(x1t, CX_ELMNT) == 0){ 
-        if (xml_child_nr_type(x0t, CX_ELMNT)){ /* base tree not empty */
+        if (!text_modify_empty(x0t)){ /* base tree not empty, default values are not set */
             switch(op){ 
             case OP_DELETE:
             case OP_REMOVE:
@@ -1077,7 +1196,7 @@ text_modify_top(clicon_handle       h,
     /* Special case top-level replace */
     else if (op == OP_REPLACE || op == OP_DELETE){
         if (createstr != NULL){
-            if (xml_child_nr_type(x0t, CX_ELMNT)) /* base tree not empty */
+            if (!text_modify_empty(x0t)) /* base tree not empty */
                 clicon_data_set(h, "objectexisted", "true");
             else
                 clicon_data_set(h, "objectexisted", "false");
@@ -1131,12 +1250,14 @@ text_modify_top(clicon_handle       h,
         }
         if ((ret = text_modify(h, x0c, x0t, x0t, x1c, x1t,
                                yc, op,
-                               username, xnacm, permit, cbret)) < 0)
+                               username, xnacm, permit, cbret, NULL)) < 0)
             goto done;
         /* If xml return - ie netconf error xml tree, then stop and return OK */
         if (ret == 0)
             goto fail;
     }
+    /* Defaults of top-level may need update, see xmldb_defaults_update */
+    xml_flag_set(x0t, XML_FLAG_CACHE_DIRTY);
     // ok:
     retval = 1;
  done:
@@ -1150,6 +1271,87 @@ text_modify_top(clicon_handle       h,
     goto done;
 } /* text_modify_top */
 
+/*! Update default values in the subtrees of the datastore cache touched by an edit
+ *
+ * Only nodes marked by text_modify are visited, ie the nodes on the paths from the top
+ * to the edited nodes. On each such node, default leaves and empty non-presence containers
+ * are removed and default values are added again, which also re-evaluates when and choice.
+ * The cost is proportional to the size of the edit, not to the size of the datastore.
+ * @param[in]  x      XML node marked with XML_FLAG_CACHE_DIRTY, initially top of cache
+ * @param[in]  yspec  Top-level yang spec, for top-level defaults
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see xmldb_get_cache  where default values are expanded in the cache the first time
+ */
+static int
+xmldb_defaults_update(cxobj     *x,
+                      yang_stmt *yspec)
+{
+    int        retval = -1;
+    cxobj     *xc;
+    cxobj     *xprev;
+    yang_stmt *yc;
+
+    xml_flag_reset(x, XML_FLAG_CACHE_DIRTY);
+    xc = NULL;
+    xprev = NULL;
+    while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL) {
+        if (xml_flag(xc, XML_FLAG_CACHE_DIRTY) &&
+            xmldb_defaults_update(xc, yspec) < 0)
+            goto done;
+        if (xml_flag(xc, XML_FLAG_DEFAULT) ||
+            ((yc = xml_spec(xc)) != NULL &&
+             yang_keyword_get(yc) == Y_CONTAINER &&
+             yang_find(yc, Y_PRESENCE, NULL) == NULL &&
+             xml_child_nr_type(xc, CX_ELMNT) == 0)){
+            if (xml_purge(xc) < 0)
+                goto done;
+            xc = xprev;
+            continue;
+        }
+        xprev = xc;
+    }
+    if (xml_default_node(x, yspec, 0) < 0)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Update default values in the datastore cache after an edit
+ *
+ * If a default value is conditional on a when statement, its condition may refer to an
+ * edited node anywhere in the tree, and all default values are re-evaluated.
+ * @param[in]  x0     Top of datastore cache
+ * @param[in]  yspec  Top-level yang spec
+ * @param[in]  mode   1: update edited nodes only, 2: update whole tree, see de_defaults
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @note XML_FLAG_CACHE_DIRTY is not reset in the whole tree, only on the updated nodes
+ * @see xml_default_when
+ */
+static int
+xmldb_defaults_refresh(cxobj     *x0,
+                       yang_stmt *yspec,
+                       int        mode)
+{
+    int retval = -1;
+
+    if (mode == 2){
+        if (xml_defaults_nopresence(x0, 2) < 0)
+            goto done;
+        if (xml_default_node(x0, yspec, 0) < 0)
+            goto done;
+        if (xml_default_recurse(x0, 0) < 0)
+            goto done;
+    }
+    else if (xmldb_defaults_update(x0, yspec) < 0)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Modify database given an xml tree and an operation
  *
  * @param[in]  h      CLICON handle
@@ -1193,6 +1395,8 @@ xmldb_put(clicon_handle       h,
     cxobj      *xnacm = NULL;
     cxobj      *xmodst = NULL;
     cxobj      *x;
+    cxobj      *xw = NULL; /* Tree written to file */
+    int         defaults;
     int         permit = 0; /* nacm permit all */
     char       *format;
     cvec       *nsc = NULL; /* nacm namespace context */
@@ -1257,17 +1461,36 @@ xmldb_put(clicon_handle       h,
             xml_free(x0);
             x0 = NULL;
         }
+        /* The edit may have been partly made, keep the cache default values consistent */
+        else if (de != NULL && de->de_defaults){
+            if (xmldb_defaults_refresh(x0, yspec, de->de_defaults) < 0)
+                goto done;
+            if (xml_apply(x0, CX_ELMNT, (xml_applyfn_t*)xml_flag_reset,
+                          (void*)XML_FLAG_CACHE_DIRTY) < 0)
+                goto done;
+        }
         goto fail;
     }
 
     /* Remove NONE nodes if all subs recursively are also NONE */
     if (xml_tree_prune_flagged_sub(x0, XML_FLAG_NONE, 0, NULL) <0)
         goto done;
+    /* Cache has default values expanded: update them where edited */
+    defaults = !firsttime && de != NULL && de->de_defaults;
+    if (defaults && xmldb_defaults_refresh(x0, yspec, de->de_defaults) < 0)
+        goto done;
     if (xml_apply(x0, CX_ELMNT, (xml_applyfn_t*)xml_flag_reset, 
-                  (void*)(XML_FLAG_NONE|XML_FLAG_MARK)) < 0)
+                  (void*)(XML_FLAG_NONE|XML_FLAG_MARK|XML_FLAG_CACHE_DIRTY)) < 0)
         goto done;
+    if (defaults){
+        /* Write a copy without defaults to file, keep them in the cache */
+        if ((xw = xml_dup(x0)) == NULL)
+            goto done;
+    }
+    else
+        xw = x0;
     /* Remove global defaults and empty non-presence containers */
-    if (xml_defaults_nopresence(x0, 2) < 0)
+    if (xml_defaults_nopresence(xw, 2) < 0)
         goto done;
 #if 0 /* debug */
     if (xml_apply0(x0, -1, xml_sort_verify, NULL) < 0)
@@ -1281,7 +1504,7 @@ xmldb_put(clicon_handle       h,
             de0 = *de;
         if (de0.de_xml == NULL)
             de0.de_xml = x0;
-        de0.de_empty = (xml_child_nr(de0.de_xml) == 0);
+        de0.de_empty = (xml_child_nr(xw) == 0);
         clicon_db_elmnt_set(h, db, &de0);
     }
     if (xmldb_db2file(h, db, &dbfile) < 0)
@@ -1296,7 +1519,7 @@ xmldb_put(clicon_handle       h,
     if ((x = clicon_modst_cache_get(h, 1)) != NULL){
         if ((xmodst = xml_dup(x)) == NULL)
             goto done;
-        if (xml_addsub(x0, xmodst) < 0)
+        if (xml_addsub(xw, xmodst) < 0)
             goto done;
     }
     if ((format = clicon_option_str(h, "CLICON_XMLDB_FORMAT")) == NULL){
@@ -1309,14 +1532,20 @@ xmldb_put(clicon_handle       h,
     } 
     pretty = clicon_option_bool(h, "CLICON_XMLDB_PRETTY");
     if (strcmp(format,"json")==0){
-        if (clixon_json2file(f, x0, pretty, fprintf, 0, 0) < 0)
+        if (clixon_json2file(f, xw, pretty, fprintf, 0, 0) < 0)
             goto done;
     }
-    else if (clixon_xml2file(f, x0, 0, pretty, fprintf, 0, 0) < 0)
+    else if (strcmp(format,"binary")==0){
+        if (clixon_xml2bin_file(f, xw) < 0)
+            goto done;
+    }
+    else if (clixon_xml2file(f, xw, 0, pretty, fprintf, 0, 0) < 0)
         goto done;
     /* Remove modules state after writing to file
      */
-    if (xmodst && xml_purge(xmodst) < 0)
+    if (xw == x0 && xmodst && xml_purge(xmodst) < 0)
+        goto done;
+    if (xmldb_generation_incr(h, db) < 0)
         goto done;
     retval = 1;
  done:
@@ -1330,6 +1559,8 @@ xmldb_put(clicon_handle       h,
         free(dbfile);
     if (cb)
         cbuf_free(cb);
+    if (xw && xw != x0)
+        xml_free(xw);
     if (x0 && clicon_datastore_cache(h) == DATASTORE_NOCACHE)
         xml_free(x0);
     return retval;
@@ -1370,6 +1601,10 @@ xmldb_dump(clicon_handle   h,
         if (clixon_json2file(f, xt, pretty, fprintf, 0, 0) < 0)
             goto done;
     }
+    else if (strcmp(format,"binary")==0){
+        if (clixon_xml2bin_file(f, xt) < 0)
+            goto done;
+    }
     else if (clixon_xml2file(f, xt, 0, pretty, fprintf, 0, 0) < 0)
         goto done;
     retval = 0;
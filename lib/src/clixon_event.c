@@ -75,7 +75,7 @@
 struct event_data{
     struct event_data *e_next;     /* next in list */
     int (*e_fn)(int, void*);            /* function */
-    enum {EVENT_FD, EVENT_TIME} e_type;        /* type of event */
+    enum {EVENT_FD, EVENT_FD_WRITE, EVENT_TIME} e_type; /* type of event */
     int e_fd;                      /* File descriptor */
     struct timeval e_time;         /* Timeout */
     void *e_arg;                   /* function argument */
@@ -198,23 +198,57 @@ clixon_event_reg_fd(int   fd,
     return 0;
 }
 
-/*! Deregister a file descriptor callback
- * @param[in]  s   File descriptor
- * @param[in]  fn  Function to call when input available on fd
- * Note: deregister when exactly function and socket match, not argument
- * @see clixon_event_reg_fd
- * @see clixon_event_unreg_timeout
+/*! Register a callback function to be called when a file descriptor is writable
+ *
+ * Typically used for non-blocking sockets where a write returned EAGAIN and the
+ * remaining output is queued until the socket can accept more data.
+ * @param[in]  fd  File descriptor
+ * @param[in]  fn  Function to call when fd is writable
+ * @param[in]  arg Argument to function fn
+ * @param[in]  str Describing string for logging
+ * @see clixon_event_unreg_fd_write
+ * @see clixon_event_reg_fd for input
  */
 int
-clixon_event_unreg_fd(int   s, 
-                      int (*fn)(int, void*))
+clixon_event_reg_fd_write(int   fd, 
+                          int (*fn)(int, void*), 
+                          void *arg, 
+                          char *str)
+{
+    struct event_data *e;
+
+    if ((e = (struct event_data *)malloc(sizeof(struct event_data))) == NULL){
+        clicon_err(OE_EVENTS, errno, "malloc");
+        return -1;
+    }
+    memset(e, 0, sizeof(struct event_data));
+    strncpy(e->e_string, str, EVENT_STRLEN-1);
+    e->e_fd = fd;
+    e->e_fn = fn;
+    e->e_arg = arg;
+    e->e_type = EVENT_FD_WRITE;
+    e->e_next = ee;
+    ee = e;
+    clicon_debug(CLIXON_DBG_DETAIL, "%s, registering %s", __FUNCTION__, e->e_string);
+    return 0;
+}
+
+/*! Deregister a file descriptor callback, input or output
+ * @param[in]  s     File descriptor
+ * @param[in]  fn    Function to call when input available on fd
+ * @param[in]  type  EVENT_FD or EVENT_FD_WRITE
+ */
+static int
+clixon_event_unreg_fd_type(int   s, 
+                           int (*fn)(int, void*),
+                           int   type)
 {
     struct event_data *e, **e_prev;
     int found = 0;
 
     e_prev = &ee;
     for (e = ee; e; e = e->e_next){
-        if (fn == e->e_fn && s == e->e_fd) {
+        if (fn == e->e_fn && s == e->e_fd && e->e_type == type) {
             found++;
             *e_prev = e->e_next;
             _ee_unreg++;
@@ -226,6 +260,32 @@ clixon_event_unreg_fd(int   s,
     return found?0:-1;
 }
 
+/*! Deregister a file descriptor callback
+ * @param[in]  s   File descriptor
+ * @param[in]  fn  Function to call when input available on fd
+ * Note: deregister when exactly function and socket match, not argument
+ * @see clixon_event_reg_fd
+ * @see clixon_event_unreg_timeout
+ */
+int
+clixon_event_unreg_fd(int   s, 
+                      int (*fn)(int, void*))
+{
+    return clixon_event_unreg_fd_type(s, fn, EVENT_FD);
+}
+
+/*! Deregister a file descriptor write callback
+ * @param[in]  s   File descriptor
+ * @param[in]  fn  Function to call when fd is writable
+ * @see clixon_event_reg_fd_write
+ */
+int
+clixon_event_unreg_fd_write(int   s, 
+                            int (*fn)(int, void*))
+{
+    return clixon_event_unreg_fd_type(s, fn, EVENT_FD_WRITE);
+}
+
 /*! Call a callback function at an absolute time
  * @param[in]  t   Absolute (not relative!) timestamp when callback is called
  * @param[in]  fn  Function to call at time t
@@ -359,10 +419,12 @@ clixon_event_loop(clicon_handle h)
     struct timeval     t0;
     struct timeval     tnull = {0,};
     fd_set             fdset;
+    fd_set             wfdset;
     int                retval = -1;
 
     while (clixon_exit_get() != 1){
         FD_ZERO(&fdset);
+        FD_ZERO(&wfdset);
         if (clicon_sig_child_get()){
             /* Go through processes and wait for child processes */
             if (clixon_process_waitpid(h) < 0)
@@ -372,16 +434,18 @@ clixon_event_loop(clicon_handle h)
         for (e=ee; e; e=e->e_next)
             if (e->e_type == EVENT_FD)
                 FD_SET(e->e_fd, &fdset);
+            else if (e->e_type == EVENT_FD_WRITE)
+                FD_SET(e->e_fd, &wfdset);
         if (ee_timers != NULL){
             gettimeofday(&t0, NULL);
             timersub(&ee_timers->e_time, &t0, &t); 
             if (t.tv_sec < 0)
-                n = select(FD_SETSIZE, &fdset, NULL, NULL, &tnull); 
+                n = select(FD_SETSIZE, &fdset, &wfdset, NULL, &tnull); 
             else
-                n = select(FD_SETSIZE, &fdset, NULL, NULL, &t); 
+                n = select(FD_SETSIZE, &fdset, &wfdset, NULL, &t); 
         }
         else
-            n = select(FD_SETSIZE, &fdset, NULL, NULL, NULL);
+            n = select(FD_SETSIZE, &fdset, &wfdset, NULL, NULL);
         if (clixon_exit_get() == 1){
             break;
         }
@@ -436,7 +500,8 @@ clixon_event_loop(clicon_handle h)
                 break;
             }
             e_next = e->e_next;
-            if(e->e_type == EVENT_FD && FD_ISSET(e->e_fd, &fdset)){
+            if ((e->e_type == EVENT_FD && FD_ISSET(e->e_fd, &fdset)) ||
+                (e->e_type == EVENT_FD_WRITE && FD_ISSET(e->e_fd, &wfdset))){
                 clicon_debug(CLIXON_DBG_DETAIL, "%s: FD_ISSET: %s", __FUNCTION__, e->e_string);
                 if ((*e->e_fn)(e->e_fd, e->e_arg) < 0){
                     clicon_debug(1, "%s Error in: %s", __FUNCTION__, e->e_string);
@@ -347,3 +347,80 @@ clicon_file_cbuf(const char *filename,
         errno = err;
     return retval;
 }
+
+/*! Read remaining content of an open file into a malloced buffer
+ *
+ * A regular file is read with a single buffer allocated from its size, other files, such
+ * as pipes, are read in large blocks.
+ * The buffer is terminated with two null characters so that it can be scanned in place by
+ * a flex scanner (yy_scan_buffer).
+ * @param[in]   fp    Open file
+ * @param[out]  bufp  Malloced buffer, free after use
+ * @param[out]  lenp  Length of content, excluding the null characters
+ * @retval 0    OK
+ * @retval -1   Error
+ * @code
+ *   char  *buf = NULL;
+ *   size_t len;
+ *   if (clicon_file_read(fp, &buf, &len) < 0)
+ *      err;
+ *   free(buf);
+ * @endcode
+ */
+int
+clicon_file_read(FILE   *fp,
+                 char  **bufp,
+                 size_t *lenp)
+{
+    int         retval = -1;
+    char       *buf = NULL;
+    char       *buf1;
+    size_t      buflen = 65536; /* start size for non-regular files */
+    size_t      len = 0;
+    size_t      n;
+    struct stat st;
+    off_t       pos;
+
+    if (fp == NULL || bufp == NULL || lenp == NULL){
+        clicon_err(OE_UNIX, EINVAL, "arg is NULL");
+        goto done;
+    }
+    if (fstat(fileno(fp), &st) == 0 &&
+        S_ISREG(st.st_mode) &&
+        (pos = ftello(fp)) >= 0 &&
+        st.st_size > pos)
+        buflen = st.st_size - pos + 1; /* +1 to detect EOF without realloc */
+    if ((buf = malloc(buflen + 2)) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    while (1){
+        n = fread(buf + len, 1, buflen - len, fp);
+        len += n;
+        if (len < buflen){
+            if (ferror(fp)){
+                clicon_err(OE_UNIX, errno, "fread");
+                goto done;
+            }
+            if (feof(fp))
+                break;
+            continue;
+        }
+        buflen *= 2;
+        if ((buf1 = realloc(buf, buflen + 2)) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            goto done;
+        }
+        buf = buf1;
+    }
+    buf[len] = '\0';
+    buf[len+1] = '\0';
+    *bufp = buf;
+    buf = NULL;
+    *lenp = len;
+    retval = 0;
+ done:
+    if (buf)
+        free(buf);
+    return retval;
+}
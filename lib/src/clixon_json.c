@@ -75,6 +75,7 @@
 #include "clixon_xml_nsctx.h" /* namespace context */
 #include "clixon_netconf_lib.h"
 #include "clixon_json.h"
+#include "clixon_file.h"
 #include "clixon_json_parse.h"
 
 /* Let xml2json_cbuf_vec() return json array: [a,b].
@@ -82,9 +83,6 @@
 */
 #define VEC_ARRAY 1
 
-/* Size of json read buffer when reading from file*/
-#define BUFLEN 1024
-
 /* Name of xml top object created by parse functions */
 #define JSON_TOP_SYMBOL "top"
 
@@ -1389,6 +1387,8 @@ json_xmlns_translate(yang_stmt *yspec,
  * are split and interpreted as in RFC7951
  *
  * @param[in]  str    Input string containing JSON
+ * @param[in]  len    If > 0, str is a buffer of len characters terminated by two null
+ *                    characters, scanned in place
  * @param[in]  rfc7951 Do sanity checks according to RFC 7951 JSON Encoding of Data Modeled with YANG
  * @param[in]  yb     How to bind yang to XML top-level when parsing (if rfc7951)
  * @param[in]  yspec  Yang specification (if rfc 7951)
@@ -1404,6 +1404,7 @@ json_xmlns_translate(yang_stmt *yspec,
  */
 static int 
 _json_parse(char      *str, 
+            size_t     len,
             int        rfc7951,
             yang_bind  yb,
             yang_stmt *yspec,
@@ -1420,6 +1421,8 @@ _json_parse(char      *str,
     
     clicon_debug(1, "%s %d %s", __FUNCTION__, yb, str);
     jy.jy_parse_string = str;
+    if (len) /* Scan buffer in place */
+        jy.jy_parse_len = len + 2;
     jy.jy_linenum = 1;
     jy.jy_current = xt;
     jy.jy_xtop = xt;
@@ -1556,7 +1559,7 @@ clixon_json_parse_string(char      *str,
         if ((*xt = xml_new("top", NULL, CX_ELMNT)) == NULL)
             return -1;
     }
-    return _json_parse(str, rfc7951, yb, yspec, *xt, xerr);
+    return _json_parse(str, 0, rfc7951, yb, yspec, *xt, xerr);
 }
 
 /*! Read a JSON definition from file and parse it into a parse-tree. 
@@ -1606,51 +1609,23 @@ clixon_json_parse_file(FILE      *fp,
     int       retval = -1;
     int       ret;
     char     *jsonbuf = NULL;
-    int       jsonbuflen = BUFLEN; /* start size */
-    int       oldjsonbuflen;
-    char     *ptr;
-    char      ch;
-    int       len = 0;
+    size_t    len = 0;
 
     if (xt==NULL){
         clicon_err(OE_JSON, EINVAL, "xt is NULL");
         return -1;
     }
-    if ((jsonbuf = malloc(jsonbuflen)) == NULL){
-        clicon_err(OE_JSON, errno, "malloc");
+    /* Read whole file and scan it in place */
+    if (clicon_file_read(fp, &jsonbuf, &len) < 0)
         goto done;
-    }
-    memset(jsonbuf, 0, jsonbuflen);
-    ptr = jsonbuf;
-    while (1){
-        if ((ret = fread(&ch, 1, 1, fp)) < 0){
-            clicon_err(OE_JSON, errno, "read");
-            break;
-        }
-        if (ret != 0)
-            jsonbuf[len++] = ch;
-        if (ret == 0){
-            if (*xt == NULL)
-                if ((*xt = xml_new(JSON_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
-                    goto done;
-            if (len){
-                if ((ret = _json_parse(ptr, rfc7951, yb, yspec, *xt, xerr)) < 0)
-                    goto done;
-                if (ret == 0)
-                    goto fail;
-            }
-            break;
-        }
-        if (len >= jsonbuflen-1){ /* Space: one for the null character */
-            oldjsonbuflen = jsonbuflen;
-            jsonbuflen *= 2;
-            if ((jsonbuf = realloc(jsonbuf, jsonbuflen)) == NULL){
-                clicon_err(OE_JSON, errno, "realloc");
-                goto done;
-            }
-            memset(jsonbuf+oldjsonbuflen, 0, jsonbuflen-oldjsonbuflen);
-            ptr = jsonbuf;
-        }
+    if (*xt == NULL)
+        if ((*xt = xml_new(JSON_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+            goto done;
+    if (len){
+        if ((ret = _json_parse(jsonbuf, len, rfc7951, yb, yspec, *xt, xerr)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
     }
     retval = 1;
  done:
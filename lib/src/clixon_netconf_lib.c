@@ -71,6 +71,8 @@
 #include "clixon_xml_io.h"
 #include "clixon_xpath_ctx.h"
 #include "clixon_xpath.h"
+#include "clixon_xpath_optimize.h"
+#include "clixon_xpath_compile.h"
 #include "clixon_yang_module.h"
 #include "clixon_yang_parse_lib.h"
 #include "clixon_plugin.h"
@@ -1615,6 +1617,13 @@ netconf_module_load(clicon_handle h)
     /* Make message-id attribute optional */
     if (clicon_option_bool(h, "CLICON_NETCONF_MESSAGE_ID_OPTIONAL") == 1)
         xml_bind_netconf_message_id_optional(1);
+    /* Use hand-written XML tokenizer */
+    if (clicon_option_bool(h, "CLICON_XML_PARSE_FAST") == 1)
+        xml_parse_fast(1);
+    /* Automatic search indexes for xpath list filters on non-key leafs */
+    xpath_auto_index_set(clicon_option_int(h, "CLICON_XPATH_AUTO_INDEX"));
+    /* Compiled xpath for yang must and when */
+    xpath_compile_enable(clicon_option_bool(h, "CLICON_XPATH_COMPILE"));
     /* Load ietf list pagination */
     if (yang_spec_parse_module(h, "ietf-list-pagination", NULL, yspec)< 0)
         goto done;
@@ -2344,3 +2353,82 @@ netconf_input_chunked_framing(char    ch,
     goto done;
 }
 
+/*! Frame a block of input with chunked framing, RFC6242 Sec 4.2, incrementally
+ *
+ * Chunk-data is appended to the message buffer in one block per chunk, or per input block
+ * if the chunk is split over several reads, instead of character by character.
+ * Framing characters are handled by netconf_input_chunked_framing.
+ * Null characters are skipped (eg from terminals)
+ * @param[in]     buf    Input block
+ * @param[in]     len    Length of buf
+ * @param[in,out] state  State machine state, see netconf_input_chunked_framing
+ * @param[in,out] size   Remaining expecting chunk bytes.
+ * @param[in]     cb     Message buffer, chunk-data is appended
+ * @param[out]    np     Number of characters of buf consumed
+ * @retval        1      End-of-frame, message in cb, rest of buf is not consumed
+ * @retval        0      All of buf consumed, no end-of-frame
+ * @retval       -1      Error
+ * @code
+ *   while (len > 0){
+ *      if ((ret = netconf_input_chunked_buf(buf, len, &state, &size, cb, &n)) < 0)
+ *         err;
+ *      buf += n; len -= n;
+ *      if (ret == 1){
+ *         # message in cb
+ *         cbuf_reset(cb);
+ *      }
+ *   }
+ * @endcode
+ */
+int
+netconf_input_chunked_buf(char   *buf,
+                          size_t  len,
+                          int    *state,
+                          size_t *size,
+                          cbuf   *cb,
+                          size_t *np)
+{
+    int     retval = -1;
+    size_t  i = 0;
+    size_t  n;
+    char   *p;
+    int     ret;
+
+    while (i < len){
+        if (*state == 4 && *size > 0){ /* chunk-data */
+            n = len - i;
+            if (n > *size)
+                n = *size;
+            if ((p = memchr(buf + i, '\0', n)) != NULL)
+                n = p - (buf + i);
+            if (n > 0){
+                if (cbuf_append_buf(cb, buf + i, n) < 0){
+                    clicon_err(OE_UNIX, errno, "cbuf_append_buf");
+                    goto done;
+                }
+                *size -= n;
+                i += n;
+            }
+            if (p != NULL)
+                i++;
+            continue;
+        }
+        if (buf[i] == '\0'){
+            i++;
+            continue;
+        }
+        if ((ret = netconf_input_chunked_framing(buf[i], state, size)) < 0)
+            goto done;
+        i++;
+        if (ret == 2){ /* end-of-frame */
+            *np = i;
+            retval = 1;
+            goto done;
+        }
+    }
+    *np = i;
+    retval = 0;
+ done:
+    return retval;
+}
+
@@ -42,6 +42,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <ctype.h>
 #include <errno.h>
 #include <signal.h>
 #include <dlfcn.h>
@@ -50,6 +51,7 @@
 #include <unistd.h>
 #include <termios.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/param.h>
 
 /* cligen */
@@ -109,14 +111,33 @@ typedef struct {
     char             *uc_namespace; /* Module namespace */
 } upgrade_callback_t;
 
+/*
+ * Cached state of a state data callback for a requested xpath
+ */
+struct statedata_cache {
+    qelem_t         ce_qelem;     /* List header */
+    char           *ce_xpath;     /* Canonical xpath of request */
+    cxobj          *ce_x;         /* Cached state tree: <config>... */
+    struct timeval  ce_expire;    /* Expiry time of entry */
+};
+
+/* Max number of cached xpaths per state data callback */
+#define STATEDATA_CACHE_MAX 64
+
+/* Forward */
+static int statedata_cache_clear(statedata_callback_t *sc);
+
 /* Internal struct for accessing plugin list and rpc list. This handle is accessed
  * via clixon-handle "cdata" structure (see clixon_data.h) using the key "clixon-plugin-handle"."
  * It is just a way to avoid using global variables
  */
 struct plugin_module_struct {
     clixon_plugin_t    *ms_plugin_list;
+    clicon_hash_t      *ms_plugin_hash;   /* Plugin by name, see clixon_plugin_find */
     rpc_callback_t     *ms_rpc_callbacks;
+    clicon_hash_t      *ms_rpc_hash;      /* Vector of RPC callbacks by namespace and name */
     upgrade_callback_t *ms_upgrade_callbacks;
+    statedata_callback_t *ms_statedata_callbacks;
 };
 typedef struct plugin_module_struct plugin_module_struct;
 
@@ -281,21 +302,44 @@ clixon_plugin_t *
 clixon_plugin_find(clicon_handle h,
                    const char   *name)
 {
-    clixon_plugin_t      *cp = NULL;
     plugin_module_struct *ms = plugin_module_struct_get(h);
+    void                 *p;
 
     if (ms == NULL){
         clicon_err(OE_PLUGIN, EINVAL, "plugin module not initialized");
         return NULL;
     }
-    if ((cp = ms->ms_plugin_list) != NULL){
-        do {
-            if (strcmp(cp->cp_name, name) == 0)
-                return cp;
-            cp = NEXTQ(clixon_plugin_t *, cp);
-        } while (cp && cp != ms->ms_plugin_list);
-    }
-    return NULL;
+    if (ms->ms_plugin_hash == NULL)
+        return NULL;
+    if ((p = clicon_hash_value(ms->ms_plugin_hash, name, NULL)) == NULL)
+        return NULL;
+    return *(clixon_plugin_t **)p;
+}
+
+/*! Append plugin to plugin list and add it to the name hash
+ *
+ * If several plugins have the same name, the first is found by clixon_plugin_find
+ * @param[in]  ms   Plugin module struct
+ * @param[in]  cp   Clixon plugin
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+static int
+plugin_add(plugin_module_struct *ms,
+           clixon_plugin_t      *cp)
+{
+    int retval = -1;
+
+    ADDQ(cp, ms->ms_plugin_list);
+    if (ms->ms_plugin_hash == NULL &&
+        (ms->ms_plugin_hash = clicon_hash_init()) == NULL)
+        goto done;
+    if (clicon_hash_lookup(ms->ms_plugin_hash, cp->cp_name) == NULL &&
+        clicon_hash_add(ms->ms_plugin_hash, cp->cp_name, &cp, sizeof(cp)) == NULL)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
 }
 
 /*! Load a dynamic plugin object and call its init-function
@@ -432,7 +476,8 @@ clixon_plugins_load(clicon_handle h,
             goto done;
         if (ret == 0)
             continue;
-        ADDQ(cp, ms->ms_plugin_list);
+        if (plugin_add(ms, cp) < 0)
+            goto done;
     }
     retval = 0;
 done:
@@ -476,7 +521,10 @@ clixon_pseudo_plugin(clicon_handle     h,
     }
     memset(cp, 0, sizeof(struct clixon_plugin));
     snprintf(cp->cp_name, sizeof(cp->cp_name), "%*s", (int)strlen(name), name);
-    ADDQ(cp, ms->ms_plugin_list);
+    if (plugin_add(ms, cp) < 0){
+        cp = NULL; /* In list, freed at exit */
+        goto done;
+    }
     *cpp = cp;
     cp = NULL;
     retval = 0;
@@ -773,6 +821,10 @@ clixon_plugin_exit_all(clicon_handle h)
                 goto done;
             free(cp);
         }
+        if (ms->ms_plugin_hash){
+            clicon_hash_free(ms->ms_plugin_hash);
+            ms->ms_plugin_hash = NULL;
+        }
     }
     retval = 0;
  done:
@@ -1158,6 +1210,78 @@ rpc_callback_dump(clicon_handle h)
 }
 #endif
 
+/*! Make hash key of RPC callback from namespace and name
+ *
+ * @param[in]  ns      Namespace
+ * @param[in]  name    RPC name
+ * @param[in]  buf     Buffer for key
+ * @param[in]  buflen  Length of buf
+ * @retval     key     Key, either buf or malloced if it does not fit in buf
+ * @retval     NULL    Error
+ */
+static char *
+rpc_callback_key(const char *ns,
+                 const char *name,
+                 char       *buf,
+                 size_t      buflen)
+{
+    size_t len;
+    char  *key = buf;
+
+    len = strlen(ns) + strlen(name) + 2;
+    if (len > buflen && (key = malloc(len)) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        return NULL;
+    }
+    snprintf(key, len, "%s %s", ns, name); /* namespace uri cannot contain space */
+    return key;
+}
+
+/*! Add RPC callback to its namespace and name vector of the RPC hash
+ *
+ * Callbacks are kept in registration order, which is the order they are called
+ * @param[in]  ms   Plugin module struct
+ * @param[in]  rc   RPC callback
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @see rpc_callback_call
+ */
+static int
+rpc_callback_hash_add(plugin_module_struct *ms,
+                      rpc_callback_t       *rc)
+{
+    int              retval = -1;
+    char             buf[128];
+    char            *key = NULL;
+    clicon_hash_t    he;
+    rpc_callback_t **vec = NULL;
+    size_t           len = 0;
+
+    if (ms->ms_rpc_hash == NULL &&
+        (ms->ms_rpc_hash = clicon_hash_init()) == NULL)
+        goto done;
+    if ((key = rpc_callback_key(rc->rc_namespace, rc->rc_name, buf, sizeof(buf))) == NULL)
+        goto done;
+    if ((he = clicon_hash_lookup(ms->ms_rpc_hash, key)) != NULL)
+        len = he->h_vlen;
+    if ((vec = malloc(len + sizeof(rc))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    if (len)
+        memcpy(vec, he->h_val, len);
+    vec[len/sizeof(rc)] = rc;
+    if (clicon_hash_add(ms->ms_rpc_hash, key, vec, len + sizeof(rc)) == NULL)
+        goto done;
+    retval = 0;
+ done:
+    if (vec)
+        free(vec);
+    if (key && key != buf)
+        free(key);
+    return retval;
+}
+
 /*! Register a RPC callback by appending a new RPC to a global list
  *
  * @param[in]  h         clicon handle
@@ -1197,6 +1321,12 @@ rpc_callback_register(clicon_handle  h,
     rc->rc_arg  = arg;
     rc->rc_namespace  = strdup(ns);
     rc->rc_name  = strdup(name);
+    if (rc->rc_namespace == NULL || rc->rc_name == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    if (rpc_callback_hash_add(ms, rc) < 0)
+        goto done;
     ADDQ(rc, ms->ms_rpc_callbacks);
     return 0;
  done:
@@ -1218,7 +1348,7 @@ rpc_callback_delete_all(clicon_handle h)
     rpc_callback_t *rc;
     plugin_module_struct *ms = plugin_module_struct_get(h);
 
-    if (ms != NULL)
+    if (ms != NULL){
         while((rc = ms->ms_rpc_callbacks) != NULL) {
             DELQ(rc, ms->ms_rpc_callbacks, rpc_callback_t *);
             if (rc->rc_namespace)
@@ -1227,6 +1357,11 @@ rpc_callback_delete_all(clicon_handle h)
                 free(rc->rc_name);
             free(rc);
         }
+        if (ms->ms_rpc_hash){
+            clicon_hash_free(ms->ms_rpc_hash);
+            ms->ms_rpc_hash = NULL;
+        }
+    }
     return 0;
 }
 
@@ -1244,6 +1379,7 @@ rpc_callback_delete_all(clicon_handle h)
  * @note that several callbacks can be registered. They need to cooperate on
  * return values, ie if one writes cbret, the other needs to handle that by
  * leaving it, replacing it or amending it.
+ * @note Callbacks are looked up by namespace and name in a hash, not by scanning all
  */
 int
 rpc_callback_call(clicon_handle h,
@@ -1261,6 +1397,10 @@ rpc_callback_call(clicon_handle h,
     plugin_module_struct *ms = plugin_module_struct_get(h);
     void                 *wh;
     int                   ret;
+    char                  buf[128];
+    char                 *key = NULL;
+    clicon_hash_t         he = NULL;
+    size_t                i;
 
     if (ms == NULL){
         clicon_err(OE_PLUGIN, EINVAL, "plugin module not initialized");
@@ -1269,26 +1409,27 @@ rpc_callback_call(clicon_handle h,
     name = xml_name(xe);
     prefix = xml_prefix(xe);
     xml2ns(xe, prefix, &ns);
-    if ((rc = ms->ms_rpc_callbacks) != NULL)
-        do {
-            if (strcmp(rc->rc_name, name) == 0 &&
-                ns && rc->rc_namespace &&
-                strcmp(rc->rc_namespace, ns) == 0){
-                wh = NULL;
-                if (plugin_context_check(h, &wh, rc->rc_name, __FUNCTION__) < 0)
-                    goto done;
-                if (rc->rc_callback(h, xe, cbret, arg, rc->rc_arg) < 0){
-                    clicon_debug(1, "%s Error in: %s", __FUNCTION__, rc->rc_name);
-                    if (plugin_context_check(h, &wh, rc->rc_name, __FUNCTION__) < 0)
-                        goto done;
-                    goto done;
-                }
-                nr++;
-                if (plugin_context_check(h, &wh, rc->rc_name, __FUNCTION__) < 0)
-                    goto done;
-            }
-            rc = NEXTQ(rpc_callback_t *, rc);
-        } while (rc != ms->ms_rpc_callbacks);
+    if (ns && ms->ms_rpc_hash){
+        if ((key = rpc_callback_key(ns, name, buf, sizeof(buf))) == NULL)
+            goto done;
+        he = clicon_hash_lookup(ms->ms_rpc_hash, key);
+    }
+    /* Vector is read from the hash entry each turn since a callback may register more */
+    for (i = 0; he && i < he->h_vlen/sizeof(rc); i++){
+        rc = ((rpc_callback_t **)he->h_val)[i];
+        wh = NULL;
+        if (plugin_context_check(h, &wh, rc->rc_name, __FUNCTION__) < 0)
+            goto done;
+        if (rc->rc_callback(h, xe, cbret, arg, rc->rc_arg) < 0){
+            clicon_debug(1, "%s Error in: %s", __FUNCTION__, rc->rc_name);
+            if (plugin_context_check(h, &wh, rc->rc_name, __FUNCTION__) < 0)
+                goto done;
+            goto done;
+        }
+        nr++;
+        if (plugin_context_check(h, &wh, rc->rc_name, __FUNCTION__) < 0)
+            goto done;
+    }
     /* action reply checked in action_callback_call */
     if (nr && !xml_rpc_isaction(xe)){
         if ((ret = rpc_reply_check(h, name, cbret)) < 0)
@@ -1301,6 +1442,8 @@ rpc_callback_call(clicon_handle h,
     retval = 1; /* 0: none found, >0 nr of handlers called */
  done:
     clicon_debug(CLIXON_DBG_DETAIL, "%s retval:%d", __FUNCTION__, retval);
+    if (key && key != buf)
+        free(key);
     return retval;
  fail:
     retval = 0;
@@ -1567,6 +1710,538 @@ upgrade_callback_call(clicon_handle h,
     goto done;
 }
 
+/*--------------------------------------------------------------------
+ * State data callbacks routed on YANG schema subtree
+ */
+
+/*! Parse an absolute schema path on the form /module:name/name into steps
+ *
+ * @param[in]  path   Schema path, a step without prefix inherits the module of its parent
+ * @param[out] cvp    Steps: name is module name, value is node name. Free with cvec_free
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+statedata_path_parse(const char *path,
+                     cvec      **cvp)
+{
+    int     retval = -1;
+    cvec   *cvv = NULL;
+    char  **vec = NULL;
+    int     nvec;
+    int     i;
+    char   *prefix = NULL;
+    char   *id = NULL;
+    char   *module = NULL;
+    cg_var *cv;
+
+    if (path == NULL || path[0] != '/'){
+        clicon_err(OE_PLUGIN, EINVAL, "State data path %s is not absolute", path?path:"NULL");
+        goto done;
+    }
+    if ((cvv = cvec_new(0)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_new");
+        goto done;
+    }
+    if ((vec = clicon_strsep((char*)path, "/", &nvec)) == NULL)
+        goto done;
+    for (i=1; i<nvec; i++){ /* vec[0] is empty (absolute path) */
+        if (strlen(vec[i]) == 0)
+            continue;
+        if (nodeid_split(vec[i], &prefix, &id) < 0)
+            goto done;
+        if (prefix != NULL){
+            if (module)
+                free(module);
+            module = prefix;
+            prefix = NULL;
+        }
+        if (module == NULL){
+            clicon_err(OE_PLUGIN, EINVAL, "State data path %s: first step lacks module name", path);
+            goto done;
+        }
+        if ((cv = cvec_add(cvv, CGV_STRING)) == NULL){
+            clicon_err(OE_UNIX, errno, "cvec_add");
+            goto done;
+        }
+        if (cv_name_set(cv, module) == NULL ||
+            cv_string_set(cv, id) == NULL){
+            clicon_err(OE_UNIX, errno, "cv_string_set");
+            goto done;
+        }
+        free(id);
+        id = NULL;
+    }
+    *cvp = cvv;
+    cvv = NULL;
+    retval = 0;
+ done:
+    if (prefix)
+        free(prefix);
+    if (id)
+        free(id);
+    if (module)
+        free(module);
+    if (vec)
+        free(vec);
+    if (cvv)
+        cvec_free(cvv);
+    return retval;
+}
+
+/*! Register a state data callback for a YANG schema subtree
+ *
+ * As opposed to the ca_statedata plugin callback which is called on every get request,
+ * a registered callback is only called if the requested xpath intersects the subtree.
+ * The subtree is given as an absolute schema-node-identifier using module names as
+ * prefixes, where a step without prefix inherits the module of its parent, eg:
+ *   /ietf-interfaces:interfaces-state/interface
+ * If ttl is non-zero, the state returned by the callback is cached per requested xpath and
+ * reused by subsequent requests during ttl milliseconds.
+ * @param[in]  h      Clicon handle
+ * @param[in]  cb     State data callback
+ * @param[in]  fnstr  Stringified function for debug
+ * @param[in]  path   Schema path of subtree provided by the callback
+ * @param[in]  ttl    Time-to-live of cached state in milliseconds, 0 means no caching
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see statedata_callback_match       which matches an xpath against the subtree
+ * @see statedata_callback_invalidate  which invalidates cached state
+ */
+int
+statedata_callback_reg_fn(clicon_handle   h,
+                          plgstatedata_t *cb,
+                          const char     *fnstr,
+                          const char     *path,
+                          uint32_t        ttl)
+{
+    int                   retval = -1;
+    statedata_callback_t *sc = NULL;
+    plugin_module_struct *ms = plugin_module_struct_get(h);
+
+    if (ms == NULL){
+        clicon_err(OE_PLUGIN, EINVAL, "plugin module not initialized");
+        goto done;
+    }
+    if ((sc = malloc(sizeof(statedata_callback_t))) == NULL) {
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(sc, 0, sizeof(*sc));
+    sc->sc_callback = cb;
+    sc->sc_fnstr = fnstr;
+    sc->sc_ttl = ttl;
+    if (statedata_path_parse(path, &sc->sc_steps) < 0)
+        goto done;
+    if ((sc->sc_path = strdup(path)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    ADDQ(sc, ms->ms_statedata_callbacks);
+    sc = NULL;
+    retval = 0;
+ done:
+    if (sc){
+        if (sc->sc_path)
+            free(sc->sc_path);
+        if (sc->sc_steps)
+            cvec_free(sc->sc_steps);
+        free(sc);
+    }
+    return retval;
+}
+
+/*! Delete all state data callbacks
+ */
+static int
+statedata_callback_delete_all(clicon_handle h)
+{
+    statedata_callback_t *sc;
+    plugin_module_struct *ms = plugin_module_struct_get(h);
+
+    if (ms != NULL)
+        while((sc = ms->ms_statedata_callbacks) != NULL) {
+            DELQ(sc, ms->ms_statedata_callbacks, statedata_callback_t *);
+            statedata_cache_clear(sc);
+            if (sc->sc_path)
+                free(sc->sc_path);
+            if (sc->sc_steps)
+                cvec_free(sc->sc_steps);
+            free(sc);
+        }
+    return 0;
+}
+
+/*! Iterator over registered state data callbacks
+ *
+ * @param[in]  h       Clicon handle
+ * @param[in]  scprev  Previous callback, or NULL on init
+ * @retval     sc      Next state data callback
+ * @retval     NULL    No more callbacks
+ * @code
+ *   statedata_callback_t *sc = NULL;
+ *   while ((sc = statedata_callback_each(h, sc)) != NULL) {
+ *     ...
+ *   }
+ * @endcode
+ */
+statedata_callback_t *
+statedata_callback_each(clicon_handle         h,
+                        statedata_callback_t *scprev)
+{
+    plugin_module_struct *ms = plugin_module_struct_get(h);
+    statedata_callback_t *sc;
+
+    if (ms == NULL || ms->ms_statedata_callbacks == NULL)
+        return NULL;
+    if (scprev == NULL)
+        return ms->ms_statedata_callbacks;
+    sc = NEXTQ(statedata_callback_t *, scprev);
+    if (sc == ms->ms_statedata_callbacks)
+        return NULL;
+    return sc;
+}
+
+/*! Match one location path (no unions) against the registered subtree
+ *
+ * Walk the child steps of the location path in parallel with the registered steps.
+ * Predicates are skipped. Any construct not understood stops the walk with a match.
+ * @param[in]  sc     State data callback
+ * @param[in]  yspec  Yang spec
+ * @param[in]  nsc    Namespace context of xpath
+ * @param[in]  s      Location path, will be modified
+ * @retval     1      Match or undecidable
+ * @retval     0      No match: xpath and registered subtree are disjoint
+ */
+static int
+statedata_match_path(statedata_callback_t *sc,
+                     yang_stmt            *yspec,
+                     cvec                 *nsc,
+                     char                 *s)
+{
+    cg_var    *cv = NULL;
+    char      *start;
+    char      *local;
+    char      *prefix;
+    char      *ns;
+    char      *ns1;
+    yang_stmt *ymod;
+    int        depth;
+    char       q;
+    size_t     len;
+
+    while (isspace(*s))
+        s++;
+    /* Relative paths, functions, parent and other axes are undecidable */
+    if (*s != '/' || strstr(s, "..") != NULL || strstr(s, "::") != NULL)
+        return 1;
+    while (*s == '/'){
+        s++;
+        start = s;
+        while (*s && *s != '[' && *s != '/' && !isspace(*s))
+            s++;
+        len = s - start;
+        if (len == 0) /* "/" or "//" */
+            return 1;
+        if (memchr(start, '*', len) || memchr(start, '(', len) ||
+            *start == '.' || *start == '@')
+            return 1;
+        /* Skip predicates */
+        depth = 0;
+        q = 0;
+        while (*s){
+            if (q){
+                if (*s == q)
+                    q = 0;
+            }
+            else if (*s == '\'' || *s == '"')
+                q = *s;
+            else if (*s == '[')
+                depth++;
+            else if (*s == ']')
+                depth--;
+            else if (depth == 0 && !isspace(*s))
+                break;
+            s++;
+        }
+        if ((cv = cvec_next(sc->sc_steps, cv)) == NULL)
+            return 1; /* xpath points into the registered subtree */
+        if ((local = memchr(start, ':', len)) != NULL){
+            *local++ = '\0';
+            prefix = start;
+        }
+        else {
+            local = start;
+            prefix = NULL;
+        }
+        len -= local - start;
+        if (strlen(cv_string_get(cv)) != len || strncmp(cv_string_get(cv), local, len) != 0)
+            return 0;
+        if (nsc == NULL || (ns = xml_nsctx_get(nsc, prefix)) == NULL)
+            return 1;
+        if ((ymod = yang_find_module_by_name(yspec, cv_name_get(cv))) == NULL ||
+            (ns1 = yang_find_mynamespace(ymod)) == NULL)
+            return 1;
+        if (strcmp(ns, ns1) != 0)
+            return 0;
+    }
+    return 1; /* xpath is an ancestor of (or equal to) registered subtree */
+}
+
+/*! Check if the subtree of a state data callback intersects a canonical xpath
+ *
+ * Intersect means that one of the paths is a prefix of the other, ie the xpath selects
+ * a node above, at or in the registered subtree.
+ * The match is conservative: an xpath which cannot be analyzed matches all subtrees.
+ * @param[in]  sc     State data callback
+ * @param[in]  yspec  Yang spec, for resolving module names of registered subtree
+ * @param[in]  nsc    Namespace context of xpath
+ * @param[in]  xpath  Canonical xpath, see xpath2canonical, or NULL for all
+ * @retval     1      Intersect: make the callback
+ * @retval     0      Disjoint: skip the callback
+ * @retval    -1      Error
+ */
+int
+statedata_callback_match(statedata_callback_t *sc,
+                         yang_stmt            *yspec,
+                         cvec                 *nsc,
+                         char                 *xpath)
+{
+    int   retval = -1;
+    char *xp = NULL;
+    char *s;
+    char *alt;
+    char  q = 0;
+    int   depth = 0;
+    int   end;
+
+    if (xpath == NULL){
+        retval = 1;
+        goto done;
+    }
+    if ((xp = strdup(xpath)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    /* Split top-level union into location paths, match if any path matches */
+    retval = 0;
+    alt = xp;
+    for (s = xp; ; s++){
+        if (*s == '\0' || (*s == '|' && q == 0 && depth == 0)){
+            end = (*s == '\0');
+            *s = '\0';
+            if (statedata_match_path(sc, yspec, nsc, alt) == 1){
+                retval = 1;
+                break;
+            }
+            if (end)
+                break;
+            alt = s + 1;
+        }
+        else if (q){
+            if (*s == q)
+                q = 0;
+        }
+        else if (*s == '\'' || *s == '"')
+            q = *s;
+        else if (*s == '[' || *s == '(')
+            depth++;
+        else if (*s == ']' || *s == ')')
+            depth--;
+    }
+ done:
+    if (xp)
+        free(xp);
+    return retval;
+}
+
+/*--------------------------------------------------------------------
+ * Cache of state data from registered state data callbacks
+ */
+
+/*! Free a state data cache entry
+ */
+static int
+statedata_cache_free(statedata_cache_t *ce)
+{
+    if (ce->ce_xpath)
+        free(ce->ce_xpath);
+    if (ce->ce_x)
+        xml_free(ce->ce_x);
+    free(ce);
+    return 0;
+}
+
+/*! Remove all cached state of one state data callback
+ *
+ * @param[in]  sc     State data callback
+ */
+static int
+statedata_cache_clear(statedata_callback_t *sc)
+{
+    statedata_cache_t *ce;
+
+    while ((ce = sc->sc_cache) != NULL){
+        DELQ(ce, sc->sc_cache, statedata_cache_t *);
+        statedata_cache_free(ce);
+    }
+    sc->sc_cachenr = 0;
+    return 0;
+}
+
+/*! Get cached state of a state data callback for an xpath
+ *
+ * Expired entries are removed.
+ * Hit and miss counters of the callback are updated.
+ * @param[in]  sc     State data callback
+ * @param[in]  xpath  Canonical xpath of request, or NULL for all
+ * @param[out] xp     Copy of cached state tree: <config>..., free with xml_free
+ * @retval     1      Hit: xp is set
+ * @retval     0      Miss: not cached, expired, or caching not enabled
+ * @retval    -1      Error
+ */
+int
+statedata_cache_get(statedata_callback_t *sc,
+                    char                 *xpath,
+                    cxobj               **xp)
+{
+    int                retval = -1;
+    statedata_cache_t *ce;
+    statedata_cache_t *cenext;
+    struct timeval     now;
+    int                i;
+    int                n;
+
+    if (sc->sc_ttl == 0)
+        goto miss;
+    if (xpath == NULL)
+        xpath = "/";
+    gettimeofday(&now, NULL);
+    ce = sc->sc_cache;
+    n = sc->sc_cachenr;
+    for (i=0; i<n; i++){
+        cenext = NEXTQ(statedata_cache_t *, ce);
+        if (timercmp(&ce->ce_expire, &now, <=)){
+            DELQ(ce, sc->sc_cache, statedata_cache_t *);
+            statedata_cache_free(ce);
+            sc->sc_cachenr--;
+        }
+        else if (strcmp(ce->ce_xpath, xpath) == 0){
+            if ((*xp = xml_dup(ce->ce_x)) == NULL)
+                goto done;
+            sc->sc_hit++;
+            retval = 1;
+            goto done;
+        }
+        ce = cenext;
+    }
+ miss:
+    sc->sc_miss++;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Cache state returned by a state data callback for an xpath
+ *
+ * If the cache of the callback is full, the oldest entry is removed.
+ * @param[in]  sc     State data callback
+ * @param[in]  xpath  Canonical xpath of request, or NULL for all
+ * @param[in]  x      State tree: <config>..., a copy is cached
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+int
+statedata_cache_set(statedata_callback_t *sc,
+                    char                 *xpath,
+                    cxobj                *x)
+{
+    int                retval = -1;
+    statedata_cache_t *ce = NULL;
+    struct timeval     t;
+
+    if (sc->sc_ttl == 0)
+        goto ok;
+    if (xpath == NULL)
+        xpath = "/";
+    if (sc->sc_cachenr >= STATEDATA_CACHE_MAX && (ce = sc->sc_cache) != NULL){
+        DELQ(ce, sc->sc_cache, statedata_cache_t *);
+        statedata_cache_free(ce);
+        sc->sc_cachenr--;
+    }
+    if ((ce = malloc(sizeof(*ce))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(ce, 0, sizeof(*ce));
+    if ((ce->ce_xpath = strdup(xpath)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    if ((ce->ce_x = xml_dup(x)) == NULL)
+        goto done;
+    gettimeofday(&ce->ce_expire, NULL);
+    t.tv_sec = sc->sc_ttl/1000;
+    t.tv_usec = (sc->sc_ttl%1000)*1000;
+    timeradd(&ce->ce_expire, &t, &ce->ce_expire);
+    ADDQ(ce, sc->sc_cache);
+    sc->sc_cachenr++;
+    ce = NULL;
+ ok:
+    retval = 0;
+ done:
+    if (ce)
+        statedata_cache_free(ce);
+    return retval;
+}
+
+/*! Invalidate cached state of registered state data callbacks
+ *
+ * Use this when the underlying state has changed before the ttl has expired.
+ * Cached state is invalidated for every callback whose registered subtree intersects path,
+ * ie one of them is a prefix of the other.
+ * @param[in]  h      Clicon handle
+ * @param[in]  path   Schema path on the form /module:name/name, or NULL for all callbacks
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see statedata_callback_reg_fn
+ */
+int
+statedata_callback_invalidate(clicon_handle h,
+                              const char   *path)
+{
+    int                   retval = -1;
+    statedata_callback_t *sc = NULL;
+    cvec                 *steps = NULL;
+    cg_var               *cv;
+    cg_var               *cv1;
+
+    if (path != NULL && statedata_path_parse(path, &steps) < 0)
+        goto done;
+    while ((sc = statedata_callback_each(h, sc)) != NULL) {
+        if (sc->sc_cache == NULL)
+            continue;
+        if (steps != NULL){
+            cv = NULL;
+            cv1 = NULL;
+            while ((cv = cvec_each(steps, cv)) != NULL &&
+                   (cv1 = cvec_each(sc->sc_steps, cv1)) != NULL){
+                if (strcmp(cv_name_get(cv), cv_name_get(cv1)) != 0 ||
+                    strcmp(cv_string_get(cv), cv_string_get(cv1)) != 0)
+                    break;
+            }
+            if (cv != NULL && cv1 != NULL) /* Disjoint */
+                continue;
+        }
+        statedata_cache_clear(sc);
+    }
+    retval = 0;
+ done:
+    if (steps)
+        cvec_free(steps);
+    return retval;
+}
+
 /* Authentication type
  * @see http-auth-type in clixon-restconf.yang
  * @see restconf_media_str2int
@@ -1636,6 +2311,8 @@ clixon_plugin_module_exit(clicon_handle h)
     rpc_callback_delete_all(h);
     /* Delete all backend plugin upgrade callbacks (only backend) */
     upgrade_callback_delete_all(h);
+    /* Delete all backend state data callbacks (only backend) */
+    statedata_callback_delete_all(h);
     /* Delete plugin_module itself */
     if ((ph = plugin_module_struct_get(h)) != NULL){
         free(ph);
@@ -49,6 +49,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <stdint.h>
 #include <syslog.h>
 #include <signal.h>
 #include <ctype.h>
@@ -75,6 +76,9 @@
 #include "clixon_sig.h"
 #include "clixon_xml.h"
 #include "clixon_xml_io.h"
+#include "clixon_xml_bin.h"
+#include "clixon_xml_bind.h"
+#include "clixon_xml_sort.h"
 #include "clixon_netconf_lib.h"
 #include "clixon_options.h"
 #include "clixon_proto.h"
@@ -135,6 +139,8 @@ format_str2int(char *str)
  * @note if format includes %, they will be expanded according to printf rules.
  *       if this is a problem, use ("%s", xml) instaead of (xml)
  *       Notaly this may an issue of RFC 3896 encoded strings
+ * @note The body is followed by two null characters, see clicon_msg_decode
+ * @see clicon_msg_encode_raw  for a string of known length
  */
 struct clicon_msg *
 clicon_msg_encode(uint32_t      id,
@@ -151,11 +157,11 @@ clicon_msg_encode(uint32_t      id,
     va_end(args);
 
     len = hdrlen + xmllen;
-    if ((msg = (struct clicon_msg *)malloc(len)) == NULL){
+    if ((msg = (struct clicon_msg *)malloc(len+1)) == NULL){
         clicon_err(OE_PROTO, errno, "malloc");
         return NULL;
     }
-    memset(msg, 0, len);
+    memset(msg, 0, len+1);
     /* hdr */
     msg->op_len = htonl(len);
     msg->op_id = htonl(id);
@@ -168,6 +174,157 @@ clicon_msg_encode(uint32_t      id,
     return msg;
 }
 
+/*! Encode a clicon netconf message from a string of known length, optionally with a head
+ *
+ * As clicon_msg_encode but the body is copied once with no format expansion.
+ * @param[in] id      Session id of client
+ * @param[in] head    Null-terminated string placed before body, or NULL
+ * @param[in] body    XML netconf string, need not be null-terminated
+ * @param[in] len     Length of body
+ * @retval    msg     Clicon message to send to eg clicon_msg_send()
+ * @retval    NULL    Error
+ * @code
+ *   if ((msg = clicon_msg_encode_raw(id, NULL, cbuf_get(cb), cbuf_len(cb))) == NULL)
+ *      err;
+ * @endcode
+ */
+struct clicon_msg *
+clicon_msg_encode_raw(uint32_t    id,
+                      const char *head,
+                      const char *body,
+                      size_t      len)
+{
+    struct clicon_msg *msg = NULL;
+    size_t             hlen;
+    size_t             mlen;
+
+    hlen = head ? strlen(head) : 0;
+    mlen = sizeof(*msg) + hlen + len + 1;
+    if (mlen > UINT32_MAX){
+        clicon_err(OE_PROTO, EMSGSIZE, "Message too large: %zu", mlen);
+        return NULL;
+    }
+    /* Two null characters so that decode can scan body in place */
+    if ((msg = (struct clicon_msg *)malloc(mlen+1)) == NULL){
+        clicon_err(OE_PROTO, errno, "malloc");
+        return NULL;
+    }
+    msg->op_len = htonl(mlen);
+    msg->op_id = htonl(id);
+    if (hlen)
+        memcpy(msg->op_body, head, hlen);
+    if (len)
+        memcpy(msg->op_body + hlen, body, len);
+    msg->op_body[hlen + len] = '\0';
+    msg->op_body[hlen + len + 1] = '\0';
+    return msg;
+}
+
+/*! Encode a clicon netconf message from XML tree in binary encoding
+ *
+ * The body is CLIXON_MSG_BIN_MARKER followed by the tree in binary format and two null
+ * characters. The tree is bound to yang on decode using one lookup per schema node instead
+ * of parsing. Host byte order, only use when negotiated on a local (UNIX) socket.
+ * @param[in] id      Session id of client
+ * @param[in] xml     XML netconf tree on the form <rpc>...</rpc>, should be bound as by 
+ *                    parsing with YB_RPC, otherwise it is bound on decode
+ * @retval    msg     Clicon message to send to eg clicon_msg_send()
+ * @retval    NULL    Error
+ * @see clixon_xml2bin_buf
+ */
+struct clicon_msg *
+clicon_msg_encode_bin(uint32_t id,
+                      cxobj   *xml)
+{
+    struct clicon_msg *msg = NULL;
+    size_t             pre;
+    size_t             len;
+    size_t             mlen;
+
+    pre = sizeof(*msg) + sizeof(CLIXON_MSG_BIN_MARKER);
+    if (clixon_xml2bin_buf(xml, pre, 2, (char**)&msg, &len) < 0)
+        return NULL;
+    mlen = pre + len + 1;
+    if (mlen > UINT32_MAX){
+        clicon_err(OE_PROTO, EMSGSIZE, "Message too large: %zu", mlen);
+        free(msg);
+        return NULL;
+    }
+    msg->op_len = htonl(mlen);
+    msg->op_id = htonl(id);
+    memcpy(msg->op_body, CLIXON_MSG_BIN_MARKER, sizeof(CLIXON_MSG_BIN_MARKER));
+    return msg;
+}
+
+/*! Check if the body of a message is in binary encoding
+ *
+ * @param[in]  msg    CLICON msg
+ * @retval     1      Body starts with CLIXON_MSG_BIN_MARKER
+ * @retval     0      Body is text
+ * @see clicon_msg_encode_bin
+ */
+int
+clicon_msg_bin_p(struct clicon_msg *msg)
+{
+    return ntohl(msg->op_len) > sizeof(*msg) + sizeof(CLIXON_MSG_BIN_MARKER) &&
+        memcmp(msg->op_body, CLIXON_MSG_BIN_MARKER, sizeof(CLIXON_MSG_BIN_MARKER)) == 0;
+}
+
+/*! Decode the body of a message in binary encoding
+ *
+ * Binding as if parsed with YB_RPC. If the encoded tree is bound, it is only sorted,
+ * but the netconf envelope is checked also then, see xml_bind_yang_rpc_envelope.
+ * @param[in]  body   Encoded tree following CLIXON_MSG_BIN_MARKER
+ * @param[in]  len    Length of encoded tree
+ * @param[in]  yspec  Yang specification, or NULL
+ * @param[out] xml    XML tree with top node
+ * @param[out] xerr   Reason for failure if retval is 0
+ * @retval     1      OK and all yang assignment made
+ * @retval     0      Yang assigment not made
+ * @retval    -1      Error
+ */
+static int
+clicon_msg_decode_bin(char       *body,
+                      size_t      len,
+                      yang_stmt  *yspec,
+                      cxobj     **xml,
+                      cxobj     **xerr)
+{
+    int    retval = -1;
+    cxobj *xt = NULL;
+    cxobj *x = NULL;
+    int    ret;
+
+    if ((ret = clixon_bin_parse_buf(body, len, yspec, &x)) < 0)
+        goto done;
+    if ((xt = xml_new(XML_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+        goto done;
+    if (xml_addsub(xt, x) < 0){
+        xml_free(x);
+        goto done;
+    }
+    if (yspec == NULL)
+        ret = 1;
+    else if (ret == 0){ /* Not bound by sender or yang differs */
+        if ((ret = xml_bind_yang_rpc(NULL, x, yspec, xerr)) < 0)
+            goto done;
+    }
+    else if ((ret = xml_bind_yang_rpc_envelope(x, xerr)) < 0)
+        goto done;
+    if (ret == 0 && xerr && *xerr &&
+        clixon_xml_attr_copy(x, *xerr, "message-id") < 0) /* Add message-id */
+        goto done;
+    if (ret == 1 && yspec && xml_sort_recurse(xt) < 0)
+        goto done;
+    *xml = xt;
+    xt = NULL;
+    retval = ret;
+ done:
+    if (xt)
+        xml_free(xt);
+    return retval;
+}
+
 /*! Decode a clicon netconf message
  * @param[in]  msg    CLICON msg
  * @param[in]  yspec  Yang specification, (can be NULL)
@@ -177,6 +334,10 @@ clicon_msg_encode(uint32_t      id,
  * @retval     1      Parse OK and all yang assignment made
  * @retval     0      Parse OK but yang assigment not made (or only partial)
  * @retval    -1      Error with clicon_err called. Includes parse error
+ * @note The body is scanned in place, msg must be created by clicon_msg_encode, 
+ *       clicon_msg_encode_raw or clicon_msg_rcv which end the body with two null characters
+ * @note A body in binary encoding is detected and decoded, see clicon_msg_encode_bin.
+ *       Use clicon_msg_bin_p to reject it from a peer that did not negotiate it
  */
 int
 clicon_msg_decode(struct clicon_msg *msg, 
@@ -185,18 +346,33 @@ clicon_msg_decode(struct clicon_msg *msg,
                   cxobj            **xml,
                   cxobj            **xerr)
 {
-    int    retval = -1;
-    char  *xmlstr;
-    int    ret;
+    int      retval = -1;
+    char    *xmlstr;
+    uint32_t mlen;
+    int      ret;
 
     clicon_debug(CLIXON_DBG_DETAIL, "%s", __FUNCTION__);
     /* hdr */
     if (id)
         *id = ntohl(msg->op_id);
+    mlen = ntohl(msg->op_len);
+    if (mlen <= sizeof(*msg)){
+        clicon_err(OE_PROTO, 0, "op_len:%u too short", mlen);
+        goto done;
+    }
     /* body */
     xmlstr = msg->op_body;
     // XXX    clicon_debug(CLIXON_DBG_MSG, "Recv: %s", xmlstr);
-    if ((ret = clixon_xml_parse_string(xmlstr, yspec?YB_RPC:YB_NONE, yspec, xml, xerr)) < 0)
+    if (clicon_msg_bin_p(msg)){
+        clicon_debug(CLIXON_DBG_MSG, "%s binary encoding", __FUNCTION__);
+        if ((ret = clicon_msg_decode_bin(xmlstr + sizeof(CLIXON_MSG_BIN_MARKER),
+                                         mlen - sizeof(*msg) - sizeof(CLIXON_MSG_BIN_MARKER) - 1,
+                                         yspec, xml, xerr)) < 0)
+            goto done;
+    }
+    /* Scan in place, length excludes null character */
+    else if ((ret = clixon_xml_parse_buf(xmlstr, mlen - sizeof(*msg) - 1,
+                                         yspec?YB_RPC:YB_NONE, yspec, xml, xerr)) < 0)
         goto done;
     if (ret == 0)
         goto fail;
@@ -449,6 +625,7 @@ clicon_msg_rcv(int                s,
         *eof = 1;
         goto ok;
     }
+    ((char*)*msg)[mlen] = '\0'; /* Second null character, see clicon_msg_decode */
     clicon_debug(CLIXON_DBG_MSG, "Recv: %s", (*msg)->op_body);
  ok:
     retval = 0;
@@ -741,9 +918,9 @@ send_msg_reply(int      s,
     uint32_t           len;
 
     len = sizeof(*reply) + datalen;
-    if ((reply = (struct clicon_msg *)malloc(len)) == NULL)
+    if ((reply = (struct clicon_msg *)malloc(len+1)) == NULL)
         goto done;
-    memset(reply, 0, len);
+    memset(reply, 0, len+1);
     reply->op_len = htonl(len);
     if (datalen > 0)
       memcpy(reply->op_body, data, datalen);
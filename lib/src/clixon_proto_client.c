@@ -47,6 +47,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <ctype.h>
+#include <inttypes.h>
 #include <assert.h>
 #include <unistd.h>
 #include <sys/param.h>
@@ -83,6 +85,10 @@
 #include "clixon_netconf_lib.h"
 #include "clixon_proto_client.h"
 
+/* Forward */
+static int rpc_async_shared_flush(clicon_handle h);
+static int rpc_async_shared_detach(clicon_handle h);
+
 #define PERSIST_ID_XML_FMT "<persist-id>%s</persist-id>"
 #define PERSIST_XML_FMT "<persist>%s</persist>"
 #define TIMEOUT_XML_FMT "<confirm-timeout>%u</confirm-timeout>"
@@ -160,6 +166,9 @@ clicon_rpc_msg_once(clicon_handle      h,
     int s;
     
     if (cache){
+        /* Outstanding asynchronous requests on the same socket are done first */
+        if (rpc_async_shared_flush(h) < 0)
+            goto done;
         if ((s = clicon_client_socket_get(h)) < 0){
             if (clicon_rpc_connect(h, &s) < 0)
                 goto done;
@@ -173,6 +182,8 @@ clicon_rpc_msg_once(clicon_handle      h,
         close(s);
         s = -1;
         clicon_client_socket_set(h, -1);
+        if (cache)
+            rpc_async_shared_detach(h);
         goto done;
     }
     if (sp)
@@ -217,6 +228,8 @@ clicon_rpc_msg(clicon_handle      h,
         close(s);
         s = -1;
         clicon_client_socket_set(h, -1);
+        if (rpc_async_shared_detach(h) < 0)
+            goto done;
 #ifdef PROTO_RESTART_RECONNECT
         if (!clixon_exit_get()) { /* May be part of termination */
             if (clicon_rpc_msg_once(h, msg, 1, &retdata, &eof, NULL) < 0)
@@ -392,7 +405,7 @@ clicon_rpc_netconf(clicon_handle  h,
 
     if (session_id_check(h, &session_id) < 0)
         goto done;
-    if ((msg = clicon_msg_encode(session_id, "%s", xmlstr)) < 0)
+    if ((msg = clicon_msg_encode_raw(session_id, NULL, xmlstr, strlen(xmlstr))) == NULL)
         goto done;
     if (sp){
         if (clicon_rpc_msg_persistent(h, msg, xret, sp) < 0)
@@ -408,6 +421,49 @@ clicon_rpc_netconf(clicon_handle  h,
     return retval;
 }
 
+/*! Bind a netconf rpc reply to yang, replace the reply with an error if it fails
+ *
+ * @param[in]     h        Clicon handle
+ * @param[in]     rpcname  Name of rpc of request
+ * @param[in,out] xret     Return XML netconf tree
+ * @retval        0        OK
+ * @retval       -1        Error
+ */
+static int
+rpc_netconf_reply_bind(clicon_handle h,
+                       char         *rpcname,
+                       cxobj        *xret)
+{
+    int        retval = -1;
+    cxobj     *xreply;
+    cxobj     *xc;
+    yang_stmt *yspec;
+    cxobj     *xerr = NULL;
+    int        ret;
+
+    if (xret != NULL &&
+        (xreply = xml_find_type(xret, NULL, "rpc-reply", CX_ELMNT)) != NULL &&
+        xml_find_type(xreply, NULL, "rpc-error", CX_ELMNT) == NULL){
+        yspec = clicon_dbspec_yang(h);
+        /* Here use rpc name to bind to yang */
+        if ((ret = xml_bind_yang_rpc_reply(h, xreply, rpcname, yspec, &xerr)) < 0) 
+            goto done;
+        if (ret == 0){
+            /* Replace reply with error */
+            if ((xc = xml_child_i(xret, 0)) != NULL)
+                xml_purge(xc);
+            if (xml_addsub(xret, xerr) < 0)
+                goto done;
+            xerr = NULL;
+        }
+    }
+    retval = 0;
+ done:
+    if (xerr)
+        xml_free(xerr);
+    return retval;
+}
+
 /*! Generic xml netconf clicon rpc
  *
  * Want to go over to use netconf directly between client and server,...
@@ -432,55 +488,144 @@ clicon_rpc_netconf_xml(clicon_handle  h,
                        cxobj        **xret,
                        int           *sp)
 {
-    int        retval = -1;
-    cbuf      *cb = NULL;
-    cxobj     *xname;
-    char      *rpcname;
-    cxobj     *xreply;
-    yang_stmt *yspec;
-    cxobj     *xerr = NULL;
-    int        ret;
+    int                retval = -1;
+    cbuf              *cb = NULL;
+    cxobj             *xname;
+    char              *rpcname;
+    uint32_t           session_id;
+    struct clicon_msg *msg = NULL;
 
-    if ((cb = cbuf_new()) == NULL){
-        clicon_err(OE_XML, errno, "cbuf_new");
-        goto done;
-    }
     if ((xname = xml_child_i_type(xml, 0, 0)) == NULL){
         clicon_err(OE_NETCONF, EINVAL, "Missing rpc name");
         goto done;
     }
     rpcname = xml_name(xname); /* Store rpc name and use in yang binding after reply */
-    if (clixon_xml2cbuf(cb, xml, 0, 0, -1, 0) < 0)
-        goto done;
-    if (clicon_rpc_netconf(h, cbuf_get(cb), xret, sp) < 0)
+    if (session_id_check(h, &session_id) < 0)
         goto done;
-    if ((xreply = xml_find_type(*xret, NULL, "rpc-reply", CX_ELMNT)) != NULL &&
-        xml_find_type(xreply, NULL, "rpc-error", CX_ELMNT) == NULL){
-        yspec = clicon_dbspec_yang(h);
-        /* Here use rpc name to bind to yang */
-        if ((ret = xml_bind_yang_rpc_reply(h, xreply, rpcname, yspec, &xerr)) < 0) 
+    if (clicon_data_int_get(h, "ipc-binary") > 0){
+        /* Negotiated in hello: send tree in binary encoding */
+        if ((msg = clicon_msg_encode_bin(session_id, xml)) == NULL)
+            goto done;
+        if (sp){
+            if (clicon_rpc_msg_persistent(h, msg, xret, sp) < 0)
+                goto done;
+        }
+        else
+            if (clicon_rpc_msg(h, msg, xret) < 0)
+                goto done;
+    }
+    else {
+        if ((cb = cbuf_new()) == NULL){
+            clicon_err(OE_XML, errno, "cbuf_new");
             goto done;
-        if (ret == 0){
-            /* Replace reply with error */
-            if (*xret) {
-                cxobj *xc;
-                if ((xc = xml_child_i(*xret, 0)) != NULL)
-                    xml_purge(xc);
-                if (xml_addsub(*xret, xerr) < 0)
-                    goto done;
-                xerr = NULL;
-            }
         }
+        if (clixon_xml2cbuf(cb, xml, 0, 0, -1, 0) < 0)
+            goto done;
+        if (clicon_rpc_netconf(h, cbuf_get(cb), xret, sp) < 0)
+            goto done;
     }
+    if (rpc_netconf_reply_bind(h, rpcname, *xret) < 0)
+        goto done;
     retval = 0;
  done:
-    if (xerr)
-        xml_free(xerr);
+    if (msg)
+        free(msg);
     if (cb)
         cbuf_free(cb);
     return retval;
 }
 
+/*! Check if a netconf rpc can be sent as its original text, and make head of message
+ *
+ * The text must start with an unprefixed <rpc element. The username of the session 
+ * is added as an attribute in the head
+ * @param[in]  h       Clicon handle
+ * @param[in]  raw     Text of rpc, or NULL
+ * @param[in]  len     Length of raw
+ * @param[out] cbhead  Head of message: "<rpc" and username attribute
+ * @retval     1       OK, send head followed by raw + strlen("<rpc")
+ * @retval     0       Not applicable
+ */
+static int
+rpc_netconf_raw_head(clicon_handle h,
+                     char         *raw,
+                     size_t        len,
+                     cbuf         *cbhead)
+{
+    char *username;
+
+    if (raw == NULL || len <= strlen("<rpc") ||
+        strncmp(raw, "<rpc", strlen("<rpc")) != 0 ||
+        (!isspace(raw[4]) && raw[4] != '>' && raw[4] != '/'))
+        return 0;
+    cprintf(cbhead, "<rpc");
+    if ((username = clicon_username_get(h)) != NULL){
+        cprintf(cbhead, " xmlns:%s=\"%s\"", CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+        cprintf(cbhead, " %s:username=\"%s\"", CLIXON_LIB_PREFIX, username);
+    }
+    return 1;
+}
+
+/*! Send a netconf rpc to the backend as its original text, not re-serialized from tree
+ *
+ * As clicon_rpc_netconf_xml, but the message is sent as the text the tree was parsed
+ * from, with the username of the session added. Use when the tree is not modified.
+ * Falls back to clicon_rpc_netconf_xml if raw is NULL or does not start with "<rpc", or
+ * if binary encoding is negotiated with the backend.
+ * @param[in]  h       Clicon handle
+ * @param[in]  xml     XML netconf tree on the form <rpc>...</rpc>, parsed from raw
+ * @param[in]  raw     Text of xml, or NULL. Must not have a username attribute
+ * @param[in]  len     Length of raw
+ * @param[out] xret    Return XML netconf tree, error or OK (need to be freed)
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see clicon_rpc_netconf_xml
+ */
+int
+clicon_rpc_netconf_raw(clicon_handle  h, 
+                       cxobj         *xml,
+                       char          *raw,
+                       size_t         len,
+                       cxobj        **xret)
+{
+    int                retval = -1;
+    cbuf              *cbhead = NULL;
+    cxobj             *xname;
+    uint32_t           session_id;
+    struct clicon_msg *msg = NULL;
+    int                ret;
+
+    if ((cbhead = cbuf_new()) == NULL){
+        clicon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    if (session_id_check(h, &session_id) < 0)
+        goto done;
+    if (clicon_data_int_get(h, "ipc-binary") > 0 ||
+        (ret = rpc_netconf_raw_head(h, raw, len, cbhead)) == 0){
+        retval = clicon_rpc_netconf_xml(h, xml, xret, NULL);
+        goto done;
+    }
+    if ((xname = xml_child_i_type(xml, 0, CX_ELMNT)) == NULL){
+        clicon_err(OE_NETCONF, EINVAL, "Missing rpc name");
+        goto done;
+    }
+    if ((msg = clicon_msg_encode_raw(session_id, cbuf_get(cbhead), 
+                                     raw + strlen("<rpc"), len - strlen("<rpc"))) == NULL)
+        goto done;
+    if (clicon_rpc_msg(h, msg, xret) < 0)
+        goto done;
+    if (rpc_netconf_reply_bind(h, xml_name(xname), *xret) < 0)
+        goto done;
+    retval = 0;
+ done:
+    if (msg)
+        free(msg);
+    if (cbhead)
+        cbuf_free(cbhead);
+    return retval;
+}
+
 /*! Get database configuration
  *
  * Same as clicon_proto_change just with a cvec instead of lvec
@@ -523,6 +668,37 @@ clicon_rpc_get_config(clicon_handle h,
                       cvec         *nsc,
                       char         *defaults,
                       cxobj       **xt)
+{
+    return clicon_rpc_get_config_generation(h, username, db, xpath, nsc, defaults, NULL, xt);
+}
+
+/*! Get database configuration only if it has changed since a generation
+ *
+ * Same as clicon_rpc_get_config but uses the Clixon generation extension of get-config:
+ * if the generation of the datastore is the same as the given, no data is returned.
+ * Used for client caching of config data.
+ * @param[in]     h          CLICON handle
+ * @param[in]     username   If NULL, use default
+ * @param[in]     db         Name of database
+ * @param[in]     xpath      XPath (or "")
+ * @param[in]     nsc        Namespace context for filter
+ * @param[in]     defaults   Value of the with-defaults mode, rfc6243, or NULL
+ * @param[in,out] generation If set, generation of cached data, set to generation of datastore
+ * @param[out]    xt         XML tree. Free with xml_free. Either <config> or <rpc-error>.
+ *                           NULL if generation is set and data has not changed
+ * @retval        0          OK
+ * @retval       -1          Error, fatal or xml
+ * @see clicon_rpc_get_config
+ */
+int
+clicon_rpc_get_config_generation(clicon_handle h, 
+                                 char         *username,
+                                 char         *db, 
+                                 char         *xpath,
+                                 cvec         *nsc,
+                                 char         *defaults,
+                                 uint64_t     *generation,
+                                 cxobj       **xt)
 {
     int                retval = -1;
     struct clicon_msg *msg = NULL;
@@ -534,6 +710,7 @@ clicon_rpc_get_config(clicon_handle h,
     int                ret;
     yang_stmt         *yspec;
     cvec              *nscd = NULL;
+    char              *genstr;
     
     if (session_id_check(h, &session_id) < 0)
         goto done;
@@ -551,7 +728,12 @@ clicon_rpc_get_config(clicon_handle h,
     cprintf(cb, " xmlns:%s=\"%s\"",
             NETCONF_BASE_PREFIX, NETCONF_BASE_NAMESPACE);
     cprintf(cb, " %s", NETCONF_MESSAGE_ID_ATTR); /* XXX: use incrementing sequence */
-    cprintf(cb, "><get-config><source><%s/></source>", db);
+    cprintf(cb, "><get-config");
+    /* Clixon extension, only get data if changed since generation */
+    if (generation)
+        cprintf(cb, " %s:generation=\"%" PRIu64 "\" xmlns:%s=\"%s\"",
+                CLIXON_LIB_PREFIX, *generation, CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    cprintf(cb, "><source><%s/></source>", db);
     if (xpath && strlen(xpath)){
         cprintf(cb, "<%s:filter %s:type=\"xpath\" %s:select=\"%s\"",
                 NETCONF_BASE_PREFIX, NETCONF_BASE_PREFIX, NETCONF_BASE_PREFIX,
@@ -595,6 +777,18 @@ clicon_rpc_get_config(clicon_handle h,
             }
         }
     }
+    if (generation && xml_find_type(xd, NULL, "rpc-error", CX_ELMNT) == NULL){
+        if ((genstr = xml_find_type_value(xd, NULL, "generation", CX_ATTR)) != NULL &&
+            parse_uint64(genstr, generation, NULL) <= 0){
+            clicon_err(OE_XML, EINVAL, "Invalid generation: %s", genstr);
+            goto done;
+        }
+        if (xml_find_type_value(xd, NULL, "unchanged", CX_ATTR) != NULL){
+            if (xt)
+                *xt = NULL;
+            goto ok;
+        }
+    }
     if (xt && xd){
         /* Sync namespaces, ie explicitly set all xmlns attributes to xd */
         if (xml_nsctx_node(xd, &nscd) < 0)
@@ -606,6 +800,7 @@ clicon_rpc_get_config(clicon_handle h,
         xml_sort(xd); /* Ensure attr is first */
         *xt = xd;
     }
+ ok:
     retval = 0;
   done:
     if (nscd)
@@ -914,77 +1109,29 @@ clicon_rpc_unlock(clicon_handle h,
     return retval;
 }
 
-/*! Get database configuration and state data
- * @param[in]  h         Clicon handle
+/*! Print a get operation body to a cbuf, ie <get>...</get>
+ *
+ * @param[in]  cb        CLIgen buffer
  * @param[in]  xpath     XPath in a filter stmt (or NULL/"" for no filter)
- * @param[in]  namespace Namespace associated w xpath
  * @param[in]  nsc       Namespace context for filter
  * @param[in]  content   Clixon extension: all, config, noconfig. -1 means all
  * @param[in]  depth     Nr of XML levels to get, -1 is all, 0 is none
  * @param[in]  defaults  Value of the with-defaults mode, rfc6243, or NULL
- * @param[out] xt        XML tree. Free with xml_free. 
- *                       Either <config> or <rpc-error>. 
  * @retval     0         OK
- * @retval    -1         Error, fatal or xml
- * @note if xpath is set but namespace is NULL, the default, netconf base 
- *       namespace will be used which is most probably wrong.
- * @code
- *  cxobj *xt = NULL;
- *  cvec *nsc = NULL;
- *
- *  if ((nsc = xml_nsctx_init(NULL, "urn:example:hello")) == NULL)
- *     err;
- *  if (clicon_rpc_get(h, "/hello/world", nsc, CONTENT_ALL, -1, &xt) < 0)
- *     err;
- *  if ((xerr = xpath_first(xt, NULL, "/rpc-error")) != NULL){
- *     clixon_netconf_error(xerr, "clicon_rpc_get", NULL);
- *     err;
- *  }
- *  if (xt)
- *     xml_free(xt);
- *  if (nsc)
- *     xml_nsctx_free(nsc);
- * @endcode
- * @see clicon_rpc_get_config which is almost the same as with content=config, but you can also select dbname
- * @see clixon_netconf_error
- * @note the netconf return message is yang populated, as well as the return data
+ * @retval    -1         Error
+ * @see clicon_rpc_get
  */
-int
-clicon_rpc_get(clicon_handle   h,
-               char           *xpath,
-               cvec           *nsc, /* namespace context for filter */
-               netconf_content content,
-               int32_t         depth,
-               char           *defaults,
-               cxobj         **xt)
+static int
+clicon_rpc_get_body(cbuf           *cb,
+                    char           *xpath,
+                    cvec           *nsc,
+                    netconf_content content,
+                    int32_t         depth,
+                    char           *defaults)
 {
-    int                retval = -1;
-    struct clicon_msg *msg = NULL;
-    cbuf              *cb = NULL;
-    cxobj             *xret = NULL;
-    cxobj             *xerr = NULL;
-    cxobj             *xd = NULL;
-    char              *username;
-    uint32_t           session_id;
-    int                ret;
-    yang_stmt         *yspec;
-    cvec              *nscd = NULL;
-    
-    clicon_debug(CLIXON_DBG_DETAIL, "%s", __FUNCTION__);
-    if (session_id_check(h, &session_id) < 0)
-        goto done;
-    if ((cb = cbuf_new()) == NULL){
-        clicon_err(OE_XML, errno, "cbuf_new");
-        goto done;
-    }
-    cprintf(cb, "<rpc xmlns=\"%s\"", NETCONF_BASE_NAMESPACE);
-    cprintf(cb, " xmlns:%s=\"%s\"", NETCONF_BASE_PREFIX, NETCONF_BASE_NAMESPACE);
-    if ((username = clicon_username_get(h)) != NULL){
-        cprintf(cb, " %s:username=\"%s\"", CLIXON_LIB_PREFIX, username);
-        cprintf(cb, " xmlns:%s=\"%s\"", CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
-    }
-    cprintf(cb, " message-id=\"%d\"", netconf_message_id_next(h)); 
-    cprintf(cb, "><get");
+    int retval = -1;
+
+    cprintf(cb, "<get");
     /* Clixon extension, content=all,config, or nonconfig */
     if ((int)content != -1)
         cprintf(cb, " %s:content=\"%s\" xmlns:%s=\"%s\"",
@@ -1011,12 +1158,33 @@ clicon_rpc_get(clicon_handle   h,
         cprintf(cb, "<with-defaults xmlns=\"%s\">%s</with-defaults>",
                 IETF_NETCONF_WITH_DEFAULTS_YANG_NAMESPACE,
                 defaults);
-    cprintf(cb, "</get></rpc>");
-    if ((msg = clicon_msg_encode(session_id,
-                                 "%s", cbuf_get(cb))) == NULL)
-        goto done;
-    if (clicon_rpc_msg(h, msg, &xret) < 0)
-        goto done;
+    cprintf(cb, "</get>");
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Extract data or error from a get reply and bind it to yang
+ *
+ * @param[in]  h         Clicon handle
+ * @param[in]  xret      Reply from backend on the form <rpc-reply>. Data is removed from it
+ * @param[out] xt        XML tree. Free with xml_free. Either <data> or <rpc-error>. 
+ * @retval     0         OK
+ * @retval    -1         Error
+ * @see clicon_rpc_get
+ */
+static int
+clicon_rpc_get_reply(clicon_handle h,
+                     cxobj        *xret,
+                     cxobj       **xt)
+{
+    int        retval = -1;
+    cxobj     *xd = NULL;
+    cxobj     *xerr = NULL;
+    yang_stmt *yspec;
+    cvec      *nscd = NULL;
+    int        ret;
+
     yspec = clicon_dbspec_yang(h);
     /* Send xml error back: first check error, then ok */
     if ((xd = xpath_first(xret, NULL, "/rpc-reply/rpc-error")) != NULL)
@@ -1053,48 +1221,132 @@ clicon_rpc_get(clicon_handle   h,
         *xt = xd;
     }
     retval = 0;
-  done:
-    clicon_debug(CLIXON_DBG_DETAIL, "%s %d", __FUNCTION__, retval);
+ done:
     if (nscd)
         cvec_free(nscd);
-    if (cb)
-        cbuf_free(cb);
     if (xerr)
         xml_free(xerr);
-    if (xret)
-        xml_free(xret);
-    if (msg)
-        free(msg);
     return retval;
 }
 
-/*! Get database configuration and state data collection
- *
+/*! Get database configuration and state data
  * @param[in]  h         Clicon handle
- * @param[in]  xpath     To identify a list/leaf-list
+ * @param[in]  xpath     XPath in a filter stmt (or NULL/"" for no filter)
  * @param[in]  namespace Namespace associated w xpath
  * @param[in]  nsc       Namespace context for filter
  * @param[in]  content   Clixon extension: all, config, noconfig. -1 means all
  * @param[in]  depth     Nr of XML levels to get, -1 is all, 0 is none
  * @param[in]  defaults  Value of the with-defaults mode, rfc6243, or NULL
- * @param[in]  offset     uint32, 0 means none
- * @param[in]  limit     uint32, 0 means unbounded
- * @param[in]  direction Collection/clixon extension
- * @param[in]  sort      Collection/clixon extension
- * @param[in]  where     Collection/clixon extension
  * @param[out] xt        XML tree. Free with xml_free. 
  *                       Either <config> or <rpc-error>. 
- * @retval    0          OK
- * @retval   -1          Error, fatal or xml
- * @see clicon_rpc_get
- * @see draft-ietf-netconf-restconf-collection-00
+ * @retval     0         OK
+ * @retval    -1         Error, fatal or xml
+ * @note if xpath is set but namespace is NULL, the default, netconf base 
+ *       namespace will be used which is most probably wrong.
+ * @code
+ *  cxobj *xt = NULL;
+ *  cvec *nsc = NULL;
+ *
+ *  if ((nsc = xml_nsctx_init(NULL, "urn:example:hello")) == NULL)
+ *     err;
+ *  if (clicon_rpc_get(h, "/hello/world", nsc, CONTENT_ALL, -1, &xt) < 0)
+ *     err;
+ *  if ((xerr = xpath_first(xt, NULL, "/rpc-error")) != NULL){
+ *     clixon_netconf_error(xerr, "clicon_rpc_get", NULL);
+ *     err;
+ *  }
+ *  if (xt)
+ *     xml_free(xt);
+ *  if (nsc)
+ *     xml_nsctx_free(nsc);
+ * @endcode
+ * @see clicon_rpc_get_config which is almost the same as with content=config, but you can also select dbname
+ * @see clicon_rpc_get_async  for non-blocking variant
+ * @see clixon_netconf_error
  * @note the netconf return message is yang populated, as well as the return data
  */
 int
-clicon_rpc_get_pageable_list(clicon_handle   h, 
-                             char           *datastore,
-                             char           *xpath,
-                             cvec           *nsc, /* namespace context for xpath */
+clicon_rpc_get(clicon_handle   h,
+               char           *xpath,
+               cvec           *nsc, /* namespace context for filter */
+               netconf_content content,
+               int32_t         depth,
+               char           *defaults,
+               cxobj         **xt)
+{
+    int                retval = -1;
+    struct clicon_msg *msg = NULL;
+    cbuf              *cb = NULL;
+    cxobj             *xret = NULL;
+    char              *username;
+    uint32_t           session_id;
+    
+    clicon_debug(CLIXON_DBG_DETAIL, "%s", __FUNCTION__);
+    if (session_id_check(h, &session_id) < 0)
+        goto done;
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "<rpc xmlns=\"%s\"", NETCONF_BASE_NAMESPACE);
+    cprintf(cb, " xmlns:%s=\"%s\"", NETCONF_BASE_PREFIX, NETCONF_BASE_NAMESPACE);
+    if ((username = clicon_username_get(h)) != NULL){
+        cprintf(cb, " %s:username=\"%s\"", CLIXON_LIB_PREFIX, username);
+        cprintf(cb, " xmlns:%s=\"%s\"", CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    }
+    cprintf(cb, " message-id=\"%d\">", netconf_message_id_next(h)); 
+    if (clicon_rpc_get_body(cb, xpath, nsc, content, depth, defaults) < 0)
+        goto done;
+    cprintf(cb, "</rpc>");
+    if ((msg = clicon_msg_encode(session_id,
+                                 "%s", cbuf_get(cb))) == NULL)
+        goto done;
+    if (clicon_rpc_msg(h, msg, &xret) < 0)
+        goto done;
+    if (clicon_rpc_get_reply(h, xret, xt) < 0)
+        goto done;
+    retval = 0;
+  done:
+    clicon_debug(CLIXON_DBG_DETAIL, "%s %d", __FUNCTION__, retval);
+    if (cb)
+        cbuf_free(cb);
+    if (xret)
+        xml_free(xret);
+    if (msg)
+        free(msg);
+    return retval;
+}
+
+/*! Get database configuration and state data collection
+ *
+ * @param[in]  h         Clicon handle
+ * @param[in]  xpath     To identify a list/leaf-list
+ * @param[in]  namespace Namespace associated w xpath
+ * @param[in]  nsc       Namespace context for filter
+ * @param[in]  content   Clixon extension: all, config, noconfig. -1 means all
+ * @param[in]  depth     Nr of XML levels to get, -1 is all, 0 is none
+ * @param[in]  defaults  Value of the with-defaults mode, rfc6243, or NULL
+ * @param[in]  offset     uint32, 0 means none
+ * @param[in]  limit     uint32, 0 means unbounded
+ * @param[in]  direction Collection/clixon extension
+ * @param[in]  sort      Collection/clixon extension
+ * @param[in]  where     Collection/clixon extension
+ * @param[in]  cursor    Clixon extension: cursor of last seen entry from previous reply, or NULL
+ * @param[in]  count     Clixon extension: if set, get nr of list entries only
+ * @param[out] xt        XML tree. Free with xml_free. 
+ *                       Either <config> or <rpc-error>. 
+ *                       Clixon-lib attributes of data: "cursor" for next page, "count"
+ * @retval    0          OK
+ * @retval   -1          Error, fatal or xml
+ * @see clicon_rpc_get
+ * @see draft-ietf-netconf-restconf-collection-00
+ * @note the netconf return message is yang populated, as well as the return data
+ */
+int
+clicon_rpc_get_pageable_list(clicon_handle   h, 
+                             char           *datastore,
+                             char           *xpath,
+                             cvec           *nsc, /* namespace context for xpath */
                              netconf_content content,
                              int32_t         depth,
                              char           *defaults,
@@ -1103,6 +1355,8 @@ clicon_rpc_get_pageable_list(clicon_handle   h,
                              char           *direction,
                              char           *sort,
                              char           *where,
+                             char           *cursor,
+                             int             count,
                              cxobj         **xt)
 {
     int                retval = -1;
@@ -1148,6 +1402,17 @@ clicon_rpc_get_pageable_list(clicon_handle   h,
                 CLIXON_LIB_PREFIX, 
                 depth,
                 CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    /* Clixon extension, keyset pagination cursor and count */
+    if (cursor){
+        cprintf(cb, " %s:cursor=\"", CLIXON_LIB_PREFIX);
+        if (xml_chardata_cbuf_append(cb, cursor) < 0)
+            goto done;
+        cprintf(cb, "\" xmlns:%s=\"%s\"", CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    }
+    if (count)
+        cprintf(cb, " %s:count=\"true\" xmlns:%s=\"%s\"",
+                CLIXON_LIB_PREFIX, 
+                CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
     /* declare lp prefix in get, so sub-elements dont need to */
     cprintf(cb, ">"); /* get */
     /* If xpath, add a filter */
@@ -1274,6 +1539,8 @@ clicon_rpc_close_session(clicon_handle h)
         goto done;
     if (clicon_rpc_msg(h, msg, &xret) < 0)
         goto done;
+    if (rpc_async_shared_detach(h) < 0)
+        goto done;
     if ((s = clicon_client_socket_get(h)) >= 0){
         close(s);
         clicon_client_socket_set(h, -1);
@@ -1759,35 +2026,22 @@ clicon_rpc_restconf_debug(clicon_handle h,
     return retval;
 }
 
-/*! Send a hello request to the backend server on INTERNAL netconf connection
+/*! Encode a hello request message
  *
  * @param[in]  h           Clixon handle
  * @param[in]  transport   RFC 6022 transport.
  * @param[in]  source_host RFC 6022 source-host
- * @param[out] id          Session id returned by backend
- * @retval     0           OK
- * @retval    -1           Error and logged to syslog
- * @note this is internal netconf to backend, not northbound to user client
- * @note this deviates from RFC6241 slightly in that it waits for a reply, the RFC does not
- *       stipulate that.
- * @note transport is an identity defined in RFC6022 with added values in clixon-lib.yang for clixon,
- *       and should in those cases be prefixed with the localname "cl:", 
- *       Example: cl:cli, cl:restconf, cl:netconf
+ * @retval     msg         Encoded message, free with free
+ * @retval     NULL        Error
+ * @see clicon_hello_req
  */
-int
-clicon_hello_req(clicon_handle h,
+static struct clicon_msg *
+clicon_hello_msg(clicon_handle h,
                  char         *transport,
-                 char         *source_host,
-                 uint32_t     *id)
+                 char         *source_host)
 {
-    int                retval = -1;
     struct clicon_msg *msg = NULL;
-    cxobj             *xret = NULL;
-    cxobj             *xerr;
-    cxobj             *x;
     char              *username;
-    char              *b;
-    int                ret;
     cbuf              *cb = NULL;
     int                clixon_lib = 0;
 
@@ -1816,14 +2070,40 @@ clicon_hello_req(clicon_handle h,
     if (clixon_lib)
         cprintf(cb, " xmlns:%s=\"%s\"", CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
     cprintf(cb, ">");
-    cprintf(cb, "<capabilities><capability>%s</capability></capabilities>",
-            NETCONF_BASE_CAPABILITY_1_1);
+    cprintf(cb, "<capabilities><capability>%s</capability>", NETCONF_BASE_CAPABILITY_1_1);
+    /* Binary encoding is in host byte order, only on local socket */
+    if (clicon_option_bool(h, "CLICON_IPC_BINARY") &&
+        clicon_sock_family(h) == AF_UNIX)
+        cprintf(cb, "<capability>%s</capability>", CLIXON_IPC_BINARY_CAPABILITY);
+    cprintf(cb, "</capabilities>");
     cprintf(cb, "</hello>");
+    msg = clicon_msg_encode(0, "%s", cbuf_get(cb));
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return msg;
+}
+
+/*! Get session-id and capabilities from hello reply
+ *
+ * @param[in]  xret    Hello reply from backend
+ * @param[out] id      Session id returned by backend
+ * @param[out] binary  Set to 1 if backend accepts binary encoding, else 0
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+static int
+clicon_hello_reply(cxobj    *xret,
+                   uint32_t *id,
+                   int      *binary)
+{
+    int    retval = -1;
+    cxobj *xerr;
+    cxobj *x;
+    cxobj *xc;
+    char  *b;
+    int    ret;
 
-    if ((msg = clicon_msg_encode(0, "%s", cbuf_get(cb))) == NULL)
-        goto done;
-    if (clicon_rpc_msg(h, msg, &xret) < 0)
-        goto done;
     if ((xerr = xpath_first(xret, NULL, "//rpc-error")) != NULL){
         clixon_netconf_error(xerr, "Hello", NULL);
         goto done;
@@ -1837,10 +2117,56 @@ clicon_hello_req(clicon_handle h,
         clicon_err(OE_XML, errno, "parse_uint32"); 
         goto done;
     }
+    *binary = 0;
+    if ((x = xpath_first(xret, NULL, "hello/capabilities")) != NULL){
+        xc = NULL;
+        while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL)
+            if ((b = xml_body(xc)) != NULL &&
+                strcmp(b, CLIXON_IPC_BINARY_CAPABILITY) == 0)
+                *binary = 1;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Send a hello request to the backend server on INTERNAL netconf connection
+ *
+ * @param[in]  h           Clixon handle
+ * @param[in]  transport   RFC 6022 transport.
+ * @param[in]  source_host RFC 6022 source-host
+ * @param[out] id          Session id returned by backend
+ * @retval     0           OK
+ * @retval    -1           Error and logged to syslog
+ * @note this is internal netconf to backend, not northbound to user client
+ * @note this deviates from RFC6241 slightly in that it waits for a reply, the RFC does not
+ *       stipulate that.
+ * @note transport is an identity defined in RFC6022 with added values in clixon-lib.yang for clixon,
+ *       and should in those cases be prefixed with the localname "cl:", 
+ *       Example: cl:cli, cl:restconf, cl:netconf
+ */
+int
+clicon_hello_req(clicon_handle h,
+                 char         *transport,
+                 char         *source_host,
+                 uint32_t     *id)
+{
+    int                retval = -1;
+    struct clicon_msg *msg = NULL;
+    cxobj             *xret = NULL;
+    int                binary = 0;
+
+    if ((msg = clicon_hello_msg(h, transport, source_host)) == NULL)
+        goto done;
+    if (clicon_rpc_msg(h, msg, &xret) < 0)
+        goto done;
+    if (clicon_hello_reply(xret, id, &binary) < 0)
+        goto done;
+    /* Encoding of rpcs in this session, see clicon_rpc_netconf_xml */
+    if (clicon_data_int_set(h, "ipc-binary", binary) < 0)
+        goto done;
     retval = 0;
  done:
-    if (cb)
-        cbuf_free(cb);
     if (msg)
         free(msg);
     if (xret)
@@ -1906,3 +2232,840 @@ clicon_rpc_restart_plugin(clicon_handle h,
         xml_free(xret);
     return retval;
 }
+
+/*
+ * Asynchronous backend session
+ * A socket to the backend where requests are sent without waiting for the reply and are
+ * tagged with message-id. Several requests may be outstanding at the same time. The
+ * backend handles the requests of a session in order, so replies arrive in the same
+ * order as the requests were sent.
+ * By default the session is a separate socket to the backend. If shared, the socket of
+ * the synchronous session is used instead, so that locks and session state are common.
+ * In that case a synchronous rpc first waits for all outstanding asynchronous requests.
+ * A reply is delivered either:
+ * - by callback, from the event loop or from clicon_rpc_async_wait/flush, or
+ * - as a future, if no callback is given, fetched with clicon_rpc_async_wait.
+ * The number of outstanding requests is bounded by a window, a request sent when
+ * the window is full first waits for the oldest reply.
+ */
+
+/* Outstanding asynchronous request */
+struct rpc_async_req {
+    qelem_t              ar_qelem;  /* List header */
+    uint32_t             ar_id;     /* Internal id, netconf message-id if not ar_caller */
+    int                  ar_caller; /* Message-id of rpc set by caller, not ar_id */
+    clicon_rpc_async_cb *ar_fn;     /* Reply callback, or NULL for future */
+    void                *ar_arg;    /* Callback argument */
+    int                (*ar_reply)(clicon_handle, cxobj *, cxobj **); /* Reply transform, or NULL */
+    int                  ar_cancel; /* Cancelled, discard reply */
+    cxobj               *ar_xret;   /* Future: reply when done */
+};
+
+/* Asynchronous backend session, stored in the clicon handle
+ */
+struct rpc_async {
+    int                   ra_s;          /* Socket to backend */
+    uint32_t              ra_session_id; /* Backend session-id of this socket */
+    int                   ra_shared;     /* Socket is shared with synchronous session */
+    int                   ra_binary;     /* Binary encoding negotiated, see CLICON_IPC_BINARY */
+    int                   ra_nr;         /* Nr of outstanding requests */
+    struct rpc_async_req *ra_reqs;       /* Outstanding requests in sent order */
+    struct rpc_async_req *ra_done;       /* Futures with reply not yet fetched */
+};
+
+/* Forward */
+static int clicon_rpc_async_input(int s, void *arg);
+
+/*! Get asynchronous backend session from handle
+ *
+ * @param[in]  h     Clicon handle
+ * @retval     ra    Asynchronous session
+ * @retval     NULL  Not open
+ */
+static struct rpc_async *
+rpc_async_get(clicon_handle h)
+{
+    struct rpc_async *ra = NULL;
+
+    if (clicon_ptr_get(h, "rpc-async", (void**)&ra) < 0)
+        return NULL;
+    return ra;
+}
+
+/*! Find request with message-id in a request list
+ *
+ * @param[in]  ar0   Request list
+ * @param[in]  id    Message-id
+ * @retval     ar    Request
+ * @retval     NULL  Not found
+ */
+static struct rpc_async_req *
+rpc_async_find(struct rpc_async_req *ar0,
+               uint32_t              id)
+{
+    struct rpc_async_req *ar;
+
+    if ((ar = ar0) != NULL)
+        do {
+            if (ar->ar_id == id)
+                return ar;
+            ar = NEXTQ(struct rpc_async_req *, ar);
+        } while (ar && ar != ar0);
+    return NULL;
+}
+
+/*! Open asynchronous backend session: connect, hello and register socket in event loop
+ *
+ * @param[in]  h     Clicon handle
+ * @retval     ra    Asynchronous session
+ * @retval     NULL  Error
+ */
+static struct rpc_async *
+rpc_async_open(clicon_handle h)
+{
+    struct rpc_async  *ra = NULL;
+    struct clicon_msg *msg = NULL;
+    char              *retdata = NULL;
+    cxobj             *xret = NULL;
+    int                s = -1;
+    int                eof = 0;
+    uint32_t           id = 0;
+    int                shared;
+    int                binary = 0;
+
+    if ((shared = clicon_data_int_get(h, "rpc-async-shared")) > 0){
+        /* Use socket of synchronous session, connect and hello if not done */
+        if (session_id_check(h, &id) < 0)
+            goto done;
+        if (clicon_client_socket_get(h) < 0){
+            if (clicon_rpc_connect(h, &s) < 0)
+                goto done;
+            clicon_client_socket_set(h, s);
+        }
+        s = clicon_client_socket_get(h);
+        binary = clicon_data_int_get(h, "ipc-binary") > 0;
+    }
+    else {
+        if (clicon_rpc_connect(h, &s) < 0)
+            goto done;
+        /* Hello is made synchronously once per session */
+        if ((msg = clicon_hello_msg(h, NULL, NULL)) == NULL)
+            goto done;
+        if (clicon_rpc(s, msg, &retdata, &eof) < 0)
+            goto done;
+        if (eof){
+            clicon_err(OE_PROTO, ESHUTDOWN, "Unexpected close of CLICON_SOCK. Clixon backend daemon may have crashed.");
+            goto done;
+        }
+        if (clixon_xml_parse_string(retdata, YB_NONE, NULL, &xret, NULL) < 0)
+            goto done;
+        if (clicon_hello_reply(xret, &id, &binary) < 0)
+            goto done;
+    }
+    if ((ra = malloc(sizeof(*ra))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(ra, 0, sizeof(*ra));
+    ra->ra_s = s;
+    ra->ra_session_id = id;
+    ra->ra_shared = shared > 0;
+    ra->ra_binary = binary;
+    if (clixon_event_reg_fd(s, clicon_rpc_async_input, h, "backend async session") < 0){
+        free(ra);
+        ra = NULL;
+        goto done;
+    }
+    if (clicon_ptr_set(h, "rpc-async", ra) < 0){
+        clixon_event_unreg_fd(s, clicon_rpc_async_input);
+        free(ra);
+        ra = NULL;
+        goto done;
+    }
+    s = -1;
+ done:
+    if (s != -1 && !shared)
+        close(s);
+    if (xret)
+        xml_free(xret);
+    if (retdata)
+        free(retdata);
+    if (msg)
+        free(msg);
+    return ra;
+}
+
+/*! Close asynchronous backend session and fail all outstanding requests
+ *
+ * Callbacks of outstanding requests are called with an rpc-error reply
+ * A shared socket is not closed, it belongs to the synchronous session.
+ * @param[in]  h       Clicon handle
+ * @param[in]  ra      Asynchronous session
+ * @param[in]  reason  Error message given to outstanding requests
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+static int
+rpc_async_shutdown(clicon_handle     h,
+                   struct rpc_async *ra,
+                   char             *reason)
+{
+    int                   retval = -1;
+    struct rpc_async_req *ar;
+    cxobj                *xerr = NULL;
+
+    clixon_event_unreg_fd(ra->ra_s, clicon_rpc_async_input);
+    if (!ra->ra_shared)
+        close(ra->ra_s);
+    clicon_ptr_del(h, "rpc-async");
+    while ((ar = ra->ra_reqs) != NULL){
+        DELQ(ar, ra->ra_reqs, struct rpc_async_req *);
+        if (ar->ar_fn && !ar->ar_cancel){
+            if (netconf_operation_failed_xml(&xerr, "protocol", reason) < 0)
+                goto done;
+            if (ar->ar_fn(h, xerr, ar->ar_arg) < 0)
+                goto done;
+            xml_free(xerr);
+            xerr = NULL;
+        }
+        free(ar);
+    }
+    while ((ar = ra->ra_done) != NULL){
+        DELQ(ar, ra->ra_done, struct rpc_async_req *);
+        if (ar->ar_xret)
+            xml_free(ar->ar_xret);
+        free(ar);
+    }
+    free(ra);
+    retval = 0;
+ done:
+    if (xerr)
+        xml_free(xerr);
+    return retval;
+}
+
+/*! Read one reply on asynchronous backend session and dispatch it to its request
+ *
+ * Blocks until a reply is read. The reply is given to the oldest outstanding request.
+ * @param[in]  h     Clicon handle
+ * @param[in]  ra    Asynchronous session, may be freed on return if closed
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+rpc_async_dispatch(clicon_handle     h,
+                   struct rpc_async *ra)
+{
+    int                   retval = -1;
+    struct rpc_async_req *ar = NULL;
+    struct clicon_msg    *reply = NULL;
+    cxobj                *xret = NULL;
+    cxobj                *xt = NULL;
+    cxobj                *xr;
+    int                   eof = 0;
+    int                   s;
+    char                 *idstr;
+    uint32_t              id;
+
+    s = ra->ra_s;
+    if (clicon_msg_rcv(s, 0, &reply, &eof) < 0)
+        goto done;
+    if (eof){
+        clicon_log(LOG_WARNING, "%s: Unexpected close of CLICON_SOCK", __FUNCTION__);
+        if (ra->ra_shared){
+            close(s);
+            clicon_client_socket_set(h, -1);
+        }
+        if (rpc_async_shutdown(h, ra, "Unexpected close of CLICON_SOCK. Clixon backend daemon may have crashed.") < 0)
+            goto done;
+        goto ok;
+    }
+    if ((ar = ra->ra_reqs) == NULL){
+        clicon_log(LOG_WARNING, "%s: Unsolicited reply on asynchronous session", __FUNCTION__);
+        goto ok;
+    }
+    DELQ(ar, ra->ra_reqs, struct rpc_async_req *);
+    ra->ra_nr--;
+    if (clixon_xml_parse_string(reply->op_body, YB_NONE, NULL, &xret, NULL) < 0)
+        goto done;
+    /* Replies are in order, message-id is checked if the reply carries it */
+    if (!ar->ar_caller &&
+        (xr = xml_find_type(xret, NULL, "rpc-reply", CX_ELMNT)) != NULL &&
+        (idstr = xml_find_type_value(xr, NULL, "message-id", CX_ATTR)) != NULL &&
+        parse_uint32(idstr, &id, NULL) > 0 &&
+        id != ar->ar_id)
+        clicon_log(LOG_WARNING, "%s: Reply message-id %u does not match request %u",
+                   __FUNCTION__, id, ar->ar_id);
+    if (ar->ar_cancel)
+        goto ok;
+    if (ar->ar_reply){
+        if (ar->ar_reply(h, xret, &xt) < 0)
+            goto done;
+        if (xt){
+            xml_free(xret);
+            xret = xt;
+            xt = NULL;
+        }
+    }
+    if (ar->ar_fn == NULL){ /* Future: keep reply until fetched */
+        ar->ar_xret = xret;
+        xret = NULL;
+        ADDQ(ar, ra->ra_done);
+        ar = NULL;
+    }
+    else if (ar->ar_fn(h, xret, ar->ar_arg) < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    if (ar)
+        free(ar);
+    if (xt)
+        xml_free(xt);
+    if (xret)
+        xml_free(xret);
+    if (reply)
+        free(reply);
+    return retval;
+}
+
+/*! Reply has arrived on asynchronous backend session, event loop callback
+ *
+ * @param[in]  s     Socket
+ * @param[in]  arg   Clicon handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+clicon_rpc_async_input(int   s,
+                       void *arg)
+{
+    clicon_handle     h = (clicon_handle)arg;
+    struct rpc_async *ra;
+
+    clicon_debug(CLIXON_DBG_DETAIL, "%s", __FUNCTION__);
+    if ((ra = rpc_async_get(h)) == NULL || ra->ra_s != s){
+        clicon_err(OE_PROTO, EINVAL, "No asynchronous session on socket %d", s);
+        return -1;
+    }
+    return rpc_async_dispatch(h, ra);
+}
+
+/*! Send an rpc message on the asynchronous backend session
+ *
+ * If the window of outstanding requests is full, wait for the oldest reply first.
+ * If xml is given, it is sent in binary encoding if negotiated, otherwise as rpc, or
+ * serialized if rpc is NULL.
+ * @param[in]  h       Clicon handle
+ * @param[in]  xml     Netconf <rpc> as tree, or NULL
+ * @param[in]  head    Start of netconf <rpc>, or NULL
+ * @param[in]  rpc     Netconf <rpc> as string, or the rest of it after head, or NULL
+ * @param[in]  len     Length of rpc
+ * @param[in]  id      Id used to identify the request, message-id of rpc if xml is NULL
+ * @param[in]  reply   Transform reply before delivering it, or NULL
+ * @param[in]  fn      Reply callback, or NULL for future
+ * @param[in]  arg     Argument to fn
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+static int
+rpc_async_send_msg(clicon_handle        h,
+                   cxobj               *xml,
+                   char                *head,
+                   char                *rpc,
+                   size_t               len,
+                   uint32_t             id,
+                   int                (*reply)(clicon_handle, cxobj *, cxobj **),
+                   clicon_rpc_async_cb *fn,
+                   void                *arg)
+{
+    int                   retval = -1;
+    struct rpc_async     *ra;
+    struct rpc_async_req *ar = NULL;
+    struct clicon_msg    *msg = NULL;
+    int                   window;
+    cbuf                 *cb = NULL;
+
+    if ((ra = rpc_async_get(h)) == NULL &&
+        (ra = rpc_async_open(h)) == NULL)
+        goto done;
+    window = clicon_data_int_get(h, "rpc-async-window");
+    while (window > 0 && ra->ra_nr >= window){
+        if (rpc_async_dispatch(h, ra) < 0)
+            goto done;
+        if ((ra = rpc_async_get(h)) == NULL){
+            clicon_err(OE_PROTO, ESHUTDOWN, "Asynchronous backend session closed");
+            goto done;
+        }
+    }
+    if (xml && ra->ra_binary){
+        if ((msg = clicon_msg_encode_bin(ra->ra_session_id, xml)) == NULL)
+            goto done;
+    }
+    else {
+        if (rpc == NULL){
+            if ((cb = cbuf_new()) == NULL){
+                clicon_err(OE_XML, errno, "cbuf_new");
+                goto done;
+            }
+            if (clixon_xml2cbuf(cb, xml, 0, 0, -1, 0) < 0)
+                goto done;
+            rpc = cbuf_get(cb);
+            len = cbuf_len(cb);
+        }
+        if ((msg = clicon_msg_encode_raw(ra->ra_session_id, head, rpc, len)) == NULL)
+            goto done;
+    }
+    if ((ar = malloc(sizeof(*ar))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(ar, 0, sizeof(*ar));
+    ar->ar_id = id;
+    ar->ar_caller = (xml != NULL);
+    ar->ar_fn = fn;
+    ar->ar_arg = arg;
+    ar->ar_reply = reply;
+    if (clicon_msg_send(ra->ra_s, msg) < 0){
+        /* Session is broken, fail outstanding requests, but not this one */
+        rpc_async_shutdown(h, ra, "Write to CLICON_SOCK failed");
+        goto done;
+    }
+    ADDQ(ar, ra->ra_reqs);
+    ra->ra_nr++;
+    ar = NULL;
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    if (ar)
+        free(ar);
+    if (msg)
+        free(msg);
+    return retval;
+}
+
+/*! Send a netconf operation on the asynchronous backend session
+ *
+ * @param[in]  h       Clicon handle
+ * @param[in]  op      Netconf operation XML, ie the body of <rpc>
+ * @param[in]  reply   Transform reply before calling fn, or NULL
+ * @param[in]  fn      Reply callback, or NULL for future
+ * @param[in]  arg     Argument to fn
+ * @param[out] idp     Message-id of request (if not NULL)
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+static int
+rpc_async_send(clicon_handle        h,
+               char                *op,
+               int                (*reply)(clicon_handle, cxobj *, cxobj **),
+               clicon_rpc_async_cb *fn,
+               void                *arg,
+               uint32_t            *idp)
+{
+    int       retval = -1;
+    cbuf     *cb = NULL;
+    char     *username;
+    uint32_t  id;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    id = netconf_message_id_next(h);
+    cprintf(cb, "<rpc xmlns=\"%s\"", NETCONF_BASE_NAMESPACE);
+    cprintf(cb, " xmlns:%s=\"%s\"", NETCONF_BASE_PREFIX, NETCONF_BASE_NAMESPACE);
+    if ((username = clicon_username_get(h)) != NULL){
+        cprintf(cb, " %s:username=\"%s\"", CLIXON_LIB_PREFIX, username);
+        cprintf(cb, " xmlns:%s=\"%s\"", CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    }
+    cprintf(cb, " message-id=\"%u\">%s</rpc>", id, op);
+    if (rpc_async_send_msg(h, NULL, NULL, cbuf_get(cb), cbuf_len(cb), id, reply, fn, arg) < 0)
+        goto done;
+    if (idp)
+        *idp = id;
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Wait for all outstanding requests of a shared asynchronous session
+ *
+ * Called before a synchronous rpc on the same socket, so that the synchronous reply
+ * is not mixed up with outstanding asynchronous replies.
+ * @param[in]  h     Clicon handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+rpc_async_shared_flush(clicon_handle h)
+{
+    struct rpc_async *ra;
+
+    if ((ra = rpc_async_get(h)) != NULL && ra->ra_shared)
+        return clicon_rpc_async_flush(h);
+    return 0;
+}
+
+/*! The synchronous socket is closed, close shared asynchronous session
+ *
+ * @param[in]  h     Clicon handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+rpc_async_shared_detach(clicon_handle h)
+{
+    struct rpc_async *ra;
+
+    if ((ra = rpc_async_get(h)) != NULL && ra->ra_shared)
+        return rpc_async_shutdown(h, ra, "Backend session closed");
+    return 0;
+}
+
+/*! Send a netconf rpc asynchronously to the backend without waiting for reply
+ *
+ * The reply is delivered by calling fn with the <rpc-reply> tree, either from the event
+ * loop or from clicon_rpc_async_wait/flush.
+ * If fn is NULL, the request is a future and the reply is fetched with clicon_rpc_async_wait.
+ * If the backend session closes, fn is called with an rpc-error reply.
+ * If the request is cancelled, fn is called with xret set to NULL.
+ * @param[in]  h       Clicon handle
+ * @param[in]  op      Netconf operation XML, ie the body of <rpc>, eg "<get-config>...</get-config>"
+ * @param[in]  fn      Reply callback, or NULL. The reply tree is freed when fn returns
+ * @param[in]  arg     Argument to fn
+ * @param[out] idp     Message-id of request, may be used in clicon_rpc_async_wait/cancel
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @code
+ *   static int
+ *   my_reply(clicon_handle h, cxobj *xret, void *arg)
+ *   {
+ *       ...
+ *   }
+ *   if (clicon_rpc_netconf_async(h, "<discard-changes/>", my_reply, NULL, NULL) < 0)
+ *      err;
+ * @endcode
+ * @see clicon_rpc_netconf  synchronous variant
+ */
+int
+clicon_rpc_netconf_async(clicon_handle        h,
+                         char                *op,
+                         clicon_rpc_async_cb *fn,
+                         void                *arg,
+                         uint32_t            *idp)
+{
+    return rpc_async_send(h, op, NULL, fn, arg, idp);
+}
+
+/*! Send a netconf rpc as xml tree asynchronously to the backend without waiting for reply
+ *
+ * As clicon_rpc_netconf_async, but the whole <rpc> is given as tree and sent as is,
+ * including its attributes, in binary encoding if negotiated. The reply is not bound to yang.
+ * @param[in]  h       Clicon handle
+ * @param[in]  xml     XML netconf tree on the form <rpc>...</rpc>
+ * @param[in]  fn      Reply callback, or NULL for future. The reply tree is freed when fn returns
+ * @param[in]  arg     Argument to fn
+ * @param[out] idp     Id of request, may be used in clicon_rpc_async_wait/cancel
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see clicon_rpc_netconf_xml  synchronous variant
+ */
+int
+clicon_rpc_netconf_xml_async(clicon_handle        h,
+                             cxobj               *xml,
+                             clicon_rpc_async_cb *fn,
+                             void                *arg,
+                             uint32_t            *idp)
+{
+    int      retval = -1;
+    uint32_t id;
+
+    /* The message-id of the tree belongs to the caller, use an internal id for the request */
+    id = netconf_message_id_next(h);
+    if (rpc_async_send_msg(h, xml, NULL, NULL, 0, id, NULL, fn, arg) < 0)
+        goto done;
+    if (idp)
+        *idp = id;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Send a netconf rpc asynchronously to the backend as its original text
+ *
+ * As clicon_rpc_netconf_xml_async, but the message is sent as the text the tree was 
+ * parsed from, with the username of the session added, see clicon_rpc_netconf_raw.
+ * The tree is sent in binary encoding instead if negotiated with the backend.
+ * @param[in]  h       Clicon handle
+ * @param[in]  xml     XML netconf tree on the form <rpc>...</rpc>, parsed from raw
+ * @param[in]  raw     Text of xml, or NULL. Must not have a username attribute
+ * @param[in]  len     Length of raw
+ * @param[in]  fn      Reply callback, or NULL for future. The reply tree is freed when fn returns
+ * @param[in]  arg     Argument to fn
+ * @param[out] idp     Id of request, may be used in clicon_rpc_async_wait/cancel
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see clicon_rpc_netconf_raw  synchronous variant
+ */
+int
+clicon_rpc_netconf_raw_async(clicon_handle        h,
+                             cxobj               *xml,
+                             char                *raw,
+                             size_t               len,
+                             clicon_rpc_async_cb *fn,
+                             void                *arg,
+                             uint32_t            *idp)
+{
+    int      retval = -1;
+    cbuf    *cbhead = NULL;
+    uint32_t id;
+
+    if ((cbhead = cbuf_new()) == NULL){
+        clicon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    if (rpc_netconf_raw_head(h, raw, len, cbhead) == 0){
+        retval = clicon_rpc_netconf_xml_async(h, xml, fn, arg, idp);
+        goto done;
+    }
+    /* The message-id of the rpc belongs to the caller, use an internal id for the request */
+    id = netconf_message_id_next(h);
+    if (rpc_async_send_msg(h, xml, cbuf_get(cbhead), raw + strlen("<rpc"), len - strlen("<rpc"),
+                           id, NULL, fn, arg) < 0)
+        goto done;
+    if (idp)
+        *idp = id;
+    retval = 0;
+ done:
+    if (cbhead)
+        cbuf_free(cbhead);
+    return retval;
+}
+
+/*! Get database configuration and state data asynchronously
+ *
+ * Same as clicon_rpc_get, but the result is delivered by calling fn with either
+ * <data> or <rpc-error> as tree
+ * @param[in]  h         Clicon handle
+ * @param[in]  xpath     XPath in a filter stmt (or NULL/"" for no filter)
+ * @param[in]  nsc       Namespace context for filter
+ * @param[in]  content   Clixon extension: all, config, noconfig. -1 means all
+ * @param[in]  depth     Nr of XML levels to get, -1 is all, 0 is none
+ * @param[in]  defaults  Value of the with-defaults mode, rfc6243, or NULL
+ * @param[in]  fn        Reply callback, or NULL for future. The reply tree is freed when fn returns
+ * @param[in]  arg       Argument to fn
+ * @param[out] idp       Message-id of request, may be used in clicon_rpc_async_wait/cancel
+ * @retval     0         OK
+ * @retval    -1         Error
+ * @see clicon_rpc_get  synchronous variant
+ */
+int
+clicon_rpc_get_async(clicon_handle        h,
+                     char                *xpath,
+                     cvec                *nsc,
+                     netconf_content      content,
+                     int32_t              depth,
+                     char                *defaults,
+                     clicon_rpc_async_cb *fn,
+                     void                *arg,
+                     uint32_t            *idp)
+{
+    int   retval = -1;
+    cbuf *cb = NULL;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    if (clicon_rpc_get_body(cb, xpath, nsc, content, depth, defaults) < 0)
+        goto done;
+    if (rpc_async_send(h, cbuf_get(cb), clicon_rpc_get_reply, fn, arg, idp) < 0)
+        goto done;
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Wait for the reply of an asynchronous request
+ *
+ * Blocks, reading and dispatching replies in order, until the request is done.
+ * Replies of earlier requests are delivered to their callbacks on the way.
+ * @param[in]  h     Clicon handle
+ * @param[in]  id    Message-id of request
+ * @param[out] xret  Future: the reply, free with xml_free. NULL if request has callback
+ * @retval     0     OK
+ * @retval    -1     Error, or request not found
+ * @code
+ *   uint32_t id;
+ *   cxobj   *xret = NULL;
+ *   if (clicon_rpc_netconf_async(h, "<commit/>", NULL, NULL, &id) < 0)
+ *      err;
+ *   ...
+ *   if (clicon_rpc_async_wait(h, id, &xret) < 0)
+ *      err;
+ *   xml_free(xret);
+ * @endcode
+ */
+int
+clicon_rpc_async_wait(clicon_handle h,
+                      uint32_t      id,
+                      cxobj       **xret)
+{
+    int                   retval = -1;
+    struct rpc_async     *ra;
+    struct rpc_async_req *ar;
+
+    if (xret)
+        *xret = NULL;
+    while ((ra = rpc_async_get(h)) != NULL &&
+           rpc_async_find(ra->ra_reqs, id) != NULL){
+        if (rpc_async_dispatch(h, ra) < 0)
+            goto done;
+    }
+    if (ra == NULL){
+        clicon_err(OE_PROTO, ESHUTDOWN, "Asynchronous backend session closed");
+        goto done;
+    }
+    if ((ar = rpc_async_find(ra->ra_done, id)) != NULL){
+        DELQ(ar, ra->ra_done, struct rpc_async_req *);
+        if (xret)
+            *xret = ar->ar_xret;
+        else if (ar->ar_xret)
+            xml_free(ar->ar_xret);
+        free(ar);
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Wait for the replies of all outstanding asynchronous requests
+ *
+ * Callbacks are called in order. Replies of futures are kept until fetched.
+ * @param[in]  h     Clicon handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+int
+clicon_rpc_async_flush(clicon_handle h)
+{
+    struct rpc_async *ra;
+
+    while ((ra = rpc_async_get(h)) != NULL && ra->ra_reqs != NULL)
+        if (rpc_async_dispatch(h, ra) < 0)
+            return -1;
+    return 0;
+}
+
+/*! Set window: max number of outstanding asynchronous requests
+ *
+ * @param[in]  h       Clicon handle
+ * @param[in]  window  Max nr of outstanding requests, 0 means unlimited
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+int
+clicon_rpc_async_window_set(clicon_handle h,
+                            int           window)
+{
+    if (window < 0){
+        clicon_err(OE_PROTO, EINVAL, "Invalid window: %d", window);
+        return -1;
+    }
+    return clicon_data_int_set(h, "rpc-async-window", window);
+}
+
+/*! Use the synchronous backend session also for asynchronous requests
+ *
+ * Then locks and other session state apply to both synchronous and asynchronous requests.
+ * Must be set before the first asynchronous request.
+ * @param[in]  h       Clicon handle
+ * @param[in]  shared  0: separate session (default), 1: shared session
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+int
+clicon_rpc_async_shared_set(clicon_handle h,
+                            int           shared)
+{
+    if (rpc_async_get(h) != NULL){
+        clicon_err(OE_PROTO, EBUSY, "Asynchronous backend session already open");
+        return -1;
+    }
+    return clicon_data_int_set(h, "rpc-async-shared", shared);
+}
+
+/*! Cancel an outstanding asynchronous request
+ *
+ * The callback is called once with xret set to NULL so that it can free its argument.
+ * The request is still outstanding in the backend and its reply is discarded when it arrives.
+ * A done future is freed.
+ * @param[in]  h     Clicon handle
+ * @param[in]  id    Message-id of request
+ * @retval     1     Cancelled
+ * @retval     0     Not found
+ * @retval    -1     Error in callback
+ */
+int
+clicon_rpc_async_cancel(clicon_handle h,
+                        uint32_t      id)
+{
+    struct rpc_async     *ra;
+    struct rpc_async_req *ar;
+
+    if ((ra = rpc_async_get(h)) == NULL)
+        return 0;
+    if ((ar = rpc_async_find(ra->ra_reqs, id)) != NULL && !ar->ar_cancel){
+        ar->ar_cancel = 1;
+        if (ar->ar_fn && ar->ar_fn(h, NULL, ar->ar_arg) < 0)
+            return -1;
+        return 1;
+    }
+    if ((ar = rpc_async_find(ra->ra_done, id)) != NULL){
+        DELQ(ar, ra->ra_done, struct rpc_async_req *);
+        if (ar->ar_xret)
+            xml_free(ar->ar_xret);
+        free(ar);
+        return 1;
+    }
+    return 0;
+}
+
+/*! Close asynchronous backend session
+ *
+ * Outstanding requests are cancelled, @see clicon_rpc_async_cancel
+ * @param[in]  h     Clicon handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+int
+clicon_rpc_async_close(clicon_handle h)
+{
+    struct rpc_async     *ra;
+    struct rpc_async_req *ar;
+
+    if ((ra = rpc_async_get(h)) != NULL){
+        if ((ar = ra->ra_reqs) != NULL)
+            do {
+                if (clicon_rpc_async_cancel(h, ar->ar_id) < 0)
+                    return -1;
+                ar = NEXTQ(struct rpc_async_req *, ar);
+            } while (ar && ar != ra->ra_reqs);
+        /* A shared socket is used further, discard outstanding replies */
+        if (ra->ra_shared){
+            if (clicon_rpc_async_flush(h) < 0)
+                return -1;
+            if ((ra = rpc_async_get(h)) == NULL)
+                return 0;
+        }
+        if (rpc_async_shutdown(h, ra, NULL) < 0)
+            return -1;
+    }
+    return 0;
+}
@@ -73,6 +73,7 @@
 #include "clixon_xml_io.h"
 #include "clixon_xpath_ctx.h"
 #include "clixon_xpath.h"
+#include "clixon_xpath_compile.h"
 #include "clixon_yang_module.h"
 #include "clixon_yang_type.h"
 #include "clixon_yang_schema_mount.h"
@@ -1222,7 +1223,6 @@ xml_yang_validate_all(clicon_handle h,
     cxobj     *xp;
     char      *ns = NULL;
     cbuf      *cb = NULL;
-    cvec      *nsc = NULL;
     int        hit = 0;
     validate_level vl = VL_NONE;
 
@@ -1325,10 +1325,9 @@ xml_yang_validate_all(clicon_handle h,
             /* the context node is the node in the accessible tree for
              * which the "must" statement is defined. 
              * The set of namespace declarations is the set of all "import" statements' 
+             * Compiled at first use and cached in yc
              */
-           if (xml_nsctx_yang(yc, &nsc) < 0)
-               goto done;
-            if ((nr = xpath_vec_bool(xt, nsc, "%s", xpath)) < 0)
+            if ((nr = xpath_prog_yang_bool(yc, xt)) < 0)
                 goto done;
             if (!nr){
                 ye = yang_find(yc, Y_ERROR_MESSAGE, NULL);
@@ -1343,10 +1342,6 @@ xml_yang_validate_all(clicon_handle h,
                     goto done;
                 goto fail;
             }
-            if (nsc){
-                xml_nsctx_free(nsc);
-                nsc = NULL;
-            }
         }
     }
     x = NULL;
@@ -1369,8 +1364,6 @@ xml_yang_validate_all(clicon_handle h,
  done:
     if (cb)
         cbuf_free(cb);
-    if (nsc)
-        xml_nsctx_free(nsc);
     return retval;
  fail:
     retval = 0;
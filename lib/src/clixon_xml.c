@@ -641,6 +641,9 @@ xml_value_set(cxobj *xn,
 {
     int    retval = -1;
     size_t sz;
+#ifdef XML_EXPLICIT_INDEX
+    cxobj *xi = NULL;
+#endif
 
     if (!is_bodyattr(xn))
         return 0;
@@ -648,6 +651,17 @@ xml_value_set(cxobj *xn,
         clicon_err(OE_XML, EINVAL, "value is NULL");
         goto done;
     }
+#ifdef XML_EXPLICIT_INDEX
+    /* Body of search index variable: move list entry in search vector */
+    if (xml_type(xn) == CX_BODY &&
+        (xi = xml_parent(xn)) != NULL &&
+        xml_search_index_p(xi)){
+        if (xml_search_child_rm(xml_parent(xi), xi) < 0)
+            goto done;
+    }
+    else
+        xi = NULL;
+#endif
     sz = strlen(val)+1;
     if (xn->x_value_cb == NULL){
         if ((xn->x_value_cb = cbuf_new_alloc(sz)) == NULL){
@@ -658,6 +672,13 @@ xml_value_set(cxobj *xn,
     else
         cbuf_reset(xn->x_value_cb);
     cbuf_append_str(xn->x_value_cb, val);
+#ifdef XML_EXPLICIT_INDEX
+    if (xi != NULL){
+        xml_cv_set(xi, NULL);
+        if (xml_search_child_insert(xml_parent(xi), xi) < 0)
+            goto done;
+    }
+#endif
     retval = 0;
  done:
     return retval;
@@ -1172,6 +1193,12 @@ xml_spec_set(cxobj     *x,
 {
     if (!is_element(x))
         return 0;
+#ifdef XML_EXPLICIT_INDEX
+    if (spec != NULL && x->x_spec != spec && x->x_up != NULL){
+        x->x_spec = spec;
+        return xml_search_index_attach(x->x_up, x);
+    }
+#endif
     x->x_spec = spec;
     return 0;
 }
@@ -1299,8 +1326,8 @@ xml_addsub(cxobj *xp,
         /* clear namespace context cache of child */
         nscache_clear(xc);
 #ifdef XML_EXPLICIT_INDEX
-    if (xml_search_index_p(xc))
-            xml_search_child_insert(xp, xc);
+        if (xml_search_index_attach(xp, xc) < 0)
+            goto done;
 #endif
     }
     retval = 0;
@@ -1417,18 +1444,16 @@ xml_child_rm(cxobj *xp,
         clicon_err(OE_XML, 0, "Child not found");
         goto done;
     }
+#ifdef XML_EXPLICIT_INDEX
+    /* Before removing since the index variable is found via its parent */
+    if (xml_search_index_detach(xp, xc) < 0)
+        goto done;
+#endif
     xml_parent_set(xc, NULL);
     xp->x_childvec[i] = NULL;
     xp->x_childvec_len--;
     if (i<xp->x_childvec_len)
         memmove(&xp->x_childvec[i], &xp->x_childvec[i+1], (xp->x_childvec_len-i)*sizeof(cxobj*));
-#ifdef XML_EXPLICIT_INDEX
-    if (xml_type(xc) == CX_ELMNT){
-        if (xml_search_index_p(xc))
-            xml_search_child_rm(xp, xc);
-
-    }
-#endif
     retval = 0;
  done:
     return retval;
@@ -2614,6 +2639,166 @@ xml_search_index_get(cxobj *x,
     return si;
 }
 
+/* Index variable name used by xml_search_index_qsort, qsort has no user argument */
+static char *_search_index_name = NULL;
+
+/*! Sort list entries in search index vector on index variable
+ */
+static int
+xml_search_index_qsort(const void *arg1,
+                       const void *arg2)
+{
+    cxobj *x1 = *(struct xml **)arg1;
+    cxobj *x2 = *(struct xml **)arg2;
+
+    return xml_cmp(x1, x2, 0, 0, _search_index_name);
+}
+
+/*! Find position of a list entry in a search index vector
+ *
+ * Binary search on the value of the index variable, then among entries with equal value
+ * (non-key variables need not be unique) for the entry itself.
+ * @param[in]  si    Search index
+ * @param[in]  xp    XML list entry
+ * @param[out] pos   Position of xp, or where to insert xp if not found
+ * @retval     1     Found
+ * @retval     0     Not found
+ * @retval    -1     Error
+ */
+static int
+xml_search_index_pos(struct search_index *si,
+                     cxobj               *xp,
+                     int                 *pos)
+{
+    int    retval = -1;
+    char  *indexvar = si->si_name;
+    int    len;
+    int    i;
+    int    j;
+    int    eq = 0;
+    cxobj *xc;
+
+    len = clixon_xvec_len(si->si_xvec);
+    if ((i = xml_search_indexvar_binary_pos(xp, indexvar, si->si_xvec, 0, len, len, &eq)) < 0)
+        goto done;
+    *pos = i;
+    if (eq){
+        for (j=i; j>=0; j--){
+            xc = clixon_xvec_i(si->si_xvec, j);
+            if (xc == xp){
+                *pos = j;
+                goto found;
+            }
+            if (xml_cmp(xp, xc, 0, 0, indexvar) != 0)
+                break;
+        }
+        for (j=i+1; j<len; j++){
+            xc = clixon_xvec_i(si->si_xvec, j);
+            if (xc == xp){
+                *pos = j;
+                goto found;
+            }
+            if (xml_cmp(xp, xc, 0, 0, indexvar) != 0)
+                break;
+        }
+    }
+    retval = 0;
+ done:
+    return retval;
+ found:
+    retval = 1;
+    goto done;
+}
+
+/*! Update search vectors when an XML node is added to a parent or gets a yang spec
+ *
+ * Either an index variable is added to a list entry, or a list entry with index variables
+ * is added to a parent with search vectors.
+ * @param[in] xp  XML parent object
+ * @param[in] xc  XML child object, already added to xp
+ * @retval    0   OK
+ * @retval   -1   Error
+ * @see xml_search_index_detach
+ */
+int
+xml_search_index_attach(cxobj *xp,
+                        cxobj *xc)
+{
+    int        retval = -1;
+    yang_stmt *y;
+    cxobj     *xi;
+
+    if (xml_type(xc) != CX_ELMNT || (y = xml_spec(xc)) == NULL)
+        goto ok;
+    if (yang_keyword_get(y) == Y_LIST){
+        if (xp->x_search_index == NULL)
+            goto ok;
+        xi = NULL;
+        while ((xi = xml_child_each(xc, xi, CX_ELMNT)) != NULL)
+            if (xml_search_index_p(xi) &&
+                xml_search_child_insert(xc, xi) < 0)
+                goto done;
+    }
+    else if (xml_search_index_p(xc)){
+        if (xml_search_child_insert(xp, xc) < 0)
+            goto done;
+    }
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Remove all search vectors of an XML node, they are rebuilt at next search
+ *
+ * Used when many list entries are added at once, instead of inserting each in the vectors
+ * @param[in] x   XML parent object of list entries
+ * @retval    0   OK
+ * @see xml_search_vector_build
+ */
+int
+xml_search_index_reset(cxobj *x)
+{
+    return xml_search_index_free(x);
+}
+
+/*! Update search vectors when an XML node is removed from a parent
+ *
+ * @param[in] xp  XML parent object
+ * @param[in] xc  XML child object, not yet removed from xp
+ * @retval    0   OK
+ * @retval   -1   Error
+ * @see xml_search_index_attach
+ */
+int
+xml_search_index_detach(cxobj *xp,
+                        cxobj *xc)
+{
+    int        retval = -1;
+    yang_stmt *y;
+    cxobj     *xi;
+
+    if (xml_type(xc) != CX_ELMNT || (y = xml_spec(xc)) == NULL)
+        goto ok;
+    if (yang_keyword_get(y) == Y_LIST){
+        if (xp->x_search_index == NULL)
+            goto ok;
+        xi = NULL;
+        while ((xi = xml_child_each(xc, xi, CX_ELMNT)) != NULL)
+            if (xml_search_index_p(xi) &&
+                xml_search_child_rm(xc, xi) < 0)
+                goto done;
+    }
+    else if (xml_search_index_p(xc)){
+        if (xml_search_child_rm(xp, xc) < 0)
+            goto done;
+    }
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*--------------------------------------------------*/
 
 /*! Get sorted index vector for list for variable "name"
@@ -2642,36 +2827,85 @@ xml_search_vector_get(cxobj        *xp,
     return 0;
 }
 
+/*! Build search index vector of list entries for variable "name" if not already done
+ *
+ * Search vectors are built on first search, then maintained when list entries and index
+ * variables are added, removed or changed.
+ * @param[in]  xp    XML parent object of list entries
+ * @param[in]  name  Name of index variable
+ * @param[out] xvec  XML object search vector
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see xml_search_index_attach
+ */
+int
+xml_search_vector_build(cxobj        *xp,
+                        char         *name,
+                        clixon_xvec **xvec)
+{
+    int                  retval = -1;
+    struct search_index *si;
+    cxobj              **vec = NULL;
+    int                  len = 0;
+    cxobj               *xc;
+    cxobj               *xi;
+    int                  i;
+
+    if ((si = xml_search_index_get(xp, name)) == NULL){
+        if ((vec = calloc(xml_child_nr(xp)+1, sizeof(cxobj *))) == NULL){
+            clicon_err(OE_XML, errno, "calloc");
+            goto done;
+        }
+        xc = NULL;
+        while ((xc = xml_child_each(xp, xc, CX_ELMNT)) != NULL) {
+            if ((xi = xml_find_type(xc, NULL, name, CX_ELMNT)) != NULL &&
+                xml_search_index_p(xi))
+                vec[len++] = xc;
+        }
+        _search_index_name = name;
+        qsort(vec, len, sizeof(cxobj *), xml_search_index_qsort);
+        _search_index_name = NULL;
+        if ((si = xml_search_index_add(xp, name)) == NULL)
+            goto done;
+        for (i=0; i<len; i++)
+            if (clixon_xvec_append(si->si_xvec, vec[i]) < 0)
+                goto done;
+    }
+    *xvec = si->si_xvec;
+    retval = 0;
+ done:    
+    if (vec)
+        free(vec);
+    return retval;
+}
+
 /*! Insert a new cxobj into search index vector for list for variable "name"
+ *
+ * Only if the search vector exists, otherwise it is built at first search.
  * @param[in] xp XML parent object (the list element)
  * @param[in] xi XML index object (that should be added)
+ * @see xml_search_vector_build
  */
 int
 xml_search_child_insert(cxobj *xp,
                         cxobj *xi)
 {
     int                  retval = -1;
-    char                *indexvar;
     struct search_index *si;
     cxobj               *xpp;
     int                  i;
-    int                  len;
-    
-    indexvar = xml_name(xi);
+    int                  ret;
+
     if ((xpp = xml_parent(xp)) == NULL)
         goto ok;
     /* Find base vector in grandparent */
-    if ((si = xml_search_index_get(xpp, indexvar)) == NULL){
-        /* If not found add base vector in grand-parent */            
-        if ((si = xml_search_index_add(xpp, indexvar)) == NULL)
-            goto done;
-    }
-    /* Find element position using binary search and then remove */
-    len = clixon_xvec_len(si->si_xvec);
-    if ((i = xml_search_indexvar_binary_pos(xp, indexvar, si->si_xvec, 0, len, len, NULL)) < 0)
+    if ((si = xml_search_index_get(xpp, xml_name(xi))) == NULL)
+        goto ok;
+    /* Find element position using binary search, it may already be there, eg bound again */
+    if ((ret = xml_search_index_pos(si, xp, &i)) < 0)
         goto done;
-    assert(clixon_xvec_i(si->si_xvec, i) != xp);
-    if (clixon_xvec_insert_pos(si->si_xvec, xp, i) < 0)
+    if (ret == 0 &&
+        clixon_xvec_insert_pos(si->si_xvec, xp, i) < 0)
         goto done;
  ok:
     retval = 0;
@@ -2689,30 +2923,31 @@ xml_search_child_rm(cxobj *xp,
 {
     int                 retval = -1;
     cxobj              *xpp;
-    char               *indexvar;
     int                 i;
-    int                 len;
+    int                 ret;
     struct search_index *si;
-    int                  eq = 0;
-    
-    indexvar = xml_name(xi);
+
     if ((xpp = xml_parent(xp)) == NULL)
         goto ok;
     /* Find base vector in grandparent */
-    if ((si = xml_search_index_get(xpp, indexvar)) == NULL)
+    if ((si = xml_search_index_get(xpp, xml_name(xi))) == NULL)
         goto ok;
-    
     /* Find element using binary search and then remove */
-    len = clixon_xvec_len(si->si_xvec);
-    if ((i = xml_search_indexvar_binary_pos(xp, indexvar, si->si_xvec, 0, len, len, &eq)) < 0)
+    if ((ret = xml_search_index_pos(si, xp, &i)) < 0)
+        goto done;
+    if (ret == 0){
+        /* Not found where its value says, eg value changed without xml_value_set */
+        for (i=0; i<clixon_xvec_len(si->si_xvec); i++)
+            if (clixon_xvec_i(si->si_xvec, i) == xp)
+                break;
+        if (i == clixon_xvec_len(si->si_xvec))
+            goto ok;
+    }
+    if (clixon_xvec_rm_pos(si->si_xvec, i) < 0)
         goto done;
-        //    if (clixon_xvec_i(si->si_xvec, i) == xp)
-    if (eq)
-        if (clixon_xvec_rm_pos(si->si_xvec, i) < 0)
-            goto done;          
  ok:
     retval = 0;
- done:
+ done:    
     return retval;
 }
 
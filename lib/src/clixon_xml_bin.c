@@ -0,0 +1,731 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * Binary datastore snapshot format
+ *
+ * File layout, all integers are uint32_t in host byte order:
+ *   header      struct xmlbin_hdr
+ *   stroff      [xh_nstr]           Offset of each string in the string blob
+ *   schema      [xh_nschema * 3]    Schema node table: parent index, name, namespace
+ *   nodes       [xh_nnode * 6]      XML nodes in pre-order: type, schema, name, prefix,
+ *                                   value, nr of children
+ *   strings     [xh_strlen]         String blob of null-terminated strings
+ * XML nodes refer to strings and schema nodes by index. Schema nodes are resolved once
+ * per file against the yang spec, which binds all XML nodes of that schema node.
+ * Children are written in the order of the (sorted) tree, and are not sorted on load,
+ * except that attributes are written before other children.
+ * The same format is used in memory for internal netconf messages, see clicon_msg_encode_bin
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clixon */
+#include "clixon_err.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_log.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_yang_module.h"
+#include "clixon_xml_bin.h"
+
+/*
+ * Constants
+ */
+#define XMLBIN_MAGIC    "CLXNBIN"     /* Including null: 8 bytes */
+#define XMLBIN_VERSION  1
+#define XMLBIN_NONE     0xffffffff    /* No string or schema node */
+#define XMLBIN_SCHEMA_W 3             /* Nr of uint32 in a schema node entry */
+#define XMLBIN_NODE_W   6             /* Nr of uint32 in a XML node entry */
+#define XMLBIN_MAXDEPTH 1024          /* Max nesting of XML nodes, bounds recursion */
+
+/*
+ * Types
+ */
+/* File header */
+struct xmlbin_hdr {
+    char     xh_magic[8];
+    uint32_t xh_version;
+    uint32_t xh_nstr;     /* Nr of strings */
+    uint32_t xh_nschema;  /* Nr of schema nodes */
+    uint32_t xh_nnode;    /* Nr of XML nodes */
+    uint32_t xh_strlen;   /* Length of string blob */
+    uint32_t xh_pad;
+};
+
+/* Growable uint32 vector used when writing */
+typedef struct {
+    uint32_t *uv_vec;
+    size_t    uv_len;
+    size_t    uv_max;
+} xmlbin_vec;
+
+/* Writer state */
+typedef struct {
+    cbuf          *xw_str;      /* String blob */
+    xmlbin_vec     xw_stroff;   /* String offsets */
+    clicon_hash_t *xw_strhash;  /* Names, prefixes and attribute values: string -> index */
+    xmlbin_vec     xw_schema;   /* Schema node table */
+    clicon_hash_t *xw_yhash;    /* Yang statement pointer -> schema index */
+    xmlbin_vec     xw_node;     /* XML nodes */
+} xmlbin_writer;
+
+/* Reader state */
+typedef struct {
+    char        *xr_strings;   /* String blob */
+    uint32_t    *xr_stroff;
+    uint32_t     xr_nstr;
+    yang_stmt  **xr_yvec;      /* Resolved schema nodes, NULL if not found */
+    uint32_t     xr_nschema;
+    uint32_t    *xr_node;
+    uint32_t     xr_nnode;
+    uint32_t     xr_i;         /* Next XML node */
+    int          xr_bound;     /* Cleared if a XML node could not be bound */
+    int          xr_strict;    /* Also unbound: element without schema node in bound parent */
+} xmlbin_reader;
+
+/*------------------------------------------------------------------------
+ * Write
+ *------------------------------------------------------------------------*/
+
+/*! Append values to uint32 vector
+ */
+static int
+xmlbin_vec_add(xmlbin_vec *uv,
+               uint32_t   *v,
+               size_t      n)
+{
+    size_t i;
+
+    if (uv->uv_len + n > uv->uv_max){
+        uv->uv_max = uv->uv_max ? 2*uv->uv_max : 1024;
+        while (uv->uv_len + n > uv->uv_max)
+            uv->uv_max *= 2;
+        if ((uv->uv_vec = realloc(uv->uv_vec, uv->uv_max*sizeof(uint32_t))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            return -1;
+        }
+    }
+    for (i=0; i<n; i++)
+        uv->uv_vec[uv->uv_len++] = v[i];
+    return 0;
+}
+
+/*! Add string to string table and return its index
+ *
+ * @param[in]  xw     Writer state
+ * @param[in]  str    String, or NULL
+ * @param[in]  dedup  If set, share identical strings (names, prefixes), otherwise append
+ * @param[out] sid    String index, or XMLBIN_NONE if str is NULL
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+xmlbin_str(xmlbin_writer *xw,
+           char          *str,
+           int            dedup,
+           uint32_t      *sid)
+{
+    uint32_t *val;
+    uint32_t  off;
+    uint32_t  id;
+
+    if (str == NULL){
+        *sid = XMLBIN_NONE;
+        return 0;
+    }
+    if (dedup &&
+        (val = clicon_hash_value(xw->xw_strhash, str, NULL)) != NULL){
+        *sid = *val;
+        return 0;
+    }
+    id = xw->xw_stroff.uv_len;
+    off = cbuf_len(xw->xw_str);
+    if (xmlbin_vec_add(&xw->xw_stroff, &off, 1) < 0)
+        return -1;
+    if (cbuf_append_buf(xw->xw_str, str, strlen(str)+1) < 0){
+        clicon_err(OE_UNIX, errno, "cbuf_append_buf");
+        return -1;
+    }
+    if (dedup &&
+        clicon_hash_add(xw->xw_strhash, str, &id, sizeof(id)) == NULL)
+        return -1;
+    *sid = id;
+    return 0;
+}
+
+/*! Get or add schema node of yang statement
+ *
+ * An rpc or action is bound to its input or output statement. It is added with
+ * the rpc or action as parent schema node and the keyword as name.
+ * @param[in]  xw     Writer state
+ * @param[in]  y      Yang statement of XML node
+ * @param[in]  pid    Schema index of XML parent, or XMLBIN_NONE if top-level
+ * @param[out] yid    Schema index
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+xmlbin_schema(xmlbin_writer *xw,
+              yang_stmt     *y,
+              uint32_t       pid,
+              uint32_t      *yid)
+{
+    char      key[32];
+    uint32_t *val;
+    uint32_t  v[XMLBIN_SCHEMA_W];
+    uint32_t  id;
+    char     *name;
+
+    snprintf(key, sizeof(key), "%p", y);
+    if ((val = clicon_hash_value(xw->xw_yhash, key, NULL)) != NULL){
+        *yid = *val;
+        return 0;
+    }
+    name = yang_argument_get(y);
+    if (yang_keyword_get(y) == Y_INPUT || yang_keyword_get(y) == Y_OUTPUT){
+        if (xmlbin_schema(xw, yang_parent_get(y), pid, &pid) < 0)
+            return -1;
+        name = yang_key2str(yang_keyword_get(y));
+    }
+    v[0] = pid;
+    if (xmlbin_str(xw, name, 1, &v[1]) < 0)
+        return -1;
+    if (xmlbin_str(xw, yang_find_mynamespace(y), 1, &v[2]) < 0)
+        return -1;
+    id = xw->xw_schema.uv_len / XMLBIN_SCHEMA_W;
+    if (xmlbin_vec_add(&xw->xw_schema, v, XMLBIN_SCHEMA_W) < 0)
+        return -1;
+    if (clicon_hash_add(xw->xw_yhash, key, &id, sizeof(id)) == NULL)
+        return -1;
+    *yid = id;
+    return 0;
+}
+
+/*! Add XML node and its children in pre-order
+ *
+ * @param[in]  xw     Writer state
+ * @param[in]  x      XML node
+ * @param[in]  pid    Schema index of parent, or XMLBIN_NONE
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+xmlbin_node(xmlbin_writer *xw,
+            cxobj         *x,
+            uint32_t       pid)
+{
+    uint32_t   v[XMLBIN_NODE_W];
+    yang_stmt *y;
+    cxobj     *xc;
+
+    v[0] = xml_type(x);
+    v[1] = XMLBIN_NONE;
+    if (v[0] == CX_ELMNT && (y = xml_spec(x)) != NULL &&
+        xmlbin_schema(xw, y, pid, &v[1]) < 0)
+        return -1;
+    if (xmlbin_str(xw, xml_name(x), 1, &v[2]) < 0)
+        return -1;
+    if (xmlbin_str(xw, xml_prefix(x), 1, &v[3]) < 0)
+        return -1;
+    /* Body values are mostly unique, attribute values are mostly namespaces */
+    if (xmlbin_str(xw, v[0]==CX_ELMNT?NULL:xml_value(x), v[0]==CX_ATTR, &v[4]) < 0)
+        return -1;
+    v[5] = v[0]==CX_ELMNT ? xml_child_nr(x) : 0;
+    if (xmlbin_vec_add(&xw->xw_node, v, XMLBIN_NODE_W) < 0)
+        return -1;
+    /* Attributes first, they may have been appended to an unsorted tree */
+    xc = NULL;
+    while ((xc = xml_child_each(x, xc, CX_ATTR)) != NULL)
+        if (xmlbin_node(xw, xc, v[1]) < 0)
+            return -1;
+    xc = NULL;
+    while ((xc = xml_child_each(x, xc, -1)) != NULL)
+        if (xml_type(xc) != CX_ATTR &&
+            xmlbin_node(xw, xc, v[1]) < 0)
+            return -1;
+    return 0;
+}
+
+/*! Encode XML tree and fill in header
+ *
+ * @param[in]  xw     Writer state, initialized
+ * @param[in]  xt     XML tree
+ * @param[out] xh     Header
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+xmlbin_write(xmlbin_writer     *xw,
+             cxobj             *xt,
+             struct xmlbin_hdr *xh)
+{
+    if ((xw->xw_str = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        return -1;
+    }
+    if ((xw->xw_strhash = clicon_hash_init()) == NULL)
+        return -1;
+    if ((xw->xw_yhash = clicon_hash_init()) == NULL)
+        return -1;
+    if (xmlbin_node(xw, xt, XMLBIN_NONE) < 0)
+        return -1;
+    memset(xh, 0, sizeof(*xh));
+    memcpy(xh->xh_magic, XMLBIN_MAGIC, sizeof(xh->xh_magic));
+    xh->xh_version = XMLBIN_VERSION;
+    xh->xh_nstr = xw->xw_stroff.uv_len;
+    xh->xh_nschema = xw->xw_schema.uv_len / XMLBIN_SCHEMA_W;
+    xh->xh_nnode = xw->xw_node.uv_len / XMLBIN_NODE_W;
+    xh->xh_strlen = cbuf_len(xw->xw_str);
+    return 0;
+}
+
+/*! Free writer state
+ */
+static int
+xmlbin_writer_free(xmlbin_writer *xw)
+{
+    if (xw->xw_str)
+        cbuf_free(xw->xw_str);
+    if (xw->xw_strhash)
+        clicon_hash_free(xw->xw_strhash);
+    if (xw->xw_yhash)
+        clicon_hash_free(xw->xw_yhash);
+    if (xw->xw_stroff.uv_vec)
+        free(xw->xw_stroff.uv_vec);
+    if (xw->xw_schema.uv_vec)
+        free(xw->xw_schema.uv_vec);
+    if (xw->xw_node.uv_vec)
+        free(xw->xw_node.uv_vec);
+    return 0;
+}
+
+/*! Write XML tree to file in binary datastore format
+ *
+ * The tree should be yang bound and sorted, since it is loaded as is.
+ * @param[in]  f      Output file
+ * @param[in]  xt     XML tree, including top node
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see clixon_bin_parse_file
+ */
+int
+clixon_xml2bin_file(FILE  *f,
+                    cxobj *xt)
+{
+    int               retval = -1;
+    xmlbin_writer     xw = {0,};
+    struct xmlbin_hdr xh;
+
+    if (xmlbin_write(&xw, xt, &xh) < 0)
+        goto done;
+    if (fwrite(&xh, sizeof(xh), 1, f) != 1 ||
+        fwrite(xw.xw_stroff.uv_vec, sizeof(uint32_t), xw.xw_stroff.uv_len, f) != xw.xw_stroff.uv_len ||
+        fwrite(xw.xw_schema.uv_vec, sizeof(uint32_t), xw.xw_schema.uv_len, f) != xw.xw_schema.uv_len ||
+        fwrite(xw.xw_node.uv_vec, sizeof(uint32_t), xw.xw_node.uv_len, f) != xw.xw_node.uv_len ||
+        fwrite(cbuf_get(xw.xw_str), 1, xh.xh_strlen, f) != xh.xh_strlen){
+        clicon_err(OE_UNIX, errno, "fwrite");
+        goto done;
+    }
+    retval = 0;
+ done:
+    xmlbin_writer_free(&xw);
+    return retval;
+}
+
+/*! Encode XML tree in binary format in a new memory buffer
+ *
+ * The buffer has room for pre bytes before and post bytes after the encoded tree, which
+ * are zeroed. The encoded tree is 4-byte aligned if pre is.
+ * @param[in]  xt     XML tree
+ * @param[in]  pre    Nr of bytes before encoded tree, eg a message header
+ * @param[in]  post   Nr of bytes after encoded tree
+ * @param[out] bufp   Allocated buffer, free with free
+ * @param[out] lenp   Length of encoded tree, excluding pre and post
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see clixon_bin_parse_buf
+ */
+int
+clixon_xml2bin_buf(cxobj  *xt,
+                   size_t  pre,
+                   size_t  post,
+                   char  **bufp,
+                   size_t *lenp)
+{
+    int               retval = -1;
+    xmlbin_writer     xw = {0,};
+    struct xmlbin_hdr xh;
+    size_t            len;
+    char             *buf;
+    char             *p;
+
+    if (xmlbin_write(&xw, xt, &xh) < 0)
+        goto done;
+    len = sizeof(xh) + sizeof(uint32_t)*(xw.xw_stroff.uv_len + xw.xw_schema.uv_len +
+                                         xw.xw_node.uv_len) + xh.xh_strlen;
+    if ((buf = malloc(pre + len + post)) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(buf, 0, pre);
+    p = buf + pre;
+    memcpy(p, &xh, sizeof(xh));
+    p += sizeof(xh);
+    memcpy(p, xw.xw_stroff.uv_vec, sizeof(uint32_t)*xw.xw_stroff.uv_len);
+    p += sizeof(uint32_t)*xw.xw_stroff.uv_len;
+    memcpy(p, xw.xw_schema.uv_vec, sizeof(uint32_t)*xw.xw_schema.uv_len);
+    p += sizeof(uint32_t)*xw.xw_schema.uv_len;
+    memcpy(p, xw.xw_node.uv_vec, sizeof(uint32_t)*xw.xw_node.uv_len);
+    p += sizeof(uint32_t)*xw.xw_node.uv_len;
+    memcpy(p, cbuf_get(xw.xw_str), xh.xh_strlen);
+    p += xh.xh_strlen;
+    memset(p, 0, post);
+    *bufp = buf;
+    *lenp = len;
+    retval = 0;
+ done:
+    xmlbin_writer_free(&xw);
+    return retval;
+}
+
+/*------------------------------------------------------------------------
+ * Read
+ *------------------------------------------------------------------------*/
+
+/*! Get string from string table
+ * @retval  str   String, or NULL if sid is XMLBIN_NONE or out of range
+ */
+static char *
+xmlbin_str_get(xmlbin_reader *xr,
+               uint32_t       sid)
+{
+    if (sid >= xr->xr_nstr)
+        return NULL;
+    return xr->xr_strings + xr->xr_stroff[sid];
+}
+
+/*! Resolve schema node table against yang spec
+ *
+ * A schema node is found by name among the data nodes of its parent schema node, or
+ * of the module of its namespace if top-level. The namespace must match.
+ * The parent of an input or output node is an rpc or action, see xmlbin_schema
+ * @param[in]  xr     Reader state
+ * @param[in]  sch    Schema node table
+ * @param[in]  yspec  Yang spec, or NULL
+ * @retval     0      OK
+ * @retval    -1      Error, invalid file
+ */
+static int
+xmlbin_schema_resolve(xmlbin_reader *xr,
+                      uint32_t      *sch,
+                      yang_stmt     *yspec)
+{
+    uint32_t   i;
+    uint32_t   pid;
+    char      *name;
+    char      *ns;
+    yang_stmt *ymod;
+    yang_stmt *yp;
+    yang_stmt *y;
+    char      *ns1;
+
+    if (xr->xr_nschema &&
+        (xr->xr_yvec = calloc(xr->xr_nschema, sizeof(yang_stmt *))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        return -1;
+    }
+    for (i=0; i<xr->xr_nschema; i++){
+        pid = sch[i*XMLBIN_SCHEMA_W];
+        name = xmlbin_str_get(xr, sch[i*XMLBIN_SCHEMA_W+1]);
+        ns = xmlbin_str_get(xr, sch[i*XMLBIN_SCHEMA_W+2]);
+        if (name == NULL || (pid != XMLBIN_NONE && pid >= i)){
+            clicon_err(OE_XML, EINVAL, "Invalid binary datastore: schema node %u", i);
+            return -1;
+        }
+        y = NULL;
+        if (yspec == NULL)
+            ;
+        else if (pid == XMLBIN_NONE){
+            if (ns && (ymod = yang_find_module_by_namespace(yspec, ns)) != NULL)
+                y = yang_find_schemanode(ymod, name);
+        }
+        else if ((yp = xr->xr_yvec[pid]) != NULL){
+            if (yang_keyword_get(yp) == Y_RPC || yang_keyword_get(yp) == Y_ACTION)
+                y = yang_find_schemanode(yp, name); /* input or output */
+            else if ((y = yang_find_datanode(yp, name)) == NULL &&
+                     (y = yang_find_schemanode(yp, name)) != NULL &&
+                     yang_keyword_get(y) != Y_ACTION)
+                y = NULL;
+        }
+        if (y && ((ns1 = yang_find_mynamespace(y)) == NULL ||
+                  ns == NULL || strcmp(ns, ns1) != 0))
+            y = NULL;
+        xr->xr_yvec[i] = y;
+    }
+    return 0;
+}
+
+/*! Create XML node and its children from binary nodes in pre-order
+ *
+ * @param[in]  xr     Reader state
+ * @param[in]  xp     XML parent, or NULL for top
+ * @param[in]  depth  Nesting level of node, at most XMLBIN_MAXDEPTH
+ * @param[out] xn     Created XML node
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+xmlbin_build(xmlbin_reader *xr,
+             cxobj         *xp,
+             int            depth,
+             cxobj        **xn)
+{
+    uint32_t  *v;
+    cxobj     *x;
+    char      *str;
+    uint32_t   i;
+    yang_stmt *y;
+
+    if (xr->xr_i >= xr->xr_nnode){
+        clicon_err(OE_XML, EINVAL, "Invalid binary datastore: node %u out of range", xr->xr_i);
+        return -1;
+    }
+    if (depth > XMLBIN_MAXDEPTH){
+        clicon_err(OE_XML, EINVAL, "Invalid binary datastore: node %u nested deeper than %d",
+                   xr->xr_i, XMLBIN_MAXDEPTH);
+        return -1;
+    }
+    v = &xr->xr_node[XMLBIN_NODE_W*xr->xr_i++];
+    if ((v[0] != CX_ELMNT && v[0] != CX_ATTR && v[0] != CX_BODY) ||
+        (str = xmlbin_str_get(xr, v[2])) == NULL){
+        clicon_err(OE_XML, EINVAL, "Invalid binary datastore: node %u", xr->xr_i-1);
+        return -1;
+    }
+    if ((x = xml_new(str, xp, v[0])) == NULL)
+        return -1;
+    if (xn)
+        *xn = x;
+    if ((str = xmlbin_str_get(xr, v[3])) != NULL &&
+        xml_prefix_set(x, str) < 0)
+        return -1;
+    if (v[0] != CX_ELMNT){
+        if ((str = xmlbin_str_get(xr, v[4])) != NULL &&
+            xml_value_set(x, str) < 0)
+            return -1;
+    }
+    else {
+        if (v[1] != XMLBIN_NONE){
+            if (v[1] < xr->xr_nschema && xr->xr_yvec[v[1]] != NULL)
+                xml_spec_set(x, xr->xr_yvec[v[1]]);
+            else
+                xr->xr_bound = 0;
+        }
+        else if (xr->xr_strict && xp != NULL &&
+                 (xml_parent(xp) == NULL ||
+                  ((y = xml_spec(xp)) != NULL &&
+                   yang_keyword_get(y) != Y_ANYXML && yang_keyword_get(y) != Y_ANYDATA)))
+            xr->xr_bound = 0;
+        for (i=0; i<v[5]; i++)
+            if (xmlbin_build(xr, x, depth+1, NULL) < 0)
+                return -1;
+#ifdef XML_EXPLICIT_INDEX
+        if (xp && xml_search_index_p(x) &&
+            xml_search_child_insert(xp, x) < 0)
+            return -1;
+#endif
+    }
+    return 0;
+}
+
+/*! Read XML tree from buffer in binary format
+ *
+ * @param[in]  buf     Buffer, 4-byte aligned
+ * @param[in]  buflen  Length of buf
+ * @param[in]  yspec   Yang spec, or NULL
+ * @param[in]  strict  Also unbound if an element has no schema node in a bound parent
+ * @param[out] xt      XML tree. Free with xml_free
+ * @retval     1       OK, all nodes are bound
+ * @retval     0       OK, but some nodes could not be bound
+ * @retval    -1       Error
+ */
+static int
+xmlbin_parse(char       *buf,
+             size_t      buflen,
+             yang_stmt  *yspec,
+             int         strict,
+             cxobj     **xt)
+{
+    int                retval = -1;
+    struct xmlbin_hdr *xh;
+    xmlbin_reader      xr = {0,};
+    uint32_t          *sch;
+    size_t             len;
+    cxobj             *x0 = NULL;
+
+    if (buflen < sizeof(*xh) || ((uintptr_t)buf & (sizeof(uint32_t)-1)) != 0){
+        clicon_err(OE_XML, EINVAL, "Invalid binary datastore: short or unaligned");
+        goto done;
+    }
+    xh = (struct xmlbin_hdr *)buf;
+    if (memcmp(xh->xh_magic, XMLBIN_MAGIC, sizeof(xh->xh_magic)) != 0 ||
+        xh->xh_version != XMLBIN_VERSION){
+        clicon_err(OE_XML, EINVAL, "Not a binary datastore file of version %d", XMLBIN_VERSION);
+        goto done;
+    }
+    len = sizeof(*xh) + sizeof(uint32_t)*((size_t)xh->xh_nstr +
+                                          (size_t)xh->xh_nschema*XMLBIN_SCHEMA_W +
+                                          (size_t)xh->xh_nnode*XMLBIN_NODE_W);
+    if (len + xh->xh_strlen != buflen || xh->xh_nnode == 0 ||
+        (xh->xh_strlen && buf[buflen-1] != '\0')){
+        clicon_err(OE_XML, EINVAL, "Invalid binary datastore: size mismatch");
+        goto done;
+    }
+    xr.xr_stroff = (uint32_t*)(xh + 1);
+    xr.xr_nstr = xh->xh_nstr;
+    sch = xr.xr_stroff + xh->xh_nstr;
+    xr.xr_nschema = xh->xh_nschema;
+    xr.xr_node = sch + xh->xh_nschema*XMLBIN_SCHEMA_W;
+    xr.xr_nnode = xh->xh_nnode;
+    xr.xr_strings = buf + len;
+    xr.xr_strict = strict;
+    for (len=0; len<xr.xr_nstr; len++)
+        if (xr.xr_stroff[len] >= xh->xh_strlen){
+            clicon_err(OE_XML, EINVAL, "Invalid binary datastore: string %zu", len);
+            goto done;
+        }
+    if (xmlbin_schema_resolve(&xr, sch, yspec) < 0)
+        goto done;
+    xr.xr_bound = 1;
+    if (xmlbin_build(&xr, NULL, 0, &x0) < 0)
+        goto done;
+    if (xr.xr_i != xr.xr_nnode){
+        clicon_err(OE_XML, EINVAL, "Invalid binary datastore: trailing nodes");
+        goto done;
+    }
+    *xt = x0;
+    x0 = NULL;
+    retval = xr.xr_bound;
+ done:
+    if (x0)
+        xml_free(x0);
+    if (xr.xr_yvec)
+        free(xr.xr_yvec);
+    return retval;
+}
+
+/*! Read XML tree from file in binary datastore format using mmap
+ *
+ * No parsing or sorting is made, and the tree is bound to yang using one lookup per
+ * schema node of the file.
+ * @param[in]  fp     Input file
+ * @param[in]  yspec  Yang spec, or NULL
+ * @param[out] xt     XML tree including top node, or NULL if file is empty. Free with xml_free
+ * @retval     1      OK, all nodes with yang in file are bound
+ * @retval     0      OK, but some nodes could not be bound, eg the yang has changed
+ * @retval    -1      Error, including file is not in binary format
+ * @see clixon_xml2bin_file
+ */
+int
+clixon_bin_parse_file(FILE       *fp,
+                      yang_stmt  *yspec,
+                      cxobj     **xt)
+{
+    int                retval = -1;
+    struct stat        st;
+    void              *map = MAP_FAILED;
+
+    if (fstat(fileno(fp), &st) < 0){
+        clicon_err(OE_UNIX, errno, "fstat");
+        goto done;
+    }
+    if (st.st_size == 0){
+        *xt = NULL;
+        retval = 1;
+        goto done;
+    }
+    if (st.st_size < sizeof(struct xmlbin_hdr)){
+        clicon_err(OE_XML, EINVAL, "Invalid binary datastore: short file");
+        goto done;
+    }
+    if ((map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0)) == MAP_FAILED){
+        clicon_err(OE_UNIX, errno, "mmap");
+        goto done;
+    }
+    retval = xmlbin_parse((char*)map, st.st_size, yspec, 0, xt);
+ done:
+    if (map != MAP_FAILED)
+        munmap(map, st.st_size);
+    return retval;
+}
+
+/*! Read XML tree from memory buffer in binary format
+ *
+ * As clixon_bin_parse_file but nodes are also unbound if an element has no schema node
+ * but its parent is the root, or is bound to other than anyxml or anydata. That is, the
+ * tree is bound as if by parsing only if the return value is 1.
+ * @param[in]  buf    Buffer with encoded tree, 4-byte aligned
+ * @param[in]  len    Length of encoded tree
+ * @param[in]  yspec  Yang spec, or NULL
+ * @param[out] xt     XML tree, the root is the encoded tree, not a top node. Free with xml_free
+ * @retval     1      OK, all nodes are bound
+ * @retval     0      OK, but some nodes are not bound
+ * @retval    -1      Error
+ * @see clixon_xml2bin_buf
+ */
+int
+clixon_bin_parse_buf(char       *buf,
+                     size_t      len,
+                     yang_stmt  *yspec,
+                     cxobj     **xt)
+{
+    return xmlbin_parse(buf, len, yspec, 1, xt);
+}
@@ -141,6 +141,7 @@ strip_body_objects(cxobj *xt)
  * @param[in]   xt     XML tree node
  * @param[in]   xsibling
  * @param[in]   yspec  Top-level YANG spec / mount-point
+ * @param[in]   index  Insert in explicit search index, requires body of xt
  * @param[out]  xerr   Reason for failure, or NULL
  * @retval      2      OK Yang assignment not made because yang parent is anyxml or anydata
  * @retval      1      OK Yang assignment made
@@ -153,6 +154,7 @@ static int
 populate_self_parent(cxobj     *xt,
                      cxobj     *xsibling,
                      yang_stmt *yspec,
+                     int        index,
                      cxobj    **xerr)
 {
     int        retval = -1;
@@ -234,7 +236,7 @@ populate_self_parent(cxobj     *xt,
  set:
     xml_spec_set(xt, y);
 #ifdef XML_EXPLICIT_INDEX
-    if (xml_search_index_p(xt))
+    if (index && xml_search_index_p(xt))
         xml_search_child_insert(xp, xt);
 #endif
     retval = 1;
@@ -439,7 +441,7 @@ xml_bind_yang0_opt(clicon_handle h,
             goto done;
         break;
     case YB_PARENT:
-        if ((ret = populate_self_parent(xt, xsibling, yspec, xerr)) < 0)
+        if ((ret = populate_self_parent(xt, xsibling, yspec, 1, xerr)) < 0)
             goto done;
         break;
     default:
@@ -546,7 +548,7 @@ xml_bind_yang0(clicon_handle h,
             goto done;
         break;
     case YB_PARENT:
-        if ((ret = populate_self_parent(xt, NULL, yspec, xerr)) < 0)
+        if ((ret = populate_self_parent(xt, NULL, yspec, 1, xerr)) < 0)
             goto done;
         break;
     case YB_NONE:
@@ -578,6 +580,44 @@ xml_bind_yang0(clicon_handle h,
     goto done;
 }
 
+/*! Bind a single XML node to yang while parsing, before its children are parsed
+ *
+ * Attributes, ie namespace declarations, of xt are parsed. No error is created: if xt cannot
+ * be bound the caller should bind the whole tree after parsing using xml_bind_yang0 to get
+ * the reason.
+ * @param[in]   xt       XML node
+ * @param[in]   yb       YB_MODULE for top-level nodes, or YB_PARENT if parent is bound
+ * @param[in]   yspec    Yang spec
+ * @param[in]   xsibling Previous sibling with same name and prefix, or NULL
+ * @retval      2        Not bound since parent is anyxml/anydata, or bound as anydata
+ * @retval      1        Bound
+ * @retval      0        Not bound
+ * @retval     -1        Error
+ * @note If bound, the caller inserts xt in the explicit search index after its body is parsed
+ * @see xml_bind_yang0   Binds a parsed tree
+ */
+int
+xml_bind_yang_parse(cxobj     *xt,
+                    yang_bind  yb,
+                    yang_stmt *yspec,
+                    cxobj     *xsibling)
+{
+    int retval = -1;
+
+    switch (yb){
+    case YB_MODULE:
+        retval = populate_self_top(xt, yspec, NULL);
+        break;
+    case YB_PARENT:
+        retval = populate_self_parent(xt, xsibling, yspec, 0, NULL);
+        break;
+    default:
+        clicon_err(OE_XML, EINVAL, "Invalid yang binding: %d", yb);
+        break;
+    }
+    return retval;
+}
+
 /*! RPC-specific
  *
  * @param[in]   h      Clixon handle
@@ -681,37 +721,24 @@ xml_bind_yang_rpc_action(clicon_handle h,
     goto done;
 }
 
-/*! Find yang spec association of XML node for incoming RPC starting with <rpc>
- * 
- * Incoming RPC has an "input" structure that is not taken care of by xml_bind_yang
- * @param[in]   h      Clixon handle
+/*! Check the netconf envelope of an incoming message: <rpc>, <hello> or <notification>
+ *
+ * Hello children are checked and a message-id attribute is required in <rpc> unless
+ * message-id is optional. The operations of an <rpc> are not checked.
  * @param[in]   xrpc   XML rpc node
- * @param[in]   yspec  Yang spec
  * @param[out]  xerr   Reason for failure, or NULL
- * @retval      1      OK yang assignment made
- * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
+ * @retval      1      OK
+ * @retval      0      Invalid envelope and xerr set
  * @retval     -1      Error
- * The 
- * @code
- *   if ((ret = xml_bind_yang_rpc(h, x, NULL, &xerr)) < 0)
- *      err;
- * @endcode
- * @see xml_bind_yang  For other generic cases
- * @see xml_bind_yang_rpc_reply 
+ * @see xml_bind_yang_rpc  which also binds the operations
  */
 int
-xml_bind_yang_rpc(clicon_handle h,
-                  cxobj        *xrpc,
-                  yang_stmt    *yspec,
-                  cxobj       **xerr)
+xml_bind_yang_rpc_envelope(cxobj  *xrpc,
+                           cxobj **xerr)
 {
     int        retval = -1;
-    yang_stmt *yrpc = NULL;    /* yang node */
-    yang_stmt *ymod=NULL; /* yang module */
     cxobj     *x;
-    int        ret;
     char      *opname;  /* top-level netconf operation */
-    char      *rpcname; /* RPC name */
     char      *name;
     cxobj     *xc;
     
@@ -771,6 +798,52 @@ xml_bind_yang_rpc(clicon_handle h,
             goto fail;
         }
     }
+ ok:
+    retval = 1;
+ done:
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Find yang spec association of XML node for incoming RPC starting with <rpc>
+ * 
+ * Incoming RPC has an "input" structure that is not taken care of by xml_bind_yang
+ * @param[in]   h      Clixon handle
+ * @param[in]   xrpc   XML rpc node
+ * @param[in]   yspec  Yang spec
+ * @param[out]  xerr   Reason for failure, or NULL
+ * @retval      1      OK yang assignment made
+ * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
+ * @retval     -1      Error
+ * The 
+ * @code
+ *   if ((ret = xml_bind_yang_rpc(h, x, NULL, &xerr)) < 0)
+ *      err;
+ * @endcode
+ * @see xml_bind_yang  For other generic cases
+ * @see xml_bind_yang_rpc_reply 
+ */
+int
+xml_bind_yang_rpc(clicon_handle h,
+                  cxobj        *xrpc,
+                  yang_stmt    *yspec,
+                  cxobj       **xerr)
+{
+    int        retval = -1;
+    yang_stmt *yrpc = NULL;    /* yang node */
+    yang_stmt *ymod=NULL; /* yang module */
+    cxobj     *x;
+    int        ret;
+    char      *rpcname; /* RPC name */
+    
+    if ((ret = xml_bind_yang_rpc_envelope(xrpc, xerr)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    if (strcmp(xml_name(xrpc), "rpc") != 0) /* hello or notification */
+        goto ok;
     x = NULL;
     while ((x = xml_child_each(xrpc, x, CX_ELMNT)) != NULL) {
         rpcname = xml_name(x);
@@ -418,6 +418,85 @@ xml_default_recurse(cxobj *xn,
     return retval;
 }
 
+/*! Fill in default values on the children of one XML node, not recursively
+ *
+ * Only missing default values are added, existing nodes are not changed.
+ * If xn has no yang spec, it is assumed to be a top-level (eg datastore) symbol and
+ * global default values of all modules in yspec are added.
+ * @param[in]   xn      XML node
+ * @param[in]   yspec   Top-level YANG specification tree, only used if xn has no yang spec
+ * @param[in]   state   If set expand defaults also for state data, otherwise only config
+ * @retval      0       OK
+ * @retval      -1      Error
+ * @see xml_default_recurse  for the recursive variant
+ */
+int
+xml_default_node(cxobj     *xn,
+                 yang_stmt *yspec,
+                 int        state)
+{
+    int        retval = -1;
+    yang_stmt *yn;
+    yang_stmt *ymod = NULL;
+
+    if ((yn = xml_spec(xn)) != NULL){
+        if (xml_default(yn, xn, state) < 0)
+            goto done;
+    }
+    else if (yspec != NULL){
+        while ((ymod = yn_each(yspec, ymod)) != NULL) 
+            if (xml_default(ymod, xn, state) < 0)
+                goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Check if a default value in a YANG spec is conditional on a when statement
+ *
+ * A default leaf or a non-presence container is not created if its when condition is
+ * false. Since the condition may refer to data anywhere in the tree, such a default may
+ * change by an edit outside of its parent.
+ * @param[in]   yn      YANG node, eg top-level yang spec
+ * @retval      1       A leaf with default value or a non-presence container has a when condition
+ * @retval      0       No default value is conditional on when
+ * @see xml_default  where the when conditions are evaluated
+ */
+int
+xml_default_when(yang_stmt *yn)
+{
+    yang_stmt *yc;
+    cg_var    *cv;
+
+    yc = NULL;
+    while ((yc = yn_each(yn, yc)) != NULL) {
+        switch (yang_keyword_get(yc)){
+        case Y_LEAF:
+            if ((cv = yang_cv_get(yc)) == NULL || cv_flag(cv, V_UNSET))
+                break;
+            if (yang_when_xpath_get(yc) != NULL || yang_find(yc, Y_WHEN, NULL) != NULL)
+                return 1;
+            break;
+        case Y_CONTAINER:
+            if (yang_find(yc, Y_PRESENCE, NULL) == NULL &&
+                (yang_when_xpath_get(yc) != NULL || yang_find(yc, Y_WHEN, NULL) != NULL))
+                return 1;
+        case Y_MODULE:   /* fall thru */
+        case Y_SUBMODULE:
+        case Y_LIST:
+        case Y_CHOICE:
+        case Y_CASE:
+            if (xml_default_when(yc) == 1)
+                return 1;
+            break;
+        default:
+            break;
+        }
+    }
+    return 0;
+}
+
 /*! Expand and set default values of global top-level on XML tree
  *
  * Not recursive, except in one case with one or several non-presence containers
@@ -0,0 +1,744 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2,
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * Hand-written XML tokenizer, an alternative to the flex/bison XML parser
+ * Scans the parse buffer in place for markup and creates cxobj nodes directly, with the same
+ * result as the grammar in clixon_xml_parse.[ly]:
+ * - Element and attribute names are ncnames with optional prefix
+ * - Attribute values are raw, a repeated attribute overwrites the earlier
+ * - Body text: the five predefined entities are decoded, character references are kept as is,
+ *   CR and CRLF are translated to LF, and CDATA sections are kept verbatim with delimiters
+ * - If an element has an element child, all its bodies are stripped
+ * If requested, yang is bound to elements when they are created and children are sorted when
+ * they are complete, instead of by xml_bind_yang0 and xml_sort_recurse after parsing.
+ * Text content is scanned with SSE2 (or AVX2 if compiled for it) for the characters '<', '&',
+ * CR and NUL.
+ * The tokenizer only handles the common subset of XML. On anything else, including all
+ * syntax errors, processing instructions and DOCTYPE, it removes what it has created and
+ * returns 0, and the caller falls back to the grammar which is the conformance reference and
+ * which produces the error messages.
+ * @see clixon_xml_parse.l
+ * @see clixon_xml_parse.y
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clixon */
+#include "clixon_err.h"
+#include "clixon_string.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_xml_bind.h"
+#include "clixon_xml_sort.h"
+#include "clixon_xml_parse.h"
+
+/* XML name characters, see ncname in clixon_xml_parse.l */
+#define XF_NAMESTART(c) (((c) >= 'A' && (c) <= 'Z') || ((c) >= 'a' && (c) <= 'z') || (c) == '_')
+#define XF_NAMECHAR(c)  (XF_NAMESTART(c) || ((c) >= '0' && (c) <= '9') || (c) == '-' || (c) == '.')
+/* Whitespace skipped between tokens inside tags */
+#define XF_WHITESPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r')
+
+/*! Body text of the current element
+ * Kept as a pointer range into the parse buffer as long as it is contiguous, otherwise
+ * assembled in a cbuf.
+ */
+typedef struct {
+    char  *ft_start; /* Start of contiguous text in parse buffer, or NULL */
+    char  *ft_end;   /* End of contiguous text in parse buffer */
+    cbuf  *ft_cb;    /* Assembled text, if ft_copy */
+    int    ft_copy;  /* Text is not contiguous and is in ft_cb */
+} xf_text;
+
+/*! Find next character in text content that needs to be handled: '<', '&', CR or NUL
+ * @param[in]  p    Start of text
+ * @param[in]  end  End of parse buffer
+ * @retval     q    Pointer to first special character, or end
+ */
+static inline char *
+xf_text_scan(char *p,
+             char *end)
+{
+#if defined(__AVX2__)
+    const __m256i lt = _mm256_set1_epi8('<');
+    const __m256i amp = _mm256_set1_epi8('&');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i nul = _mm256_setzero_si256();
+    __m256i       v;
+    uint32_t      m;
+
+    while (end - p >= 32){
+        v = _mm256_loadu_si256((const __m256i *)p);
+        m = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+                         _mm256_or_si256(_mm256_cmpeq_epi8(v, lt), _mm256_cmpeq_epi8(v, amp)),
+                         _mm256_or_si256(_mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, nul))));
+        if (m)
+            return p + __builtin_ctz(m);
+        p += 32;
+    }
+#elif defined(__SSE2__)
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i nul = _mm_setzero_si128();
+    __m128i       v;
+    uint32_t      m;
+
+    while (end - p >= 16){
+        v = _mm_loadu_si128((const __m128i *)p);
+        m = (uint32_t)_mm_movemask_epi8(_mm_or_si128(
+                         _mm_or_si128(_mm_cmpeq_epi8(v, lt), _mm_cmpeq_epi8(v, amp)),
+                         _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, nul))));
+        if (m)
+            return p + __builtin_ctz(m);
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '<' && *p != '&' && *p != '\r' && *p != '\0')
+        p++;
+    return p;
+}
+
+/*! Find a string in the parse buffer
+ * @param[in]  p    Start of search
+ * @param[in]  end  End of parse buffer
+ * @param[in]  pat  String to find
+ * @retval     q    Pointer to first occurence of pat
+ * @retval     NULL Not found
+ */
+static char *
+xf_find(char       *p,
+        char       *end,
+        const char *pat)
+{
+    size_t len = strlen(pat);
+
+    while (end - p >= (ptrdiff_t)len){
+        if ((p = memchr(p, pat[0], end - p - len + 1)) == NULL)
+            break;
+        if (memcmp(p, pat, len) == 0)
+            return p;
+        p++;
+    }
+    return NULL;
+}
+
+/*! Scan a possibly prefixed name: NAME or NAME:NAME
+ * @param[in]  p       Start of name
+ * @param[out] prefix  Start of prefix, or NULL
+ * @param[out] plen    Length of prefix
+ * @param[out] name    Start of name
+ * @param[out] nlen    Length of name
+ * @retval     q       Pointer after name
+ * @retval     NULL    Not a name
+ * @note parse buffer is null-terminated, so scanning for name characters stops at the end
+ */
+static char *
+xf_qname(char    *p,
+         char   **prefix,
+         size_t  *plen,
+         char   **name,
+         size_t  *nlen)
+{
+    char *q = p;
+
+    if (!XF_NAMESTART(*q))
+        return NULL;
+    while (XF_NAMECHAR(*q))
+        q++;
+    if (*q == ':'){
+        *prefix = p;
+        *plen = q - p;
+        p = ++q;
+        if (!XF_NAMESTART(*q))
+            return NULL;
+        while (XF_NAMECHAR(*q))
+            q++;
+    }
+    else{
+        *prefix = NULL;
+        *plen = 0;
+    }
+    *name = p;
+    *nlen = q - p;
+    return q;
+}
+
+/*! Create an element or attribute from a name in the parse buffer
+ * Name and prefix are null-terminated in place while the node is created
+ * @param[in]  xp      Parent
+ * @param[in]  prefix  Prefix in parse buffer, or NULL
+ * @param[in]  plen    Length of prefix
+ * @param[in]  name    Name in parse buffer
+ * @param[in]  nlen    Length of name
+ * @param[in]  type    CX_ELMNT or CX_ATTR
+ * @retval     x       Created node, or existing attribute with same name
+ * @retval     NULL    Error
+ * @see xml_parse_prefixed_name
+ * @see xml_parse_attr
+ */
+static cxobj *
+xf_node(cxobj          *xp,
+        char           *prefix,
+        size_t          plen,
+        char           *name,
+        size_t          nlen,
+        enum cxobj_type type)
+{
+    cxobj *x = NULL;
+    char   c;
+    char   pc = '\0';
+
+    c = name[nlen];
+    name[nlen] = '\0';
+    if (prefix){
+        pc = prefix[plen];
+        prefix[plen] = '\0';
+    }
+    if (type == CX_ATTR &&
+        (x = xml_find_type(xp, prefix, name, CX_ATTR)) != NULL)
+        goto done;
+    if ((x = xml_new(name, xp, type)) == NULL)
+        goto done;
+    if (xml_prefix_set(x, prefix) < 0){
+        x = NULL;
+        goto done;
+    }
+ done:
+    name[nlen] = c;
+    if (prefix)
+        prefix[plen] = pc;
+    return x;
+}
+
+/*! Set value of body or attribute from a range of the parse buffer
+ * @param[in]  x     Body or attribute
+ * @param[in]  s     Start of value in parse buffer
+ * @param[in]  e     End of value in parse buffer
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+xf_value_set(cxobj *x,
+             char  *s,
+             char  *e)
+{
+    int  retval;
+    char c;
+
+    c = *e;
+    *e = '\0';
+    retval = xml_value_set(x, s);
+    *e = c;
+    return retval;
+}
+
+/*! Add text to body of current element
+ * @param[in]  ft    Body text
+ * @param[in]  s     Text, in parse buffer or a constant
+ * @param[in]  len   Length of text
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+xf_text_add(xf_text *ft,
+            char    *s,
+            size_t   len)
+{
+    if (ft->ft_copy){
+        if (cbuf_append_buf(ft->ft_cb, s, len) < 0){
+            clicon_err(OE_XML, errno, "cbuf_append_buf");
+            return -1;
+        }
+    }
+    else if (ft->ft_start == NULL){
+        ft->ft_start = s;
+        ft->ft_end = s + len;
+    }
+    else if (ft->ft_end == s)
+        ft->ft_end += len;
+    else {
+        if (ft->ft_cb == NULL &&
+            (ft->ft_cb = cbuf_new()) == NULL){
+            clicon_err(OE_XML, errno, "cbuf_new");
+            return -1;
+        }
+        cbuf_reset(ft->ft_cb);
+        if (cbuf_append_buf(ft->ft_cb, ft->ft_start, ft->ft_end - ft->ft_start) < 0 ||
+            cbuf_append_buf(ft->ft_cb, s, len) < 0){
+            clicon_err(OE_XML, errno, "cbuf_append_buf");
+            return -1;
+        }
+        ft->ft_copy = 1;
+    }
+    return 0;
+}
+
+/*! Decode an entity reference in body text
+ * Predefined entities are decoded, character references are kept as they are
+ * @param[in]  p     Pointer to '&'
+ * @param[out] s     Text to add to body
+ * @param[out] len   Length of text
+ * @retval     n     Length of entity reference
+ * @retval     0     Unknown entity
+ * @see AMPERSAND in clixon_xml_parse.l
+ */
+static int
+xf_entity(char   *p,
+          char  **s,
+          size_t *len)
+{
+    char *q;
+
+    switch (p[1]){
+    case 'a':
+        if (strncmp(p, "&amp;", 5) == 0){
+            *s = "&"; *len = 1;
+            return 5;
+        }
+        if (strncmp(p, "&apos;", 6) == 0){
+            *s = "'"; *len = 1;
+            return 6;
+        }
+        break;
+    case 'l':
+        if (strncmp(p, "&lt;", 4) == 0){
+            *s = "<"; *len = 1;
+            return 4;
+        }
+        break;
+    case 'g':
+        if (strncmp(p, "&gt;", 4) == 0){
+            *s = ">"; *len = 1;
+            return 4;
+        }
+        break;
+    case 'q':
+        if (strncmp(p, "&quot;", 6) == 0){
+            *s = "\""; *len = 1;
+            return 6;
+        }
+        break;
+    case '#':
+        q = p + 2;
+        if (*q == 'x'){
+            q++;
+            while ((*q >= '0' && *q <= '9') || (*q >= 'a' && *q <= 'f') || (*q >= 'A' && *q <= 'F'))
+                q++;
+        }
+        else
+            while (*q >= '0' && *q <= '9')
+                q++;
+        if (*q != ';' || q == p + 2 || (p[2] == 'x' && q == p + 3))
+            break;
+        *s = p;
+        *len = q + 1 - p;
+        return *len;
+    default:
+        break;
+    }
+    return 0;
+}
+
+/*! Scan an XML declaration: <?xml version="1.0" encoding="UTF-8" standalone="yes"?>
+ * Only version 1.0 and encoding UTF-8 are accepted, as in the grammar
+ * @param[in]  p     Pointer to "<?xml"
+ * @retval     q     Pointer after "?>"
+ * @retval     NULL  Not accepted
+ * @see xmldcl in clixon_xml_parse.y
+ */
+static char *
+xf_xmldecl(char *p)
+{
+    char *attr[] = {"version", "encoding", "standalone"};
+    int   i;
+    char *v;
+    char *q;
+    size_t len;
+
+    p += strlen("<?xml");
+    for (i = 0; i < 3; i++){
+        while (XF_WHITESPACE(*p))
+            p++;
+        len = strlen(attr[i]);
+        if (strncmp(p, attr[i], len) != 0){
+            if (i == 0)
+                return NULL; /* version is mandatory */
+            continue;
+        }
+        p += len;
+        while (XF_WHITESPACE(*p))
+            p++;
+        if (*p++ != '=')
+            return NULL;
+        while (XF_WHITESPACE(*p))
+            p++;
+        if (*p != '"' && *p != '\'')
+            return NULL;
+        v = p + 1;
+        if ((q = strchr(v, *p)) == NULL || q == v)
+            return NULL;
+        if (i == 0 && (q - v != 3 || strncmp(v, "1.0", 3) != 0))
+            return NULL;
+        if (i == 1 && (q - v != 5 || strncasecmp(v, "UTF-8", 5) != 0))
+            return NULL;
+        p = q + 1;
+    }
+    while (XF_WHITESPACE(*p))
+        p++;
+    if (strncmp(p, "?>", 2) != 0)
+        return NULL;
+    return p + 2;
+}
+
+/*! Bind yang to a new element whose attributes are parsed
+ * @param[in]  xy    XML parser yacc handler struct
+ * @param[in]  xp    Parent
+ * @param[in]  x     New element
+ * @retval     2     Not bound, parent is anydata or not bound
+ * @retval     1     Bound
+ * @retval     0     Not bound, bind after parsing to get reason
+ * @retval    -1     Error
+ * @see xml_bind_yang0_opt
+ */
+static int
+xf_bind(clixon_xml_yacc *xy,
+        cxobj           *xp,
+        cxobj           *x)
+{
+    cxobj *xs = NULL;
+    int    i;
+
+    if (xp == xy->xy_xtop)
+        return xml_bind_yang_parse(x, xy->xy_yb, xy->xy_yspec, NULL);
+    if (xml_spec(xp) == NULL)
+        return 2;
+    /* Use previous sibling with same name as role model */
+    if ((i = xml_child_nr(xp) - 2) >= 0 &&
+        xml_type(xs = xml_child_i(xp, i)) == CX_ELMNT &&
+        xml_spec(xs) != NULL &&
+        clicon_strcmp(xml_name(xs), xml_name(x)) == 0 &&
+        clicon_strcmp(xml_prefix(xs), xml_prefix(x)) == 0)
+        ;
+    else
+        xs = NULL;
+    return xml_bind_yang_parse(x, YB_PARENT, xy->xy_yspec, xs);
+}
+
+/*! All of an element is parsed: insert in search index and sort
+ * @param[in]  xy    XML parser yacc handler struct
+ * @param[in]  x     Element
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+xf_bind_end(clixon_xml_yacc *xy,
+            cxobj           *x)
+{
+#ifdef XML_EXPLICIT_INDEX
+    cxobj *xp = xml_parent(x);
+
+    if (xml_spec(x) != NULL &&
+        (xp != xy->xy_xtop || xy->xy_yb == YB_PARENT) &&
+        xml_search_index_p(x))
+        xml_search_child_insert(xp, x);
+#endif
+    if (xml_sort_parse_end(x) < 0)
+        return -1;
+    return xml_sort_parse_child(x);
+}
+
+/*! Parse XML with a hand-written tokenizer, fallback to grammar if not handled
+ *
+ * Creates XML nodes under xy_xtop and adds top-level elements to xy_xvec, as the grammar.
+ * If xy_yb is YB_MODULE or YB_PARENT and xy_xtop has no elements, yang is bound and the tree is
+ * sorted while parsing, and xy_bound is set. If a node cannot be bound, 0 is returned and the
+ * grammar and xml_bind_yang0 are used to get the error.
+ * @param[in]  xy    XML parser yacc handler struct, parse string is writable and null-terminated
+ * @param[in]  len   Length of parse string
+ * @retval     1     OK
+ * @retval     0     Not handled, nothing created, use the grammar
+ * @retval    -1     Error
+ * @see _xml_parse
+ */
+int
+clixon_xml_fastparse(clixon_xml_yacc *xy,
+                     size_t           len)
+{
+    int     retval = -1;
+    char   *p = xy->xy_parse_string;
+    char   *end = p + len;
+    char   *q;
+    char   *s;
+    size_t  slen;
+    cxobj  *xt = xy->xy_xtop;
+    cxobj  *x = xt;      /* Current element */
+    cxobj  *xe;          /* New element */
+    cxobj  *xc;
+    char   *prefix;
+    size_t  plen;
+    char   *name;
+    size_t  nlen;
+    char   *xprefix;
+    int     start = 1;    /* As lex START state: after markup declaration or at beginning */
+    int     markup = 0;   /* Markup seen: XML declaration must be first */
+    int     decl = 0;     /* XML declaration seen: only one top-level element */
+    int     elemchild = 0; /* Current element has an element child: skip body */
+    xf_text ft = {0,};
+    int     bind = 0;     /* Bind yang and sort while parsing */
+    int     empty;
+    yang_stmt *y;
+    int     ret;
+    int     i;
+
+    if (((xy->xy_yb == YB_MODULE && xy->xy_yspec != NULL) ||
+         (xy->xy_yb == YB_PARENT && xml_spec(xt) != NULL)) &&
+        xml_child_nr_type(xt, CX_ELMNT) == 0)
+        bind = 1;
+
+    while (p < end){
+        if (start){ /* Whitespace is skipped and only markup is accepted */
+            while (XF_WHITESPACE(*p))
+                p++;
+            if (p >= end)
+                break;
+            if (*p != '<')
+                goto fail;
+        }
+        else if (*p != '<'){ /* Text content */
+            q = xf_text_scan(p, end);
+            if (q > p){
+                if (decl && x == xt){ /* Only whitespace after top element */
+                    for (s = p; s < q; s++)
+                        if (!XF_WHITESPACE(*s))
+                            goto fail;
+                }
+                if (x != xt && !elemchild &&
+                    xf_text_add(&ft, p, q - p) < 0)
+                    goto done;
+                p = q;
+            }
+            if (p >= end)
+                break;
+            switch (*p){
+            case '&':
+                if (decl && x == xt)
+                    goto fail;
+                if ((i = xf_entity(p, &s, &slen)) == 0)
+                    goto fail;
+                p += i;
+                break;
+            case '\r':
+                s = "\n";
+                slen = 1;
+                if (*++p == '\n')
+                    p++;
+                break;
+            case '<':
+                continue;
+            default: /* NUL */
+                goto fail;
+                break;
+            }
+            if (x != xt && !elemchild &&
+                xf_text_add(&ft, s, slen) < 0)
+                goto done;
+            continue;
+        }
+        /* p points to '<' */
+        if (p[1] == '/'){ /* End tag */
+            if (x == xt)
+                goto fail;
+            if ((q = xf_qname(p+2, &prefix, &plen, &name, &nlen)) == NULL)
+                goto fail;
+            while (XF_WHITESPACE(*q))
+                q++;
+            if (*q != '>')
+                goto fail;
+            if (strlen(xml_name(x)) != nlen || strncmp(xml_name(x), name, nlen) != 0)
+                goto fail;
+            xprefix = xml_prefix(x);
+            if (prefix == NULL ? xprefix != NULL :
+                (xprefix == NULL || strlen(xprefix) != plen || strncmp(xprefix, prefix, plen) != 0))
+                goto fail;
+            if (!elemchild && ft.ft_start != NULL &&
+                (!bind || (y = xml_spec(x)) == NULL ||
+                 (yang_keyword_get(y) != Y_CONTAINER && yang_keyword_get(y) != Y_LIST))){
+                if ((xc = xml_new("body", x, CX_BODY)) == NULL)
+                    goto done;
+                if (ft.ft_copy){
+                    if (xml_value_set(xc, cbuf_get(ft.ft_cb)) < 0)
+                        goto done;
+                }
+                else if (xf_value_set(xc, ft.ft_start, ft.ft_end) < 0)
+                    goto done;
+            }
+            if (bind && xf_bind_end(xy, x) < 0)
+                goto done;
+            x = xml_parent(x);
+            elemchild = 1;
+            p = q + 1;
+            start = 0;
+        }
+        else if (strncmp(p, "<!--", 4) == 0){
+            if ((q = xf_find(p + 4, end, "-->")) == NULL)
+                goto fail;
+            p = q + 3;
+            start = 1;
+        }
+        else if (strncmp(p, "<![CDATA[", 9) == 0){ /* Kept verbatim */
+            if (start)
+                goto fail;
+            if ((q = xf_find(p + 9, end, "]]>")) == NULL)
+                goto fail;
+            if (decl && x == xt)
+                goto fail;
+            if (x != xt && !elemchild &&
+                xf_text_add(&ft, p, q + 3 - p) < 0)
+                goto done;
+            p = q + 3;
+        }
+        else if (strncmp(p, "<?xml", 5) == 0){
+            if (markup)
+                goto fail;
+            if ((p = xf_xmldecl(p)) == NULL)
+                goto fail;
+            decl = 1;
+            start = 1;
+        }
+        else { /* Start tag */
+            if ((q = xf_qname(p+1, &prefix, &plen, &name, &nlen)) == NULL)
+                goto fail;  /* Includes <? and <! */
+            if ((xe = xf_node(x, prefix, plen, name, nlen, CX_ELMNT)) == NULL)
+                goto done;
+            if (x == xt){
+                if (cxvec_append(xe, &xy->xy_xvec, &xy->xy_xlen) < 0)
+                    goto done;
+                if (decl && xy->xy_xlen > 1)
+                    goto fail;
+            }
+            p = q;
+            while (1){ /* Attributes */
+                while (XF_WHITESPACE(*p))
+                    p++;
+                if (*p == '>'){
+                    p++;
+                    empty = 0;
+                    break;
+                }
+                if (*p == '/' && p[1] == '>'){
+                    p += 2;
+                    empty = 1;
+                    break;
+                }
+                if ((q = xf_qname(p, &prefix, &plen, &name, &nlen)) == NULL)
+                    goto fail;
+                while (XF_WHITESPACE(*q))
+                    q++;
+                if (*q++ != '=')
+                    goto fail;
+                while (XF_WHITESPACE(*q))
+                    q++;
+                if (*q != '"' && *q != '\'')
+                    goto fail;
+                if ((s = memchr(q + 1, *q, end - q - 1)) == NULL)
+                    goto fail;
+                if ((xc = xf_node(xe, prefix, plen, name, nlen, CX_ATTR)) == NULL)
+                    goto done;
+                if (xf_value_set(xc, q + 1, s) < 0)
+                    goto done;
+                p = s + 1;
+            }
+            if (bind){
+                if ((ret = xf_bind(xy, x, xe)) < 0)
+                    goto done;
+                if (ret == 0)
+                    goto fail;
+            }
+            if (empty){
+                if (bind && xf_bind_end(xy, xe) < 0)
+                    goto done;
+                elemchild = 1;
+            }
+            else {
+                x = xe;
+                elemchild = 0;
+                ft.ft_start = NULL;
+                ft.ft_copy = 0;
+            }
+            start = 0;
+        }
+        markup = 1;
+    }
+    if (x != xt) /* Premature end of input */
+        goto fail;
+    if (bind){
+        if (xml_sort_parse_end(xt) < 0)
+            goto done;
+        xy->xy_bound = 1;
+    }
+    retval = 1;
+ done:
+    if (ft.ft_cb)
+        cbuf_free(ft.ft_cb);
+    return retval;
+ fail: /* Remove all created nodes */
+    for (i = 0; i < xy->xy_xlen; i++)
+        xml_purge(xy->xy_xvec[i]);
+    if (xy->xy_xvec)
+        free(xy->xy_xvec);
+    xy->xy_xvec = NULL;
+    xy->xy_xlen = 0;
+    retval = 0;
+    goto done;
+}
@@ -73,13 +73,13 @@
 #include "clixon_xml_sort.h"
 #include "clixon_xml_nsctx.h"
 #include "clixon_xml_parse.h"
+#include "clixon_file.h"
 #include "clixon_xml_io.h"
 
 /*
- * Constants
+ * Local variables
  */
-/* Size of xml read buffer */
-#define BUFLEN 1024  
+static int _xml_parse_fast = 0;
 
 /*------------------------------------------------------------------------
  * XML printing functions. Output a parse tree to file, string cligen buf
@@ -460,6 +460,161 @@ clixon_xml2cbuf(cbuf   *cb,
     return retval;
 }
 
+/*! Internal: print XML tree to a cligen buffer, with a filter callback on elements
+ *
+ * As clixon_xml2cbuf1 but element children are only printed if the filter accepts them
+ * @param[in,out] cb       Cligen buffer to write to
+ * @param[in]     xn       Clixon xml tree, element
+ * @param[in]     level    Indentation level for prettyprint
+ * @param[in]     pretty   Insert \n and spaces to make the xml more readable.
+ * @param[in]     depth    Limit levels of child resources: -1 is all, 0 is none, 1 is node itself
+ * @param[in]     fn       Filter function, called once for every element child
+ * @param[in]     arg      Argument to filter function
+ */
+static int
+clixon_xml2cbuf_filter1(cbuf              *cb,
+                        cxobj             *x,
+                        int                level,
+                        int                pretty,
+                        int32_t            depth,
+                        xml2cbuf_filter_t *fn,
+                        void              *arg)
+{
+    int    retval = -1;
+    cxobj *xc;
+    char  *name;
+    int    hasbody = 0;
+    int    haselement = 0; /* Set when first child is printed */
+    char  *namespace;
+    char  *val;
+    int    ret;
+
+    if (depth == 0)
+        goto ok;
+    name = xml_name(x);
+    namespace = xml_prefix(x);
+    if (pretty)
+        cprintf(cb, "%*s<", level*PRETTYPRINT_INDENT, "");
+    else
+        cbuf_append_str(cb, "<");
+    if (namespace){
+        cbuf_append_str(cb, namespace);
+        cbuf_append_str(cb, ":");
+    }
+    cbuf_append_str(cb, name);
+    /* print attributes only */
+    xc = NULL;
+    while ((xc = xml_child_each(x, xc, CX_ATTR)) != NULL)
+        if (clixon_xml2cbuf1(cb, xc, level+1, pretty, -1) < 0)
+            goto done;
+    xc = NULL;
+    while ((xc = xml_child_each(x, xc, -1)) != NULL){
+        switch (xml_type(xc)){
+        case CX_BODY:
+            if ((val = xml_value(xc)) == NULL) /* incomplete tree */
+                break;
+            if (haselement == 0 && hasbody == 0)
+                cbuf_append_str(cb, ">");
+            hasbody = 1;
+            if (xml_chardata_cbuf_append(cb, val) < 0)
+                goto done;
+            break;
+        case CX_ELMNT:
+            if ((ret = fn(xc, arg)) < 0)
+                goto done;
+            if (ret == 0)
+                break;
+            if (haselement == 0 && hasbody == 0){
+                cbuf_append_str(cb, ">");
+                if (pretty)
+                    cbuf_append_str(cb, "\n");
+            }
+            haselement = 1;
+            if (clixon_xml2cbuf_filter1(cb, xc, level+1, pretty, depth-1, fn, arg) < 0)
+                goto done;
+            break;
+        default:
+            break;
+        }
+    }
+    /* Check for special case <a/> instead of <a></a> */
+    if (hasbody==0 && haselement==0)
+        cbuf_append_str(cb, "/>");
+    else{
+        if (pretty && hasbody == 0)
+            cprintf(cb, "%*s", level*PRETTYPRINT_INDENT, "");
+        cbuf_append_str(cb, "</");
+        if (namespace){
+            cbuf_append_str(cb, namespace);
+            cbuf_append_str(cb, ":");
+        }
+        cbuf_append_str(cb, name);
+        cbuf_append_str(cb, ">");
+    }
+    if (pretty)
+        cbuf_append_str(cb, "\n");
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Print an XML tree to a cligen buffer, only elements accepted by a filter callback
+ *
+ * Serializes a view of a tree without building a copy of the sub-tree to print, eg directly
+ * from the datastore cache.
+ * The filter is called for element children (not for xn itself) and returns:
+ *   -1: Error, 0: Skip the element and its sub-tree, 1: Print the element and call the filter
+ *   on its children.
+ * @param[in,out] cb      Cligen buffer to write to
+ * @param[in]     xn      Top-level xml object
+ * @param[in]     level   Indentation level for pretty
+ * @param[in]     pretty  Insert \n and spaces to make the xml more readable.
+ * @param[in]     depth   Limit levels of child resources: -1: all, 0: none, 1: node itself
+ * @param[in]     skiptop 0: Include top object 1: Skip top-object, only children
+ * @param[in]     fn      Filter function
+ * @param[in]     arg     Argument to filter function
+ * @retval        0       OK
+ * @retval        -1      Error
+ * @note Mixed content where body and elements are interleaved is not supported
+ * @see clixon_xml2cbuf  without filter
+ * @see xmldb_view_filter  for a datastore view filter
+ */
+int
+clixon_xml2cbuf_filter(cbuf              *cb,
+                       cxobj             *xn,
+                       int                level,
+                       int                pretty,
+                       int32_t            depth,
+                       int                skiptop,
+                       xml2cbuf_filter_t *fn,
+                       void              *arg)
+{
+    int    retval = -1;
+    cxobj *xc;
+    int    ret;
+
+    if (fn == NULL){
+        clicon_err(OE_XML, EINVAL, "fn is NULL");
+        goto done;
+    }
+    if (skiptop){
+        xc = NULL;
+        while ((xc = xml_child_each(xn, xc, CX_ELMNT)) != NULL){
+            if ((ret = fn(xc, arg)) < 0)
+                goto done;
+            if (ret == 1 &&
+                clixon_xml2cbuf_filter1(cb, xc, level, pretty, depth, fn, arg) < 0)
+                goto done;
+        }
+    }
+    else if (clixon_xml2cbuf_filter1(cb, xn, level, pretty, depth, fn, arg) < 0)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Print actual xml tree datastructures (not xml), mainly for debugging
  * @param[in,out] cb          Cligen buffer to write to
  * @param[in]     xn          Clicon xml tree
@@ -502,10 +657,26 @@ xmltree2cbuf(cbuf  *cb,
 /*--------------------------------------------------------------------
  * XML parsing functions. Create XML parse tree from string and file.
  *--------------------------------------------------------------------*/
+/*! Kludge to use hand-written XML tokenizer before the flex/bison grammar
+ *
+ * The tokenizer handles the common subset of XML, anything else is parsed by the grammar.
+ * The problem with this is that its global and should be bound to a handle
+ * @param[in]  val  If set, use the tokenizer
+ * @see clixon_xml_fastparse
+ */
+int
+xml_parse_fast(int val)
+{
+    _xml_parse_fast = val;
+    return 0;
+}
+
 /*! Common internal xml parsing function string to parse-tree
  *
  * Given a string containing XML, parse into existing XML tree and return
  * @param[in]     str   Pointer to string containing XML definition. 
+ * @param[in]     len   If > 0, str is a writable buffer of len characters terminated by two
+ *                      null characters, scanned in place. If 0, str is copied
  * @param[in]     yb    How to bind yang to XML top-level when parsing
  * @param[in]     yspec Yang specification (only if bind is TOP or CONFIG)
  * @param[in,out] xtop  Top of XML parse tree. Assume created. Holds new tree.
@@ -529,6 +700,7 @@ xmltree2cbuf(cbuf  *cb,
  */
 static int 
 _xml_parse(const char *str, 
+           size_t      len,
            yang_bind   yb,
            yang_stmt  *yspec,
            cxobj      *xt,
@@ -542,24 +714,35 @@ _xml_parse(const char *str,
     int             i;
 
     clicon_debug(CLIXON_DBG_DETAIL, "%s", __FUNCTION__);
-    if (strlen(str) == 0){
+    if (len == 0 && strlen(str) == 0){
         return 1; /* OK */
     }
     if (xt == NULL){
         clicon_err(OE_XML, errno, "Unexpected NULL XML");
         return -1;      
     }
-    if ((xy.xy_parse_string = strdup(str)) == NULL){
+    if (len){ /* Scan buffer in place */
+        xy.xy_parse_string = (char*)str;
+        xy.xy_parse_len = len + 2;
+    }
+    else if ((xy.xy_parse_string = strdup(str)) == NULL){
         clicon_err(OE_XML, errno, "strdup");
         return -1;
     }
     xy.xy_xtop = xt;
     xy.xy_xparent = xt;
     xy.xy_yspec = yspec;
-    if (clixon_xml_parsel_init(&xy) < 0)
-        goto done;    
-    if (clixon_xml_parseparse(&xy) != 0)  /* yacc returns 1 on error */
+    xy.xy_yb = yb;
+    ret = 0;
+    if (_xml_parse_fast &&
+        (ret = clixon_xml_fastparse(&xy, len?len:strlen(xy.xy_parse_string))) < 0)
         goto done;
+    if (ret == 0){ /* Grammar, also if not handled by hand-written tokenizer */
+        if (clixon_xml_parsel_init(&xy) < 0)
+            goto done;    
+        if (clixon_xml_parseparse(&xy) != 0)  /* yacc returns 1 on error */
+            goto done;
+    }
     /* Purge all top-level body objects */
     x = NULL;
     while ((x = xml_find_type(xt, NULL, "body", CX_BODY)) != NULL)
@@ -570,6 +753,8 @@ _xml_parse(const char *str,
         /* Verify namespaces after parsing */
         if (xml2ns_recurse(x) < 0)
             goto done;
+        if (xy.xy_bound) /* Bound while parsing */
+            continue;
         /* Populate, ie associate xml nodes with yang specs 
          */
         switch (yb){
@@ -615,13 +800,14 @@ _xml_parse(const char *str,
         goto fail;
     /* Sort the complete tree after parsing. Sorting is not really meaningful if Yang
        not bound */
-    if (yb != YB_NONE)
+    if (yb != YB_NONE && !xy.xy_bound)
         if (xml_sort_recurse(xt) < 0)
             goto done;
     retval = 1;
   done:
-    clixon_xml_parsel_exit(&xy);
-    if (xy.xy_parse_string != NULL)
+    if (xy.xy_lexbuf)
+        clixon_xml_parsel_exit(&xy);
+    if (xy.xy_parse_len == 0 && xy.xy_parse_string != NULL)
         free(xy.xy_parse_string);
     if (xy.xy_xvec)
         free(xy.xy_xvec);
@@ -664,15 +850,9 @@ clixon_xml_parse_file(FILE      *fp,
                       cxobj    **xt,
                       cxobj    **xerr)
 {
-    int   retval = -1;
-    int   ret;
-    int   len = 0;
-    char  ch;
-    char *xmlbuf = NULL;
-    char *ptr;
-    int   xmlbuflen = BUFLEN; /* start size */
-    int   oldxmlbuflen;
-    int   failed = 0;
+    int     retval = -1;
+    char   *xmlbuf = NULL;
+    size_t  len = 0;
 
     if (xt==NULL || fp == NULL){
         clicon_err(OE_XML, EINVAL, "arg is NULL");
@@ -682,42 +862,16 @@ clixon_xml_parse_file(FILE      *fp,
         clicon_err(OE_XML, EINVAL, "yspec is required if yb == YB_MODULE");
         return -1;
     }
-    if ((xmlbuf = malloc(xmlbuflen)) == NULL){
-        clicon_err(OE_XML, errno, "malloc");
+    /* Read whole file and scan it in place */
+    if (clicon_file_read(fp, &xmlbuf, &len) < 0)
+        goto done;
+    if (*xt == NULL)
+        if ((*xt = xml_new(XML_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+            goto done;
+    if (len == 0)
+        retval = 1;
+    else if ((retval = _xml_parse(xmlbuf, len, yb, yspec, *xt, xerr)) < 0)
         goto done;
-    }
-    memset(xmlbuf, 0, xmlbuflen);
-    ptr = xmlbuf;
-    while (1){
-        if ((ret = fread(&ch, 1, 1, fp)) < 0){
-            clicon_err(OE_XML, errno, "read");
-            break;
-        }
-        if (ret != 0){
-            xmlbuf[len++] = ch;
-        }
-        if (ret == 0) {
-            if (*xt == NULL)
-                if ((*xt = xml_new(XML_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
-                    goto done;
-            if ((ret = _xml_parse(ptr, yb, yspec, *xt, xerr)) < 0)
-                goto done;
-            if (ret == 0)
-                failed++;
-            break;
-        }
-        if (len >= xmlbuflen-1){ /* Space: one for the null character */
-            oldxmlbuflen = xmlbuflen;
-            xmlbuflen *= 2;
-            if ((xmlbuf = realloc(xmlbuf, xmlbuflen)) == NULL){
-                clicon_err(OE_XML, errno, "realloc");
-                goto done;
-            }
-            memset(xmlbuf+oldxmlbuflen, 0, xmlbuflen-oldxmlbuflen);
-            ptr = xmlbuf;
-        }
-    } /* while */
-    retval = (failed==0) ? 1 : 0;
  done:
     if (retval < 0 && *xt){
         free(*xt);
@@ -773,7 +927,53 @@ clixon_xml_parse_string(const char *str,
         if ((*xt = xml_new(XML_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
             return -1;
     }
-    return _xml_parse(str, yb, yspec, *xt, xerr);
+    return _xml_parse(str, 0, yb, yspec, *xt, xerr);
+}
+
+/*! Parse XML in a writable buffer in place into a parse-tree, advanced API
+ *
+ * As clixon_xml_parse_string, but the buffer is scanned in place instead of being copied.
+ * @param[in]     buf   Buffer of len characters followed by two null characters
+ * @param[in]     len   Length of XML in buf, excluding the null characters
+ * @param[in]     yb    How to bind yang to XML top-level when parsing
+ * @param[in]     yspec Yang specification, or NULL
+ * @param[in,out] xt    Pointer to XML parse tree. If empty will be created.
+ * @param[out]    xerr  Reason for failure (yang assignment not made) if retval = 0
+ * @retval        1     Parse OK and all yang assignment made
+ * @retval        0     Parse OK but yang assigment not made (or only partial), xerr is set
+ * @retval       -1     Error with clicon_err called. Includes parse error
+ * @code
+ *  cbuf  *cb;  # Contains XML
+ *  cxobj *xt = NULL;
+ *  cbuf_append_buf(cb, "", 1); # Second null character
+ *  if ((ret = clixon_xml_parse_buf(cbuf_get(cb), cbuf_len(cb)-1, YB_NONE, NULL, &xt, NULL)) < 0)
+ *    err;
+ * @endcode
+ * @note The buffer is modified while parsing but restored when the parser returns OK
+ * @see clixon_xml_parse_string
+ * @see clicon_file_read  Reads a file into such a buffer
+ */
+int 
+clixon_xml_parse_buf(char      *buf, 
+                     size_t     len,
+                     yang_bind  yb,
+                     yang_stmt *yspec,
+                     cxobj    **xt,
+                     cxobj    **xerr)
+{
+    if (xt==NULL || buf == NULL){
+        clicon_err(OE_XML, EINVAL, "arg is NULL");
+        return -1;
+    }
+    if (yb == YB_MODULE && yspec == NULL){
+        clicon_err(OE_XML, EINVAL, "yspec is required if yb == YB_MODULE");
+        return -1;
+    }
+    if (*xt == NULL){
+        if ((*xt = xml_new(XML_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+            return -1;
+    }
+    return _xml_parse(buf, len, yb, yspec, *xt, xerr);
 }
 
 /*! Read XML from var-arg list and parse it into xml tree
@@ -72,6 +72,7 @@
 #include "clixon_xml_nsctx.h"
 #include "clixon_xpath_ctx.h"
 #include "clixon_xpath.h"
+#include "clixon_xpath_compile.h"
 #include "clixon_log.h"
 #include "clixon_err.h"
 #include "clixon_netconf_lib.h"
@@ -1472,17 +1473,16 @@ yang_check_when_xpath(cxobj        *xn,
 {
     int        retval = 1;
     yang_stmt *yc;
+    yang_stmt *yw = NULL; /* yang statement with compiled xpath */
     char      *xpath = NULL;
     cxobj     *x = NULL;
     int        nr = 0;
-    cvec      *nsc = NULL;
     int        xmalloc = 0;   /* ugly help variable to clean temporary object */
-    int        nscmalloc = 0; /* ugly help variable to remove */
 
     /* First variant */
     if ((xpath = yang_when_xpath_get(yn)) != NULL){
         x = xp;
-        nsc = yang_when_nsc_get(yn);
+        yw = yn;
         *hit = 1;
     }
     /* Second variant */
@@ -1497,15 +1497,13 @@ yang_check_when_xpath(cxobj        *xn,
         }
         else
             x = xn;
-        if (xml_nsctx_yang(yn, &nsc) < 0)
-            goto done;
-        nscmalloc++;
+        yw = yc;
         *hit = 1;
     }
     else
         *hit = 0;
     if (x && xpath){
-        if ((nr = xpath_vec_bool(x, nsc, "%s", xpath)) < 0)
+        if ((nr = xpath_prog_yang_bool(yw, x)) < 0)
             goto done;
     }
     if (nrp)
@@ -1516,8 +1514,6 @@ yang_check_when_xpath(cxobj        *xn,
  done:
     if (xmalloc)
         xml_purge(x);
-    if (nsc && nscmalloc)
-        xml_nsctx_free(nsc);
     return retval;
 }
 
@@ -46,6 +46,8 @@
 /*! XML parser yacc handler struct */
 struct clixon_xml_parse_yacc {
     char       *xy_parse_string; /* original (copy of) parse string */
+    size_t      xy_parse_len;    /* If set, parse string is a buffer of this length ending
+                                    with two null characters, scanned in place */
     int         xy_linenum;      /* Number of \n in parsed buffer */
     void       *xy_lexbuf;       /* internal parse buffer from lex */
     cxobj      *xy_xtop;         /* cxobj top element (fixed) */
@@ -55,6 +57,8 @@ struct clixon_xml_parse_yacc {
     int         xy_lex_state;    /* lex return state */
     cxobj     **xy_xvec;         /* Vector of created top-level nodes (to know which are created) */
     int         xy_xlen;         /* Length of xy_xvec */
+    yang_bind   xy_yb;           /* Fast parser: bind yang while parsing if YB_MODULE/YB_PARENT */
+    int         xy_bound;        /* Fast parser: yang bound and sorted while parsing */
 };
 typedef struct clixon_xml_parse_yacc clixon_xml_yacc;
 
@@ -73,4 +77,6 @@ int clixon_xml_parsel_linenr(void);
 int clixon_xml_parselex(void *);
 int clixon_xml_parseparse(void *);
 
+int clixon_xml_fastparse(clixon_xml_yacc *xy, size_t len);
+
 #endif  /* _CLIXON_XML_PARSE_H_ */
@@ -454,6 +454,84 @@ xml_sort_recurse(cxobj *xn)
     return retval;
 }
 
+/*! Check order of a node appended as last child of its parent while parsing
+ *
+ * The subtree of x is complete. If x is not in order with its previous sibling, the parent
+ * is marked and sorted by xml_sort_parse_end. Sorted input, such as datastores written by
+ * clixon, is then kept in place with a single comparison per node.
+ * @param[in]  x   XML node, last child of its parent
+ * @retval     0   OK
+ * @retval    -1   Error
+ * @see xml_sort_recurse  Sorts a parsed tree
+ */
+int
+xml_sort_parse_child(cxobj *x)
+{
+    int    retval = -1;
+    cxobj *xp;
+    cxobj *xprev;
+    int    i;
+
+    if ((xp = xml_parent(x)) == NULL)
+        goto ok;
+    if (xml_flag(xp, XML_FLAG_TRANSIENT)) /* Already not sorted */
+        goto ok;
+    if ((i = xml_child_nr(xp) - 2) < 0)
+        goto ok;
+    xprev = xml_child_i(xp, i);
+    if (xml_type(xprev) != CX_ELMNT)
+        goto ok;
+    if (xml_cmp(xprev, x, 1, 0, NULL) > 0)
+        xml_flag_set(xp, XML_FLAG_TRANSIENT);
+    /* xprev is not compared again unless sorted */
+    if (xml_cv_set(xprev, NULL) < 0)
+        goto done;
+    if (xml_cv_cache_clear(xprev) < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! All children of a node are parsed, sort them if they are not in order
+ *
+ * @param[in]  xp  XML node
+ * @retval     0   OK
+ * @retval    -1   Error
+ * @see xml_sort_parse_child
+ */
+int
+xml_sort_parse_end(cxobj *xp)
+{
+    int    retval = -1;
+    cxobj *x;
+    int    i;
+
+    if (xml_flag(xp, XML_FLAG_TRANSIENT)){
+        xml_flag_reset(xp, XML_FLAG_TRANSIENT);
+        if (xml_sort(xp) < 0)
+            goto done;
+        x = NULL;
+        while ((x = xml_child_each(xp, x, CX_ELMNT)) != NULL){
+            if (xml_cv_set(x, NULL) < 0)
+                goto done;
+            if (xml_cv_cache_clear(x) < 0)
+                goto done;
+        }
+    }
+    else if ((i = xml_child_nr(xp) - 1) >= 0 &&
+             xml_type(x = xml_child_i(xp, i)) == CX_ELMNT){
+        if (xml_cv_set(x, NULL) < 0)
+            goto done;
+        if (xml_cv_cache_clear(x) < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Special case search for ordered-by user or state data where linear sort is used
  *
  * @param[in]  xp    Parent XML node (go through its childre)
@@ -574,6 +652,7 @@ search_multi_equals_xvec(clixon_xvec  *childvec,
                          int           yangi,
                          int           mid,
                          int           skip1,
+                         char         *indexvar,
                          clixon_xvec  *xvec)
 {
     int        retval = -1;
@@ -589,7 +668,7 @@ search_multi_equals_xvec(clixon_xvec  *childvec,
             goto done;
         if (yangi != yi) /* wrong yang */
             break;
-        if (xml_cmp(x1, xc, 0, skip1, NULL) != 0)
+        if (xml_cmp(x1, xc, 0, skip1, indexvar) != 0)
             break;
         if (clixon_xvec_prepend(xvec, xc) < 0)
             goto done;
@@ -601,7 +680,7 @@ search_multi_equals_xvec(clixon_xvec  *childvec,
             goto done;
         if (yangi != yi) /* wrong yang */
             break;
-        if (xml_cmp(x1, xc, 0, skip1, NULL) != 0)
+        if (xml_cmp(x1, xc, 0, skip1, indexvar) != 0)
             break;
         if (clixon_xvec_append(xvec, xc) < 0)
             goto done;
@@ -697,7 +776,7 @@ xml_search_indexvar(cxobj   *xp,
     cxobj       *xc;
 
     /* Check if (exactly one) explicit indexes in cvk */
-    if (xml_search_vector_get(xp, indexvar, &ivec) < 0)
+    if (xml_search_vector_build(xp, indexvar, &ivec) < 0)
         goto done;
     if (ivec){
         ilen = clixon_xvec_len(ivec);
@@ -711,7 +790,7 @@ xml_search_indexvar(cxobj   *xp,
                 goto done;
             /* there may be more? */
             if (search_multi_equals_xvec(ivec, x1, yangi, pos,
-                                         0, xvec) < 0)
+                                         0, indexvar, xvec) < 0)
                 goto done;
         }
     }
@@ -1105,12 +1184,136 @@ xml_insert(cxobj           *xp,
     xml_parent_set(xi, xp);
     /* clear namespace context cache of child */
     nscache_clear(xi);
+#ifdef XML_EXPLICIT_INDEX
+    if (xml_search_index_attach(xp, xi) < 0)
+        goto done;
+#endif
 
     retval = 0;
  done:
     return retval;
 }
 
+/*!
+ * @note args are pointer to pointers, to fit into qsort cmp function
+ * @see xml_cmp_qsort  which also orders equal nodes by enumeration
+ */
+static int
+xml_cmp_qsort_system(const void* arg1,
+                     const void* arg2)
+{
+    return xml_cmp(*(struct xml**)arg1, *(struct xml**)arg2, 0, 0, NULL);
+}
+
+/*! Insert many new list entries as children of xp in sorted place in a single pass
+ *
+ * The new entries are sorted and then merged with the existing sorted children of xp,
+ * instead of a binary search and a move of the child vector for each entry as in
+ * xml_insert, which is quadratic in the number of children.
+ * Search vectors of xp are removed and rebuilt at next search.
+ * @param[in] xp    Parent xml node
+ * @param[in] xvec  New list entries without parent of lists ordered-by system.
+ *                  Sorted on return
+ * @param[in] xlen  Length of xvec
+ * @retval    0     OK
+ * @retval   -1     Error
+ * @see xml_insert  for a single node
+ */
+int
+xml_insert_bulk(cxobj  *xp,
+                cxobj **xvec,
+                int     xlen)
+{
+    int        retval = -1;
+    yang_stmt *y;
+    yang_stmt *yc;
+    yang_stmt *yprev = NULL;  /* Cache of yang order of new entry */
+    yang_stmt *ycprev = NULL; /* Cache of yang order of existing child */
+    int        yi = 0;
+    int        yci = 0;
+    cxobj    **cvec;
+    cxobj    **vec = NULL;
+    cxobj     *xc;
+    int        clen;
+    int        i = 0; /* existing children */
+    int        j = 0; /* new entries */
+    int        k = 0;
+    int        cmp;
+
+    if (xlen == 0)
+        goto ok;
+    for (j=0; j<xlen; j++){
+        if (xml_parent(xvec[j]) != NULL){
+            clicon_err(OE_XML, 0, "XML node %s should not have parent", xml_name(xvec[j]));
+            goto done;
+        }
+        if (xml_spec(xvec[j]) == NULL){
+            clicon_err(OE_XML, 0, "No spec found %s", xml_name(xvec[j]));
+            goto done;
+        }
+    }
+    qsort(xvec, xlen, sizeof(cxobj *), xml_cmp_qsort_system);
+    clen = xml_child_nr(xp);
+    cvec = xml_childvec_get(xp);
+    if ((vec = malloc((clen+xlen)*sizeof(cxobj *))) == NULL){
+        clicon_err(OE_XML, errno, "malloc");
+        goto done;
+    }
+    /* Merge, a new entry is placed before an equal existing child as in xml_insert */
+    j = 0;
+    while (i < clen && j < xlen){
+        xc = cvec[i];
+        if (xml_type(xc) != CX_ELMNT){ /* Attributes first */
+            vec[k++] = cvec[i++];
+            continue;
+        }
+        if ((yc = xml_spec(xc)) == NULL){
+            clicon_err(OE_XML, 0, "No spec found %s", xml_name(xc));
+            goto done;
+        }
+        if ((y = xml_spec(xvec[j])) == yc)
+            cmp = xml_cmp(xvec[j], xc, 0, 0, NULL);
+        else {
+            if (y != yprev){
+                if ((yi = yang_order(y)) < -1)
+                    goto done;
+                yprev = y;
+            }
+            if (yc != ycprev){
+                if ((yci = yang_order(yc)) < -1)
+                    goto done;
+                ycprev = yc;
+            }
+            cmp = yi - yci;
+        }
+        if (cmp <= 0)
+            vec[k++] = xvec[j++];
+        else
+            vec[k++] = cvec[i++];
+    }
+    while (i < clen)
+        vec[k++] = cvec[i++];
+    while (j < xlen)
+        vec[k++] = xvec[j++];
+    if (xml_childvec_set(xp, k) < 0)
+        goto done;
+    memcpy(xml_childvec_get(xp), vec, k*sizeof(cxobj *));
+    for (j=0; j<xlen; j++){
+        xml_parent_set(xvec[j], xp);
+        nscache_clear(xvec[j]);
+    }
+#ifdef XML_EXPLICIT_INDEX
+    if (xml_search_index_reset(xp) < 0)
+        goto done;
+#endif
+ ok:
+    retval = 0;
+ done:
+    if (vec)
+        free(vec);
+    return retval;
+}
+
 /*! Verify all children of XML node are sorted according to xml_sort()
  * @param[in]   x    XML node. Check its children
  * @param[in]   arg  Dummy. Ensures xml_apply can be used with this fn
@@ -1598,3 +1801,153 @@ clixon_xml_find_pos(cxobj        *xp,
  done:
     return retval;
 }
+
+/*! Binary search for first child of xp at or after a yang order, skipping attributes
+ * @param[in]  xp     Parent xml node, children sorted in yang order
+ * @param[in]  low    Start of child vector search interval
+ * @param[in]  yi     Yang order, see yang_order
+ * @retval     pos    First child position with yang order >= yi, or nr of children
+ * @retval    -1      Error
+ */
+static int
+xml_child_yang_lower(cxobj *xp,
+                     int    low,
+                     int    yi)
+{
+    int        upper = xml_child_nr(xp);
+    int        mid;
+    yang_stmt *y;
+    int        ym;
+
+    while (low < upper){
+        mid = (low + upper) / 2;
+        if ((y = xml_spec(xml_child_i(xp, mid))) == NULL){
+            clicon_err(OE_YANG, ENOENT, "No yang spec of %s", xml_name(xml_child_i(xp, mid)));
+            return -1;
+        }
+        if ((ym = yang_order(y)) < -1)
+            return -1;
+        if (ym < yi)
+            low = mid + 1;
+        else
+            upper = mid;
+    }
+    return low;
+}
+
+/*! Find position after a key among list or leaf-list entries, for keyset pagination (cursors)
+ *
+ * The entries of yc are a contiguous range in the sorted child vector of xp. The range is
+ * found using binary search on yang order. The position after cvk in the range is found with
+ * binary search on keys, or with linear search if the list is ordered-by user.
+ * @param[in]  xp     Parent xml node. 
+ * @param[in]  yc     Yang spec of list or leaf-list child
+ * @param[in]  cvk    Keys and values of last seen entry as k1=foo, k2=bar, "." for leaf-list,
+ *                    or NULL for the first entry
+ * @param[out] startp Child vector position of first entry of yc
+ * @param[out] posp   Child vector position of first entry after cvk
+ * @param[out] endp   Child vector position after last entry of yc
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @note If the list is ordered-by user and cvk is not found, posp is set to endp
+ * @see clixon_xml_find_index  for finding entries matching keys
+ */
+int
+clixon_xml_find_cursor(cxobj     *xp,
+                       yang_stmt *yc,
+                       cvec      *cvk,
+                       int       *startp,
+                       int       *posp,
+                       int       *endp)
+{
+    int        retval = -1;
+    cxobj     *xc = NULL;
+    cxobj     *xk;
+    cxobj     *xb;
+    cg_var    *cvi;
+    yang_stmt *yk;
+    int        low;
+    int        start;
+    int        end;
+    int        pos;
+    int        upper;
+    int        mid;
+    int        yi;
+    int        sorted;
+
+    if (xp == NULL || yc == NULL){
+        clicon_err(OE_XML, EINVAL, "xp or yc is NULL");
+        goto done;
+    }
+    if (yang_keyword_get(yc) != Y_LIST && yang_keyword_get(yc) != Y_LEAF_LIST){
+        clicon_err(OE_YANG, EINVAL, "%s is not list or leaf-list", yang_argument_get(yc));
+        goto done;
+    }
+    for (low=0; low<xml_child_nr(xp); low++)
+        if (xml_type(xml_child_i(xp, low)) != CX_ATTR)
+            break;
+    if ((yi = yang_order(yc)) < -1)
+        goto done;
+    if ((start = xml_child_yang_lower(xp, low, yi)) < 0)
+        goto done;
+    if ((end = xml_child_yang_lower(xp, start, yi+1)) < 0)
+        goto done;
+    pos = start;
+    if (cvk != NULL && start < end){
+        /* Create a temporary search object with the keys */
+        if ((xc = xml_new(yang_argument_get(yc), NULL, CX_ELMNT)) == NULL)
+            goto done;
+        xml_spec_set(xc, yc);
+        cvi = NULL;
+        while ((cvi = cvec_each(cvk, cvi)) != NULL) {
+            if (yang_keyword_get(yc) == Y_LEAF_LIST)
+                xk = xc;
+            else {
+                if ((yk = yang_find(yc, Y_LEAF, cv_name_get(cvi))) == NULL){
+                    clicon_err(OE_YANG, ENOENT, "%s is not a key of %s",
+                               cv_name_get(cvi), yang_argument_get(yc));
+                    goto done;
+                }
+                if ((xk = xml_new(cv_name_get(cvi), xc, CX_ELMNT)) == NULL)
+                    goto done;
+                xml_spec_set(xk, yk);
+            }
+            if ((xb = xml_new("body", xk, CX_BODY)) == NULL)
+                goto done;
+            if (xml_value_set(xb, cv_string_get(cvi)) < 0)
+                goto done;
+        }
+        sorted = yang_find(yc, Y_ORDERED_BY, "user") == NULL;
+#ifndef STATE_ORDERED_BY_SYSTEM
+        if (yang_config_ancestor(yc) == 0)
+            sorted = 0;
+#endif
+        if (sorted){ /* First entry greater than cvk */
+            upper = end;
+            while (pos < upper){
+                mid = (pos + upper) / 2;
+                if (xml_cmp(xc, xml_child_i(xp, mid), 0, 1, NULL) < 0)
+                    upper = mid;
+                else
+                    pos = mid + 1;
+            }
+        }
+        else { /* Entry after the one equal to cvk */
+            while (pos < end && xml_cmp(xc, xml_child_i(xp, pos), 0, 1, NULL) != 0)
+                pos++;
+            if (pos < end)
+                pos++;
+        }
+    }
+    if (startp)
+        *startp = start;
+    if (posp)
+        *posp = pos;
+    if (endp)
+        *endp = end;
+    retval = 0;
+ done:
+    if (xc)
+        xml_free(xc);
+    return retval;
+}
@@ -0,0 +1,1045 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, indicate
+  your decision by deleting the provisions above and replace them with the 
+  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * Clixon XML XPATH 1.0 according to https://www.w3.org/TR/xpath-10
+ * Compiled XPath: the parse tree is translated to a flat instruction vector which is evaluated
+ * with a value stack.
+ * The parse tree evaluator (xp_eval) allocates new contexts for every tree node, step and
+ * predicate candidate. A compiled program keeps its value stack and the nodeset buffers of each
+ * stack entry between evaluations, so that once they have grown, an evaluation does no
+ * allocations. Used for YANG must and when expressions which are evaluated for every
+ * instance of a node, see xpath_prog_yang_bool.
+ * Compiled:
+ *   - Number and string literals, and, or, relational and numeric operators, union
+ *   - Location paths with child, parent and self steps, and predicates
+ *   - current(), current()/<path>, count(), boolean(), not(), true() and false()
+ * Any other expression, eg // or other functions, is compiled to an instruction evaluating
+ * the parse sub-tree with xp_eval with the same context as the parse tree evaluator.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <syslog.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clicon */
+#include "clixon_err.h"
+#include "clixon_log.h"
+#include "clixon_string.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_xml_nsctx.h"
+#include "clixon_xpath_ctx.h"
+#include "clixon_xpath.h"
+#include "clixon_xpath_optimize.h"
+#include "clixon_xpath_function.h"
+#include "clixon_xpath_eval.h"
+#include "clixon_xpath_compile.h"
+
+/*
+ * Types
+ */
+/* Instruction opcodes
+ * @see xpc_opmap
+ */
+enum xpc_op{
+    XPC_NUMBER,  /* Push number literal of xi_xs */
+    XPC_STRING,  /* Push string literal of xi_xs */
+    XPC_CONTEXT, /* Push context node */
+    XPC_ROOT,    /* Push top of context node */
+    XPC_CURRENT, /* Push initial node: current() */
+    XPC_CHILD,   /* Replace nodeset on top with children matching nodetest of step xi_xs */
+    XPC_PARENT,  /* Replace nodeset on top with parents */
+    XPC_FILTER,  /* Filter nodeset on top with predicate in the following xi_int instructions */
+    XPC_LOGOP,   /* Replace two top values with logical operation xi_int */
+    XPC_NUMOP,   /* Replace two top values with numeric operation xi_int */
+    XPC_RELOP,   /* Replace two top values with relational operation xi_int */
+    XPC_UNION,   /* Replace two top nodesets with their union */
+    XPC_COUNT,   /* Replace top value with number of nodes */
+    XPC_BOOLEAN, /* Replace top value with its boolean value */
+    XPC_NOT,     /* Replace top value with its negated boolean value */
+    XPC_BOOL,    /* Push boolean xi_int: true() or false() */
+    XPC_TREE,    /* Push result of parse tree evaluation of xi_xs */
+    XPC_RETURN,  /* End of program or predicate, result on top */
+};
+
+/* Instruction */
+struct xpc_insn{
+    enum xpc_op  xi_op;
+    int          xi_int;   /* Operator, boolean or predicate length */
+    xpath_tree  *xi_xs;    /* Parse tree node, points into program tree */
+};
+
+/* Value stack entry. The nodeset buffer is kept when the entry is popped */
+struct xpc_value{
+    xp_ctx       xv_ctx;
+    int          xv_max;   /* Allocated length of xv_ctx.xc_nodeset */
+    int          xv_free;  /* xv_ctx.xc_string is malloced */
+};
+
+/* Compiled XPath program */
+struct xpath_prog{
+    char             *xp_xpath;    /* Original XPath string */
+    xpath_tree       *xp_tree;     /* Parse tree */
+    cvec             *xp_nsc;      /* Namespace context */
+    struct xpc_insn  *xp_insn;     /* Instruction vector */
+    int               xp_len;      /* Number of instructions */
+    int               xp_max;      /* Allocated instructions */
+    struct xpc_value *xp_stack;    /* Value stack, kept between evaluations */
+    int               xp_stackmax; /* Allocated stack entries */
+};
+
+/*
+ * Variables
+ */
+static const map_str2int xpc_opmap[] = {
+    {"number",    XPC_NUMBER},
+    {"string",    XPC_STRING},
+    {"context",   XPC_CONTEXT},
+    {"root",      XPC_ROOT},
+    {"current",   XPC_CURRENT},
+    {"child",     XPC_CHILD},
+    {"parent",    XPC_PARENT},
+    {"filter",    XPC_FILTER},
+    {"logop",     XPC_LOGOP},
+    {"numop",     XPC_NUMOP},
+    {"relop",     XPC_RELOP},
+    {"union",     XPC_UNION},
+    {"count",     XPC_COUNT},
+    {"boolean",   XPC_BOOLEAN},
+    {"not",       XPC_NOT},
+    {"bool",      XPC_BOOL},
+    {"tree",      XPC_TREE},
+    {"return",    XPC_RETURN},
+    {NULL,        -1}
+};
+
+/* Use compiled programs for must and when, otherwise parse and evaluate the xpath string */
+static int _xpath_compile = 1;
+
+/*! Enable or disable compiled xpath for yang must and when statements
+ *
+ * Global setting since it is used in validation functions without a handle
+ * @param[in]  enable  If 0 parse and evaluate must/when xpath at every validation
+ * @see CLICON_XPATH_COMPILE
+ */
+int
+xpath_compile_enable(int enable)
+{
+    _xpath_compile = enable;
+    return 0;
+}
+
+/*! Append an instruction to a program
+ */
+static int
+xpc_emit(xpath_prog  *prog,
+         enum xpc_op  op,
+         int          i,
+         xpath_tree  *xs)
+{
+    struct xpc_insn *insn;
+    int              max;
+
+    if (prog->xp_len >= prog->xp_max){
+        max = prog->xp_max ? 2*prog->xp_max : 16;
+        if ((insn = realloc(prog->xp_insn, max*sizeof(*insn))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            return -1;
+        }
+        prog->xp_insn = insn;
+        prog->xp_max = max;
+    }
+    insn = &prog->xp_insn[prog->xp_len++];
+    insn->xi_op = op;
+    insn->xi_int = i;
+    insn->xi_xs = xs;
+    return 0;
+}
+
+static int xpc_expr(xpath_prog *prog, xpath_tree *xs);
+
+/*! Compile predicates of a step, each filters the nodeset on top of stack
+ *
+ * @param[in]  prog  XPath program
+ * @param[in]  xs    XP_PRED node or NULL
+ * @retval     1     OK
+ * @retval     0     Not compiled
+ * @retval    -1     Error
+ */
+static int
+xpc_preds(xpath_prog *prog,
+          xpath_tree *xs)
+{
+    int ret;
+    int i;
+
+    if (xs == NULL)
+        return 1;
+    if (xs->xs_type != XP_PRED)
+        return 0;
+    if (xs->xs_c0 && (ret = xpc_preds(prog, xs->xs_c0)) <= 0)
+        return ret;
+    if (xs->xs_c1){
+        i = prog->xp_len;
+        if (xpc_emit(prog, XPC_FILTER, 0, xs) < 0)
+            return -1;
+        if (xpc_expr(prog, xs->xs_c1) < 0)
+            return -1;
+        if (xpc_emit(prog, XPC_RETURN, 0, NULL) < 0)
+            return -1;
+        prog->xp_insn[i].xi_int = prog->xp_len - i - 1;
+    }
+    return 1;
+}
+
+/*! Compile relative location path applied to the nodeset on top of stack
+ *
+ * @param[in]  prog  XPath program
+ * @param[in]  xs    XP_RELLOCPATH or XP_STEP node
+ * @retval     1     OK
+ * @retval     0     Not compiled, eg // or other axes
+ * @retval    -1     Error
+ */
+static int
+xpc_path(xpath_prog *prog,
+         xpath_tree *xs)
+{
+    int ret;
+
+    switch (xs->xs_type){
+    case XP_RELLOCPATH:
+        if (xs->xs_int == A_DESCENDANT_OR_SELF || xs->xs_c0 == NULL)
+            return 0;
+        if ((ret = xpc_path(prog, xs->xs_c0)) <= 0)
+            return ret;
+        if (xs->xs_c1)
+            return xpc_path(prog, xs->xs_c1);
+        return 1;
+    case XP_STEP:
+        switch (xs->xs_int){
+        case A_CHILD:
+            if (xpc_emit(prog, XPC_CHILD, 0, xs) < 0)
+                return -1;
+            break;
+        case A_PARENT:
+            if (xpc_emit(prog, XPC_PARENT, 0, xs) < 0)
+                return -1;
+            break;
+        case A_SELF:
+            break;
+        default:
+            return 0;
+        }
+        return xpc_preds(prog, xs->xs_c1);
+    default:
+        break;
+    }
+    return 0;
+}
+
+/*! Compile one expression node, leaving its value on top of stack
+ *
+ * @param[in]  prog  XPath program
+ * @param[in]  xs    XPath parse tree node
+ * @retval     1     OK
+ * @retval     0     Not compiled, partially emitted instructions are discarded by caller
+ * @retval    -1     Error
+ */
+static int
+xpc_expr1(xpath_prog *prog,
+          xpath_tree *xs)
+{
+    xpath_tree *xf;
+    enum xpc_op op;
+
+    switch (xs->xs_type){
+    case XP_EXP:
+    case XP_AND:
+    case XP_RELEX:
+    case XP_ADD:
+    case XP_UNION:
+        if (xs->xs_c0 == NULL)
+            return 0;
+        if (xs->xs_c1 == NULL)
+            return xpc_expr(prog, xs->xs_c0) < 0 ? -1 : 1;
+        switch (xs->xs_type){
+        case XP_EXP:
+            /* expr: "or", or function arguments which have A_NAN, ie same value as XO_AND */
+            if (xs->xs_int != XO_OR)
+                return 0;
+            op = XPC_LOGOP;
+            break;
+        case XP_AND:
+            op = XPC_LOGOP;
+            break;
+        case XP_RELEX:
+            op = XPC_RELOP;
+            break;
+        case XP_ADD:
+            op = XPC_NUMOP;
+            break;
+        case XP_UNION:
+            op = XPC_UNION;
+            break;
+        default:
+            return 0;
+        }
+        if (xpc_expr(prog, xs->xs_c0) < 0 ||
+            xpc_expr(prog, xs->xs_c1) < 0)
+            return -1;
+        if (xpc_emit(prog, op, xs->xs_int, xs) < 0)
+            return -1;
+        return 1;
+    case XP_FILTEREXPR:
+    case XP_PRI0:
+    case XP_LOCPATH:
+        if (xs->xs_c0 == NULL || xs->xs_c1 != NULL)
+            return 0;
+        return xpc_expr(prog, xs->xs_c0) < 0 ? -1 : 1;
+    case XP_PATHEXPR:
+        if (xs->xs_c0 == NULL)
+            return 0;
+        if (xs->xs_c1 == NULL)
+            return xpc_expr(prog, xs->xs_c0) < 0 ? -1 : 1;
+        /* Only current()/<rellocpath> */
+        if (xs->xs_s0 == NULL || strcmp(xs->xs_s0, "/") != 0 ||
+            xs->xs_c0->xs_type != XP_FILTEREXPR ||
+            (xf = xs->xs_c0->xs_c0) == NULL ||
+            xf->xs_type != XP_PRIME_FN ||
+            xf->xs_s0 == NULL ||
+            xf->xs_int != XPATHFN_CURRENT)
+            return 0;
+        if (xpc_emit(prog, XPC_CURRENT, 0, xf) < 0)
+            return -1;
+        return xpc_path(prog, xs->xs_c1);
+    case XP_ABSPATH:
+        if (xs->xs_int == A_DESCENDANT_OR_SELF || xs->xs_c0 == NULL)
+            return 0;
+        if (xpc_emit(prog, XPC_ROOT, 0, xs) < 0)
+            return -1;
+        return xpc_path(prog, xs->xs_c0);
+    case XP_RELLOCPATH:
+        if (xpc_emit(prog, XPC_CONTEXT, 0, xs) < 0)
+            return -1;
+        return xpc_path(prog, xs);
+    case XP_PRIME_NR:
+        if (xpc_emit(prog, XPC_NUMBER, 0, xs) < 0)
+            return -1;
+        return 1;
+    case XP_PRIME_STR:
+        if (xpc_emit(prog, XPC_STRING, 0, xs) < 0)
+            return -1;
+        return 1;
+    case XP_PRIME_FN:
+        if (xs->xs_s0 == NULL)
+            return 0;
+        switch (xs->xs_int){
+        case XPATHFN_CURRENT:
+            op = XPC_CURRENT;
+            break;
+        case XPATHFN_TRUE:
+            return xpc_emit(prog, XPC_BOOL, 1, xs) < 0 ? -1 : 1;
+        case XPATHFN_FALSE:
+            return xpc_emit(prog, XPC_BOOL, 0, xs) < 0 ? -1 : 1;
+        case XPATHFN_COUNT:
+            op = XPC_COUNT;
+            break;
+        case XPATHFN_BOOLEAN:
+            op = XPC_BOOLEAN;
+            break;
+        case XPATHFN_NOT:
+            op = XPC_NOT;
+            break;
+        default:
+            return 0;
+        }
+        if (op != XPC_CURRENT){ /* Single argument */
+            if (xs->xs_c0 == NULL || xs->xs_c0->xs_c1 != NULL)
+                return 0;
+            if (xpc_expr(prog, xs->xs_c0) < 0)
+                return -1;
+        }
+        if (xpc_emit(prog, op, 0, xs) < 0)
+            return -1;
+        return 1;
+    default:
+        break;
+    }
+    return 0;
+}
+
+/*! Compile an expression, leaving its value on top of stack
+ *
+ * If the expression cannot be compiled, emit an instruction evaluating its parse tree
+ * @param[in]  prog  XPath program
+ * @param[in]  xs    XPath parse tree node
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+xpc_expr(xpath_prog *prog,
+         xpath_tree *xs)
+{
+    int len = prog->xp_len;
+    int ret;
+
+    if ((ret = xpc_expr1(prog, xs)) < 0)
+        return -1;
+    if (ret == 0){
+        prog->xp_len = len;
+        if (xpc_emit(prog, XPC_TREE, 0, xs) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*! Compile an XPath expression
+ *
+ * @param[in]  xpath  XPath string
+ * @param[in]  nsc    Namespace context, copied, or NULL
+ * @param[out] progp  Compiled program, free with xpath_prog_free
+ * @retval     0      OK
+ * @retval    -1      Error, eg xpath syntax error
+ * @code
+ *   xpath_prog *prog = NULL;
+ *   if (xpath_prog_new("../type = 'eth'", nsc, &prog) < 0)
+ *      err;
+ *   if ((ret = xpath_prog_bool(prog, x)) < 0)
+ *      err;
+ *   xpath_prog_free(prog);
+ * @endcode
+ */
+int
+xpath_prog_new(const char  *xpath,
+               cvec        *nsc,
+               xpath_prog **progp)
+{
+    int         retval = -1;
+    xpath_prog *prog = NULL;
+
+    if (xpath == NULL || progp == NULL){
+        clicon_err(OE_XML, EINVAL, "xpath or progp is NULL");
+        goto done;
+    }
+    if ((prog = malloc(sizeof(*prog))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(prog, 0, sizeof(*prog));
+    if ((prog->xp_xpath = strdup(xpath)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    if (nsc && (prog->xp_nsc = cvec_dup(nsc)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_dup");
+        goto done;
+    }
+    if (xpath_parse(xpath, &prog->xp_tree) < 0)
+        goto done;
+    if (xpc_expr(prog, prog->xp_tree) < 0)
+        goto done;
+    if (xpc_emit(prog, XPC_RETURN, 0, NULL) < 0)
+        goto done;
+    *progp = prog;
+    prog = NULL;
+    retval = 0;
+ done:
+    if (prog)
+        xpath_prog_free(prog);
+    return retval;
+}
+
+/*! Free a compiled XPath program
+ */
+int
+xpath_prog_free(xpath_prog *prog)
+{
+    int i;
+
+    if (prog->xp_stack){
+        for (i=0; i<prog->xp_stackmax; i++){
+            if (prog->xp_stack[i].xv_ctx.xc_nodeset)
+                free(prog->xp_stack[i].xv_ctx.xc_nodeset);
+            if (prog->xp_stack[i].xv_free && prog->xp_stack[i].xv_ctx.xc_string)
+                free(prog->xp_stack[i].xv_ctx.xc_string);
+        }
+        free(prog->xp_stack);
+    }
+    if (prog->xp_insn)
+        free(prog->xp_insn);
+    if (prog->xp_tree)
+        xpath_tree_free(prog->xp_tree);
+    if (prog->xp_nsc)
+        cvec_free(prog->xp_nsc);
+    if (prog->xp_xpath)
+        free(prog->xp_xpath);
+    free(prog);
+    return 0;
+}
+
+/*! Print a compiled XPath program, for debugging
+ */
+int
+xpath_prog_print(FILE       *f,
+                 xpath_prog *prog)
+{
+    int              retval = -1;
+    struct xpc_insn *insn;
+    cbuf            *cb = NULL;
+    int              i;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    fprintf(f, "%s\n", prog->xp_xpath);
+    for (i=0; i<prog->xp_len; i++){
+        insn = &prog->xp_insn[i];
+        fprintf(f, "%3d %-8s", i, clicon_int2str(xpc_opmap, insn->xi_op));
+        switch (insn->xi_op){
+        case XPC_NUMBER:
+            fprintf(f, " %s", insn->xi_xs->xs_strnr);
+            break;
+        case XPC_STRING:
+            fprintf(f, " '%s'", insn->xi_xs->xs_s0?insn->xi_xs->xs_s0:"");
+            break;
+        case XPC_CHILD:
+            if (insn->xi_xs->xs_c0 && insn->xi_xs->xs_c0->xs_type == XP_NODE)
+                fprintf(f, " %s%s%s",
+                        insn->xi_xs->xs_c0->xs_s0?insn->xi_xs->xs_c0->xs_s0:"",
+                        insn->xi_xs->xs_c0->xs_s0?":":"",
+                        insn->xi_xs->xs_c0->xs_s1?insn->xi_xs->xs_c0->xs_s1:"*");
+            break;
+        case XPC_FILTER:
+        case XPC_BOOL:
+            fprintf(f, " %d", insn->xi_int);
+            break;
+        case XPC_LOGOP:
+        case XPC_NUMOP:
+        case XPC_RELOP:
+            fprintf(f, " %s", clicon_int2str(xpopmap, insn->xi_int));
+            break;
+        case XPC_TREE:
+            cbuf_reset(cb);
+            if (xpath_tree2cbuf(insn->xi_xs, cb) < 0)
+                goto done;
+            fprintf(f, " %s", cbuf_get(cb));
+            break;
+        default:
+            break;
+        }
+        fprintf(f, "\n");
+    }
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Clear a stack entry keeping its nodeset buffer
+ */
+static void
+xpc_value_reset(struct xpc_value *v)
+{
+    cxobj **vec = v->xv_ctx.xc_nodeset;
+
+    if (v->xv_free && v->xv_ctx.xc_string)
+        free(v->xv_ctx.xc_string);
+    v->xv_free = 0;
+    memset(&v->xv_ctx, 0, sizeof(v->xv_ctx));
+    v->xv_ctx.xc_nodeset = vec;
+}
+
+/*! Push an empty nodeset on the value stack
+ *
+ * @param[in]     prog  XPath program
+ * @param[in,out] sp    Stack pointer
+ * @retval        v     New top of stack
+ * @retval        NULL  Error
+ * @note The stack may be reallocated, stack entry pointers are not valid after a push
+ */
+static struct xpc_value *
+xpc_push(xpath_prog *prog,
+         int        *sp)
+{
+    struct xpc_value *v;
+    int               max;
+
+    if (*sp >= prog->xp_stackmax){
+        max = prog->xp_stackmax ? 2*prog->xp_stackmax : 8;
+        if ((v = realloc(prog->xp_stack, max*sizeof(*v))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            return NULL;
+        }
+        memset(&v[prog->xp_stackmax], 0, (max-prog->xp_stackmax)*sizeof(*v));
+        prog->xp_stack = v;
+        prog->xp_stackmax = max;
+    }
+    v = &prog->xp_stack[(*sp)++];
+    xpc_value_reset(v);
+    return v;
+}
+
+/*! Append a node to the nodeset of a stack entry
+ */
+static int
+xpc_append(struct xpc_value *v,
+           cxobj            *x)
+{
+    cxobj **vec;
+    int     max;
+
+    if (v->xv_ctx.xc_size >= v->xv_max){
+        max = v->xv_max ? 2*v->xv_max : 8;
+        if ((vec = realloc(v->xv_ctx.xc_nodeset, max*sizeof(*vec))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            return -1;
+        }
+        v->xv_ctx.xc_nodeset = vec;
+        v->xv_max = max;
+    }
+    v->xv_ctx.xc_nodeset[v->xv_ctx.xc_size++] = x;
+    return 0;
+}
+
+/*! Push a single node on the value stack
+ */
+static int
+xpc_push_node(xpath_prog *prog,
+              int        *sp,
+              cxobj      *x)
+{
+    struct xpc_value *v;
+
+    if ((v = xpc_push(prog, sp)) == NULL)
+        return -1;
+    return xpc_append(v, x);
+}
+
+/*! Replace the nodeset on top with the children matching a step nodetest
+ *
+ * The new nodeset is built in the entry above the top, and then swapped with it
+ * @param[in]     prog  XPath program
+ * @param[in]     xs    XP_STEP node
+ * @param[in,out] sp    Stack pointer
+ * @see xp_eval_step   A_CHILD
+ */
+static int
+xpc_child(xpath_prog *prog,
+          xpath_tree *xs,
+          int        *sp)
+{
+    int               retval = -1;
+    struct xpc_value *v;
+    struct xpc_value *w;
+    struct xpc_value  tmp;
+    xpath_tree       *nodetest = xs->xs_c0;
+    cxobj            *xv;
+    cxobj            *x;
+    cxobj           **vec = NULL;
+    int               veclen = 0;
+    int               optimize;
+    int               i;
+    int               j;
+    int               ret;
+
+    /* Only steps with predicates can be list searches, see xpath_list_optimize_fn */
+    optimize = (xs->xs_c1 != NULL && xs->xs_c1->xs_c1 != NULL);
+    if ((w = xpc_push(prog, sp)) == NULL)
+        goto done;
+    v = &prog->xp_stack[*sp-2];
+    for (i=0; i<v->xv_ctx.xc_size; i++){
+        xv = v->xv_ctx.xc_nodeset[i];
+        if (optimize){
+            if ((ret = xpath_optimize_check(xs, xv, &vec, &veclen)) < 0)
+                goto done;
+            if (ret == 1){
+                for (j=0; j<veclen; j++)
+                    if (xpc_append(w, vec[j]) < 0)
+                        goto done;
+                if (vec){
+                    free(vec);
+                    vec = NULL;
+                }
+                veclen = 0;
+                continue;
+            }
+        }
+        x = NULL;
+        while ((x = xml_child_each(xv, x, CX_ELMNT)) != NULL) {
+            if (nodetest == NULL ||
+                nodetest_eval(x, nodetest, prog->xp_nsc, 0) == 1)
+                if (xpc_append(w, x) < 0)
+                    goto done;
+        }
+    }
+    tmp = *v;
+    *v = *w;
+    *w = tmp;
+    (*sp)--;
+    retval = 0;
+ done:
+    if (vec)
+        free(vec);
+    return retval;
+}
+
+/*! Push the result of evaluating a parse sub-tree
+ *
+ * The context is the same as the parse tree evaluator gives expressions: a nodeset with the
+ * context node
+ * @see xp_eval_predicate
+ */
+static int
+xpc_tree(xpath_prog *prog,
+         xpath_tree *xs,
+         cxobj      *xnode,
+         int         position,
+         cxobj      *xinitial,
+         int        *sp)
+{
+    int               retval = -1;
+    xp_ctx            xc = {0,};
+    cxobj            *vec[1];
+    xp_ctx           *xr = NULL;
+    struct xpc_value *v;
+    int               i;
+
+    vec[0] = xnode;
+    xc.xc_type = XT_NODESET;
+    xc.xc_nodeset = vec;
+    xc.xc_size = 1;
+    xc.xc_position = position;
+    xc.xc_node = xnode;
+    xc.xc_initial = xinitial;
+    if (xp_eval(&xc, xs, prog->xp_nsc, 0, &xr) < 0)
+        goto done;
+    if ((v = xpc_push(prog, sp)) == NULL)
+        goto done;
+    v->xv_ctx.xc_type = xr->xc_type;
+    v->xv_ctx.xc_bool = xr->xc_bool;
+    v->xv_ctx.xc_number = xr->xc_number;
+    if (xr->xc_string){
+        v->xv_ctx.xc_string = xr->xc_string;
+        xr->xc_string = NULL;
+        v->xv_free = 1;
+    }
+    for (i=0; i<xr->xc_size; i++)
+        if (xpc_append(v, xr->xc_nodeset[i]) < 0)
+            goto done;
+    retval = 0;
+ done:
+    if (xr)
+        ctx_free(xr);
+    return retval;
+}
+
+/*! Evaluate a compiled program, or predicate, from an instruction until return
+ *
+ * @param[in]     prog      XPath program
+ * @param[in]     pc        First instruction
+ * @param[in]     xnode     Context node
+ * @param[in]     position  Context position
+ * @param[in]     xinitial  Initial node, for current()
+ * @param[in,out] sp        Stack pointer, result is pushed on the stack
+ * @retval        0         OK
+ * @retval       -1         Error
+ */
+static int
+xpc_exec(xpath_prog *prog,
+         int         pc,
+         cxobj      *xnode,
+         int         position,
+         cxobj      *xinitial,
+         int        *sp)
+{
+    int               retval = -1;
+    struct xpc_insn  *insn;
+    struct xpc_value *v;
+    xp_ctx           *xc1;
+    xp_ctx           *xc2;
+    xp_ctx            xr;
+    cxobj            *x;
+    cxobj            *xp;
+    int               vi;
+    int               i;
+    int               k;
+    int               b;
+
+    for (; pc < prog->xp_len; pc++){
+        insn = &prog->xp_insn[pc];
+        switch (insn->xi_op){
+        case XPC_NUMBER:
+            if ((v = xpc_push(prog, sp)) == NULL)
+                goto done;
+            v->xv_ctx.xc_type = XT_NUMBER;
+            v->xv_ctx.xc_number = insn->xi_xs->xs_double;
+            break;
+        case XPC_STRING:
+            if ((v = xpc_push(prog, sp)) == NULL)
+                goto done;
+            v->xv_ctx.xc_type = XT_STRING;
+            v->xv_ctx.xc_string = insn->xi_xs->xs_s0; /* Not copied */
+            break;
+        case XPC_CONTEXT:
+            if (xpc_push_node(prog, sp, xnode) < 0)
+                goto done;
+            break;
+        case XPC_ROOT:
+            x = xnode;
+#ifdef XML_PARENT_CANDIDATE
+            while (xml_parent(x) != NULL || xml_parent_candidate(x) != NULL)
+                x = xml_parent(x)?xml_parent(x):xml_parent_candidate(x);
+#else
+            while (xml_parent(x) != NULL)
+                x = xml_parent(x);
+#endif
+            if (xpc_push_node(prog, sp, x) < 0)
+                goto done;
+            break;
+        case XPC_CURRENT:
+            if (xpc_push_node(prog, sp, xinitial) < 0)
+                goto done;
+            break;
+        case XPC_CHILD:
+            if (xpc_child(prog, insn->xi_xs, sp) < 0)
+                goto done;
+            break;
+        case XPC_PARENT: /* In place since at most one parent per node */
+            v = &prog->xp_stack[*sp-1];
+            k = 0;
+            for (i=0; i<v->xv_ctx.xc_size; i++){
+                x = v->xv_ctx.xc_nodeset[i];
+                if ((xp = xml_parent(x)) != NULL
+#ifdef XML_PARENT_CANDIDATE
+                    || (xp = xml_parent_candidate(x)) != NULL
+#endif
+                    )
+                    v->xv_ctx.xc_nodeset[k++] = xp;
+            }
+            v->xv_ctx.xc_size = k;
+            break;
+        case XPC_FILTER: /* In place, evaluate predicate for each node with it as context */
+            vi = *sp - 1;
+            k = 0;
+            for (i=0; i<prog->xp_stack[vi].xv_ctx.xc_size; i++){
+                x = prog->xp_stack[vi].xv_ctx.xc_nodeset[i];
+                if (xpc_exec(prog, pc+1, x, i, xinitial, sp) < 0)
+                    goto done;
+                xc1 = &prog->xp_stack[*sp-1].xv_ctx;
+                if (xc1->xc_type == XT_NUMBER)
+                    b = ((int)xc1->xc_number == i);
+                else
+                    b = ctx2boolean(xc1);
+                (*sp)--;
+                if (b)
+                    prog->xp_stack[vi].xv_ctx.xc_nodeset[k++] = x;
+            }
+            prog->xp_stack[vi].xv_ctx.xc_size = k;
+            pc += insn->xi_int;
+            break;
+        case XPC_LOGOP:
+        case XPC_NUMOP:
+        case XPC_RELOP:
+            xc1 = &prog->xp_stack[*sp-2].xv_ctx;
+            xc2 = &prog->xp_stack[*sp-1].xv_ctx;
+            memset(&xr, 0, sizeof(xr));
+            if (insn->xi_op == XPC_LOGOP){
+                if (xp_logop1(xc1, xc2, insn->xi_int, &xr) < 0)
+                    goto done;
+            }
+            else if (insn->xi_op == XPC_NUMOP){
+                if (xp_numop1(xc1, xc2, insn->xi_int, &xr) < 0)
+                    goto done;
+            }
+            else if (xp_relop1(xc1, xc2, insn->xi_int, &xr) < 0)
+                goto done;
+            *sp -= 2;
+            if ((v = xpc_push(prog, sp)) == NULL)
+                goto done;
+            v->xv_ctx.xc_type = xr.xc_type;
+            v->xv_ctx.xc_bool = xr.xc_bool;
+            v->xv_ctx.xc_number = xr.xc_number;
+            break;
+        case XPC_UNION:
+            v = &prog->xp_stack[*sp-2];
+            if (v->xv_ctx.xc_type != XT_NODESET)
+                xpc_value_reset(v);
+            xc2 = &prog->xp_stack[*sp-1].xv_ctx;
+            for (i=0; i<xc2->xc_size; i++)
+                if (xpc_append(v, xc2->xc_nodeset[i]) < 0)
+                    goto done;
+            (*sp)--;
+            break;
+        case XPC_COUNT:
+            v = &prog->xp_stack[*sp-1];
+            i = v->xv_ctx.xc_size;
+            xpc_value_reset(v);
+            v->xv_ctx.xc_type = XT_NUMBER;
+            v->xv_ctx.xc_number = i;
+            break;
+        case XPC_BOOLEAN:
+        case XPC_NOT:
+            v = &prog->xp_stack[*sp-1];
+            b = ctx2boolean(&v->xv_ctx);
+            xpc_value_reset(v);
+            v->xv_ctx.xc_type = XT_BOOL;
+            v->xv_ctx.xc_bool = (insn->xi_op == XPC_NOT) ? !b : b;
+            break;
+        case XPC_BOOL:
+            if ((v = xpc_push(prog, sp)) == NULL)
+                goto done;
+            v->xv_ctx.xc_type = XT_BOOL;
+            v->xv_ctx.xc_bool = insn->xi_int;
+            break;
+        case XPC_TREE:
+            if (xpc_tree(prog, insn->xi_xs, xnode, position, xinitial, sp) < 0)
+                goto done;
+            break;
+        case XPC_RETURN:
+            goto ok;
+            break;
+        }
+    }
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Evaluate a compiled XPath program as boolean
+ *
+ * Same result as xpath_vec_bool on the original xpath string
+ * @param[in]  prog   XPath program
+ * @param[in]  xcur   Context and initial node
+ * @retval     1      True
+ * @retval     0      False
+ * @retval    -1      Error
+ * @see xpath_vec_bool
+ */
+int
+xpath_prog_bool(xpath_prog *prog,
+                cxobj      *xcur)
+{
+    int retval = -1;
+    int sp = 0;
+    int i;
+
+    if (xpc_exec(prog, 0, xcur, 0, xcur, &sp) < 0)
+        goto done;
+    if (sp != 1){
+        clicon_err(OE_XML, EFAULT, "Internal error: stack size %d after evaluation of %s",
+                   sp, prog->xp_xpath);
+        goto done;
+    }
+    retval = ctx2boolean(&prog->xp_stack[0].xv_ctx);
+ done:
+    /* Free result strings, keep nodeset buffers */
+    for (i=0; i<prog->xp_stackmax; i++)
+        if (prog->xp_stack[i].xv_free)
+            xpc_value_reset(&prog->xp_stack[i]);
+    return retval;
+}
+
+/*! Evaluate the xpath of a yang must or when statement as boolean
+ *
+ * The xpath is compiled at first call and cached in the yang statement
+ * @param[in]  ys     Yang must or when statement, or node with when xpath from augment/uses
+ * @param[in]  xcur   XML context node
+ * @retval     1      True
+ * @retval     0      False
+ * @retval    -1      Error
+ * @see yang_when_xpath_get  for when from augment/uses
+ */
+int
+xpath_prog_yang_bool(yang_stmt *ys,
+                     cxobj     *xcur)
+{
+    int         retval = -1;
+    xpath_prog *prog;
+    char       *xpath;
+    cvec       *nsc = NULL;
+    int         nscmalloc = 0;
+
+    if ((prog = yang_xpath_prog_get(ys)) == NULL){
+        switch (yang_keyword_get(ys)){
+        case Y_MUST:
+        case Y_WHEN:
+            xpath = yang_argument_get(ys);
+            if (xml_nsctx_yang(ys, &nsc) < 0)
+                goto done;
+            nscmalloc++;
+            break;
+        default:
+            xpath = yang_when_xpath_get(ys);
+            nsc = yang_when_nsc_get(ys);
+            break;
+        }
+        if (xpath == NULL){
+            clicon_err(OE_YANG, EINVAL, "No xpath in %s", yang_argument_get(ys));
+            goto done;
+        }
+        if (!_xpath_compile){
+            retval = xpath_vec_bool(xcur, nsc, "%s", xpath);
+            goto done;
+        }
+        if (xpath_prog_new(xpath, nsc, &prog) < 0)
+            goto done;
+        if (yang_xpath_prog_set(ys, prog) < 0){
+            xpath_prog_free(prog);
+            goto done;
+        }
+        clicon_debug(CLIXON_DBG_DETAIL, "%s %s: %d instructions", __FUNCTION__,
+                     xpath, prog->xp_len);
+    }
+    retval = xpath_prog_bool(prog, xcur);
+ done:
+    if (nsc && nscmalloc)
+        xml_nsctx_free(nsc);
+    return retval;
+}
@@ -221,7 +221,7 @@ nodetest_eval_node_localonly(cxobj      *x,
  * - node() is true for any node of any type whatsoever.
  * - text() is true for any text node.
  */
-static int
+int
 nodetest_eval(cxobj      *x,
               xpath_tree *xs,
               cvec       *nsc,
@@ -249,7 +249,10 @@ nodetest_eval(cxobj      *x,
     return retval;
 }
 
-/*!
+/*! Find all descendants of an XML node matching a nodetest
+ *
+ * If the nodetest is a name and a descendant node is bound to yang, its subtree is only
+ * searched if the yang schema has a descendant data node with that name.
  * @param[in]  xn
  * @param[in]  nodetest   XPATH stack
  * @param[in]  node_type
@@ -258,6 +261,7 @@ nodetest_eval(cxobj      *x,
  * @param[in]  localonly  Skip prefix and namespace tests (non-standard)
  * @param[out] vec0
  * @param[out] vec0len
+ * @see yang_descendant_maybe
  */
 int
 nodetest_recursive(cxobj      *xn, 
@@ -269,11 +273,20 @@ nodetest_recursive(cxobj      *xn,
                    cxobj    ***vec0,
                    int        *vec0len)
 {
-    int     retval = -1;
-    cxobj  *xsub; 
-    cxobj **vec = *vec0;
-    int     veclen = *vec0len;
+    int        retval = -1;
+    cxobj     *xsub; 
+    cxobj    **vec = *vec0;
+    int        veclen = *vec0len;
+    char      *name = NULL;
+    yang_stmt *y;
+    int        ret;
 
+    /* Only element name tests can be pruned using yang */
+    if (node_type == CX_ELMNT &&
+        nodetest->xs_type == XP_NODE &&
+        nodetest->xs_s1 != NULL &&
+        strcmp(nodetest->xs_s1, "*") != 0)
+        name = nodetest->xs_s1;
     xsub = NULL;
     while ((xsub = xml_child_each(xn, xsub, node_type)) != NULL) {
         if (nodetest_eval(xsub, nodetest, nsc, localonly) == 1){
@@ -283,6 +296,12 @@ nodetest_recursive(cxobj      *xn,
                     goto done;
             //      continue; /* Dont go deeper */
         }
+        if (name != NULL && (y = xml_spec(xsub)) != NULL){
+            if ((ret = yang_descendant_maybe(y, name)) < 0)
+                goto done;
+            if (ret == 0)
+                continue; /* No such name in subtree */
+        }
         if (nodetest_recursive(xsub, nodetest, node_type, flags, nsc, localonly, &vec, &veclen) < 0)
             goto done;
     }
@@ -482,8 +501,9 @@ xp_eval_predicate(xp_ctx     *xc,
     xp_ctx  *xrc = NULL;
     int      i;
     cxobj   *x;
-    xp_ctx  *xcc = NULL;
-    
+    xp_ctx   xcc = {0,};
+    cxobj   *xccvec[1];
+
     if (xs->xs_c0 != NULL){ /* eval previous predicates */
         if (xp_eval(xc, xs->xs_c0, nsc, localonly, &xr0) < 0)   
             goto done;  
@@ -507,24 +527,19 @@ xp_eval_predicate(xp_ctx     *xc,
         xr1->xc_initial = xc->xc_initial;
         for (i=0; i<xr0->xc_size; i++){
             x = xr0->xc_nodeset[i];
-            /* Create new context */
-            if ((xcc = malloc(sizeof(*xcc))) == NULL){
-                clicon_err(OE_XML, errno, "malloc");
-                goto done;
-            }
-            memset(xcc, 0, sizeof(*xcc));
-            xcc->xc_type = XT_NODESET;
-            xcc->xc_initial = xc->xc_initial;
-            xcc->xc_node = x;
-            xcc->xc_position = i;
+            /* Reuse context on stack, evaluation does not change its nodeset size */
+            memset(&xcc, 0, sizeof(xcc));
+            xcc.xc_type = XT_NODESET;
+            xcc.xc_initial = xc->xc_initial;
+            xcc.xc_node = x;
+            xcc.xc_position = i;
             /* For each node in the node-set to be filtered, the PredicateExpr is
              * evaluated with that node as the context node */
-            if (cxvec_append(x, &xcc->xc_nodeset, &xcc->xc_size) < 0)
+            xccvec[0] = x;
+            xcc.xc_nodeset = xccvec;
+            xcc.xc_size = 1;
+            if (xp_eval(&xcc, xs->xs_c1, nsc, localonly, &xrc) < 0)
                 goto done;
-            if (xp_eval(xcc, xs->xs_c1, nsc, localonly, &xrc) < 0)
-                goto done;
-            ctx_free(xcc);
-            xcc = NULL;
             if (xrc->xc_type == XT_NUMBER){
                 /* If the result is a number, the result will be converted to true
                    if the number is equal to the context position */
@@ -557,8 +572,6 @@ xp_eval_predicate(xp_ctx     *xc,
     }
     retval = 0;
  done:
-    if (xcc)
-        ctx_free(xcc);
     if (xr0)
         ctx_free(xr0);
     if (xr1)
@@ -566,32 +579,42 @@ xp_eval_predicate(xp_ctx     *xc,
     return retval;
 }
 
+/*! Allocate a result context of a binary operation
+ */
+static xp_ctx *
+xp_op_result(xp_ctx *xc1)
+{
+    xp_ctx *xr;
+
+    if ((xr = malloc(sizeof(*xr))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        return NULL;
+    }
+    memset(xr, 0, sizeof(*xr));
+    xr->xc_initial = xc1->xc_initial;
+    return xr;
+}
+
 /*! Given two XPATH contexts, eval logical  operations: or,and
  * The logical operators convert their operands to booleans
  * @param[in]  xc1  Context of operand1
  * @param[in]  xc2  Context of operand2
  * @param[in]  op   Relational operator
- * @param[out] xrp  Result context
+ * @param[out] xr   Result context, allocated by caller, nodeset not used
  * @retval     0    OK
  * @retval    -1    Error
+ * @see xp_logop which allocates the result
  */
-static int
-xp_logop(xp_ctx    *xc1,
-         xp_ctx    *xc2,
-         enum xp_op op,
-         xp_ctx   **xrp)
+int
+xp_logop1(xp_ctx    *xc1,
+          xp_ctx    *xc2,
+          enum xp_op op,
+          xp_ctx    *xr)
 {
     int     retval = -1;
-    xp_ctx *xr = NULL;
     int     b1;
     int     b2;
-    
-    if ((xr = malloc(sizeof(*xr))) == NULL){
-        clicon_err(OE_UNIX, errno, "malloc");
-        goto done;
-    }
-    memset(xr, 0, sizeof(*xr));
-    xr->xc_initial = xc1->xc_initial;
+
     xr->xc_type = XT_BOOL;
     if ((b1 = ctx2boolean(xc1)) < 0)
         goto done;
@@ -609,39 +632,50 @@ xp_logop(xp_ctx    *xc1,
                    __FUNCTION__, clicon_int2str(xpopmap,op));
         goto done;
     }
-    *xrp = xr;
     retval = 0;
  done:
     return retval;
 }
 
+static int
+xp_logop(xp_ctx    *xc1,
+         xp_ctx    *xc2,
+         enum xp_op op,
+         xp_ctx   **xrp)
+{
+    xp_ctx *xr;
+
+    if ((xr = xp_op_result(xc1)) == NULL)
+        return -1;
+    if (xp_logop1(xc1, xc2, op, xr) < 0){
+        ctx_free(xr);
+        return -1;
+    }
+    *xrp = xr;
+    return 0;
+}
+
 /*! Given two XPATH contexts, eval numeric operations: +-*,div,mod
  * The numeric operators convert their operands to numbers as if by 
  * calling the number function.
  * @param[in]  xc1  Context of operand1
  * @param[in]  xc2  Context of operand2
  * @param[in]  op   Relational operator
- * @param[out] xrp  Result context
+ * @param[out] xr   Result context, allocated by caller, nodeset not used
  * @retval     0    OK
  * @retval    -1    Error
+ * @see xp_numop which allocates the result
  */
-static int
-xp_numop(xp_ctx    *xc1,
-         xp_ctx    *xc2,
-         enum xp_op op,
-         xp_ctx   **xrp)
+int
+xp_numop1(xp_ctx    *xc1,
+          xp_ctx    *xc2,
+          enum xp_op op,
+          xp_ctx    *xr)
 {
     int     retval = -1;
-    xp_ctx *xr = NULL;
     double  n1;
     double  n2;
-    
-    if ((xr = malloc(sizeof(*xr))) == NULL){
-        clicon_err(OE_UNIX, errno, "malloc");
-        goto done;
-    }
-    memset(xr, 0, sizeof(*xr));
-    xr->xc_initial = xc1->xc_initial;
+
     xr->xc_type = XT_NUMBER;
     if (ctx2number(xc1, &n1) < 0)
         goto done;
@@ -671,12 +705,29 @@ xp_numop(xp_ctx    *xc1,
                        clicon_int2str(xpopmap,op));
             goto done;
         }
-    *xrp = xr;
     retval = 0;
  done:
     return retval;
 }
 
+static int
+xp_numop(xp_ctx    *xc1,
+         xp_ctx    *xc2,
+         enum xp_op op,
+         xp_ctx   **xrp)
+{
+    xp_ctx *xr;
+
+    if ((xr = xp_op_result(xc1)) == NULL)
+        return -1;
+    if (xp_numop1(xc1, xc2, op, xr) < 0){
+        ctx_free(xr);
+        return -1;
+    }
+    *xrp = xr;
+    return 0;
+}
+
 /*! Get xml body value as cligen variable
  * @param[in]  x   XML node (body and leaf/leaf-list)
  * @param[out] cvp Pointer to cligen variable containing value of x body
@@ -764,18 +815,18 @@ xml_cv_cache(cxobj   *x,
  * @param[in]  xc1  Context of operand1
  * @param[in]  xc2  Context of operand2
  * @param[in]  op   Relational operator
- * @param[out] xrp  Result context
+ * @param[out] xr   Result context, allocated by caller, nodeset not used
  * @retval     0    OK
  * @retval    -1    Error
+ * @see xp_relop which allocates the result
  */
-static int
-xp_relop(xp_ctx    *xc1,
-         xp_ctx    *xc2,
-         enum xp_op op,
-         xp_ctx   **xrp)
+int
+xp_relop1(xp_ctx    *xc1,
+          xp_ctx    *xc2,
+          enum xp_op op,
+          xp_ctx    *xr)
 {
     int     retval = -1;
-    xp_ctx *xr = NULL;
     xp_ctx *xc;
     cxobj  *x1;
     cxobj  *x2;
@@ -794,12 +845,6 @@ xp_relop(xp_ctx    *xc1,
         clicon_err(OE_UNIX, EINVAL, "xc1 or xc2 NULL");
         goto done;
     }
-    if ((xr = malloc(sizeof(*xr))) == NULL){
-        clicon_err(OE_UNIX, errno, "malloc");
-        goto done;
-    }
-    memset(xr, 0, sizeof(*xr));
-    xr->xc_initial = xc1->xc_initial;
     xr->xc_type = XT_BOOL;
     if (xc1->xc_type == xc2->xc_type){ /* cases (2-3) above */
         switch (xc1->xc_type){
@@ -1048,15 +1093,33 @@ xp_relop(xp_ctx    *xc1,
     /* Just ensure bool is 0 or 1 */
     if (xr->xc_type == XT_BOOL && xr->xc_bool != 0)
         xr->xc_bool = 1;
-    *xrp = xr;
-    xr = NULL;
     retval = 0;
  done:
-    if (xr)
-        ctx_free(xr);
     return retval;
 }
 
+static int
+xp_relop(xp_ctx    *xc1,
+         xp_ctx    *xc2,
+         enum xp_op op,
+         xp_ctx   **xrp)
+{
+    xp_ctx *xr;
+
+    if (xc1 == NULL){
+        clicon_err(OE_UNIX, EINVAL, "xc1 or xc2 NULL");
+        return -1;
+    }
+    if ((xr = xp_op_result(xc1)) == NULL)
+        return -1;
+    if (xp_relop1(xc1, xc2, op, xr) < 0){
+        ctx_free(xr);
+        return -1;
+    }
+    *xrp = xr;
+    return 0;
+}
+
 /*! Given two XPATH contexts, eval union operation
  * Both operands must be nodesets, otherwise empty nodeset is returned
  * @param[in]  xc1  Context of operand1
@@ -45,6 +45,10 @@ extern const map_str2int xpopmap[];
 /*
  * Prototypes
  */
+int nodetest_eval(cxobj *x, xpath_tree *xs, cvec *nsc, int localonly);
+int xp_logop1(xp_ctx *xc1, xp_ctx *xc2, enum xp_op op, xp_ctx *xr);
+int xp_numop1(xp_ctx *xc1, xp_ctx *xc2, enum xp_op op, xp_ctx *xr);
+int xp_relop1(xp_ctx *xc1, xp_ctx *xc2, enum xp_op op, xp_ctx *xr);
 int xp_eval(xp_ctx *xc, xpath_tree *xs, cvec *nsc, int localonly, xp_ctx **xrp);
 
 #endif /* _CLIXON_XPATH_EVAL_H */
@@ -76,6 +76,10 @@ static xpath_tree *_xm = NULL;
 static xpath_tree *_xe = NULL;
 static int _optimize_enable = 1;
 static int _optimize_hits = 0;
+#ifdef XML_EXPLICIT_INDEX
+static int _auto_index = 0;                      /* Nr of filters before a leaf is indexed */
+static clicon_hash_t *_auto_index_stats = NULL;  /* Nr of filters per list leaf */
+#endif
 #endif /* XPATH_LIST_OPTIMIZE */
 
 /* XXX development in clixon_xpath_eval */
@@ -101,12 +105,34 @@ xpath_list_optimize_set(int enable)
     return 0;
 }
 
+/*! Make non-key list leafs search indexes when used in xpath filters
+ *
+ * Cant replace this with option since there is no handle in xpath functions,...
+ * @param[in]  threshold  Number of filters of type list[leaf='value'] on a non-key leaf before
+ *                        the leaf is used as a search index. 0 disables
+ * @see CLICON_XPATH_AUTO_INDEX
+ */
+int
+xpath_auto_index_set(int threshold)
+{
+#if defined(XPATH_LIST_OPTIMIZE) && defined(XML_EXPLICIT_INDEX)
+    _auto_index = threshold;
+#endif
+    return 0;
+}
+
 void
 xpath_optimize_exit(void)
 {
 #ifdef XPATH_LIST_OPTIMIZE
     if (_xmtop)
         xpath_tree_free(_xmtop);
+#ifdef XML_EXPLICIT_INDEX
+    if (_auto_index_stats){
+        clicon_hash_free(_auto_index_stats);
+        _auto_index_stats = NULL;
+    }
+#endif
 #endif
 }
 
@@ -212,6 +238,61 @@ loop_preds(xpath_tree *xt,
     goto done;
 }
 
+#ifdef XML_EXPLICIT_INDEX
+/*! Check if a list filter on a non-key leaf can use a search index
+ *
+ * Either the leaf is a search index (cc:search_index extension or made so earlier), or
+ * automatic indexes are enabled and the leaf has been used in enough filters.
+ * The search vector itself is built at first search and then maintained as the XML changes.
+ * @param[in]  yc    Yang of list
+ * @param[in]  cvk   Vector of <leaf>:<value> pairs from the filter
+ * @retval     1     Yes, search using index
+ * @retval     0     No
+ * @retval    -1     Error
+ * @see xpath_auto_index_set
+ * @see xml_search_vector_build
+ */
+static int
+xpath_list_index_check(yang_stmt *yc,
+                       cvec      *cvk)
+{
+    int        retval = -1;
+    yang_stmt *yi;
+    char       key[32];
+    int        nr = 0;
+    int       *np;
+
+    if (cvec_len(cvk) != 1)
+        goto ok;
+    if ((yi = yang_find(yc, Y_LEAF, cv_name_get(cvec_i(cvk, 0)))) == NULL)
+        goto ok;
+    if (yang_flag_get(yi, YANG_FLAG_INDEX) == 0){
+        if (_auto_index <= 0)
+            goto ok;
+        if (_auto_index_stats == NULL &&
+            (_auto_index_stats = clicon_hash_init()) == NULL)
+            goto done;
+        snprintf(key, sizeof(key), "%p", yi);
+        if ((np = clicon_hash_value(_auto_index_stats, key, NULL)) != NULL)
+            nr = *np;
+        nr++;
+        if (clicon_hash_add(_auto_index_stats, key, &nr, sizeof(nr)) == NULL)
+            goto done;
+        if (nr < _auto_index)
+            goto ok;
+        clicon_debug(1, "%s %s/%s used as search index", __FUNCTION__,
+                     yang_argument_get(yc), yang_argument_get(yi));
+        yang_flag_set(yi, YANG_FLAG_INDEX);
+    }
+    retval = 1;
+ done:
+    return retval;
+ ok:
+    retval = 0;
+    goto done;
+}
+#endif /* XML_EXPLICIT_INDEX */
+
 /*! Pattern matching to find fastpath
  *
  * @param[in]  xt     XPath tree
@@ -225,6 +306,7 @@ loop_preds(xpath_tree *xt,
  * @retval     1      Match
  *  XPath:
  *  y[k=3] # corresponds to: <name>[<keyname>=<keyval>]
+ *  y[i=3] # where i is not a key but a search index, see xpath_list_index_check
  */
 static int
 xpath_list_optimize_fn(xpath_tree  *xt,
@@ -246,6 +328,7 @@ xpath_list_optimize_fn(xpath_tree  *xt,
     cg_var      *cvi;
     int          i;
     yang_stmt   *ypp;
+    int          iskey;
     
     /* revert to non-optimized if no yang */
     if ((yp = xml_spec(xv)) == NULL)
@@ -291,16 +374,24 @@ xpath_list_optimize_fn(xpath_tree  *xt,
         goto done;
     if (ret == 0)
         goto ok;
-
-    if (cvec_len(cvv) != cvec_len(cvk))
-        goto ok;
+    iskey = (cvec_len(cvv) == cvec_len(cvk));
     i = 0;
     cvi = NULL;
-    while ((cvi = cvec_each(cvk, cvi)) != NULL) {
+    while (iskey && (cvi = cvec_each(cvk, cvi)) != NULL) {
         if (strcmp(cv_name_get(cvi), cv_string_get(cvec_i(cvv,i))))
-            goto ok;
+            iskey = 0;
         i++;
     }
+    if (!iskey){
+#ifdef XML_EXPLICIT_INDEX
+        if ((ret = xpath_list_index_check(yc, cvk)) < 0)
+            goto done;
+        if (ret == 0)
+            goto ok;
+#else
+        goto ok;
+#endif
+    }
     /* Use 2a form since yc allready given to compute cvk */
     if (clixon_xml_find_index(xv, yp, NULL, name, cvk, xvec) < 0)
         goto done;
@@ -75,6 +75,7 @@
 #include "clixon_hash.h"
 #include "clixon_xml.h"
 #include "clixon_xml_nsctx.h"
+#include "clixon_xpath_compile.h"
 #include "clixon_yang_module.h"
 #include "clixon_plugin.h"
 #include "clixon_data.h"
@@ -91,6 +92,9 @@
 static int yang_search_index_extension(clicon_handle h, yang_stmt *yext, yang_stmt *ys);
 #endif
 
+/* Size in 64-bit words of descendant name bloom filter, see yang_descendant_maybe */
+#define YANG_DESCBLOOM_WORDS 4
+
 /*
  * Local variables
  */
@@ -452,6 +456,36 @@ yang_when_nsc_set(yang_stmt *ys,
     return retval;
 }
 
+/*! Get compiled xpath of a must or when statement
+ *
+ * For other nodes, the compiled xpath of a "when"-associated augment/uses
+ * @param[in]  ys     Yang statement
+ * @retval     prog   Compiled xpath
+ * @retval     NULL   Not compiled
+ * @see xpath_prog_yang_bool
+ */
+struct xpath_prog *
+yang_xpath_prog_get(yang_stmt *ys)
+{
+    return ys->ys_xpath_prog;
+}
+
+/*! Set compiled xpath of a must or when statement, free previous
+ *
+ * @param[in]  ys     Yang statement
+ * @param[in]  prog   Compiled xpath, consumed
+ * @retval     0      OK
+ */
+int
+yang_xpath_prog_set(yang_stmt         *ys,
+                    struct xpath_prog *prog)
+{
+    if (ys->ys_xpath_prog)
+        xpath_prog_free(ys->ys_xpath_prog);
+    ys->ys_xpath_prog = prog;
+    return 0;
+}
+
 /*! Get yang filename for error/debug purpose
  *
  * @param[in]  ys       Yang statement
@@ -683,6 +717,10 @@ ys_free1(yang_stmt *ys,
         free(ys->ys_when_xpath);
     if (ys->ys_when_nsc)
         cvec_free(ys->ys_when_nsc);
+    if (ys->ys_xpath_prog)
+        xpath_prog_free(ys->ys_xpath_prog);
+    if (ys->ys_descbloom)
+        free(ys->ys_descbloom);
     if (ys->ys_stmt)
         free(ys->ys_stmt);
     if (ys->ys_filename)
@@ -802,6 +840,27 @@ ys_free(yang_stmt *ys)
     return 0;
 }
 
+/*! Reset descendant name bloom filters of a yang node and its ancestors
+ *
+ * Called when a child is added, eg an anydata for an unknown XML node.
+ * A computed bloom filter implies computed filters in all its descendants, so stop at the
+ * first ancestor without one
+ * @param[in]  ys   Yang node
+ * @see yang_descendant_maybe
+ */
+static void
+yang_descbloom_reset(yang_stmt *ys)
+{
+    while (ys != NULL && yang_flag_get(ys, YANG_FLAG_DESC_CACHE)){
+        if (ys->ys_descbloom){
+            free(ys->ys_descbloom);
+            ys->ys_descbloom = NULL;
+        }
+        yang_flag_reset(ys, YANG_FLAG_DESC_CACHE);
+        ys = ys->ys_parent;
+    }
+}
+
 /*! Allocate larger yang statement vector adding empty field last */
 static int 
 yn_realloc(yang_stmt *yn)
@@ -839,8 +898,11 @@ ys_cp(yang_stmt *ynew,
     cg_var    *cvn;
     cg_var    *cvo;
 
-    memcpy(ynew, yold, sizeof(*yold)); 
+    memcpy(ynew, yold, sizeof(*yold));
     ynew->ys_parent = NULL;
+    ynew->ys_xpath_prog = NULL;
+    ynew->ys_descbloom = NULL;
+    ynew->ys_flags &= ~YANG_FLAG_DESC_CACHE;
     if (yold->ys_stmt)
         if ((ynew->ys_stmt = calloc(yold->ys_len, sizeof(yang_stmt *))) == NULL){
             clicon_err(OE_YANG, errno, "calloc");
@@ -955,6 +1017,7 @@ ys_replace(yang_stmt *yorig,
     if (ys_cp(yorig, yfrom) < 0)
         goto done;
     yorig->ys_parent = yp;
+    yang_descbloom_reset(yp);
     retval = 0;
  done:
     return retval;
@@ -979,6 +1042,7 @@ yn_insert(yang_stmt *ys_parent,
         return -1;
     ys_parent->ys_stmt[pos] = ys_child;
     ys_child->ys_parent = ys_parent;
+    yang_descbloom_reset(ys_parent);
     return 0;
 }
 
@@ -993,6 +1057,7 @@ yn_insert1(yang_stmt *ys_parent,
     if (yn_realloc(ys_parent) < 0)
         return -1;
     ys_parent->ys_stmt[pos] = ys_child;
+    yang_descbloom_reset(ys_parent);
     return 0;
 }
 
@@ -1267,6 +1332,151 @@ yang_find_schemanode(yang_stmt *yn,
     return ysmatch;
 }
 
+/*! Hash of a data node name in a descendant bloom filter
+ *
+ * FNV-1a, the two low bytes select the two bits set per name
+ */
+static uint32_t
+yang_descbloom_hash(char *name)
+{
+    uint32_t h = 2166136261U;
+
+    while (*name)
+        h = (h ^ (uint8_t)*name++) * 16777619U;
+    return h;
+}
+
+/*! Set a bit in a descendant bloom filter, allocate if not already done
+ */
+static int
+yang_descbloom_add(yang_stmt *ys,
+                   uint32_t   bit)
+{
+    bit %= YANG_DESCBLOOM_WORDS*64;
+    if (ys->ys_descbloom == NULL &&
+        (ys->ys_descbloom = calloc(YANG_DESCBLOOM_WORDS, sizeof(uint64_t))) == NULL){
+        clicon_err(OE_YANG, errno, "calloc");
+        return -1;
+    }
+    ys->ys_descbloom[bit/64] |= ((uint64_t)1 << (bit%64));
+    return 0;
+}
+
+/*! Compute descendant name bloom filter of a yang node and all its schema node descendants
+ *
+ * The names of all data nodes (and rpc/action/notification) below ys are added.
+ * Choice, case, input and output are transparent as in XML. Anydata, anyxml and schema
+ * mount-points may have any descendant and have all bits set.
+ * @param[in]  ys   Yang node
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+static int
+yang_descbloom_compute(yang_stmt *ys)
+{
+    int            retval = -1;
+    yang_stmt     *yc;
+    enum rfc_6020  keyw;
+    uint32_t       h;
+    int            i;
+    int            ret;
+
+    if (yang_flag_get(ys, YANG_FLAG_DESC_CACHE))
+        goto ok;
+    keyw = yang_keyword_get(ys);
+    if (keyw == Y_CONTAINER || keyw == Y_LIST){
+        if ((ret = yang_schema_mount_point(ys)) < 0)
+            goto done;
+        if (ret == 1)
+            keyw = Y_ANYDATA;
+    }
+    if (keyw == Y_ANYDATA || keyw == Y_ANYXML){
+        for (i=0; i<YANG_DESCBLOOM_WORDS*64; i++)
+            if (yang_descbloom_add(ys, i) < 0)
+                goto done;
+    }
+    else {
+        yc = NULL;
+        while ((yc = yn_each(ys, yc)) != NULL){
+            if (!yang_schemanode(yc))
+                continue;
+            if (yang_descbloom_compute(yc) < 0)
+                goto done;
+            keyw = yang_keyword_get(yc);
+            if (keyw != Y_CHOICE && keyw != Y_CASE && keyw != Y_INPUT && keyw != Y_OUTPUT &&
+                yc->ys_argument != NULL){
+                h = yang_descbloom_hash(yc->ys_argument);
+                if (yang_descbloom_add(ys, h) < 0 ||
+                    yang_descbloom_add(ys, h >> 8) < 0)
+                    goto done;
+            }
+            if (yc->ys_descbloom){
+                if (ys->ys_descbloom == NULL &&
+                    (ys->ys_descbloom = calloc(YANG_DESCBLOOM_WORDS, sizeof(uint64_t))) == NULL){
+                    clicon_err(OE_YANG, errno, "calloc");
+                    goto done;
+                }
+                for (i=0; i<YANG_DESCBLOOM_WORDS; i++)
+                    ys->ys_descbloom[i] |= yc->ys_descbloom[i];
+            }
+        }
+    }
+    yang_flag_set(ys, YANG_FLAG_DESC_CACHE);
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Check if a data node with a name may exist as a descendant of a yang node
+ *
+ * Uses a bloom filter of the names of all data nodes in the subtree, computed at first
+ * call. Used to prune descendant (//) xpath searches in bound XML trees.
+ * @param[in]  ys    Yang node, eg spec of an XML node
+ * @param[in]  name  Name of descendant data node
+ * @retval     1     A descendant may have this name
+ * @retval     0     No descendant has this name
+ * @retval    -1     Error
+ * @code
+ *   if ((ret = yang_descendant_maybe(xml_spec(x), "name")) < 0)
+ *      err;
+ *   if (ret == 0)
+ *      skip x subtree
+ * @endcode
+ */
+int
+yang_descendant_maybe(yang_stmt *ys,
+                      char      *name)
+{
+    int      retval = -1;
+    uint32_t h;
+    uint32_t b0;
+    uint32_t b1;
+
+    switch (yang_keyword_get(ys)){
+    case Y_SPEC:
+    case Y_MODULE:
+    case Y_SUBMODULE:
+        retval = 1; /* Not a data node, eg top-level symbol */
+        goto done;
+    default:
+        break;
+    }
+    if (yang_descbloom_compute(ys) < 0)
+        goto done;
+    if (ys->ys_descbloom == NULL){
+        retval = 0;
+        goto done;
+    }
+    h = yang_descbloom_hash(name);
+    b0 = h % (YANG_DESCBLOOM_WORDS*64);
+    b1 = (h >> 8) % (YANG_DESCBLOOM_WORDS*64);
+    retval = (ys->ys_descbloom[b0/64] & ((uint64_t)1 << (b0%64))) &&
+        (ys->ys_descbloom[b1/64] & ((uint64_t)1 << (b1%64)));
+ done:
+    return retval;
+}
+
 /*! Given a yang statement, or module itself, find the prefix associated to this module
  *
  * @param[in]  ys        Yang statement in module tree (or module itself)
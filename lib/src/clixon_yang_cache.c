@@ -0,0 +1,1284 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * Cache of post-processed YANG specification
+ *
+ * The complete yang spec of a daemon, after parsing and post-processing (features,
+ * types, groupings, augments, deviations etc), is written to a cache file the first time
+ * it is loaded. Subsequent starts map the file and rebuild the yang tree without parsing.
+ * The cache is valid only if the cache key and the content of all (sub)module files
+ * match, otherwise the modules are parsed and the cache is rewritten.
+ * The cache key consists of clixon version, daemon name, all config options including
+ * features and yang dirs, and timestamps of yang dirs and loaded plugins, and the paths
+ * of yang files found recursively in yang dirs.
+ *
+ * File layout, all integers are uint32_t in host byte order:
+ *   header      struct ycache_hdr
+ *   stroff      [yh_nstr]            Offset of each string in the string blob
+ *   stmts       [yh_nstmt * 12]      Yang statements in pre-order, the first is the yspec
+ *   cvs         [yh_ncv * 5]         Cligen variables: type, name, value, aux, flags
+ *   cvecs       [yh_ncvec * 3]       Cligen vectors: name, first cv, nr of cvs
+ *   types       [yh_ntype * 5]       Type caches: options, cvv, patterns, fraction, resolved
+ *   strings     [yh_strlen]          String blob of null-terminated strings
+ * String 0 is the cache key, followed by filename and content hash of each (sub)module.
+ * References to statements (mymodule, resolved type, void cvs) are statement indexes.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <syslog.h>
+#include <sys/types.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <dirent.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clixon */
+#include "clixon_err.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_log.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_options.h"
+#include "clixon_data.h"
+#include "clixon_yang_module.h"
+#include "clixon_plugin.h"
+#include "clixon_file.h"
+#include "clixon_yang_cache.h"
+
+#include "clixon_yang_internal.h" /* internal included by this file only, not API*/
+
+/*
+ * Constants
+ */
+#define YCACHE_MAGIC   "CLXNYNG"     /* Including null: 8 bytes */
+#define YCACHE_VERSION 1
+#define YCACHE_NONE    0xffffffff    /* No string, statement, cv or cvec */
+#define YCACHE_STMT_W  12            /* Nr of uint32 in a statement entry */
+#define YCACHE_CV_W    5             /* Nr of uint32 in a cv entry */
+#define YCACHE_CVEC_W  3             /* Nr of uint32 in a cvec entry */
+#define YCACHE_TYPE_W  5             /* Nr of uint32 in a type cache entry */
+
+/* Dynamic yang flags not written to cache */
+#ifdef USE_CONFIG_FLAG_CACHE
+#define YCACHE_FLAG_DYNAMIC (YANG_FLAG_MARK|YANG_FLAG_TMP|YANG_FLAG_CACHE_LOADED|YANG_FLAG_DESC_CACHE|YANG_FLAG_CONFIG_CACHE|YANG_FLAG_CONFIG_VALUE)
+#else
+#define YCACHE_FLAG_DYNAMIC (YANG_FLAG_MARK|YANG_FLAG_TMP|YANG_FLAG_CACHE_LOADED|YANG_FLAG_DESC_CACHE)
+#endif
+
+/*
+ * Types
+ */
+/* File header */
+struct ycache_hdr {
+    char     yh_magic[8];
+    uint32_t yh_version;
+    uint32_t yh_nfile;    /* Nr of (sub)module files, strings 1..2*nfile */
+    uint32_t yh_nstr;     /* Nr of strings */
+    uint32_t yh_nstmt;    /* Nr of yang statements including yspec */
+    uint32_t yh_ncv;      /* Nr of cvs */
+    uint32_t yh_ncvec;    /* Nr of cvecs */
+    uint32_t yh_ntype;    /* Nr of type caches */
+    uint32_t yh_strlen;   /* Length of string blob */
+};
+
+/* Growable uint32 vector used when writing */
+typedef struct {
+    uint32_t *uv_vec;
+    size_t    uv_len;
+    size_t    uv_max;
+} ycache_vec;
+
+/* Yang statement pointer to index, sorted on pointer */
+typedef struct {
+    yang_stmt *yp_ys;
+    uint32_t   yp_i;
+} ycache_ptr;
+
+/* Writer state */
+typedef struct {
+    cbuf       *yw_str;      /* String blob */
+    ycache_vec  yw_stroff;   /* String offsets */
+    ycache_ptr *yw_ptr;      /* Statement pointers, sorted */
+    uint32_t    yw_nptr;
+    ycache_vec  yw_stmt;
+    ycache_vec  yw_cv;
+    ycache_vec  yw_cvec;
+    ycache_vec  yw_type;
+} ycache_writer;
+
+/* Reader state */
+typedef struct {
+    char        *yr_strings;  /* String blob */
+    uint32_t    *yr_stroff;
+    uint32_t     yr_nstr;
+    uint32_t    *yr_stmt;
+    uint32_t     yr_nstmt;
+    uint32_t     yr_i;        /* Next statement */
+    yang_stmt  **yr_yvec;     /* Created statements, index 0 is the yspec */
+    uint32_t    *yr_cv;
+    uint32_t     yr_ncv;
+    uint32_t    *yr_cvec;
+    uint32_t     yr_ncvec;
+    uint32_t    *yr_type;
+    uint32_t     yr_ntype;
+} ycache_reader;
+
+/*------------------------------------------------------------------------
+ * Cache key
+ *------------------------------------------------------------------------*/
+
+static int
+ycache_strcmp(const void *a,
+              const void *b)
+{
+    return strcmp(*(char**)a, *(char**)b);
+}
+
+/*! Get modification time of file or directory, or 0 if not found
+ */
+static long
+ycache_mtime(const char *path)
+{
+    struct stat st;
+
+    if (path == NULL || stat(path, &st) < 0)
+        return 0;
+    return (long)st.st_mtime;
+}
+
+/*! Add yang files of a CLICON_YANG_DIR to cache key
+ *
+ * The dir is searched recursively as when loading modules. A hash of the sorted paths of
+ * all yang files detects files added or removed in any subdirectory, such as a new revision
+ * of an imported module.
+ * @param[in]  dir   Yang dir
+ * @param[out] cb    Cache key
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+ycache_key_dir(const char *dir,
+               cbuf       *cb)
+{
+    int        retval = -1;
+    cvec      *cvv = NULL;
+    cg_var    *cv;
+    char     **paths = NULL;
+    int        n = 0;
+    int        i;
+    char      *p;
+    uint64_t   hash = 0xcbf29ce484222325ULL;
+
+    if ((cvv = cvec_new(0)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_new");
+        goto done;
+    }
+    if (clicon_files_recursive(dir, "(.yang)$", cvv) < 0)
+        goto done;
+    if (cvec_len(cvv) &&
+        (paths = calloc(cvec_len(cvv), sizeof(char*))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    cv = NULL;
+    while ((cv = cvec_each(cvv, cv)) != NULL)
+        paths[n++] = cv_string_get(cv);
+    if (n)
+        qsort(paths, n, sizeof(char*), ycache_strcmp);
+    for (i = 0; i < n; i++)
+        for (p = paths[i]; ; p++){ /* FNV-1a including null character */
+            hash ^= (uint8_t)*p;
+            hash *= 0x100000001b3ULL;
+            if (*p == '\0')
+                break;
+        }
+    cprintf(cb, "CLICON_YANG_DIR=%s %ld %d %016" PRIx64 "\n", dir, ycache_mtime(dir), n, hash);
+    retval = 0;
+ done:
+    if (paths)
+        free(paths);
+    if (cvv)
+        cvec_free(cvv);
+    return retval;
+}
+
+/*! Compute cache key of daemon
+ *
+ * All options, features and yang dirs determine which modules are loaded and how.
+ * Dir timestamps and the yang files of yang dirs detect added or removed yang files, and
+ * plugin timestamps detect changed extension callbacks. The content of loaded yang files
+ * is checked separately.
+ * @param[in]  h     Clicon handle
+ * @param[in]  name  Daemon name
+ * @param[out] cb    Cache key
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+ycache_key(clicon_handle h,
+           const char   *name,
+           cbuf         *cb)
+{
+    int              retval = -1;
+    clicon_hash_t   *copt = clicon_options(h);
+    char           **keys = NULL;
+    size_t           klen;
+    size_t           vlen;
+    char            *val;
+    int              i;
+    cxobj           *x;
+    clixon_plugin_t *cp;
+
+    cprintf(cb, "%s %s\n", CLIXON_VERSION_STRING, name);
+    if (clicon_hash_keys(copt, &keys, &klen) < 0)
+        goto done;
+    if (klen)
+        qsort(keys, klen, sizeof(char*), ycache_strcmp);
+    for (i = 0; i < klen; i++) {
+        val = clicon_hash_value(copt, keys[i], &vlen);
+        if (vlen && val[vlen-1] == '\0') /* assume string */
+            cprintf(cb, "%s=%s\n", keys[i], val);
+    }
+    x = NULL;
+    while ((x = xml_child_each(clicon_conf_xml(h), x, CX_ELMNT)) != NULL) {
+        if (strcmp(xml_name(x), "CLICON_FEATURE") == 0)
+            cprintf(cb, "%s=%s\n", xml_name(x), xml_body(x));
+        else if (strcmp(xml_name(x), "CLICON_YANG_DIR") == 0 && xml_body(x) != NULL){
+            if (ycache_key_dir(xml_body(x), cb) < 0)
+                goto done;
+        }
+    }
+    cprintf(cb, "mtime=%ld\n", ycache_mtime(clicon_yang_main_dir(h)));
+    cp = NULL;
+    while ((cp = clixon_plugin_each(h, cp)) != NULL)
+        cprintf(cb, "plugin=%s %ld\n", clixon_plugin_name_get(cp),
+                ycache_mtime(clixon_plugin_name_get(cp)));
+    retval = 0;
+ done:
+    if (keys)
+        free(keys);
+    return retval;
+}
+
+/*! Compute FNV-1a hash of file content
+ *
+ * @param[in]  filename  File
+ * @param[out] hash      Hash value
+ * @retval     1         OK
+ * @retval     0         File not readable
+ */
+static int
+ycache_file_hash(const char *filename,
+                 uint64_t   *hash)
+{
+    FILE    *f;
+    char     buf[4096];
+    size_t   n;
+    size_t   i;
+    uint64_t h = 0xcbf29ce484222325ULL;
+
+    if ((f = fopen(filename, "r")) == NULL)
+        return 0;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        for (i=0; i<n; i++){
+            h ^= (uint8_t)buf[i];
+            h *= 0x100000001b3ULL;
+        }
+    fclose(f);
+    *hash = h;
+    return 1;
+}
+
+/*------------------------------------------------------------------------
+ * Write
+ *------------------------------------------------------------------------*/
+
+/*! Append values to uint32 vector
+ */
+static int
+ycache_vec_add(ycache_vec *uv,
+               uint32_t   *v,
+               size_t      n)
+{
+    size_t i;
+
+    if (uv->uv_len + n > uv->uv_max){
+        uv->uv_max = uv->uv_max ? 2*uv->uv_max : 1024;
+        while (uv->uv_len + n > uv->uv_max)
+            uv->uv_max *= 2;
+        if ((uv->uv_vec = realloc(uv->uv_vec, uv->uv_max*sizeof(uint32_t))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            return -1;
+        }
+    }
+    for (i=0; i<n; i++)
+        uv->uv_vec[uv->uv_len++] = v[i];
+    return 0;
+}
+
+/*! Append string to string table and return its index
+ *
+ * @param[in]  yw     Writer state
+ * @param[in]  str    String, or NULL
+ * @param[out] sid    String index, or YCACHE_NONE if str is NULL
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+ycache_str(ycache_writer *yw,
+           const char    *str,
+           uint32_t      *sid)
+{
+    uint32_t off;
+
+    if (str == NULL){
+        *sid = YCACHE_NONE;
+        return 0;
+    }
+    *sid = yw->yw_stroff.uv_len;
+    off = cbuf_len(yw->yw_str);
+    if (ycache_vec_add(&yw->yw_stroff, &off, 1) < 0)
+        return -1;
+    if (cbuf_append_buf(yw->yw_str, (void*)str, strlen(str)+1) < 0){
+        clicon_err(OE_UNIX, errno, "cbuf_append_buf");
+        return -1;
+    }
+    return 0;
+}
+
+static int
+ycache_ptrcmp(const void *a,
+              const void *b)
+{
+    yang_stmt *ya = ((ycache_ptr*)a)->yp_ys;
+    yang_stmt *yb = ((ycache_ptr*)b)->yp_ys;
+
+    return ya < yb ? -1 : ya > yb ? 1 : 0;
+}
+
+/*! Add statement and its descendants to pointer vector in pre-order
+ */
+static void
+ycache_ptr_add(ycache_writer *yw,
+               yang_stmt     *ys)
+{
+    int i;
+
+    if (yw->yw_ptr){
+        yw->yw_ptr[yw->yw_nptr].yp_ys = ys;
+        yw->yw_ptr[yw->yw_nptr].yp_i = yw->yw_nptr;
+    }
+    yw->yw_nptr++;
+    for (i=0; i<ys->ys_len; i++)
+        if (ys->ys_stmt[i])
+            ycache_ptr_add(yw, ys->ys_stmt[i]);
+}
+
+/*! Translate statement pointer to statement index
+ *
+ * @param[in]  yw     Writer state
+ * @param[in]  ys     Yang statement, or NULL
+ * @param[out] id     Statement index, or YCACHE_NONE if ys is NULL
+ * @retval     1      OK
+ * @retval     0      Statement is not in yang spec
+ */
+static int
+ycache_ptr2id(ycache_writer *yw,
+              yang_stmt     *ys,
+              uint32_t      *id)
+{
+    ycache_ptr  key = {ys, 0};
+    ycache_ptr *yp;
+
+    if (ys == NULL){
+        *id = YCACHE_NONE;
+        return 1;
+    }
+    if ((yp = bsearch(&key, yw->yw_ptr, yw->yw_nptr, sizeof(*yp), ycache_ptrcmp)) == NULL)
+        return 0;
+    *id = yp->yp_i;
+    return 1;
+}
+
+/*! Add cv to cv table
+ *
+ * Void cvs must point to statements, other non-string values are stored as strings.
+ * @param[in]  yw     Writer state
+ * @param[in]  cv     Cligen variable
+ * @retval     1      OK
+ * @retval     0      Cv cannot be cached
+ * @retval    -1      Error
+ */
+static int
+ycache_cv(ycache_writer *yw,
+          cg_var        *cv)
+{
+    int      retval = -1;
+    uint32_t v[YCACHE_CV_W];
+    char    *str = NULL;
+
+    v[0] = cv_type_get(cv);
+    if (ycache_str(yw, cv_name_get(cv), &v[1]) < 0)
+        goto done;
+    v[2] = v[3] = YCACHE_NONE;
+    if (v[0] == CGV_VOID){
+        if (ycache_ptr2id(yw, cv_void_get(cv), &v[3]) == 0)
+            goto fail;
+    }
+    else if (cv_isstring(v[0])){
+        if (ycache_str(yw, cv_string_get(cv), &v[2]) < 0)
+            goto done;
+    }
+    else {
+        if (v[0] == CGV_DEC64)
+            v[3] = cv_dec64_n_get(cv);
+        if ((str = cv2str_dup(cv)) == NULL){
+            clicon_err(OE_UNIX, errno, "cv2str_dup");
+            goto done;
+        }
+        if (ycache_str(yw, str, &v[2]) < 0)
+            goto done;
+    }
+    v[4] = cv_flag(cv, 0xff);
+    if (ycache_vec_add(&yw->yw_cv, v, YCACHE_CV_W) < 0)
+        goto done;
+    retval = 1;
+ done:
+    if (str)
+        free(str);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Add single cv or cvec to cv and cvec tables
+ *
+ * @param[in]  yw     Writer state
+ * @param[in]  cv     Single cv (as one-element vector), or NULL
+ * @param[in]  cvv    Cligen vector, or NULL
+ * @param[out] id     Index in cv table if cv, cvec table if cvv, or YCACHE_NONE
+ * @retval     1      OK
+ * @retval     0      Cannot be cached
+ * @retval    -1      Error
+ */
+static int
+ycache_cvec(ycache_writer *yw,
+            cg_var        *cv,
+            cvec          *cvv,
+            uint32_t      *id)
+{
+    int      ret;
+    uint32_t v[YCACHE_CVEC_W];
+
+    *id = YCACHE_NONE;
+    if (cv){
+        *id = yw->yw_cv.uv_len / YCACHE_CV_W;
+        return ycache_cv(yw, cv);
+    }
+    if (cvv == NULL)
+        return 1;
+    if (ycache_str(yw, cvec_name_get(cvv), &v[0]) < 0)
+        return -1;
+    v[1] = yw->yw_cv.uv_len / YCACHE_CV_W;
+    v[2] = cvec_len(cvv);
+    cv = NULL;
+    while ((cv = cvec_each(cvv, cv)) != NULL)
+        if ((ret = ycache_cv(yw, cv)) < 1)
+            return ret;
+    *id = yw->yw_cvec.uv_len / YCACHE_CVEC_W;
+    if (ycache_vec_add(&yw->yw_cvec, v, YCACHE_CVEC_W) < 0)
+        return -1;
+    return 1;
+}
+
+/*! Add yang statement and its descendants in pre-order
+ *
+ * @param[in]  yw     Writer state
+ * @param[in]  ys     Yang statement
+ * @retval     1      OK
+ * @retval     0      Statement cannot be cached, eg has references outside the yang spec
+ * @retval    -1      Error
+ */
+static int
+ycache_stmt(ycache_writer *yw,
+            yang_stmt     *ys)
+{
+    int              ret;
+    uint32_t         v[YCACHE_STMT_W];
+    uint32_t         t[YCACHE_TYPE_W];
+    yang_type_cache *yc;
+    int              i;
+
+    v[0] = ys->ys_keyword;
+    if (ycache_str(yw, ys->ys_argument, &v[1]) < 0)
+        return -1;
+    v[2] = ys->ys_flags & ~YCACHE_FLAG_DYNAMIC;
+    v[3] = 0;
+    for (i=0; i<ys->ys_len; i++)
+        if (ys->ys_stmt[i]){
+            if (ys->ys_stmt[i]->ys_parent != ys)
+                return 0;
+            v[3]++;
+        }
+    if (ycache_ptr2id(yw, ys->ys_mymodule, &v[4]) == 0)
+        return 0;
+    if (ycache_str(yw, ys->ys_filename, &v[5]) < 0)
+        return -1;
+    v[6] = ys->ys_linenum;
+    if ((ret = ycache_cvec(yw, ys->ys_cv, NULL, &v[7])) < 1)
+        return ret;
+    if ((ret = ycache_cvec(yw, NULL, ys->ys_cvec, &v[8])) < 1)
+        return ret;
+    v[9] = YCACHE_NONE;
+    if ((yc = ys->ys_typecache) != NULL){
+        t[0] = yc->yc_options;
+        if ((ret = ycache_cvec(yw, NULL, yc->yc_cvv, &t[1])) < 1)
+            return ret;
+        if ((ret = ycache_cvec(yw, NULL, yc->yc_patterns, &t[2])) < 1)
+            return ret;
+        t[3] = yc->yc_fraction;
+        if (ycache_ptr2id(yw, yc->yc_resolved, &t[4]) == 0)
+            return 0;
+        v[9] = yw->yw_type.uv_len / YCACHE_TYPE_W;
+        if (ycache_vec_add(&yw->yw_type, t, YCACHE_TYPE_W) < 0)
+            return -1;
+    }
+    if (ycache_str(yw, ys->ys_when_xpath, &v[10]) < 0)
+        return -1;
+    if ((ret = ycache_cvec(yw, NULL, ys->ys_when_nsc, &v[11])) < 1)
+        return ret;
+    if (ycache_vec_add(&yw->yw_stmt, v, YCACHE_STMT_W) < 0)
+        return -1;
+    for (i=0; i<ys->ys_len; i++)
+        if (ys->ys_stmt[i] &&
+            (ret = ycache_stmt(yw, ys->ys_stmt[i])) < 1)
+            return ret;
+    return 1;
+}
+
+/*! Write yang spec to cache file
+ *
+ * The file is written to a temporary file which is then renamed, so that concurrently
+ * starting daemons never see a partial file.
+ * @param[in]  yspec  Yang spec
+ * @param[in]  key    Cache key
+ * @param[in]  path   Cache file
+ * @retval     1      OK
+ * @retval     0      Yang spec cannot be cached
+ * @retval    -1      Error
+ */
+static int
+ycache_write(yang_stmt  *yspec,
+             const char *key,
+             const char *path)
+{
+    int               retval = -1;
+    ycache_writer     yw = {0,};
+    struct ycache_hdr yh = {0,};
+    yang_stmt        *ym;
+    uint64_t          hash;
+    char              hstr[32];
+    uint32_t          sid;
+    cbuf             *cbtmp = NULL;
+    FILE             *f = NULL;
+    int               ret;
+
+    if ((yw.yw_str = cbuf_new()) == NULL ||
+        (cbtmp = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (ycache_str(&yw, key, &sid) < 0)
+        goto done;
+    /* (Sub)module files and content hashes */
+    ym = NULL;
+    while ((ym = yn_each(yspec, ym)) != NULL) {
+        if (ym->ys_filename == NULL)
+            continue;
+        if (ycache_file_hash(ym->ys_filename, &hash) == 0)
+            goto fail;
+        snprintf(hstr, sizeof(hstr), "%016" PRIx64, hash);
+        if (ycache_str(&yw, ym->ys_filename, &sid) < 0 ||
+            ycache_str(&yw, hstr, &sid) < 0)
+            goto done;
+        yh.yh_nfile++;
+    }
+    /* Statement pointers sorted for lookup of references */
+    ycache_ptr_add(&yw, yspec);
+    if ((yw.yw_ptr = calloc(yw.yw_nptr, sizeof(ycache_ptr))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    yw.yw_nptr = 0;
+    ycache_ptr_add(&yw, yspec);
+    qsort(yw.yw_ptr, yw.yw_nptr, sizeof(ycache_ptr), ycache_ptrcmp);
+    if ((ret = ycache_stmt(&yw, yspec)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    memcpy(yh.yh_magic, YCACHE_MAGIC, sizeof(yh.yh_magic));
+    yh.yh_version = YCACHE_VERSION;
+    yh.yh_nstr = yw.yw_stroff.uv_len;
+    yh.yh_nstmt = yw.yw_stmt.uv_len / YCACHE_STMT_W;
+    yh.yh_ncv = yw.yw_cv.uv_len / YCACHE_CV_W;
+    yh.yh_ncvec = yw.yw_cvec.uv_len / YCACHE_CVEC_W;
+    yh.yh_ntype = yw.yw_type.uv_len / YCACHE_TYPE_W;
+    yh.yh_strlen = cbuf_len(yw.yw_str);
+    cprintf(cbtmp, "%s.%d", path, getpid());
+    if ((f = fopen(cbuf_get(cbtmp), "w")) == NULL){
+        clicon_err(OE_UNIX, errno, "fopen(%s)", cbuf_get(cbtmp));
+        goto done;
+    }
+    if (fwrite(&yh, sizeof(yh), 1, f) != 1 ||
+        fwrite(yw.yw_stroff.uv_vec, sizeof(uint32_t), yw.yw_stroff.uv_len, f) != yw.yw_stroff.uv_len ||
+        fwrite(yw.yw_stmt.uv_vec, sizeof(uint32_t), yw.yw_stmt.uv_len, f) != yw.yw_stmt.uv_len ||
+        fwrite(yw.yw_cv.uv_vec, sizeof(uint32_t), yw.yw_cv.uv_len, f) != yw.yw_cv.uv_len ||
+        fwrite(yw.yw_cvec.uv_vec, sizeof(uint32_t), yw.yw_cvec.uv_len, f) != yw.yw_cvec.uv_len ||
+        fwrite(yw.yw_type.uv_vec, sizeof(uint32_t), yw.yw_type.uv_len, f) != yw.yw_type.uv_len ||
+        fwrite(cbuf_get(yw.yw_str), 1, yh.yh_strlen, f) != yh.yh_strlen){
+        clicon_err(OE_UNIX, errno, "fwrite");
+        goto done;
+    }
+    if (fclose(f) != 0){
+        f = NULL;
+        clicon_err(OE_UNIX, errno, "fclose");
+        goto done;
+    }
+    f = NULL;
+    if (rename(cbuf_get(cbtmp), path) < 0){
+        clicon_err(OE_UNIX, errno, "rename(%s)", path);
+        goto done;
+    }
+    retval = 1;
+ done:
+    if (f){
+        fclose(f);
+        unlink(cbuf_get(cbtmp));
+    }
+    else if (retval < 0 && cbtmp && cbuf_len(cbtmp))
+        unlink(cbuf_get(cbtmp));
+    if (cbtmp)
+        cbuf_free(cbtmp);
+    if (yw.yw_str)
+        cbuf_free(yw.yw_str);
+    if (yw.yw_ptr)
+        free(yw.yw_ptr);
+    if (yw.yw_stroff.uv_vec)
+        free(yw.yw_stroff.uv_vec);
+    if (yw.yw_stmt.uv_vec)
+        free(yw.yw_stmt.uv_vec);
+    if (yw.yw_cv.uv_vec)
+        free(yw.yw_cv.uv_vec);
+    if (yw.yw_cvec.uv_vec)
+        free(yw.yw_cvec.uv_vec);
+    if (yw.yw_type.uv_vec)
+        free(yw.yw_type.uv_vec);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*------------------------------------------------------------------------
+ * Read
+ *------------------------------------------------------------------------*/
+
+/*! Get string from string table
+ * @retval  str   String, or NULL if sid is YCACHE_NONE or out of range
+ */
+static char *
+ycache_str_get(ycache_reader *yr,
+               uint32_t       sid)
+{
+    if (sid >= yr->yr_nstr)
+        return NULL;
+    return yr->yr_strings + yr->yr_stroff[sid];
+}
+
+/*! Get created statement from statement index
+ *
+ * @param[in]  yr     Reader state
+ * @param[in]  id     Statement index, or YCACHE_NONE
+ * @param[out] ys     Yang statement, or NULL
+ * @retval     1      OK
+ * @retval     0      Invalid index
+ */
+static int
+ycache_id2ptr(ycache_reader *yr,
+              uint32_t       id,
+              yang_stmt    **ys)
+{
+    *ys = NULL;
+    if (id == YCACHE_NONE)
+        return 1;
+    if (id >= yr->yr_nstmt)
+        return 0;
+    *ys = yr->yr_yvec[id];
+    return 1;
+}
+
+/*! Set name, value and flags of a cv from cv table
+ *
+ * @param[in]  yr     Reader state
+ * @param[in]  id     Index in cv table
+ * @param[in]  cv     Cligen variable created with the type of the entry
+ * @retval     1      OK
+ * @retval     0      Invalid entry
+ * @retval    -1      Error
+ */
+static int
+ycache_cv_set(ycache_reader *yr,
+              uint32_t       id,
+              cg_var        *cv)
+{
+    uint32_t  *v = &yr->yr_cv[id*YCACHE_CV_W];
+    char      *str;
+    char      *reason = NULL;
+    yang_stmt *ys;
+    int        ret;
+
+    if ((str = ycache_str_get(yr, v[1])) != NULL &&
+        cv_name_set(cv, str) == NULL){
+        clicon_err(OE_UNIX, errno, "cv_name_set");
+        return -1;
+    }
+    str = ycache_str_get(yr, v[2]);
+    if (v[0] == CGV_VOID){
+        if (ycache_id2ptr(yr, v[3], &ys) == 0)
+            return 0;
+        cv_void_set(cv, ys);
+    }
+    else if (cv_isstring(v[0])){
+        if (str && cv_string_set(cv, str) == NULL){
+            clicon_err(OE_UNIX, errno, "cv_string_set");
+            return -1;
+        }
+    }
+    else if (str){
+        if (v[0] == CGV_DEC64)
+            cv_dec64_n_set(cv, v[3]);
+        if ((ret = cv_parse1(str, cv, &reason)) < 0){
+            clicon_err(OE_YANG, errno, "cv_parse1");
+            return -1;
+        }
+        if (reason)
+            free(reason);
+        if (ret == 0)
+            return 0;
+    }
+    cv_flag_set(cv, v[4]);
+    return 1;
+}
+
+/*! Create single cv from cv table
+ *
+ * @param[in]  yr     Reader state
+ * @param[in]  id     Index in cv table, or YCACHE_NONE
+ * @param[out] cvp    Created cv, or NULL. Free with cv_free
+ * @retval     1      OK
+ * @retval     0      Invalid entry
+ * @retval    -1      Error
+ */
+static int
+ycache_cv_new(ycache_reader *yr,
+              uint32_t       id,
+              cg_var       **cvp)
+{
+    int     ret;
+    cg_var *cv;
+
+    *cvp = NULL;
+    if (id == YCACHE_NONE)
+        return 1;
+    if (id >= yr->yr_ncv)
+        return 0;
+    if ((cv = cv_new(yr->yr_cv[id*YCACHE_CV_W])) == NULL){
+        clicon_err(OE_UNIX, errno, "cv_new");
+        return -1;
+    }
+    if ((ret = ycache_cv_set(yr, id, cv)) < 1){
+        cv_free(cv);
+        return ret;
+    }
+    *cvp = cv;
+    return 1;
+}
+
+/*! Create cvec from cvec table
+ *
+ * @param[in]  yr     Reader state
+ * @param[in]  id     Index in cvec table, or YCACHE_NONE
+ * @param[out] cvvp   Created cvec, or NULL. Free with cvec_free
+ * @retval     1      OK
+ * @retval     0      Invalid entry
+ * @retval    -1      Error
+ */
+static int
+ycache_cvec_new(ycache_reader *yr,
+                uint32_t       id,
+                cvec         **cvvp)
+{
+    int       ret;
+    uint32_t *v;
+    uint32_t  i;
+    char     *str;
+    cvec     *cvv;
+    cg_var   *cv;
+
+    *cvvp = NULL;
+    if (id == YCACHE_NONE)
+        return 1;
+    if (id >= yr->yr_ncvec)
+        return 0;
+    v = &yr->yr_cvec[id*YCACHE_CVEC_W];
+    if (v[1] > yr->yr_ncv || v[2] > yr->yr_ncv - v[1])
+        return 0;
+    if ((cvv = cvec_new(0)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_new");
+        return -1;
+    }
+    *cvvp = cvv;
+    if ((str = ycache_str_get(yr, v[0])) != NULL &&
+        cvec_name_set(cvv, str) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_name_set");
+        return -1;
+    }
+    for (i=v[1]; i<v[1]+v[2]; i++){
+        if ((cv = cvec_add(cvv, yr->yr_cv[i*YCACHE_CV_W])) == NULL){
+            clicon_err(OE_UNIX, errno, "cvec_add");
+            return -1;
+        }
+        if ((ret = ycache_cv_set(yr, i, cv)) < 1)
+            return ret;
+    }
+    return 1;
+}
+
+/*! Create yang statement and its descendants from statement table in pre-order
+ *
+ * References to other statements are resolved in a second pass, see ycache_refs
+ * @param[in]  yr     Reader state
+ * @param[in]  yp     Yang parent
+ * @retval     1      OK
+ * @retval     0      Invalid file
+ * @retval    -1      Error
+ */
+static int
+ycache_build(ycache_reader *yr,
+             yang_stmt     *yp)
+{
+    int        ret;
+    uint32_t  *v;
+    yang_stmt *ys;
+    char      *str;
+    uint32_t   i;
+
+    if (yr->yr_i >= yr->yr_nstmt)
+        return 0;
+    v = &yr->yr_stmt[YCACHE_STMT_W*yr->yr_i];
+    if (v[0] >= Y_SPEC)
+        return 0;
+    if ((ys = ys_new(v[0])) == NULL)
+        return -1;
+    if (yn_insert(yp, ys) < 0){
+        ys_free(ys);
+        return -1;
+    }
+    yr->yr_yvec[yr->yr_i++] = ys;
+    if ((str = ycache_str_get(yr, v[1])) != NULL &&
+        (ys->ys_argument = strdup(str)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        return -1;
+    }
+    ys->ys_flags = v[2];
+    if ((str = ycache_str_get(yr, v[5])) != NULL &&
+        yang_filename_set(ys, str) < 0)
+        return -1;
+    ys->ys_linenum = v[6];
+    if ((str = ycache_str_get(yr, v[10])) != NULL &&
+        yang_when_xpath_set(ys, str) < 0)
+        return -1;
+    for (i=0; i<v[3]; i++)
+        if ((ret = ycache_build(yr, ys)) < 1)
+            return ret;
+    return 1;
+}
+
+/*! Set cvs, cvecs, type caches and statement references of created statements
+ *
+ * @param[in]  yr     Reader state
+ * @retval     1      OK
+ * @retval     0      Invalid file
+ * @retval    -1      Error
+ */
+static int
+ycache_refs(ycache_reader *yr)
+{
+    int              ret;
+    uint32_t         i;
+    uint32_t        *v;
+    uint32_t        *t;
+    yang_stmt       *ys;
+    yang_type_cache *yc;
+
+    for (i=1; i<yr->yr_nstmt; i++){
+        ys = yr->yr_yvec[i];
+        v = &yr->yr_stmt[i*YCACHE_STMT_W];
+        if (ycache_id2ptr(yr, v[4], &ys->ys_mymodule) == 0)
+            return 0;
+        if ((ret = ycache_cv_new(yr, v[7], &ys->ys_cv)) < 1)
+            return ret;
+        if ((ret = ycache_cvec_new(yr, v[8], &ys->ys_cvec)) < 1)
+            return ret;
+        if ((ret = ycache_cvec_new(yr, v[11], &ys->ys_when_nsc)) < 1)
+            return ret;
+        if (v[9] == YCACHE_NONE)
+            continue;
+        if (v[9] >= yr->yr_ntype)
+            return 0;
+        t = &yr->yr_type[v[9]*YCACHE_TYPE_W];
+        if ((yc = malloc(sizeof(*yc))) == NULL){
+            clicon_err(OE_UNIX, errno, "malloc");
+            return -1;
+        }
+        memset(yc, 0, sizeof(*yc));
+        ys->ys_typecache = yc;
+        yc->yc_options = t[0];
+        if ((ret = ycache_cvec_new(yr, t[1], &yc->yc_cvv)) < 1)
+            return ret;
+        if ((ret = ycache_cvec_new(yr, t[2], &yc->yc_patterns)) < 1)
+            return ret;
+        yc->yc_fraction = t[3];
+        if (ycache_id2ptr(yr, t[4], &yc->yc_resolved) == 0)
+            return 0;
+    }
+    return 1;
+}
+
+/*! Check that cache key and (sub)module file contents match cache file
+ *
+ * @param[in]  yr     Reader state
+ * @param[in]  nfile  Nr of (sub)module files
+ * @param[in]  key    Cache key of this daemon
+ * @retval     1      Match
+ * @retval     0      No match
+ */
+static int
+ycache_check(ycache_reader *yr,
+             uint32_t       nfile,
+             const char    *key)
+{
+    uint32_t i;
+    char    *filename;
+    char    *str;
+    uint64_t hash;
+    char     hstr[32];
+
+    if ((str = ycache_str_get(yr, 0)) == NULL ||
+        strcmp(str, key) != 0)
+        return 0;
+    for (i=0; i<nfile; i++){
+        if ((filename = ycache_str_get(yr, 1+2*i)) == NULL ||
+            (str = ycache_str_get(yr, 2+2*i)) == NULL)
+            return 0;
+        if (ycache_file_hash(filename, &hash) == 0)
+            return 0;
+        snprintf(hstr, sizeof(hstr), "%016" PRIx64, hash);
+        if (strcmp(str, hstr) != 0)
+            return 0;
+    }
+    return 1;
+}
+
+/*! Read yang cache file and create yang statements
+ *
+ * @param[in]  fd     Open cache file
+ * @param[in]  key    Cache key of this daemon
+ * @param[in]  yspec  Yang spec, top-level modules are added if file is valid
+ * @retval     1      OK, modules are added to yspec
+ * @retval     0      Cache file is invalid or stale
+ * @retval    -1      Error
+ */
+static int
+ycache_read(int         fd,
+            const char *key,
+            yang_stmt  *yspec)
+{
+    int                retval = -1;
+    struct stat        st;
+    void              *map = MAP_FAILED;
+    struct ycache_hdr *yh;
+    ycache_reader      yr = {0,};
+    size_t             len;
+    uint32_t           i;
+    yang_stmt         *ytmp = NULL;
+    yang_stmt         *ym;
+    int                ret;
+
+    if (fstat(fd, &st) < 0){
+        clicon_err(OE_UNIX, errno, "fstat");
+        goto done;
+    }
+    if (st.st_size < sizeof(*yh))
+        goto fail;
+    if ((map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED){
+        clicon_err(OE_UNIX, errno, "mmap");
+        goto done;
+    }
+    yh = (struct ycache_hdr *)map;
+    if (memcmp(yh->yh_magic, YCACHE_MAGIC, sizeof(yh->yh_magic)) != 0 ||
+        yh->yh_version != YCACHE_VERSION)
+        goto fail;
+    len = sizeof(*yh) + sizeof(uint32_t)*((size_t)yh->yh_nstr +
+                                          (size_t)yh->yh_nstmt*YCACHE_STMT_W +
+                                          (size_t)yh->yh_ncv*YCACHE_CV_W +
+                                          (size_t)yh->yh_ncvec*YCACHE_CVEC_W +
+                                          (size_t)yh->yh_ntype*YCACHE_TYPE_W);
+    if (len + yh->yh_strlen != st.st_size || yh->yh_nstmt == 0 || yh->yh_strlen == 0 ||
+        yh->yh_nstr < 1 + 2*(size_t)yh->yh_nfile ||
+        ((char*)map)[st.st_size-1] != '\0')
+        goto fail;
+    yr.yr_stroff = (uint32_t*)(yh + 1);
+    yr.yr_nstr = yh->yh_nstr;
+    yr.yr_stmt = yr.yr_stroff + yh->yh_nstr;
+    yr.yr_nstmt = yh->yh_nstmt;
+    yr.yr_cv = yr.yr_stmt + (size_t)yh->yh_nstmt*YCACHE_STMT_W;
+    yr.yr_ncv = yh->yh_ncv;
+    yr.yr_cvec = yr.yr_cv + (size_t)yh->yh_ncv*YCACHE_CV_W;
+    yr.yr_ncvec = yh->yh_ncvec;
+    yr.yr_type = yr.yr_cvec + (size_t)yh->yh_ncvec*YCACHE_CVEC_W;
+    yr.yr_ntype = yh->yh_ntype;
+    yr.yr_strings = (char*)map + len;
+    for (i=0; i<yr.yr_nstr; i++)
+        if (yr.yr_stroff[i] >= yh->yh_strlen)
+            goto fail;
+    if (ycache_check(&yr, yh->yh_nfile, key) == 0)
+        goto fail;
+    if ((yr.yr_yvec = calloc(yr.yr_nstmt, sizeof(yang_stmt *))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    /* Build top-level modules in a temporary yspec, moved to yspec when complete */
+    if ((ytmp = yspec_new()) == NULL)
+        goto done;
+    yr.yr_yvec[0] = yspec;
+    yr.yr_i = 1;
+    for (i=0; i<yr.yr_stmt[3]; i++)
+        if ((ret = ycache_build(&yr, ytmp)) < 1){
+            if (ret < 0)
+                goto done;
+            goto fail;
+        }
+    if (yr.yr_i != yr.yr_nstmt)
+        goto fail;
+    if ((ret = ycache_refs(&yr)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    for (i=0; i<ytmp->ys_len; i++){
+        ym = ytmp->ys_stmt[i];
+        if (yn_insert(yspec, ym) < 0)
+            goto done;
+        ytmp->ys_stmt[i] = NULL;
+    }
+    retval = 1;
+ done:
+    if (ytmp)
+        ys_free(ytmp);
+    if (yr.yr_yvec)
+        free(yr.yr_yvec);
+    if (map != MAP_FAILED)
+        munmap(map, st.st_size);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Get cache file path and cache key of daemon
+ *
+ * @param[in]  h     Clicon handle
+ * @param[in]  name  Daemon name
+ * @param[out] path  Cache file path, or empty if no cache dir is configured
+ * @param[out] key   Cache key
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+ycache_path_key(clicon_handle h,
+                const char   *name,
+                cbuf         *path,
+                cbuf         *key)
+{
+    char *dir;
+
+    if ((dir = clicon_option_str(h, "CLICON_YANG_CACHE_DIR")) == NULL)
+        return 0;
+    cprintf(path, "%s/clixon_%s.yspec", dir, name);
+    return ycache_key(h, name, key);
+}
+
+/*! Load yang spec of a daemon from yang cache, if enabled and valid
+ *
+ * If loaded, the yspec is marked and subsequent calls to parse yang modules into the yspec
+ * are no-ops until yang_spec_cache_done is called.
+ * @param[in]  h     Clicon handle
+ * @param[in]  name  Daemon name, eg "backend"
+ * @param[in]  yspec Empty yang spec
+ * @retval     1     Loaded from cache
+ * @retval     0     Not loaded: cache not enabled, missing or stale
+ * @retval    -1     Error
+ * @code
+ *   if (yang_spec_cache_load(h, "backend", yspec) < 0)
+ *      err;
+ *   yang_spec_parse_module(h, ..., yspec); // no-op if loaded
+ *   if (yang_spec_cache_done(h, "backend", yspec) < 0)
+ *      err;
+ * @endcode
+ * @see CLICON_YANG_CACHE_DIR
+ */
+int
+yang_spec_cache_load(clicon_handle h,
+                     const char   *name,
+                     yang_stmt    *yspec)
+{
+    int   retval = -1;
+    cbuf *path = NULL;
+    cbuf *key = NULL;
+    int   fd = -1;
+    int   ret;
+
+    if (yang_len_get(yspec) != 0)
+        goto fail;
+    if ((path = cbuf_new()) == NULL ||
+        (key = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (ycache_path_key(h, name, path, key) < 0)
+        goto done;
+    if (cbuf_len(path) == 0)
+        goto fail;
+    if ((fd = open(cbuf_get(path), O_RDONLY)) < 0)
+        goto fail;
+    if ((ret = ycache_read(fd, cbuf_get(key), yspec)) < 0)
+        goto done;
+    if (ret == 0){
+        clicon_debug(1, "%s yang cache %s is stale", __FUNCTION__, cbuf_get(path));
+        goto fail;
+    }
+    yang_flag_set(yspec, YANG_FLAG_CACHE_LOADED);
+    clicon_debug(1, "%s yang spec loaded from cache %s", __FUNCTION__, cbuf_get(path));
+    retval = 1;
+ done:
+    if (fd != -1)
+        close(fd);
+    if (path)
+        cbuf_free(path);
+    if (key)
+        cbuf_free(key);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Finish loading yang spec of a daemon and write yang cache if not loaded from it
+ *
+ * A yang spec that cannot be cached, or a cache file that cannot be written, is logged but
+ * is not an error.
+ * @param[in]  h     Clicon handle
+ * @param[in]  name  Daemon name, eg "backend"
+ * @param[in]  yspec Yang spec with all modules loaded
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see yang_spec_cache_load
+ */
+int
+yang_spec_cache_done(clicon_handle h,
+                     const char   *name,
+                     yang_stmt    *yspec)
+{
+    int   retval = -1;
+    cbuf *path = NULL;
+    cbuf *key = NULL;
+    int   ret;
+
+    if (yang_flag_get(yspec, YANG_FLAG_CACHE_LOADED)){
+        yang_flag_reset(yspec, YANG_FLAG_CACHE_LOADED);
+        goto ok;
+    }
+    if ((path = cbuf_new()) == NULL ||
+        (key = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (ycache_path_key(h, name, path, key) < 0)
+        goto done;
+    if (cbuf_len(path) == 0)
+        goto ok;
+    if ((ret = ycache_write(yspec, cbuf_get(key), cbuf_get(path))) < 0){
+        clicon_log(LOG_WARNING, "%s: Writing yang cache %s: %s",
+                   __FUNCTION__, cbuf_get(path), clicon_err_reason);
+        clicon_err_reset();
+    }
+    else if (ret == 0)
+        clicon_debug(1, "%s yang spec cannot be cached", __FUNCTION__);
+ ok:
+    retval = 0;
+ done:
+    if (path)
+        cbuf_free(path);
+    if (key)
+        cbuf_free(key);
+    return retval;
+}
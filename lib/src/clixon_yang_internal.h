@@ -104,6 +104,11 @@ struct yang_stmt{
     char              *ys_filename;   /* For debug/errors: filename (only (sub)modules) */
     int                ys_linenum;    /* For debug/errors: line number (in ys_filename) */
     rpc_callback_t    *ys_action_cb;  /* Action callback list, only for Y_ACTION */
+    struct xpath_prog *ys_xpath_prog; /* Compiled xpath of must/when statement, or of
+                                         ys_when_xpath for other nodes, see yang_xpath_prog_get */
+    uint64_t          *ys_descbloom;  /* Bloom filter of descendant data node names, computed
+                                         on demand if YANG_FLAG_DESC_CACHE is set, NULL if none
+                                         @see yang_descendant_maybe */
     /* Internal use */
     int               _ys_vector_i;   /* internal use: yn_each */
 };
@@ -103,6 +103,35 @@
 /* Size of json read buffer when reading from file*/
 #define BUFLEN 1024
 
+/* Name of yang file index in clicon data, see yang_file_index_begin */
+#define YANG_FILE_INDEX "yang-file-index"
+
+/*
+ * Types
+ */
+/* Yang file found in a yang dir */
+struct yang_file {
+    char *yf_name;    /* Filename without dir */
+    char *yf_path;    /* Full path */
+    int   yf_order;   /* Order found in dir */
+};
+
+/* Index of yang files of one CLICON_YANG_MAIN_DIR or CLICON_YANG_DIR, sorted on name */
+struct yang_file_dir {
+    struct yang_file *yd_files;
+    int               yd_len;
+};
+
+/* Index of yang files of all yang dirs, in the order of the config file
+ * Built on first lookup and used during a single load of yang modules, so that imported
+ * modules are found without scanning the yang dirs for each module
+ */
+struct yang_file_index {
+    int                   yi_built;
+    struct yang_file_dir *yi_dirs;
+    int                   yi_len;
+};
+
 /* Forward */
 static int yang_expand_grouping(yang_stmt *yn);
 
@@ -824,36 +853,34 @@ yang_parse_file(FILE       *fp,
                 yang_stmt  *yspec)
 {
     char         *buf = NULL;
-    int           i;
-    char          c;
-    int           len;
+    size_t        i;
+    size_t        len;
     yang_stmt    *ymod = NULL;
-    int           ret;
+    size_t        ret;
+    struct stat   st;
 
     len = BUFLEN; /* any number is fine */
+    /* Size the buffer from the file size, if known, to read the file in one call */
+    if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= len)
+        len = st.st_size + 1;
     if ((buf = malloc(len)) == NULL){
         clicon_err(OE_XML, errno, "malloc");
         goto done;
     }
-    memset(buf, 0, len);
     i = 0; /* position in buf */
-    while (1){ /* read the whole file */
-        if ((ret = fread(&c, 1, 1, fp)) < 0){
-            clicon_err(OE_XML, errno, "read");
-            break;
-        }
-        if (ret == 0)
-            break; /* eof */
+    while ((ret = fread(buf+i, 1, len-1-i, fp)) > 0){ /* read the whole file */
+        i += ret;
         if (i == len-1){
             if ((buf = realloc(buf, 2*len)) == NULL){
                 clicon_err(OE_XML, errno, "realloc");
                 goto done;
             }       
-            memset(buf+len, 0, len);
             len *= 2;
         }
-        buf[i++] = (char)(c&0xff);
-    } /* read a line */
+    }
+    if (ferror(fp))
+        clicon_err(OE_XML, errno, "read");
+    buf[i] = '\0';
     if ((ymod = yang_parse_str(buf, name, yspec)) < 0)
         goto done;
   done:
@@ -900,6 +927,292 @@ filename2revision(const char *filename,
     return retval;
 }
 
+/*! Check if filename is a yang file of a module
+ *
+ * Same as regexp: ^<module>@<revision>(.yang)$ or ^<module>(@YYYY-MM-DD)?(.yang)$
+ * @param[in]  name     Filename without dir
+ * @param[in]  module   Module name
+ * @param[in]  revision Revision or NULL
+ * @retval     1        Match
+ * @retval     0        No match
+ */
+static int
+yang_filename_match(const char *name,
+                    const char *module,
+                    const char *revision)
+{
+    size_t len = strlen(module);
+    int    i;
+
+    if (strncmp(name, module, len) != 0)
+        return 0;
+    name += len;
+    if (revision){
+        len = strlen(revision);
+        if (*name++ != '@' || strncmp(name, revision, len) != 0)
+            return 0;
+        name += len;
+    }
+    else if (*name == '@'){
+        name++;
+        for (i=0; i<10; i++)
+            if ((i==4 || i==7) ? name[i] != '-' : !isdigit(name[i]))
+                return 0;
+        name += 10;
+    }
+    return strcmp(name, ".yang") == 0;
+}
+
+static int
+yang_file_cmp(const void *a,
+              const void *b)
+{
+    const struct yang_file *fa = (const struct yang_file *)a;
+    const struct yang_file *fb = (const struct yang_file *)b;
+    int                     eq;
+
+    if ((eq = strcmp(fa->yf_name, fb->yf_name)) != 0)
+        return eq;
+    return fa->yf_order - fb->yf_order;
+}
+
+/*! Free yang file index
+ */
+static int
+yang_file_index_free(struct yang_file_index *yi)
+{
+    int                   i;
+    int                   j;
+    struct yang_file_dir *yd;
+
+    for (i=0; i<yi->yi_len; i++){
+        yd = &yi->yi_dirs[i];
+        for (j=0; j<yd->yd_len; j++){
+            if (yd->yd_files[j].yf_name)
+                free(yd->yd_files[j].yf_name);
+            if (yd->yd_files[j].yf_path)
+                free(yd->yd_files[j].yf_path);
+        }
+        if (yd->yd_files)
+            free(yd->yd_files);
+    }
+    if (yi->yi_dirs)
+        free(yi->yi_dirs);
+    free(yi);
+    return 0;
+}
+
+/*! Add a yang file to a dir of the yang file index
+ */
+static int
+yang_file_index_add(struct yang_file_dir *yd,
+                    const char           *name,
+                    const char           *path)
+{
+    struct yang_file *yf;
+
+    if ((yd->yd_files = realloc(yd->yd_files, (yd->yd_len+1)*sizeof(*yf))) == NULL){
+        clicon_err(OE_UNIX, errno, "realloc");
+        return -1;
+    }
+    yf = &yd->yd_files[yd->yd_len];
+    memset(yf, 0, sizeof(*yf));
+    yf->yf_order = yd->yd_len++;
+    if ((yf->yf_name = strdup(name)) == NULL ||
+        (yf->yf_path = strdup(path)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        return -1;
+    }
+    return 0;
+}
+
+/*! Build yang file index by scanning all yang dirs once
+ *
+ * CLICON_YANG_MAIN_DIR is scanned non-recursively and CLICON_YANG_DIR recursively, as in
+ * yang_file_find_match.
+ * @param[in]  h     Clicon handle
+ * @param[in]  yi    Yang file index
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+yang_file_index_build(clicon_handle           h,
+                      struct yang_file_index *yi)
+{
+    int                   retval = -1;
+    cxobj                *x;
+    cxobj                *xc;
+    char                 *dir;
+    struct yang_file_dir *yd;
+    struct dirent        *dp = NULL;
+    int                   ndp;
+    int                   i;
+    cvec                 *cvv = NULL;
+    cg_var               *cv;
+    char                  path[MAXPATHLEN];
+
+    yi->yi_built = 1;
+    if ((x = clicon_conf_xml(h)) == NULL)
+        goto ok;
+    xc = NULL;
+    while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL) {
+        if (strcmp(xml_name(xc), "CLICON_YANG_MAIN_DIR") != 0 &&
+            strcmp(xml_name(xc), "CLICON_YANG_DIR") != 0)
+            continue;
+        if ((dir = xml_body(xc)) == NULL)
+            continue;
+        if ((yi->yi_dirs = realloc(yi->yi_dirs, (yi->yi_len+1)*sizeof(*yd))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            goto done;
+        }
+        yd = &yi->yi_dirs[yi->yi_len++];
+        memset(yd, 0, sizeof(*yd));
+        if (strcmp(xml_name(xc), "CLICON_YANG_MAIN_DIR") == 0){
+            if ((ndp = clicon_file_dirent(dir, &dp, "(.yang)$", S_IFREG)) < 0)
+                goto done;
+            for (i=0; i<ndp; i++){
+                snprintf(path, sizeof(path), "%s/%s", dir, dp[i].d_name);
+                if (yang_file_index_add(yd, dp[i].d_name, path) < 0)
+                    goto done;
+            }
+            if (dp){
+                free(dp);
+                dp = NULL;
+            }
+        }
+        else {
+            if ((cvv = cvec_new(0)) == NULL){
+                clicon_err(OE_UNIX, errno, "cvec_new");
+                goto done;
+            }
+            if (clicon_files_recursive(dir, "(.yang)$", cvv) < 0)
+                goto done;
+            cv = NULL;
+            while ((cv = cvec_each(cvv, cv)) != NULL)
+                if (yang_file_index_add(yd, cv_name_get(cv), cv_string_get(cv)) < 0)
+                    goto done;
+            cvec_free(cvv);
+            cvv = NULL;
+        }
+        if (yd->yd_len)
+            qsort(yd->yd_files, yd->yd_len, sizeof(*yd->yd_files), yang_file_cmp);
+    }
+ ok:
+    retval = 0;
+ done:
+    if (dp)
+        free(dp);
+    if (cvv)
+        cvec_free(cvv);
+    return retval;
+}
+
+/*! Match a yang file given module using the yang file index
+ *
+ * Same result as scanning the dirs: the first dir in config order with a match, and
+ * in that dir the last file name in sort order, ie the most recent revision
+ * @param[in]  yi       Yang file index
+ * @param[in]  module   Name of main YANG module. 
+ * @param[in]  revision Revision or NULL
+ * @param[out] fbuf     Buffer containing filename or NULL (if retval=1)
+ * @retval     1        Match found
+ * @retval     0        No matching entry found
+ */
+static int
+yang_file_index_match(struct yang_file_index *yi,
+                      const char             *module,
+                      const char             *revision,
+                      cbuf                   *fbuf)
+{
+    struct yang_file_dir *yd;
+    struct yang_file     *best;
+    size_t                len = strlen(module);
+    int                   i;
+    int                   lo;
+    int                   hi;
+    int                   mid;
+
+    for (i=0; i<yi->yi_len; i++){
+        yd = &yi->yi_dirs[i];
+        /* Find first file name starting with module */
+        lo = 0;
+        hi = yd->yd_len;
+        while (lo < hi){
+            mid = (lo + hi) / 2;
+            if (strncmp(yd->yd_files[mid].yf_name, module, len) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        best = NULL;
+        for (; lo < yd->yd_len && strncmp(yd->yd_files[lo].yf_name, module, len) == 0; lo++){
+            if (!yang_filename_match(yd->yd_files[lo].yf_name, module, revision))
+                continue;
+            if (best == NULL || strcoll(yd->yd_files[lo].yf_name, best->yf_name) > 0)
+                best = &yd->yd_files[lo];
+        }
+        if (best){
+            if (fbuf)
+                cprintf(fbuf, "%s", best->yf_path);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*! Start using a yang file index for a load of yang modules
+ *
+ * Yang dirs are scanned once at the first lookup instead of at each module lookup.
+ * Nested calls share the index of the outermost call.
+ * @param[in]  h       Clicon handle
+ * @param[out] created Set if index is created by this call, pass to yang_file_index_end
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see yang_file_index_end
+ */
+static int
+yang_file_index_begin(clicon_handle h,
+                      int          *created)
+{
+    struct yang_file_index *yi;
+
+    *created = 0;
+    if (h == NULL || clicon_ptr_get(h, YANG_FILE_INDEX, NULL) == 0)
+        return 0;
+    if ((yi = malloc(sizeof(*yi))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        return -1;
+    }
+    memset(yi, 0, sizeof(*yi));
+    if (clicon_ptr_set(h, YANG_FILE_INDEX, yi) < 0){
+        free(yi);
+        return -1;
+    }
+    *created = 1;
+    return 0;
+}
+
+/*! Stop using yang file index, free it if created by corresponding begin call
+ *
+ * The index is not kept between loads since yang files may change
+ * @param[in]  h       Clicon handle
+ * @param[in]  created From yang_file_index_begin
+ * @see yang_file_index_begin
+ */
+static int
+yang_file_index_end(clicon_handle h,
+                    int           created)
+{
+    struct yang_file_index *yi = NULL;
+
+    if (!created)
+        return 0;
+    if (clicon_ptr_get(h, YANG_FILE_INDEX, (void**)&yi) == 0 && yi != NULL)
+        yang_file_index_free(yi);
+    clicon_ptr_del(h, YANG_FILE_INDEX);
+    return 0;
+}
+
 /*! No specific revision give. Match a yang file given module 
  * @param[in]  h        CLICON handle
  * @param[in]  module   Name of main YANG module. 
@@ -924,7 +1237,15 @@ yang_file_find_match(clicon_handle h,
     cvec         *cvv = NULL;
     cg_var       *cv = NULL;
     cg_var       *bestcv = NULL;
+    struct yang_file_index *yi = NULL;
 
+    /* Use yang file index if loading modules, see yang_file_index_begin */
+    if (h && clicon_ptr_get(h, YANG_FILE_INDEX, (void**)&yi) == 0 && yi != NULL){
+        if (!yi->yi_built && yang_file_index_build(h, yi) < 0)
+            goto done;
+        retval = yang_file_index_match(yi, module, revision, fbuf);
+        goto done;
+    }
     /* get clicon config file in xml form */
     if ((x = clicon_conf_xml(h)) == NULL)
         goto ok;
@@ -1593,6 +1914,7 @@ yang_spec_parse_module(clicon_handle h,
     int         retval = -1;
     int         modmin;       /* Existing number of modules */
     char       *base = NULL;;
+    int         created = 0;  /* Yang file index created */
 
     if (yspec == NULL){
         clicon_err(OE_YANG, EINVAL, "yang spec is NULL");
@@ -1602,11 +1924,16 @@ yang_spec_parse_module(clicon_handle h,
         clicon_err(OE_YANG, EINVAL, "yang module not set");
         goto done;
     }
+    /* Modules are already loaded from yang cache */
+    if (yang_flag_get(yspec, YANG_FLAG_CACHE_LOADED))
+        goto ok;
     /* Apply steps 2.. on new modules, ie ones after modmin. */
     modmin = yang_len_get(yspec);
     /* Do not load module if it already exists */
     if (yang_find_module_by_name_revision(yspec, name, revision) != NULL)
         goto ok;
+    if (yang_file_index_begin(h, &created) < 0)
+        goto done;
     /* Find a yang module and parse it and all its submodules */
     if (yang_parse_module(h, name, revision, yspec, NULL) == NULL)
         goto done;
@@ -1615,6 +1942,7 @@ yang_spec_parse_module(clicon_handle h,
  ok:
     retval = 0;
  done:
+    yang_file_index_end(h, created);
     if (base)
         free(base);
     return retval;
@@ -1638,7 +1966,11 @@ yang_spec_parse_file(clicon_handle h,
     int         retval = -1;
     int         modmin;       /* Existing number of modules */
     char       *base = NULL;;
+    int         created = 0;  /* Yang file index created */
 
+    /* Modules are already loaded from yang cache */
+    if (yang_flag_get(yspec, YANG_FLAG_CACHE_LOADED))
+        goto ok;
     /* Apply steps 2.. on new modules, ie ones after modmin. */
     modmin = yang_len_get(yspec);
     /* Find module, and do not load file if module already exists */
@@ -1654,6 +1986,8 @@ yang_spec_parse_file(clicon_handle h,
         *index(base, '@') = '\0';
     if (yang_find(yspec, Y_MODULE, base) != NULL)
         goto ok;
+    if (yang_file_index_begin(h, &created) < 0)
+        goto done;
     if (yang_parse_filename(h, filename, yspec) == NULL)
         goto done;
     if (yang_parse_post(h, yspec, modmin) < 0)
@@ -1661,6 +1995,7 @@ yang_spec_parse_file(clicon_handle h,
  ok:
     retval = 0;
  done:
+    yang_file_index_end(h, created);
     if (base)
         free(base);
     return retval;
@@ -1702,6 +2037,7 @@ yang_spec_load_dir(clicon_handle h,
     uint32_t       rev0; /* revision in existing module */
     char          *oldbase = NULL;
     int            taken = 0;
+    int            created = 0; /* Yang file index created */
     
     /* Get yang files names from yang module directory. Note that these
      * are sorted alphatetically:
@@ -1709,6 +2045,9 @@ yang_spec_load_dir(clicon_handle h,
      * a@2000-01-01.yang, 
      * a@2111-11-11.yang
      */
+    /* Modules are already loaded from yang cache */
+    if (yang_flag_get(yspec, YANG_FLAG_CACHE_LOADED))
+        goto ok;
     if((ndp = clicon_file_dirent(dir, &dp, "(.yang)$", S_IFREG)) < 0)
         goto done;
     if (ndp == 0)
@@ -1781,11 +2120,14 @@ yang_spec_load_dir(clicon_handle h,
             ys_free(ym);
         }
     }
+    if (yang_file_index_begin(h, &created) < 0)
+        goto done;
     if (yang_parse_post(h, yspec, modmin) < 0)
         goto done;
  ok:
     retval = 0;
   done:
+    yang_file_index_end(h, created);
     if (dp)
         free(dp);
     if (base)
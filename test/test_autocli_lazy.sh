@@ -0,0 +1,155 @@
+#!/usr/bin/env bash
+# Lazy autocli: with CLICON_CLI_AUTOCLI_LAZY, syntax of top-level yang nodes is generated
+# when first used by a command instead of at CLI startup.
+# Check one-shot commands naming a top-level node, a choice at top-level, a command in
+# another module, and interactive completion where all syntax is generated.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+clispec=$dir/automode.cli
+fyang=$dir/clixon-example.yang
+fyang2=$dir/clixon-other.yang
+
+cat <<EOF > $fyang
+module clixon-example {
+    yang-version 1.1;
+    namespace "urn:example:clixon";
+    prefix ex;
+    container table{
+        list parameter{
+            key name;
+            leaf name{
+                type string;
+            }
+            leaf value{
+                type string;
+            }
+        }
+    }
+    choice ch {
+        leaf alpha {
+            type string;
+        }
+        case b {
+            leaf beta {
+                type uint32;
+            }
+        }
+    }
+}
+EOF
+
+cat <<EOF > $fyang2
+module clixon-other {
+    yang-version 1.1;
+    namespace "urn:example:other";
+    prefix oth;
+    container other{
+        leaf-list x{
+            type string;
+        }
+    }
+}
+EOF
+
+cat <<EOF > $clispec
+CLICON_MODE="example";
+CLICON_PROMPT="%U@%H %W> ";
+CLICON_PLUGIN="example_cli";
+
+# Autocli syntax tree operations
+set @datamodel, cli_auto_set();
+delete("Delete a configuration item") @datamodel, cli_auto_del();
+quit("Quit"), cli_quit();
+show("Show a particular state of the system"){
+    configuration("Show configuration"), cli_show_auto_mode("candidate", "xml", false, false);{
+        @datamodelshow, cli_show_auto("candidate", "xml", false, false, "explicit");
+    }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_FEATURE>ietf-netconf:startup</CLICON_FEATURE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$IETFRFC</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_DIR>$dir</CLICON_YANG_MAIN_DIR>
+  <CLICON_CLI_MODE>$APPNAME</CLICON_CLI_MODE>
+  <CLICON_CLI_DIR>/usr/local/lib/$APPNAME/cli</CLICON_CLI_DIR>
+  <CLICON_CLISPEC_DIR>$dir</CLICON_CLISPEC_DIR>
+  <CLICON_CLI_AUTOCLI_LAZY>true</CLICON_CLI_AUTOCLI_LAZY>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XMLDB_PRETTY>false</CLICON_XMLDB_PRETTY>
+  ${AUTOCLI}
+</clixon-config>
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "set table parameter"
+expectpart "$($clixon_cli -1 -f $cfg set table parameter x value 42)" 0 "^$"
+
+new "set choice leaf in case"
+expectpart "$($clixon_cli -1 -f $cfg set beta 17)" 0 "^$"
+
+new "set leaf-list in other module"
+expectpart "$($clixon_cli -1 -f $cfg set other x abc)" 0 "^$"
+
+new "set table invalid"
+expectpart "$($clixon_cli -1 -f $cfg set table parameter x wrong 42 2>&1)" 255 "CLI syntax error"
+
+new "set unknown top-level"
+expectpart "$($clixon_cli -1 -f $cfg set nonexist 2>&1)" 255 "CLI syntax error"
+
+new "show configuration table"
+expectpart "$($clixon_cli -1 -f $cfg show configuration table)" 0 "<table xmlns=\"urn:example:clixon\"><parameter><name>x</name><value>42</value></parameter></table>"
+
+new "show configuration"
+expectpart "$($clixon_cli -1 -f $cfg show configuration)" 0 "<beta xmlns=\"urn:example:clixon\">17</beta>" "<other xmlns=\"urn:example:other\"><x>abc</x></other>"
+
+new "completion generates all top-level nodes"
+expectpart "$(echo "set ?" | $clixon_cli -f $cfg 2>&1)" 0 "table" "alpha" "beta" "other"
+
+new "completion in container"
+expectpart "$(echo "set table parameter x ?" | $clixon_cli -f $cfg 2>&1)" 0 "value"
+
+new "delete table parameter"
+expectpart "$($clixon_cli -1 -f $cfg delete table parameter x)" 0 "^$"
+
+new "show configuration table deleted"
+expectpart "$($clixon_cli -1 -f $cfg show configuration)" 0 --not-- "<table"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -143,6 +143,18 @@ expectpart "$(echo "set table parameter opta value2 ?" | $clixon_cli -f $cfg 2>&
 new "Check query value3"
 expectpart "$(echo "set table parameter opta value3 ?" | $clixon_cli -f $cfg 2>&1)" 0 44 --not-- '<value>'
 
+# Expanded values are cached in the CLI, check cache is invalidated if another session
+# changes the datastore
+new "Expand cache: value3 45 fails, netconf adds 45 in other session, value3 45 ok"
+ret=$({ echo "set table parameter opta value3 45"; sleep 2; echo "$HELLONO11<rpc $DEFAULTNS><edit-config><default-operation>merge</default-operation><target><candidate/></target><config><table xmlns=\"urn:example:clixon\"><parameter><name>opta</name><value3>45</value3></parameter></table></config></edit-config></rpc>]]>]]>" | $clixon_netconf -qf $cfg > /dev/null; echo "set table parameter opta value3 45"; } | $clixon_cli -f $cfg 2>&1)
+count=$(echo "$ret" | grep -c "CLI syntax error")
+if [ $count -ne 1 ]; then
+    err "1 syntax error" "$ret"
+fi
+
+new "Check query value3 after netconf edit"
+expectpart "$(echo "set table parameter opta value3 ?" | $clixon_cli -f $cfg 2>&1)" 0 44 45 --not-- '<value>'
+
 if [ $BE -ne 0 ]; then
     new "Kill backend"
     # Check if premature kill
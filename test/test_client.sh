@@ -110,6 +110,30 @@ main(int    argc,
          goto done;
        printf("%u\n", u); /* for test output */
     }
+    /* Read plan: several values in one request, second read uses cache */
+    {
+       clixon_client_plan cp;
+       uint32_t           a = 0;
+       uint32_t           b = 0;
+       uint32_t           c = 0;
+       int                ia, ib, ic;
+       int                i;
+
+       if ((cp = clixon_client_plan_new("urn:example:clixon-client", 1)) == NULL)
+         goto done;
+       ia = clixon_client_plan_add(cp, "/table/parameter[name='a']/value");
+       ib = clixon_client_plan_add(cp, "/table/parameter[name='b']/value");
+       ic = clixon_client_plan_add(cp, "/table/parameter[name='c']/value");
+       for (i=0; i<2; i++){
+          if (clixon_client_plan_read(ch, cp) < 0)
+            goto done;
+          if (clixon_client_plan_uint32(cp, ia, &a) != 1 ||
+              clixon_client_plan_uint32(cp, ib, &b) != 1)
+            goto done;
+          printf("plan%d %u %u %d\n", i, a, b, clixon_client_plan_uint32(cp, ic, &c)); /* for test output */
+       }
+       clixon_client_plan_free(cp);
+    }
     retval = 0;
   done:
     clixon_client_disconnect(ch);
@@ -155,7 +179,7 @@ fi
 new "wait restconf"
 wait_restconf
 
-XML='<table xmlns="urn:example:clixon-client"><parameter><name>a</name><value>42</value></parameter></table>'
+XML='<table xmlns="urn:example:clixon-client"><parameter><name>a</name><value>42</value></parameter><parameter><name>b</name><value>17</value></parameter></table>'
 
 # Add a set of entries using restconf
 new "POST the XML"
@@ -165,7 +189,7 @@ new "Check entries"
 expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/clixon-client:table -H 'Accept: application/yang-data+xml')" 0 "HTTP/$HVER 200" "$XML"
 
 new "Run $app"
-expectpart "$($app)" 0 '^42$'
+expectpart "$($app)" 0 '^42$' '^plan0 42 17 0$' '^plan1 42 17 0$'
 
 if [ $RC -ne 0 ]; then
     new "Kill restconf daemon"
@@ -0,0 +1,163 @@
+#!/usr/bin/env bash
+# Binary datastore format
+# Convert a datastore between XML and binary using clixon_util_datastore, and run the
+# backend with binary datastores: startup from a converted file, edit, commit and restart
+# from running. An augmented leaf-list checks that schema nodes resolve via namespace.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+: ${clixon_util_datastore:=clixon_util_datastore}
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-binary.yang
+fyang1=$dir/example-binary-aug.yang
+xmldir=$dir/xmldb
+bindir=$dir/bindb
+
+test -d $xmldir || mkdir $xmldir
+test -d $bindir || mkdir $bindir
+
+cat <<EOF > $fyang
+module example-binary{
+    yang-version 1.1;
+    namespace "urn:example:binary";
+    prefix ex;
+    container table{
+        list parameter{
+            key name;
+            leaf name{
+                type string;
+            }
+            leaf value{
+                type string;
+            }
+            leaf-list array1{
+                type string;
+            }
+        }
+    }
+}
+EOF
+
+cat <<EOF > $fyang1
+module example-binary-aug{
+    yang-version 1.1;
+    namespace "urn:example:binary-aug";
+    prefix aug;
+    import example-binary {
+        prefix ex;
+    }
+    augment "/ex:table/ex:parameter" {
+        leaf-list array2{
+            type string;
+        }
+    }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_FEATURE>ietf-netconf:startup</CLICON_FEATURE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$IETFRFC</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_DIR>$dir</CLICON_YANG_MAIN_DIR>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$bindir</CLICON_XMLDB_DIR>
+  <CLICON_XMLDB_FORMAT>binary</CLICON_XMLDB_FORMAT>
+</clixon-config>
+EOF
+
+# Entries in reverse order, the xml datastore sorts them
+XML="<table xmlns=\"urn:example:binary\"><parameter><name>b</name><value>x&amp;y</value></parameter><parameter><name>a</name><value>42</value><array1>z</array1><array1>y</array1></parameter></table>"
+SORTED="<table xmlns=\"urn:example:binary\"><parameter><name>a</name><value>42</value><array1>y</array1><array1>z</array1></parameter><parameter><name>b</name><value>x&amp;y</value></parameter></table>"
+
+# Utility loads a single yang file, the augment is tested with the backend
+util="$clixon_util_datastore -y $fyang -Y ${YANG_INSTALLDIR}"
+
+new "xml datastore init"
+expectpart "$($util -b $xmldir -d startup init)" 0 ""
+
+new "xml datastore put"
+expectpart "$($util -b $xmldir -d startup put replace "$XML")" 0 ""
+
+new "convert xml to binary"
+expectpart "$($util -b $xmldir -d startup convert binary $bindir/startup_db)" 0 ""
+
+new "binary file is not xml"
+expectpart "$(head -c 7 $bindir/startup_db)" 0 "CLXNBIN"
+
+new "get from binary datastore"
+expectpart "$($util -b $bindir -d startup -f binary get /)" 0 "^<${DATASTORE_TOP}>$SORTED</${DATASTORE_TOP}>$"
+
+new "convert binary to xml"
+expectpart "$($util -b $bindir -d startup -f binary convert xml $dir/startup.xml)" 0 ""
+
+new "converted xml"
+expectpart "$(cat $dir/startup.xml)" 0 "$SORTED"
+
+new "xml file read as binary fails"
+expectpart "$($util -b $xmldir -d startup -f binary get / 2>&1)" 255 "Not a binary datastore file"
+
+new "test params: -s startup -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s startup -f $cfg"
+    start_backend -s startup -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "get-config running from binary startup"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data>$SORTED</data></rpc-reply>"
+
+new "add entry and augmented leaf-list"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><table xmlns=\"urn:example:binary\"><parameter><name>0</name><value>first</value></parameter><parameter><name>a</name><array2 xmlns=\"urn:example:binary-aug\">c2</array2></parameter></table></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+
+    new "start backend -s running -f $cfg"
+    start_backend -s running -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "get-config running after restart"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><table xmlns=\"urn:example:binary\"><parameter><name>0</name><value>first</value></parameter><parameter><name>a</name><value>42</value><array1>y</array1><array1>z</array1><array2 xmlns=\"urn:example:binary-aug\">c2</array2></parameter><parameter><name>b</name><value>x&amp;y</value></parameter></table></data></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,217 @@
+#!/usr/bin/env bash
+# Default values in the datastore cache
+# Default values are kept in the cache and updated by edits, see xmldb_put. Check:
+# - Default values are not set: create is allowed and delete is an error
+# - The with-defaults retrieval modes after edits, also after a failed edit
+# - A default value with a when condition referring to another subtree
+# Run without when: defaults are updated only on edited nodes
+# Run with when: defaults are updated in the whole tree
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-dsdef.yang
+
+NCNS="xmlns:nc=\"urn:ietf:params:xml:ns:netconf:base:1.0\""
+WDNS="xmlns:wd=\"urn:ietf:params:xml:ns:netconf:default:1.0\""
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+# Edit candidate
+# 1: config
+# 2: expected reply
+function editwd(){
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config>$1</config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS>$2"
+}
+
+# Get config with a with-defaults retrieval mode
+# 1: datastore
+# 2: xpath
+# 3: with-defaults mode
+# 4: expected data
+function getwd(){
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><$1/></source><filter type=\"xpath\" select=\"$2\" xmlns:ex=\"urn:example:dsdef\"/><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">$3</with-defaults></get-config></rpc>" "" "<rpc-reply $DEFAULTNS>$4</rpc-reply>"
+}
+
+# Parameters:
+# 1: when: true, false
+function testrun(){
+    when=$1
+    if $when; then
+        WHEN="when \"../../ex:a/ex:mode = 'on'\";"
+    else
+        WHEN=""
+    fi
+    cat <<EOF > $fyang
+module example-dsdef{
+   yang-version 1.1;
+   namespace "urn:example:dsdef";
+   prefix ex;
+   container a{
+      leaf mode{
+         type string;
+      }
+   }
+   container b{
+      leaf x{
+         $WHEN
+         type uint32;
+         default 7;
+      }
+      leaf y{
+         type uint32;
+         default 8;
+      }
+      container bc{
+         $WHEN
+         leaf z{
+            type uint32;
+            default 9;
+         }
+      }
+   }
+   container c{
+      leaf d{
+         type uint32;
+         default 10;
+      }
+      leaf e{
+         type string;
+      }
+   }
+}
+EOF
+
+    new "test params: -f $cfg # when: $when"
+
+    if [ $BE -ne 0 ]; then
+        new "kill old backend"
+        sudo clixon_backend -zf $cfg
+        if [ $? -ne 0 ]; then
+            err
+        fi
+        new "start backend -s init -f $cfg"
+        start_backend -s init -f $cfg
+    fi
+
+    new "wait backend"
+    wait_backend
+
+    new "report-all default values"
+    getwd candidate /ex:c report-all "<data><c xmlns=\"urn:example:dsdef\"><d>10</d></c></data>"
+
+    new "delete default leaf, not set"
+    editwd "<c xmlns=\"urn:example:dsdef\" $NCNS><d nc:operation=\"delete\"/></c>" "<rpc-error><error-type>application</error-type><error-tag>data-missing</error-tag>"
+
+    new "delete non-presence container with default values, not set"
+    editwd "<c xmlns=\"urn:example:dsdef\" $NCNS nc:operation=\"delete\"/>" "<rpc-error><error-type>application</error-type><error-tag>data-missing</error-tag>"
+
+    new "report-all default values after failed edits"
+    getwd candidate /ex:c report-all "<data><c xmlns=\"urn:example:dsdef\"><d>10</d></c></data>"
+
+    new "create default leaf with default value"
+    editwd "<c xmlns=\"urn:example:dsdef\" $NCNS><d nc:operation=\"create\">10</d></c>" "<ok/></rpc-reply>"
+
+    new "explicit set leaf with default value"
+    getwd candidate /ex:c explicit "<data><c xmlns=\"urn:example:dsdef\"><d>10</d></c></data>"
+
+    new "report-all-tagged set leaf with default value"
+    getwd candidate /ex:c report-all-tagged "<data><c xmlns=\"urn:example:dsdef\" $WDNS><d wd:default=\"true\">10</d></c></data>"
+
+    new "create set leaf"
+    editwd "<c xmlns=\"urn:example:dsdef\" $NCNS><d nc:operation=\"create\">11</d></c>" "<rpc-error><error-type>application</error-type><error-tag>data-exists</error-tag>"
+
+    new "delete set leaf"
+    editwd "<c xmlns=\"urn:example:dsdef\" $NCNS><d nc:operation=\"delete\"/></c>" "<ok/></rpc-reply>"
+
+    new "explicit after delete"
+    getwd candidate /ex:c explicit "<data/>"
+
+    new "report-all after delete"
+    getwd candidate /ex:c report-all "<data><c xmlns=\"urn:example:dsdef\"><d>10</d></c></data>"
+
+    new "create non-presence container with default values"
+    editwd "<c xmlns=\"urn:example:dsdef\" $NCNS nc:operation=\"create\"><e>x</e></c>" "<ok/></rpc-reply>"
+
+    new "trim"
+    getwd candidate /ex:c trim "<data><c xmlns=\"urn:example:dsdef\"><e>x</e></c></data>"
+
+    new "report-all-tagged"
+    getwd candidate /ex:c report-all-tagged "<data><c xmlns=\"urn:example:dsdef\" $WDNS><d wd:default=\"true\">10</d><e>x</e></c></data>"
+
+    new "report-all"
+    getwd candidate /ex:c report-all "<data><c xmlns=\"urn:example:dsdef\"><d>10</d><e>x</e></c></data>"
+
+    new "discard-changes"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "explicit after discard"
+    getwd candidate /ex:c explicit "<data/>"
+
+    new "report-all after discard"
+    getwd candidate /ex:c report-all "<data><c xmlns=\"urn:example:dsdef\"><d>10</d></c></data>"
+
+    if $when; then
+        new "when false, no default values"
+        getwd candidate /ex:b report-all "<data><b xmlns=\"urn:example:dsdef\"><y>8</y></b></data>"
+
+        new "edit other subtree: when true"
+        editwd "<a xmlns=\"urn:example:dsdef\"><mode>on</mode></a>" "<ok/></rpc-reply>"
+
+        new "report-all when true"
+        getwd candidate /ex:b report-all "<data><b xmlns=\"urn:example:dsdef\"><x>7</x><y>8</y><bc><z>9</z></bc></b></data>"
+
+        new "report-all-tagged when true"
+        getwd candidate /ex:b report-all-tagged "<data><b xmlns=\"urn:example:dsdef\" $WDNS><x wd:default=\"true\">7</x><y wd:default=\"true\">8</y><bc><z wd:default=\"true\">9</z></bc></b></data>"
+
+        new "explicit when true"
+        getwd candidate /ex:b explicit "<data/>"
+
+        new "commit"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+        new "edit other subtree: when false"
+        editwd "<a xmlns=\"urn:example:dsdef\"><mode>off</mode></a>" "<ok/></rpc-reply>"
+
+        new "report-all when false"
+        getwd candidate /ex:b report-all "<data><b xmlns=\"urn:example:dsdef\"><y>8</y></b></data>"
+
+        new "report-all running when true"
+        getwd running /ex:b report-all "<data><b xmlns=\"urn:example:dsdef\"><x>7</x><y>8</y><bc><z>9</z></bc></b></data>"
+    else
+        new "report-all no when"
+        getwd candidate /ex:b report-all "<data><b xmlns=\"urn:example:dsdef\"><x>7</x><y>8</y><bc><z>9</z></bc></b></data>"
+    fi
+
+    if [ $BE -ne 0 ]; then
+        new "Kill backend"
+        # Check if premature kill
+        pid=$(pgrep -u root -f clixon_backend)
+        if [ -z "$pid" ]; then
+            err "backend already dead"
+        fi
+        # kill backend
+        stop_backend -f $cfg
+    fi
+}
+
+testrun false
+
+testrun true
+
+rm -rf $dir
+
+new "endtest"
+endtest
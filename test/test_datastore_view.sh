@@ -0,0 +1,143 @@
+#!/usr/bin/env bash
+# Get-config serialized directly from the datastore cache (datastore view)
+# The same get-config requests are made with and without datastore cache, where nocache
+# uses the copying read path, and the results should be identical.
+# Checks xpath with ancestor lists (keys), depth, generation and with-defaults explicit
+# and report-all, including edits of default values after the cache is expanded.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-view.yang
+
+cat <<EOF > $fyang
+module example-view{
+    yang-version 1.1;
+    namespace "urn:example:view";
+    prefix ex;
+    container c{
+        list x {
+            key "name";
+            leaf name {
+                type string;
+            }
+            leaf a {
+                type string;
+            }
+            container np {
+                leaf d {
+                    type uint32;
+                    default 7;
+                }
+            }
+        }
+        leaf e {
+            type uint32;
+            default 8;
+        }
+    }
+}
+EOF
+
+# Parameters:
+# 1: dbcache: cache, nocache, cache-zerocopy
+function testrun(){
+    dbcache=$1
+    new "test params: -f $cfg  # dbcache: $dbcache"
+
+    cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_DATASTORE_CACHE>$dbcache</CLICON_DATASTORE_CACHE>
+</clixon-config>
+EOF
+
+    if [ $BE -ne 0 ]; then
+        new "kill old backend"
+        sudo clixon_backend -zf $cfg
+        if [ $? -ne 0 ]; then
+            err
+        fi
+        new "start backend -s init -f $cfg"
+        start_backend -s init -f $cfg
+    fi
+
+    new "wait backend"
+    wait_backend
+
+    new "get-config empty"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+    new "get-config empty report-all"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">report-all</with-defaults><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><e>8</e></c></data></rpc-reply>"
+
+    new "add two list entries"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:view\"><x><name>x1</name><a>a1</a></x><x><name>x2</name><a>a2</a><np><d>9</d></np></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "get-config all"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><x><name>x1</name><a>a1</a></x><x><name>x2</name><a>a2</a><np><d>9</d></np></x></c></data></rpc-reply>"
+
+    new "get-config all report-all"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">report-all</with-defaults><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><x><name>x1</name><a>a1</a><np><d>7</d></np></x><x><name>x2</name><a>a2</a><np><d>9</d></np></x><e>8</e></c></data></rpc-reply>"
+
+    new "get-config leaf in list: ancestors and key"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:c/ex:x[ex:name='x2']/ex:a\" xmlns:ex=\"urn:example:view\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><x><name>x2</name><a>a2</a></x></c></data></rpc-reply>"
+
+    new "get-config default leaf explicit"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:c/ex:x[ex:name='x1']/ex:np/ex:d\" xmlns:ex=\"urn:example:view\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+    new "get-config default leaf report-all"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">report-all</with-defaults><source><candidate/></source><filter type=\"xpath\" select=\"/ex:c/ex:x[ex:name='x1']/ex:np/ex:d\" xmlns:ex=\"urn:example:view\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><x><name>x1</name><np><d>7</d></np></x></c></data></rpc-reply>"
+
+    new "get-config depth 2"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config depth=\"2\"><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><x></x><x></x></c></data></rpc-reply>"
+
+    new "set default value explicitly"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:view\"><x><name>x1</name><np><d>7</d></np></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "get-config explicitly set default"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:c/ex:x[ex:name='x1']\" xmlns:ex=\"urn:example:view\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><x><name>x1</name><a>a1</a><np><d>7</d></np></x></c></data></rpc-reply>"
+
+    new "delete list entry x2"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:view\"><x nc:operation=\"delete\" xmlns:nc=\"${BASENS}\"><name>x2</name></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "get-config after delete report-all"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">report-all</with-defaults><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><x><name>x1</name><a>a1</a><np><d>7</d></np></x><e>8</e></c></data></rpc-reply>"
+
+    new "get-config trim (copying path)"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">trim</with-defaults><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:view\"><x><name>x1</name><a>a1</a></x></c></data></rpc-reply>"
+
+    if [ $BE -ne 0 ]; then
+        new "Kill backend"
+        # Check if premature kill
+        pid=$(pgrep -u root -f clixon_backend)
+        if [ -z "$pid" ]; then
+            err "backend already dead"
+        fi
+        # kill backend
+        stop_backend -f $cfg
+    fi
+}
+
+# Run without db cache: copying read path
+testrun nocache
+
+# Run with db cache: datastore view
+testrun cache
+
+# Run with zero-copy
+testrun cache-zerocopy
+
+rm -rf $dir
+
+new "endtest"
+endtest
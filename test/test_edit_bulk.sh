@@ -0,0 +1,142 @@
+#!/usr/bin/env bash
+# Bulk insert of many new list entries in one edit-config (XML_INSERT_BULK)
+# New entries of a list ordered-by system are sorted once and merged with the existing entries.
+# Check that the result is sorted when entries are added in reverse order, interleaved with
+# existing entries and with entries of another list, and that search indexes are rebuilt.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-bulk.yang
+
+# Number of entries (even numbers are added in bulk)
+: ${perfnr:=200}
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XPATH_AUTO_INDEX>1</CLICON_XPATH_AUTO_INDEX>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example-bulk{
+    yang-version 1.1;
+    namespace "urn:example:bulk";
+    prefix ex;
+    container c{
+        leaf first {
+            type string;
+        }
+        list x {
+            key "k";
+            leaf k {
+                type int32;
+            }
+            leaf type {
+                type string;
+            }
+        }
+        list y {
+            key "k";
+            leaf k {
+                type int32;
+            }
+        }
+        leaf last {
+            type string;
+        }
+    }
+}
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+# Existing: odd entries of x, and first and last leafs
+new "add odd entries"
+rpc="<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:bulk\"><first>a</first><last>z</last>"
+for (( i=1; i<$perfnr; i+=2 )); do
+    rpc+="<x><k>$i</k><type>odd</type></x>"
+done
+rpc+="</c></config></edit-config></rpc>"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "$rpc" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "get odd entries, build search index"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:c/ex:x[ex:type='odd']/ex:k\" xmlns:ex=\"urn:example:bulk\"/></get-config></rpc>" "" "<x><k>1</k></x><x><k>3</k></x>"
+
+# Bulk: even entries of x in reverse order, interleaved with y entries
+new "add even entries in reverse order in bulk"
+rpc="<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:bulk\">"
+for (( i=$perfnr-2; i>=0; i-=2 )); do
+    rpc+="<x><k>$i</k><type>even</type></x><y><k>$i</k></y>"
+done
+rpc+="</c></config></edit-config></rpc>"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "$rpc" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+expect="<c xmlns=\"urn:example:bulk\"><first>a</first>"
+for (( i=0; i<$perfnr; i++ )); do
+    if [ $((i%2)) -eq 0 ]; then
+        expect+="<x><k>$i</k><type>even</type></x>"
+    else
+        expect+="<x><k>$i</k><type>odd</type></x>"
+    fi
+done
+for (( i=0; i<$perfnr; i+=2 )); do
+    expect+="<y><k>$i</k></y>"
+done
+expect+="<last>z</last></c>"
+
+new "get-config sorted"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data>$expect</data></rpc-reply>"
+
+new "get even entries using rebuilt search index"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:c/ex:x[ex:type='even']/ex:k\" xmlns:ex=\"urn:example:bulk\"/></get-config></rpc>" "" "<x><k>0</k></x><x><k>2</k></x>"
+
+new "get one even entry by key"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:c/ex:x[ex:k='42']\" xmlns:ex=\"urn:example:bulk\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:bulk\"><x><k>42</k><type>even</type></x></c></data></rpc-reply>"
+
+new "validate"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "get-config running sorted"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data>$expect</data></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,187 @@
+#!/usr/bin/env bash
+# Binary encoding of internal netconf rpcs between frontend and backend (CLICON_IPC_BINARY)
+# The netconf client sends rpcs as binary encoded trees, synchronously and pipelined.
+# Check edit-config, get-config, validate and commit, invalid config, and that a client
+# with the option disabled still uses XML text to the same backend.
+# The backend debug log shows if a message was binary encoded.
+# Last, the backend has the option disabled and the client falls back to XML text.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-ipc.yang
+finput=$dir/input.xml
+flog=$dir/backend.log
+
+# Number of pipelined edit-config requests
+: ${nr:=50}
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_IPC_BINARY>true</CLICON_IPC_BINARY>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example-ipc{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix ex;
+   container x {
+      leaf name {
+         type string;
+      }
+      list y {
+         key "a";
+         leaf a {
+            type int32;
+         }
+         leaf b {
+            type int32;
+         }
+      }
+   }
+}
+EOF
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg -l f$flog -D 2"
+    start_backend -s init -f $cfg -l f$flog -D 2
+fi
+
+new "wait backend"
+wait_backend
+
+# Number of binary encoded messages decoded by the backend, from its debug log
+function binarynr(){
+    grep "clicon_msg_decode binary encoding" $flog | wc -l
+}
+
+new "binary edit-config"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><y><a>2</a><b>2</b></y><name>a&amp;b</name><y><a>1</a><b>1</b></y></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "binary encoding used"
+    if [ $(binarynr) -eq 0 ]; then
+        err "binary encoding" "none in $flog"
+    fi
+fi
+
+new "binary get-config sorted"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><name>a&amp;b</name><y><a>1</a><b>1</b></y><y><a>2</a><b>2</b></y></x></data></rpc-reply>"
+
+new "binary get-config with filter"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=2]\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>2</a><b>2</b></y></x></data></rpc-reply>"
+
+new "binary edit-config invalid type"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><y><a>3</a><b>notint</b></y></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error>"
+
+new "binary edit-config unknown element"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><z>3</z></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>unknown-element</error-tag>"
+
+new "binary validate"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "binary commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    nr0=$(binarynr)
+fi
+
+new "text client get-config running"
+expecteof_netconf "$clixon_netconf -qf $cfg -o CLICON_IPC_BINARY=false" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><name>a&amp;b</name><y><a>1</a><b>1</b></y><y><a>2</a><b>2</b></y></x></data></rpc-reply>"
+
+new "text client edit-config"
+expecteof_netconf "$clixon_netconf -qf $cfg -o CLICON_IPC_BINARY=false" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><name>c</name></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "text client: no binary encoding"
+    if [ $(binarynr) -ne $nr0 ]; then
+        err "$nr0 binary messages" "$(binarynr)"
+    fi
+fi
+
+new "binary discard-changes"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+# Pipelined: asynchronous session to backend
+echo -n "$DEFAULTHELLO" > $finput
+for (( i=0; i<$nr; i++ )); do
+    chunked_framing "<rpc $DEFAULTONLY message-id=\"$((i+1))\"><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><y><a>$((i+10))</a><b>$i</b></y></x></config></edit-config></rpc>" >> $finput
+done
+chunked_framing "<rpc $DEFAULTONLY message-id=\"1000\"><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=$((nr+9))]\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" >> $finput
+
+if [ $BE -ne 0 ]; then
+    nr0=$(binarynr)
+fi
+
+new "binary pipeline $nr edit-config"
+ret=$(cat $finput | $clixon_netconf -qef $cfg -o CLICON_NETCONF_PIPELINE=4)
+match=$(echo "$ret" | grep -o "<ok/>" | wc -l)
+if [ "$match" != $nr ]; then
+    err "$nr" "$match"
+fi
+
+new "binary pipeline get-config after edits"
+expectpart "$ret" 0 "<rpc-reply $DEFAULTONLY message-id=\"1000\"><data><x xmlns=\"urn:example:clixon\"><y><a>$((nr+9))</a><b>$((nr-1))</b></y></x></data></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "binary pipeline encoding used"
+    if [ $(binarynr) -lt $((nr0+nr)) ]; then
+        err "at least $((nr0+nr)) binary messages" "$(binarynr)"
+    fi
+
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+
+    # Backend with binary encoding disabled, client falls back to XML text
+    flog=$dir/backend-text.log
+
+    new "start backend -s running -f $cfg -o CLICON_IPC_BINARY=false -l f$flog -D 2"
+    start_backend -s running -f $cfg -o CLICON_IPC_BINARY=false -l f$flog -D 2
+
+    new "wait backend"
+    wait_backend
+
+    new "text backend: edit-config"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><name>d</name></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "text backend: get-config"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:x/ex:name\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><name>d</name></x></data></rpc-reply>"
+
+    new "text backend: no binary encoding"
+    if [ $(binarynr) -ne 0 ]; then
+        err "0 binary messages" "$(binarynr)"
+    fi
+
+    new "Kill backend"
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
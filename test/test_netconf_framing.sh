@@ -97,6 +97,45 @@ EOF
 new "Netconf 1.1 multi-chunked framing"
 expecteof_netconf "$clixon_netconf -qef $cfg -o CLICON_NETCONF_BASE_CAPABILITY=1" 0 "$rpc" "" "" "<rpc-reply $DEFAULTNS><data><table xmlns=\"urn:example:clixon\"><parameter><name>a</name></parameter></table></data></rpc-reply>"
 
+# Forwarded to backend as received: leading whitespace and message-id
+rpc=$(chunked_framing " <rpc $DEFAULTONLY message-id=\"43\"><edit-config><target><candidate/></target><config><table xmlns=\"urn:example:clixon\"><parameter><name>b</name><value>x</value></parameter></table></config></edit-config></rpc>")
+
+new "Netconf 1.1 edit-config and get-config in one input"
+expecteof_netconf "$clixon_netconf -qef $cfg -o CLICON_NETCONF_BASE_CAPABILITY=1" 0 "<?xml version=\"1.0\" encoding=\"UTF-8\"?><hello $DEFAULTNS><capabilities><capability>urn:ietf:params:netconf:base:1.1</capability></capabilities></hello>]]>]]>$rpc" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "message-id=\"43\"><ok/></rpc-reply>" "<rpc-reply $DEFAULTNS><data><table xmlns=\"urn:example:clixon\"><parameter><name>a</name></parameter><parameter><name>b</name><value>x</value></parameter></table></data></rpc-reply>"
+
+# Not forwarded as received: prefixed rpc, and username attribute
+new "Netconf 1.1 edit-config prefixed rpc"
+expecteof_netconf "$clixon_netconf -qef $cfg -o CLICON_NETCONF_BASE_CAPABILITY=1" 0 "$DEFAULTHELLO" "<nc:rpc xmlns:nc=\"urn:ietf:params:xml:ns:netconf:base:1.0\"><nc:edit-config><nc:target><nc:candidate/></nc:target><nc:config><table xmlns=\"urn:example:clixon\"><parameter><name>c</name></parameter></table></nc:config></nc:edit-config></nc:rpc>" "" "<rpc-reply $DEFAULTONLY xmlns:nc=\"urn:ietf:params:xml:ns:netconf:base:1.0\"><ok/></rpc-reply>"
+
+new "Netconf 1.1 edit-config rpc with username attribute"
+expecteof_netconf "$clixon_netconf -qef $cfg -o CLICON_NETCONF_BASE_CAPABILITY=1" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS xmlns:cl=\"http://clicon.org/lib\" cl:username=\"nobody\"><edit-config><target><candidate/></target><config><table xmlns=\"urn:example:clixon\"><parameter><name>d</name></parameter></table></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS xmlns:cl=\"http://clicon.org/lib\"><ok/></rpc-reply>"
+
+new "Netconf 1.1 get-config entries of prefixed rpc and rpc with username attribute"
+expecteof_netconf "$clixon_netconf -qef $cfg -o CLICON_NETCONF_BASE_CAPABILITY=1" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:table/ex:parameter[ex:name='c' or ex:name='d']\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><table xmlns=\"urn:example:clixon\"><parameter><name>c</name></parameter><parameter><name>d</name></parameter></table></data></rpc-reply>"
+
+# Large edit-config split in many small chunks
+: ${perfnr:=1000}
+body="<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><table xmlns=\"urn:example:clixon\">"
+for (( i=0; i<$perfnr; i++ )); do
+    body+="<parameter><name>p$i</name><value>$i</value></parameter>"
+done
+body+="</table></config></edit-config></rpc>"
+rpc=""
+for (( i=0; i<${#body}; i+=77 )); do
+    chunk=${body:$i:77}
+    rpc+=$(printf "\n#%s\n%s" ${#chunk} "$chunk")
+done
+rpc+=$(printf "\n##\n")
+
+new "Netconf 1.1 edit-config of $perfnr entries in chunks of 77 bytes"
+expecteof_netconf "$clixon_netconf -qef $cfg -o CLICON_NETCONF_BASE_CAPABILITY=1" 0 "$DEFAULTHELLO$rpc" "" "<ok/></rpc-reply>" ""
+
+new "Netconf 1.1 get-config last entry"
+expecteof_netconf "$clixon_netconf -qef $cfg -o CLICON_NETCONF_BASE_CAPABILITY=1" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:table/ex:parameter[ex:name='p$((perfnr-1))']\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><table xmlns=\"urn:example:clixon\"><parameter><name>p$((perfnr-1))</name><value>$((perfnr-1))</value></parameter></table></data></rpc-reply>"
+
+new "Netconf 1.0 eom framing, two messages in one input"
+expecteof "$clixon_netconf -qef $cfg -o CLICON_NETCONF_BASE_CAPABILITY=0" 0 "<?xml version=\"1.0\" encoding=\"UTF-8\"?><hello $DEFAULTNS><capabilities><capability>urn:ietf:params:netconf:base:1.0</capability></capabilities></hello>]]>]]><rpc $DEFAULTONLY message-id=\"1\"><discard-changes/></rpc>]]>]]><rpc $DEFAULTONLY message-id=\"2\"><get-config><source><candidate/></source></get-config></rpc>]]>]]>$" "^<rpc-reply $DEFAULTONLY message-id=\"1\"><ok/></rpc-reply>]]>]]><rpc-reply $DEFAULTONLY message-id=\"2\"><data/></rpc-reply>]]>]]>$"
+
 if [ $BE -ne 0 ]; then
     new "Kill backend"
     # Check if premature kill
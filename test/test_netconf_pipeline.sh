@@ -0,0 +1,125 @@
+#!/usr/bin/env bash
+# Netconf pipelining of edit-config to backend, see CLICON_NETCONF_PIPELINE
+# Many edit-config requests are sent in one stream, replies must arrive in order
+# and be interleaved correctly with non-pipelined requests, also with locks
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-pipeline.yang
+finput=$dir/input.xml
+
+# Number of edit-config requests
+: ${nr:=100}
+
+# Window of outstanding requests
+: ${window:=8}
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_NETCONF_PIPELINE>$window</CLICON_NETCONF_PIPELINE>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example-pipeline{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix ex;
+   container x {
+      list y {
+         key "a";
+         leaf a {
+            type int32;
+         }
+         leaf b {
+            type int32;
+         }
+      }
+   }
+}
+EOF
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+# Input: hello, lock, nr edit-configs, an invalid edit-config, get-config, commit, unlock
+# Each request has its own message-id
+echo -n "$DEFAULTHELLO" > $finput
+chunked_framing "<rpc $DEFAULTONLY message-id=\"1\"><lock><target><candidate/></target></lock></rpc>" >> $finput
+for (( i=0; i<$nr; i++ )); do
+    chunked_framing "<rpc $DEFAULTONLY message-id=\"$((i+2))\"><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><y><a>$i</a><b>$i</b></y></x></config></edit-config></rpc>" >> $finput
+done
+chunked_framing "<rpc $DEFAULTONLY message-id=\"1000\"><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><y><a>0</a><b>notint</b></y></x></config></edit-config></rpc>" >> $finput
+chunked_framing "<rpc $DEFAULTONLY message-id=\"1001\"><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=$((nr-1))]\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" >> $finput
+chunked_framing "<rpc $DEFAULTONLY message-id=\"1002\"><commit/></rpc>" >> $finput
+chunked_framing "<rpc $DEFAULTONLY message-id=\"1003\"><unlock><target><candidate/></target></unlock></rpc>" >> $finput
+
+new "netconf pipeline $nr edit-config window $window"
+ret=$(cat $finput | $clixon_netconf -qef $cfg)
+# Extract message-ids in reply order
+ids=$(echo "$ret" | grep -o "<rpc-reply [^>]*message-id=\"[0-9]*\"" | sed 's/.*message-id="\([0-9]*\)"/\1/' | tr '\n' ' ')
+expect="1 "
+for (( i=0; i<$nr; i++ )); do
+    expect="$expect$((i+2)) "
+done
+expect="${expect}1000 1001 1002 1003 "
+if [ "$ids" != "$expect" ]; then
+    err "$expect" "$ids"
+fi
+
+new "netconf pipeline edit-config with lock held by same session ok"
+match=$(echo "$ret" | grep -c "lock-denied")
+if [ "$match" != 0 ]; then
+    err "no lock-denied" "$ret"
+fi
+
+new "netconf pipeline invalid edit-config error"
+expectpart "$ret" 0 "<rpc-reply $DEFAULTONLY message-id=\"1000\"><rpc-error>"
+
+new "netconf pipeline get-config after edits"
+expectpart "$ret" 0 "<rpc-reply $DEFAULTONLY message-id=\"1001\"><data><x xmlns=\"urn:example:clixon\"><y><a>$((nr-1))</a><b>$((nr-1))</b></y></x></data></rpc-reply>"
+
+new "netconf get-config running has $nr entries"
+ret=$(echo "$DEFAULTHELLO$(chunked_framing "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>")" | $clixon_netconf -qef $cfg)
+match=$(echo "$ret" | grep -o "<y>" | wc -l)
+if [ "$match" != $nr ]; then
+    err "$nr" "$match"
+fi
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
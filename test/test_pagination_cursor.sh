@@ -0,0 +1,170 @@
+#!/usr/bin/env bash
+# List pagination using clixon-lib cursor and count extensions (keyset pagination)
+# A page starts after the entry given by the cursor returned in the previous reply.
+# Requires the datastore cache, with nocache the request is not supported.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-cursor.yang
+
+# Clixon-lib namespace declaration of cursor and count attributes
+CLNS="xmlns:cl=\"http://clicon.org/lib\""
+
+# Define default restconfig config: RESTCONFIG
+RESTCONFIG=$(restconf_config none false)
+
+cat <<EOF > $fyang
+module example-cursor{
+    yang-version 1.1;
+    namespace "urn:example:cursor";
+    prefix ex;
+    container c{
+        list x {
+            key "name";
+            leaf name {
+                type string;
+            }
+            leaf a {
+                type string;
+            }
+        }
+        leaf-list y {
+            type string;
+        }
+    }
+}
+EOF
+
+# Parameters:
+# 1: dbcache: cache, nocache
+function testrun(){
+    dbcache=$1
+    new "test params: -f $cfg  # dbcache: $dbcache"
+
+    cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_FEATURE>clixon-restconf:allow-auth-none</CLICON_FEATURE> <!-- Use auth-type=none -->
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$IETFRFC</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_DATASTORE_CACHE>$dbcache</CLICON_DATASTORE_CACHE>
+  $RESTCONFIG
+</clixon-config>
+EOF
+
+    if [ $BE -ne 0 ]; then
+        new "kill old backend"
+        sudo clixon_backend -zf $cfg
+        if [ $? -ne 0 ]; then
+            err
+        fi
+        new "start backend -s init -f $cfg"
+        start_backend -s init -f $cfg
+    fi
+
+    new "wait backend"
+    wait_backend
+
+    new "add list and leaf-list entries"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:cursor\"><x><name>a3</name><a>3</a></x><x><name>a1</name><a>1</a></x><x><name>a5</name><a>5</a></x><x><name>a2</name><a>2</a></x><x><name>a4</name><a>4</a></x><y>v,1</y><y>v,2</y><y>v,3</y></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "commit"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    SELX="<filter type=\"xpath\" select=\"/ex:c/ex:x\" xmlns:ex=\"urn:example:cursor\"/>"
+    SELY="<filter type=\"xpath\" select=\"/ex:c/ex:y\" xmlns:ex=\"urn:example:cursor\"/>"
+    LIMIT2="<list-pagination xmlns=\"urn:ietf:params:xml:ns:yang:ietf-list-pagination-nc\"><limit>2</limit></list-pagination>"
+
+    if [ $dbcache = nocache ]; then
+        new "cursor not supported without cache"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get cl:count=\"true\" $CLNS>$SELX$LIMIT2</get></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>operation-not-supported</error-tag>"
+    else
+        new "count list entries"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get cl:count=\"true\" $CLNS>$SELX$LIMIT2</get></rpc>" "" "<rpc-reply $DEFAULTNS><data cl:count=\"5\" $CLNS/></rpc-reply>"
+
+        new "first page"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get cl:cursor=\"\" $CLNS>$SELX$LIMIT2</get></rpc>" "" "<rpc-reply $DEFAULTNS><data cl:cursor=\"a2\" $CLNS><c xmlns=\"urn:example:cursor\"><x><name>a1</name><a>1</a></x><x><name>a2</name><a>2</a></x></c></data></rpc-reply>"
+
+        new "second page"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get cl:cursor=\"a2\" $CLNS>$SELX$LIMIT2</get></rpc>" "" "<rpc-reply $DEFAULTNS><data cl:cursor=\"a4\" $CLNS><c xmlns=\"urn:example:cursor\"><x><name>a3</name><a>3</a></x><x><name>a4</name><a>4</a></x></c></data></rpc-reply>"
+
+        new "last page, no cursor"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get cl:cursor=\"a4\" $CLNS>$SELX$LIMIT2</get></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:cursor\"><x><name>a5</name><a>5</a></x></c></data></rpc-reply>"
+
+        new "cursor of deleted entry continues after it"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get cl:cursor=\"a25\" $CLNS>$SELX$LIMIT2</get></rpc>" "" "<rpc-reply $DEFAULTNS><data cl:cursor=\"a4\" $CLNS><c xmlns=\"urn:example:cursor\"><x><name>a3</name><a>3</a></x><x><name>a4</name><a>4</a></x></c></data></rpc-reply>"
+
+        new "invalid cursor"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get cl:cursor=\"a1,a2\" $CLNS>$SELX$LIMIT2</get></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>bad-attribute</error-tag><error-info><bad-attribute>cursor</bad-attribute>"
+
+        new "leaf-list cursor is percent-encoded"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config cl:cursor=\"v%2C1\" $CLNS><source><running/></source>$SELY$LIMIT2</get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:cursor\"><y>v,2</y><y>v,3</y></c></data></rpc-reply>"
+
+        if [ $RC -ne 0 ]; then
+            new "kill old restconf daemon"
+            stop_restconf_pre
+
+            new "start restconf daemon"
+            start_restconf -f $cfg
+        fi
+
+        new "wait restconf"
+        wait_restconf
+
+        new "restconf count list entries"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept: application/yang-data+json' "$RCPROTO://localhost/restconf/data/example-cursor:c/x?count=true&limit=2")" 0 "HTTP/$HVER 200" "Clixon-Count: 5"
+
+        new "restconf first page"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept: application/yang-data+json' "$RCPROTO://localhost/restconf/data/example-cursor:c/x?cursor=&limit=2")" 0 "HTTP/$HVER 200" "Clixon-Cursor: a2" '"name":"a1"' '"name":"a2"' --not-- '"name":"a3"'
+
+        new "restconf second page"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept: application/yang-data+json' "$RCPROTO://localhost/restconf/data/example-cursor:c/x?cursor=a2&limit=2")" 0 "HTTP/$HVER 200" "Clixon-Cursor: a4" '"name":"a3"' '"name":"a4"' --not-- '"name":"a2"'
+
+        new "restconf last page, no cursor"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept: application/yang-data+json' "$RCPROTO://localhost/restconf/data/example-cursor:c/x?cursor=a4&limit=2")" 0 "HTTP/$HVER 200" '"name":"a5"' --not-- "Clixon-Cursor"
+
+        new "restconf invalid count"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept: application/yang-data+json' "$RCPROTO://localhost/restconf/data/example-cursor:c/x?count=maybe&limit=2")" 0 "HTTP/$HVER 400" "bad-attribute"
+
+        new "restconf leaf-list first page, cursor is percent-encoded"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept: application/yang-data+json' "$RCPROTO://localhost/restconf/data/example-cursor:c/y?cursor=&limit=2")" 0 "HTTP/$HVER 200" "Clixon-Cursor: v%2C2" '"v,1"' '"v,2"' --not-- '"v,3"'
+
+        # The Clixon-Cursor value is used as is in the query of the next page
+        new "restconf leaf-list next page using cursor of previous reply"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept: application/yang-data+json' "$RCPROTO://localhost/restconf/data/example-cursor:c/y?cursor=v%2C2&limit=2")" 0 "HTTP/$HVER 200" '"v,3"' --not-- '"v,2"' "Clixon-Cursor"
+
+        if [ $RC -ne 0 ]; then
+            new "Kill restconf daemon"
+            stop_restconf
+        fi
+    fi
+
+    if [ $BE -ne 0 ]; then
+        new "Kill backend"
+        # Check if premature kill
+        pid=$(pgrep -u root -f clixon_backend)
+        if [ -z "$pid" ]; then
+            err "backend already dead"
+        fi
+        # kill backend
+        stop_backend -f $cfg
+    fi
+}
+
+testrun nocache
+
+testrun cache
+
+rm -rf $dir
+
+new "endtest"
+endtest
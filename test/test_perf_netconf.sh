@@ -177,6 +177,13 @@ new "netconf add $perfreq small config"
     echo "$rpc"
 done | $clixon_netconf -qe1f $cfg > /dev/null; } 2>&1 | awk '/real/ {print $2}'
 
+new "netconf add $perfreq small config pipelined"
+{ time -p for (( i=0; i<$perfreq; i++ )); do
+    rnd=$(( ( RANDOM % $perfnr ) ))
+    rpc=$(chunked_framing "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><y><a>$rnd</a><b>$rnd</b></y></x></config></edit-config></rpc>")
+    echo "$rpc"
+done | $clixon_netconf -qe1f $cfg -o CLICON_NETCONF_PIPELINE=64 > /dev/null; } 2>&1 | awk '/real/ {print $2}'
+
 # Instead of many small entries, get one large in netconf and restconf
 # cli?
 new "netconf get large config"
@@ -26,6 +26,12 @@ fi
 # Number of requests made get/put
 : ${perfreq:=10}
 
+# Number of parallel clients in parallel get test
+: ${perfpar:=8}
+
+# Number of native restconf worker processes, eg run with workers=4 to compare scaling
+: ${workers:=1}
+
 # time function (this is a mess to get right on freebsd/linux)
 # -f %e gives elapsed wall clock time but is not available on all systems
 # so we use time -p for POSIX compliance and awk to get wall clock time
@@ -66,7 +72,7 @@ module scaling{
 EOF
 
 # Define default restconfig config: RESTCONFIG
-RESTCONFIG=$(restconf_config none false)
+RESTCONFIG=$(restconf_config none false | sed "s,<restconf>,<restconf><workers>$workers</workers>,")
 
 cat <<EOF > $cfg
 <clixon-config xmlns="http://clicon.org/config">
@@ -167,6 +173,16 @@ new "restconf get $perfreq small config 1 key index"
     curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/scaling:x/y=$rnd > /dev/null
 done } 2>&1 | awk '/real/ {print $2}'
 
+# Parallel RESTCONF get, scales with number of workers
+new "restconf get $perfreq small config $perfpar parallel clients workers=$workers"
+{ time -p for (( i=0; i<$perfreq; i++ )); do
+    for (( j=0; j<$perfpar; j++ )); do
+        rnd=$(( ( RANDOM % $perfnr ) ))
+        curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/scaling:x/y=$rnd > /dev/null &
+    done
+    wait
+done } 2>&1 | awk '/real/ {print $2}'
+
 # RESTCONF put
 # Reference:
 # i686 format=xml perfnr=10000/100 time: 38/29s 20190425  WITH/OUT startup copying
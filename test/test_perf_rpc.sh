@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+# Micro-benchmark of RPC callback dispatch and plugin lookup with many registered RPCs
+# RPC callbacks are looked up by namespace and name, and plugins by name, in hash tables.
+# Check that the right number of handlers are called and print time per call.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+: ${clixon_util_rpc:="clixon_util_rpc -D $DBG"}
+
+# Number of registered RPCs and plugins
+: ${perfnr:=1000}
+
+# Number of calls
+: ${perfreq:=100000}
+
+new "dispatch first of $perfnr rpcs"
+expectpart "$($clixon_util_rpc -n $perfnr -c $perfreq -r rpc0 -p plugin0)" 0 "rpc:rpc0 handlers:1 calls:$perfreq" "plugin:plugin0 found:1"
+
+new "dispatch last of $perfnr rpcs"
+ret=$($clixon_util_rpc -n $perfnr -c $perfreq)
+expectpart "$ret" 0 "rpc:rpc$((perfnr-1)) handlers:1 calls:$perfreq" "plugin:plugin$((perfnr-1)) found:1"
+echo "$ret"
+
+new "dispatch rpc registered twice"
+expectpart "$($clixon_util_rpc -n $perfnr -c 10 -d -r rpc7)" 0 "rpc:rpc7 handlers:2 calls:10"
+
+new "dispatch all rpcs in one namespace"
+expectpart "$($clixon_util_rpc -n $perfnr -N 1 -c 10 -r rpc42)" 0 "rpc:rpc42 handlers:1 calls:10"
+
+new "dispatch unknown rpc and plugin"
+expectpart "$($clixon_util_rpc -n $perfnr -c 10 -r norpc -p noplugin)" 0 "rpc:norpc handlers:0 calls:10" "plugin:noplugin found:0"
+
+new "dispatch with no rpcs"
+expectpart "$($clixon_util_rpc -n 0 -c 10 -r rpc0 -p plugin0)" 0 "rpc:rpc0 handlers:0 calls:10" "plugin:plugin0 found:0"
+
+rm -rf $dir
+
+new "endtest"
+endtest
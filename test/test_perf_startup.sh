@@ -9,6 +9,8 @@ s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
 # Number of list/leaf-list entries in file
 : ${perfnr:=20000}
 
+: ${clixon_util_xml:="clixon_util_xml"}
+
 APPNAME=example
 
 cfg=$dir/scaling-conf.xml
@@ -118,8 +120,7 @@ cat<<EOF >>  $sxpp
 </config>
 EOF
 
-if false; then # ---------- not supported
-new "generate pretty-printed json startup config ($sj) with $perfnr entries"
+new "generate pretty-printed json config ($sj) with $perfnr entries"
 echo -n '{"config": {"scaling:x":{"y":[' > $sj
 for (( i=0; i<$perfnr; i++ )); do  
     if [ $i -ne 0 ]; then
@@ -130,7 +131,15 @@ for (( i=0; i<$perfnr; i++ )); do
 
 done
 echo "]}}}" >> $sj
-fi
+
+# Parse only, ie file ingestion and parsing without backend startup
+for f in $sx $sxpre $sxpp; do
+    new "Parse xml $f"
+    { time -p $clixon_util_xml -f $f > /dev/null; } 2>&1 | awk '/real/ {print $2}'
+done
+
+new "Parse json $sj"
+{ time -p $clixon_util_xml -J -f $sj > /dev/null; } 2>&1 | awk '/real/ {print $2}'
 
 # Loop over mode and format
 mode=startup # running
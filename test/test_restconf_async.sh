@@ -0,0 +1,137 @@
+#!/usr/bin/env bash
+# Restconf native http/2: GET requests are sent asynchronously to the backend and
+# replies are deferred per stream. Several streams of one connection are outstanding
+# at the same time. Check that all replies are correct and matched to their streams.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+# Only works with native and http/2
+if [ "${WITH_RESTCONF}" != "native" -o ${HVER} != 2 ]; then
+    rm -rf $dir
+    if [ "$s" = $0 ]; then exit 0; else return 0; fi # skip
+fi
+
+cfg=$dir/conf.xml
+fyang=$dir/restconf.yang
+
+# Number of parallel GET streams
+: ${nr:=20}
+
+# Define default restconfig config: RESTCONFIG
+RESTCONFIG=$(restconf_config none false)
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_FEATURE>clixon-restconf:allow-auth-none</CLICON_FEATURE> <!-- Use auth-type=none -->
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>/usr/local/share/clixon</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>$dir/restconf.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  $RESTCONFIG
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix ex;
+   container table{
+      list parameter{
+         key name;
+         leaf name{
+            type string;
+         }
+         leaf value{
+            type string;
+         }
+      }
+   }
+}
+EOF
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    sudo pkill -f clixon_backend # to be sure
+
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+if [ $RC -ne 0 ]; then
+    new "kill old restconf daemon"
+    stop_restconf_pre
+
+    new "start restconf daemon"
+    start_restconf -f $cfg
+fi
+
+new "wait restconf"
+wait_restconf
+
+new "restconf POST $nr entries"
+data='{"example:table":{"parameter":['
+for (( i=0; i<$nr; i++ )); do
+    if [ $i -ne 0 ]; then
+        data="$data,"
+    fi
+    data="$data{\"name\":\"A$i\",\"value\":\"$i\"}"
+done
+data="$data]}}"
+expectpart "$(curl $CURLOPTS -X POST -H "Content-Type: application/yang-data+json" -d "$data" $RCPROTO://localhost/restconf/data)" 0 "HTTP/$HVER 201"
+
+# All GETs on one connection, each stream has its own outstanding backend request
+urls=""
+for (( i=0; i<$nr; i++ )); do
+    urls="$urls $RCPROTO://localhost/restconf/data/example:table/parameter=A$i"
+done
+
+new "restconf $nr parallel GET streams on one connection"
+ret=$(curl $CURLOPTS --parallel --parallel-immediate --parallel-max $nr -X GET $urls)
+for (( i=0; i<$nr; i++ )); do
+    match=$(echo "$ret" | grep -c "{\"example:parameter\":\[{\"name\":\"A$i\",\"value\":\"$i\"}\]}")
+    if [ "$match" != 1 ]; then
+        err "{\"example:parameter\":[{\"name\":\"A$i\",\"value\":\"$i\"}]}" "$ret"
+    fi
+done
+
+new "restconf parallel GET streams with error"
+expectpart "$(curl $CURLOPTS --parallel -X GET $RCPROTO://localhost/restconf/data/example:table/parameter=A1 $RCPROTO://localhost/restconf/data/example:table/parameter=XXX)" 0 "HTTP/$HVER 200" "HTTP/$HVER 404" '{"example:parameter":\[{"name":"A1","value":"1"}\]}' "Instance does not exist"
+
+new "restconf HEAD"
+expectpart "$(curl $CURLOPTS -I $RCPROTO://localhost/restconf/data/example:table/parameter=A2)" 0 "HTTP/$HVER 200" "content-type: application/yang-data+json"
+
+if [ $RC -ne 0 ]; then
+    new "Kill restconf daemon"
+    stop_restconf 
+fi
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
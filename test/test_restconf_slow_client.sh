@@ -0,0 +1,160 @@
+#!/usr/bin/env bash
+# Restconf native: a slow client reading a large reply must not block other clients
+# Start a rate-limited GET of a large list in the background, then check that other
+# requests are served while the slow client is still reading.
+# Then a client that stops reading altogether
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+# Only works with native
+if [ "${WITH_RESTCONF}" != "native" ]; then
+    rm -rf $dir
+    if [ "$s" = $0 ]; then exit 0; else return 0; fi # skip
+fi
+
+cfg=$dir/conf.xml
+fyang=$dir/restconf.yang
+fjson=$dir/large.json
+
+# Number of list entries, reply should be larger than socket buffers
+: ${nr:=20000}
+
+# Define default restconfig config: RESTCONFIG
+RESTCONFIG=$(restconf_config none false)
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_FEATURE>clixon-restconf:allow-auth-none</CLICON_FEATURE> <!-- Use auth-type=none -->
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>/usr/local/share/clixon</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>$dir/restconf.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  $RESTCONFIG
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix ex;
+   container table{
+      list parameter{
+         key name;
+         leaf name{
+            type string;
+         }
+         leaf value{
+            type string;
+         }
+      }
+   }
+}
+EOF
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    sudo pkill -f clixon_backend # to be sure
+
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+if [ $RC -ne 0 ]; then
+    new "kill old restconf daemon"
+    stop_restconf_pre
+
+    new "start restconf daemon"
+    start_restconf -f $cfg
+fi
+
+new "wait restconf"
+wait_restconf
+
+new "generate large request"
+echo -n '{"example:table":{"parameter":[' > $fjson
+for (( i=0; i<$nr; i++ )); do  
+    if [ $i -ne 0 ]; then
+        echo -n "," >> $fjson
+    fi
+    echo -n "{\"name\":\"A$i\",\"value\":\"$i\"}" >> $fjson
+done
+echo -n "]}}" >> $fjson
+
+new "restconf large POST"
+expectpart "$(curl $CURLOPTS -X POST -H "Content-Type: application/yang-data+json" -d @$fjson $RCPROTO://localhost/restconf/data)" 0 "HTTP/$HVER 201"
+
+new "restconf slow GET in background"
+curl $CURLOPTS --limit-rate 20K -o /dev/null -X GET $RCPROTO://localhost/restconf/data/example:table > /dev/null 2>&1 &
+slowpid=$!
+sleep 1
+
+new "restconf GET while slow client is reading"
+expectpart "$(timeout 5 curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/example:table/parameter=A42)" 0 "HTTP/$HVER 200" '{"example:parameter":\[{"name":"A42","value":"42"}\]}'
+
+new "restconf POST while slow client is reading"
+expectpart "$(timeout 5 curl $CURLOPTS -X POST -H "Content-Type: application/yang-data+json" -d '{"example:parameter":[{"name":"B","value":"42"}]}' $RCPROTO://localhost/restconf/data/example:table)" 0 "HTTP/$HVER 201"
+
+new "Check slow client is still reading"
+if ! kill -0 $slowpid 2> /dev/null; then
+    err "slow client running" "slow client terminated"
+fi
+kill $slowpid 2> /dev/null
+wait $slowpid 2> /dev/null
+
+new "restconf GET after slow client closed"
+expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/example:table/parameter=B)" 0 "HTTP/$HVER 200" '{"example:parameter":\[{"name":"B","value":"42"}\]}'
+
+# curl blocks writing to the pipe when its buffer is full and then stops reading the socket
+new "restconf GET in background by client that stops reading"
+(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/example:table 2> /dev/null | sleep 20) &
+stallpid=$!
+sleep 2
+
+new "restconf GET while stalled client does not read"
+expectpart "$(timeout 5 curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/example:table/parameter=A4711)" 0 "HTTP/$HVER 200" '{"example:parameter":\[{"name":"A4711","value":"4711"}\]}'
+
+new "restconf POST while stalled client does not read"
+expectpart "$(timeout 5 curl $CURLOPTS -X POST -H "Content-Type: application/yang-data+json" -d '{"example:parameter":[{"name":"C","value":"42"}]}' $RCPROTO://localhost/restconf/data/example:table)" 0 "HTTP/$HVER 201"
+
+pkill -P $stallpid 2> /dev/null
+kill $stallpid 2> /dev/null
+wait $stallpid 2> /dev/null
+
+new "restconf GET after stalled client closed"
+expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/example:table/parameter=C)" 0 "HTTP/$HVER 200" '{"example:parameter":\[{"name":"C","value":"42"}\]}'
+
+if [ $RC -ne 0 ]; then
+    new "Kill restconf daemon"
+    stop_restconf 
+fi
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
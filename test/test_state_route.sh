@@ -0,0 +1,245 @@
+#!/usr/bin/env bash
+# State data callbacks registered on a YANG schema subtree
+# Compile a backend plugin registering two state callbacks, one for each of two containers,
+# using statedata_callback_register().
+# Each callback returns how many times it has been called, and a get request should only
+# call the callbacks whose subtree intersects the requested xpath.
+# A third callback is registered with a ttl using statedata_callback_register_ttl(), its
+# state is cached per xpath until the ttl expires or a commit is made.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-route.yang
+cfile=$dir/example-route.c
+pdir=$dir/plugin
+sofile=$pdir/example-route.so
+
+# Time-to-live of cached state of t in ms
+TTL=5000
+
+if [ ! -d $pdir ]; then
+    mkdir $pdir
+fi
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_CLISPEC_DIR>/usr/local/lib/$APPNAME/clispec</CLICON_CLISPEC_DIR>
+  <CLICON_CLI_DIR>/usr/local/lib/$APPNAME/cli</CLICON_CLI_DIR>
+  <CLICON_CLI_MODE>$APPNAME</CLICON_CLI_MODE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_DIR>$pdir</CLICON_BACKEND_DIR>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_YANG_LIBRARY>false</CLICON_YANG_LIBRARY>
+  <CLICON_NETCONF_MONITORING>false</CLICON_NETCONF_MONITORING>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example-route{
+    yang-version 1.1;
+    namespace "urn:example:route";
+    prefix ex;
+    container r {
+      config false;
+      container a {
+        leaf calls {
+          type uint32;
+        }
+      }
+      container b {
+        leaf calls {
+          type uint32;
+        }
+      }
+    }
+    container t {
+      config false;
+      leaf calls {
+        type uint32;
+      }
+    }
+    container x {
+      config false;
+      leaf y {
+        type string;
+      }
+    }
+}
+EOF
+
+cat<<EOF > $cfile
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/syslog.h>
+
+/* clicon */
+#include <cligen/cligen.h>
+
+/* Clicon library functions. */
+#include <clixon/clixon.h>
+
+/* These include signatures for plugin and transaction callbacks. */
+#include <clixon/clixon_backend.h> 
+
+static int _a = 0; /* Number of calls to route_state_a */
+static int _b = 0; /* Number of calls to route_state_b */
+static int _t = 0; /* Number of calls to route_state_t */
+
+static int 
+route_state_a(clicon_handle h,
+              cvec         *nsc,
+              char         *xpath,
+              cxobj        *xstate)
+{
+    char buf[128];
+
+    snprintf(buf, sizeof(buf), "<r xmlns=\"urn:example:route\"><a><calls>%d</calls></a></r>", ++_a);
+    return clixon_xml_parse_string(buf, YB_NONE, NULL, &xstate, NULL);
+}
+
+static int 
+route_state_b(clicon_handle h,
+              cvec         *nsc,
+              char         *xpath,
+              cxobj        *xstate)
+{
+    char buf[128];
+
+    snprintf(buf, sizeof(buf), "<r xmlns=\"urn:example:route\"><b><calls>%d</calls></b></r>", ++_b);
+    return clixon_xml_parse_string(buf, YB_NONE, NULL, &xstate, NULL);
+}
+
+static int 
+route_state_t(clicon_handle h,
+              cvec         *nsc,
+              char         *xpath,
+              cxobj        *xstate)
+{
+    char buf[128];
+
+    snprintf(buf, sizeof(buf), "<t xmlns=\"urn:example:route\"><calls>%d</calls></t>", ++_t);
+    return clixon_xml_parse_string(buf, YB_NONE, NULL, &xstate, NULL);
+}
+
+clixon_plugin_api *clixon_plugin_init(clicon_handle h);
+
+static clixon_plugin_api api = {
+    "route",            /* name */           /*--- Common fields.  ---*/
+    clixon_plugin_init, /* init */
+};
+
+/*! Backend plugin initialization
+ * @param[in]  h    Clixon handle
+ * @retval     NULL Error with clicon_err set
+ * @retval     api  Pointer to API struct
+ */
+clixon_plugin_api *
+clixon_plugin_init(clicon_handle h)
+{
+    if (statedata_callback_register(h, route_state_a, "/example-route:r/a") < 0)
+        return NULL;
+    if (statedata_callback_register(h, route_state_b, "/example-route:r/b") < 0)
+        return NULL;
+    if (statedata_callback_register_ttl(h, route_state_t, "/example-route:t", $TTL) < 0)
+        return NULL;
+    return &api;
+}
+EOF
+
+new "compile $cfile"
+# -I /usr/local_include for eg freebsd
+expectpart "$($CC -g -Wall -rdynamic -fPIC -shared -I/usr/local/include $cfile -o $sofile)" 0 ""
+
+new "test params: -s init -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "get a: only a called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:r/ex:a\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><r xmlns=\"urn:example:route\"><a><calls>1</calls></a></r></data></rpc-reply>"
+
+new "get b leaf: only b called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:r/ex:b/ex:calls\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><r xmlns=\"urn:example:route\"><b><calls>1</calls></b></r></data></rpc-reply>"
+
+new "get a with predicate: only a called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:r/ex:a[ex:calls=2]\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><r xmlns=\"urn:example:route\"><a><calls>2</calls></a></r></data></rpc-reply>"
+
+new "get parent: both called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:r\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><r xmlns=\"urn:example:route\"><a><calls>3</calls></a><b><calls>2</calls></b></r></data></rpc-reply>"
+
+new "get union: both called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:r/ex:b | /ex:r/ex:a\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><r xmlns=\"urn:example:route\"><a><calls>4</calls></a><b><calls>3</calls></b></r></data></rpc-reply>"
+
+new "get descendant: both called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"//ex:calls\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><r xmlns=\"urn:example:route\"><a><calls>5</calls></a><b><calls>4</calls></b></r><t xmlns=\"urn:example:route\"><calls>1</calls></t></data></rpc-reply>"
+
+new "get other container: none called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:x\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+new "get a again: a not called by previous get"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:r/ex:a\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><r xmlns=\"urn:example:route\"><a><calls>6</calls></a></r></data></rpc-reply>"
+
+new "get b again: b not called by previous gets"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:r/ex:b\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><r xmlns=\"urn:example:route\"><b><calls>5</calls></b></r></data></rpc-reply>"
+
+new "get t: not cached for this xpath"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:t\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><t xmlns=\"urn:example:route\"><calls>2</calls></t></data></rpc-reply>"
+
+new "get t again: cached"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:t\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><t xmlns=\"urn:example:route\"><calls>2</calls></t></data></rpc-reply>"
+
+new "stats: state cache hit and miss"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><stats $LIBNS/></rpc>" "" "<state-cache $LIBNS><path>/example-route:t</path><callback>route_state_t</callback><ttl>$TTL</ttl><entries>2</entries><hit>1</hit><miss>2</miss></state-cache>"
+
+new "commit invalidates cache"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "get t after commit: callback called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:t\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><t xmlns=\"urn:example:route\"><calls>3</calls></t></data></rpc-reply>"
+
+new "get t: cached"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:t\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><t xmlns=\"urn:example:route\"><calls>3</calls></t></data></rpc-reply>"
+
+sleep $(((TTL+999)/1000+1))
+
+new "get t after ttl: callback called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:t\" xmlns:ex=\"urn:example:route\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><t xmlns=\"urn:example:route\"><calls>4</calls></t></data></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,207 @@
+#!/usr/bin/env bash
+# Hand-written XML tokenizer (clixon_util_xml -F, CLICON_XML_PARSE_FAST)
+# Parse the same XML with the tokenizer and with the grammar and check that the
+# results are identical, including errors where the tokenizer falls back to the grammar.
+# With yang, the tokenizer also binds yang and sorts while parsing.
+# Also run a netconf session with the option set.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+: ${clixon_util_xml:="clixon_util_xml"}
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-fast.yang
+fxml=$dir/large.xml
+
+cat <<EOF > $fyang
+module example-fast{
+    yang-version 1.1;
+    namespace "urn:example:fast";
+    prefix ex;
+    container c{
+        list x {
+            key "name";
+            leaf name {
+                type string;
+            }
+            leaf y {
+                type string;
+            }
+        }
+        leaf-list ll {
+            type int32;
+        }
+        list u {
+            ordered-by user;
+            key "k";
+            leaf k {
+                type string;
+            }
+        }
+        anydata ad;
+        leaf e {
+            type string;
+        }
+    }
+}
+EOF
+
+# Parse with grammar and tokenizer and compare output and exit code
+# Parameters:
+# 1: XML input
+# 2: Extra options, eg yang file
+function difftest(){
+    input="$1"
+    opts="$2"
+    new "fastparse $opts: $(echo -n "$input" | head -c 60 | tr '\r\n' '  ')"
+    ret1=$(echo -n "$input" | $clixon_util_xml -o $opts 2>&1)
+    r1=$?
+    ret2=$(echo -n "$input" | $clixon_util_xml -o -F $opts 2>&1)
+    r2=$?
+    if [ $r1 -ne $r2 ]; then
+        err "exit code $r1" "$r2"
+    fi
+    if [ "$ret1" != "$ret2" ]; then
+        err "$ret1" "$ret2"
+    fi
+}
+
+CR=$(printf '\r')
+LF='
+'
+
+difftest '<a><b/></a>'
+difftest '<a>x</a>'
+difftest '<a> </a>'
+difftest '<a></a>'
+difftest '<_-><b0.><c-.-._/></b0.></_->'
+difftest '<a x="1" y='"'"'2'"'"' x="3"><b z=""/></a>'
+difftest '<a xmlns="urn:a" xmlns:p="urn:p"><p:b p:c="1">x</p:b></a>'
+difftest '<a>hello &amp; &lt;world&gt; &apos;&quot; &#65;&#x41;</a>'
+difftest "<a>x${CR}${LF}y${CR}z</a>"
+difftest "<a>${LF}  <b>x</b>${LF}  <c> y </c>${LF}</a>"
+difftest '<a>x<b/>y</a>'
+difftest '<a><![CDATA[ x < y & z ]]></a>'
+difftest '<a>x<![CDATA[]]]>y</a>'
+difftest '<a>x<!-- comment --></a>'
+difftest '<a><!-- comment -->  <b/></a>'
+difftest '<?xml version="1.0" encoding="UTF-8"?><a/>'
+difftest "<?xml version='1.0' encoding='utf-8' standalone='yes'?>${LF}<a>x</a>${LF}"
+difftest '<a/><b/>'
+difftest '<a/> text <b/>'
+# Handled by the grammar
+difftest '<?pi x?><a/>'
+difftest '<a>x<!-- comment -->y</a>'
+difftest '< a/>'
+difftest '</a>'
+# Errors
+difftest '<-a/>'
+difftest '<a%/>'
+difftest '<a>'
+difftest '<a></b>'
+difftest '<p:a></a>'
+difftest '<a>&foo;</a>'
+difftest '<a b="1></a>'
+difftest 'text<a/>'
+difftest '<?xml version="2.0"?><a/>'
+difftest '<?xml version="1.0" encoding="ISO-8859-1"?><a/>'
+difftest '<?xml version="1.0"?><a/><b/>'
+difftest '<a><!-- comment </a>'
+difftest '<a><![CDATA[ x </a>'
+
+# Yang bound and sorted while parsing
+difftest '<c xmlns="urn:example:fast"><x><name>a</name><y>1</y></x><x><name>b</name></x><ll>1</ll><ll>2</ll><e>x</e></c>' "-y $fyang"
+difftest '<c xmlns="urn:example:fast"><e>x</e><ll>10</ll><ll>9</ll><x><y>1</y><name>b</name></x><x><name>a</name></x></c>' "-y $fyang"
+difftest '<c xmlns="urn:example:fast"><u><k>z</k></u><u><k>a</k></u><x><name>a</name></x></c>' "-y $fyang"
+difftest '<c xmlns="urn:example:fast"><ad><q>1</q><p>2</p></ad><x>text<name>a</name></x></c>' "-y $fyang"
+difftest '<ex:c xmlns:ex="urn:example:fast"><ex:e>x</ex:e><ex:x><ex:name>a</ex:name></ex:x></ex:c>' "-y $fyang"
+difftest '<c xmlns="urn:example:fast">text</c>' "-y $fyang"
+# Bind errors
+difftest '<c xmlns="urn:example:fast"><unknown/></c>' "-y $fyang"
+difftest '<c xmlns="urn:example:other"/>' "-y $fyang"
+difftest '<c><e>x</e></c>' "-y $fyang"
+
+new "generate large file"
+echo -n "<c xmlns=\"urn:example:fast\">" > $fxml
+for (( i=0; i<1000; i++ )); do
+    echo "  <x name=\"n$i\"><y>value $i &amp; &lt;$i&gt;</y><z><![CDATA[<$i>]]></z></x>" >> $fxml
+done
+echo "</c>" >> $fxml
+
+new "large file grammar"
+ret1=$($clixon_util_xml -o -f $fxml)
+new "large file fastparse"
+ret2=$($clixon_util_xml -o -F -f $fxml)
+if [ "$ret1" != "$ret2" ]; then
+    err "$ret1" "$ret2"
+fi
+
+new "generate large file with yang, list in reverse order"
+echo "<c xmlns=\"urn:example:fast\">" > $fxml
+for (( i=1000; i>0; i-- )); do
+    echo "  <x><name>n$i</name><y>$i</y></x><ll>$i</ll>" >> $fxml
+done
+echo "</c>" >> $fxml
+
+new "large file with yang grammar"
+ret1=$($clixon_util_xml -o -y $fyang -f $fxml)
+new "large file with yang fastparse"
+ret2=$($clixon_util_xml -o -F -y $fyang -f $fxml)
+if [ "$ret1" != "$ret2" ]; then
+    err "$ret1" "$ret2"
+fi
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XML_PARSE_FAST>true</CLICON_XML_PARSE_FAST>
+</clixon-config>
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "add list entry with entities"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:fast\"><x><name>x1</name><y>a &amp; b</y></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "get-config"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:fast\"><x><name>x1</name><y>a &amp; b</y></x></c></data></rpc-reply>"
+
+new "malformed rpc is rejected"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>rpc</error-type><error-tag>operation-failed</error-tag>" "Sanity check failed"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
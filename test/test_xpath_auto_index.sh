@@ -0,0 +1,130 @@
+#!/usr/bin/env bash
+# Automatic search index on non-key list leafs used in xpath filters (CLICON_XPATH_AUTO_INDEX)
+# After two filters on the non-key leaf "type", it is indexed and subsequent filters use
+# binary search in the index vector.
+# Check that results are the same before and after, and after the list is changed:
+# values are changed, entries added and deleted, and with duplicate values.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-index.yang
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XPATH_AUTO_INDEX>2</CLICON_XPATH_AUTO_INDEX>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example-index{
+    yang-version 1.1;
+    namespace "urn:example:index";
+    prefix ex;
+    container c{
+        list x {
+            key "name";
+            leaf name {
+                type string;
+            }
+            leaf type {
+                type string;
+            }
+        }
+    }
+}
+EOF
+
+# Get entries of a type
+# 1: type
+# 2: expected entries
+function gettype(){
+    t=$1
+    expect=$2
+    new "get-config type=$t"
+    if [ -z "$expect" ]; then
+        expect="<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+    else
+        expect="<rpc-reply $DEFAULTNS><data>$expect</data></rpc-reply>"
+    fi
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/ex:c/ex:x[ex:type='$t']\" xmlns:ex=\"urn:example:index\"/></get-config></rpc>" "" "$expect"
+}
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "add entries"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:index\"><x><name>a</name><type>eth</type></x><x><name>b</name><type>lo</type></x><x><name>c</name><type>eth</type></x><x><name>d</name><type>ppp</type></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+# Below and at the threshold
+for i in 1 2 3; do
+    gettype eth "<c xmlns=\"urn:example:index\"><x><name>a</name><type>eth</type></x><x><name>c</name><type>eth</type></x></c>"
+done
+
+gettype lo "<c xmlns=\"urn:example:index\"><x><name>b</name><type>lo</type></x></c>"
+
+gettype none ""
+
+new "change type of b to eth"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:index\"><x><name>b</name><type>eth</type></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+gettype eth "<c xmlns=\"urn:example:index\"><x><name>a</name><type>eth</type></x><x><name>b</name><type>eth</type></x><x><name>c</name><type>eth</type></x></c>"
+
+gettype lo ""
+
+new "delete a"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:index\"><x nc:operation=\"delete\" xmlns:nc=\"urn:ietf:params:xml:ns:netconf:base:1.0\"><name>a</name></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "delete type of c"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:index\"><x><name>c</name><type nc:operation=\"delete\" xmlns:nc=\"urn:ietf:params:xml:ns:netconf:base:1.0\">eth</type></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+gettype eth "<c xmlns=\"urn:example:index\"><x><name>b</name><type>eth</type></x></c>"
+
+new "add entry e"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:index\"><x><name>e</name><type>eth</type></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+gettype eth "<c xmlns=\"urn:example:index\"><x><name>b</name><type>eth</type></x><x><name>e</name><type>eth</type></x></c>"
+
+gettype ppp "<c xmlns=\"urn:example:index\"><x><name>d</name><type>ppp</type></x></c>"
+
+new "discard-changes"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+gettype eth ""
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
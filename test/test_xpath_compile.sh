@@ -0,0 +1,130 @@
+#!/usr/bin/env bash
+# Compiled XPath of YANG must and when statements (CLICON_XPATH_COMPILE)
+# Each expression is evaluated twice as a compiled program and compared with the parse
+# tree evaluator by clixon_util_xpath -B, including expressions that fall back to parse tree
+# evaluation of a subexpression.
+# Then validate must statements of a yang with clixon_util_xml
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+: ${clixon_util_xpath:=clixon_util_xpath}
+: ${clixon_util_xml:="clixon_util_xml -D $DBG"}
+
+ydir=$dir/yang
+xml=$dir/xml.xml
+fyang=$ydir/example-comp.yang
+
+if [ ! -d $ydir ]; then
+    mkdir $ydir
+fi
+
+cat <<EOF > $fyang
+module example-comp{
+    yang-version 1.1;
+    namespace "urn:example:comp";
+    prefix c;
+    container c{
+        leaf mtu {
+            type int32;
+            must ". >= 64 and . <= 9000" {
+                error-message "mtu out of range";
+            }
+        }
+        leaf mode {
+            type string;
+        }
+        leaf speed {
+            type int32;
+            must "../mode = 'fast' or . < 100";
+        }
+        list x {
+            key name;
+            leaf name {
+                type string;
+            }
+            leaf type {
+                type string;
+            }
+            leaf ref {
+                type string;
+                must "count(../../x[name = current()]) = 1";
+            }
+        }
+    }
+}
+EOF
+
+cat <<EOF > $xml
+<c xmlns="urn:example:comp">
+  <mtu>1500</mtu>
+  <mode>fast</mode>
+  <speed>1000</speed>
+  <x><name>a</name><type>eth</type></x>
+  <x><name>b</name><type>lo</type><ref>a</ref></x>
+  <x><name>c</name><type>eth</type></x>
+</c>
+EOF
+
+XPATH="$clixon_util_xpath -D $DBG -f $xml -y $ydir -n c:urn:example:comp -B"
+
+# Evaluate compiled boolean and check it is equal to parse tree evaluation
+# 1: initial xpath (context node)
+# 2: xpath
+# 3: expected true|false
+function compiled(){
+    i=$1
+    p=$2
+    expect=$3
+    new "compiled xpath $p on $i: $expect"
+    expectpart "$($XPATH -i "$i" -p "$p")" 0 "^bool:$expect$"
+}
+
+compiled /c:c/c:mtu ". >= 64 and . <= 9000" true
+compiled /c:c/c:mtu ". > 1500" false
+compiled /c:c/c:mtu ". + 100 = 1600" true
+compiled /c:c/c:mtu ". mod 7 = 2" true
+compiled /c:c/c:mtu "not(. = 1500)" false
+compiled /c:c/c:speed "../c:mode = 'fast' or . < 100" true
+compiled /c:c/c:speed "../c:mode = 'slow' or . < 100" false
+compiled /c:c/c:speed "../c:mode != 'slow' and ../c:mtu" true
+compiled /c:c "c:x[c:type = 'eth']" true
+compiled /c:c "c:x[c:type = 'ppp']" false
+compiled /c:c "count(c:x[c:type = 'eth']) = 2" true
+compiled /c:c "count(c:x) > 3" false
+# Positions are 0-based in this xpath implementation, see test_xpath.sh
+compiled /c:c "c:x[0]/c:name = 'a'" true
+compiled /c:c "c:x[2]/c:name = 'b'" false
+compiled /c:c "c:x[1]/c:name = 'b'" true
+compiled /c:c "c:x[c:type = 'eth'][1]/c:name = 'c'" true
+compiled /c:c "c:x[c:type = 'eth'][2]/c:name = 'c'" false
+compiled /c:c "boolean(c:nothere)" false
+compiled /c:c "c:mode | c:nothere" true
+compiled /c:c "/c:c/c:mtu = 1500" true
+compiled "/c:c/c:x[c:name='b']/c:ref" "count(../../c:x[c:name = current()]) = 1" true
+compiled "/c:c/c:x[c:name='b']/c:ref" "count(../../c:x[c:name = current()/../c:type]) = 1" false
+# Not compiled: parse tree evaluation of subexpressions
+compiled /c:c "count(//c:name) = 3" true
+compiled /c:c "count(descendant::c:type) = 3 and c:mtu" true
+compiled /c:c "contains(c:mode, 'as')" true
+compiled /c:c "name(c:mode) = 'speed'" false
+
+new "validate must ok"
+expecteof "$clixon_util_xml -y $fyang -vo" 0 "$(cat $xml)" "<mtu>1500</mtu>"
+
+new "validate must mtu out of range"
+expecteof "$clixon_util_xml -y $fyang -vo" 255 '<c xmlns="urn:example:comp"><mtu>10</mtu></c>' 2> /dev/null
+
+new "validate must speed fail"
+expecteof "$clixon_util_xml -y $fyang -vo" 255 '<c xmlns="urn:example:comp"><mode>slow</mode><speed>1000</speed></c>' 2> /dev/null
+
+new "validate must speed ok"
+expecteof "$clixon_util_xml -y $fyang -vo" 0 '<c xmlns="urn:example:comp"><mode>slow</mode><speed>10</speed></c>' '^<c xmlns="urn:example:comp"><mode>slow</mode><speed>10</speed></c>$'
+
+new "validate must ref fail"
+expecteof "$clixon_util_xml -y $fyang -vo" 255 '<c xmlns="urn:example:comp"><x><name>b</name><ref>z</ref></x></c>' 2> /dev/null
+
+rm -rf $dir
+
+new "endtest"
+endtest
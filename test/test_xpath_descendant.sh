@@ -0,0 +1,127 @@
+#!/usr/bin/env bash
+# XPATH descendant (//) searches in XML bound to YANG
+# Subtrees are pruned if the yang has no descendant data node with the searched name.
+# Check that names are found through choice/case, lists, augments from another module,
+# and in anydata where yang cannot tell which names exist.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+: ${clixon_util_xpath:=clixon_util_xpath}
+
+ydir=$dir/yang
+xml=$dir/xml.xml
+
+if [ ! -d $ydir ]; then
+    mkdir $ydir
+fi
+
+cat <<EOF > $ydir/example-desc.yang
+module example-desc{
+    yang-version 1.1;
+    namespace "urn:example:desc";
+    prefix d;
+    grouping gr {
+        leaf name {
+            type string;
+        }
+    }
+    container c{
+        container a{
+            container b{
+                uses gr;
+                leaf v {
+                    type int32;
+                }
+            }
+        }
+        list l{
+            key k;
+            leaf k {
+                type int32;
+            }
+            container inner{
+                uses gr;
+            }
+        }
+        choice ch{
+            case c1 {
+                leaf alpha {
+                    type int32;
+                }
+            }
+            leaf beta {
+                type int32;
+            }
+        }
+        anydata ad;
+    }
+}
+EOF
+
+cat <<EOF > $ydir/example-desc2.yang
+module example-desc2{
+    yang-version 1.1;
+    namespace "urn:example:desc2";
+    prefix a;
+    import example-desc {
+        prefix d;
+    }
+    augment "/d:c/d:a" {
+        container aug{
+            leaf name {
+                type string;
+            }
+        }
+    }
+}
+EOF
+
+cat <<EOF > $xml
+<c xmlns="urn:example:desc">
+  <a>
+    <b><name>x</name><v>1</v></b>
+    <aug xmlns="urn:example:desc2"><name>w</name></aug>
+  </a>
+  <l><k>1</k><inner><name>y</name></inner></l>
+  <alpha>7</alpha>
+  <ad><name>z</name><deep><v>2</v></deep></ad>
+</c>
+EOF
+
+XPATH="$clixon_util_xpath -D $DBG -f $xml -y $ydir -n d:urn:example:desc -n a:urn:example:desc2"
+
+new "xpath //d:name"
+expectpart "$($XPATH -p //d:name)" 0 "<name>x</name>" "<name>y</name>" "<name>z</name>" --not-- "<name>w</name>"
+
+new "xpath //a:name in augment"
+expectpart "$($XPATH -p //a:name)" 0 "^nodeset:0:<name>w</name>$"
+
+new "xpath //d:v in container and anydata"
+expectpart "$($XPATH -p //d:v)" 0 "<v>1</v>" "<v>2</v>"
+
+new "xpath //d:k in list"
+expectpart "$($XPATH -p //d:k)" 0 "^nodeset:0:<k>1</k>$"
+
+new "xpath //d:alpha in choice"
+expectpart "$($XPATH -p //d:alpha)" 0 "^nodeset:0:<alpha>7</alpha>$"
+
+new "xpath //d:deep only in anydata"
+expectpart "$($XPATH -p //d:deep)" 0 "^nodeset:0:<deep><v>2</v></deep>$"
+
+new "xpath //d:inner/d:name"
+expectpart "$($XPATH -p //d:inner/d:name)" 0 "^nodeset:0:<name>y</name>$"
+
+new "xpath /d:c/d:a//d:name"
+expectpart "$($XPATH -p /d:c/d:a//d:name)" 0 "^nodeset:0:<name>x</name>$"
+
+new "xpath //d:beta not in xml"
+expectpart "$($XPATH -p //d:beta)" 0 "^nodeset:$"
+
+new "xpath //d:nothere not in yang"
+expectpart "$($XPATH -p //d:nothere)" 0 "^nodeset:$"
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,227 @@
+#!/usr/bin/env bash
+# Yang cache: daemons write their post-processed yang spec to CLICON_YANG_CACHE_DIR and
+# load it at next start instead of parsing yang files.
+# Check that the cache file is written, reused if nothing changed (same inode), and
+# rewritten if a yang file is changed, or if a new revision of an imported module is
+# added in a subdirectory of a yang dir. The yang uses typedefs, ranges, patterns, defaults,
+# groupings, augment/when and identities to check the cached spec validates as the parsed.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/example-cache.yang
+cachedir=$dir/cache
+subdir=$dir/sub
+
+# Parameters:
+# 1: revision of imported module
+# 2: type of imptype
+function genimp(){
+    cat <<EOF > $subdir/example-imp@$1.yang
+module example-imp{
+    yang-version 1.1;
+    namespace "urn:example:imp";
+    prefix imp;
+    revision $1;
+    typedef imptype {
+        type $2;
+    }
+}
+EOF
+}
+
+# Parameters:
+# 1: extra statement in container c
+function genyang(){
+    extra=$1
+    cat <<EOF > $fyang
+module example-cache{
+    yang-version 1.1;
+    namespace "urn:example:cache";
+    prefix ex;
+    import example-imp {
+        prefix imp;
+    }
+    identity base-id;
+    identity id1 {
+        base base-id;
+    }
+    typedef small {
+        type uint8 {
+            range "1..10";
+        }
+    }
+    grouping gr {
+        leaf name {
+            type string;
+        }
+        leaf p {
+            type string {
+                pattern '[a-z]+';
+            }
+        }
+        leaf s {
+            type small;
+            default 5;
+        }
+    }
+    container c{
+        list x {
+            key "name";
+            uses gr;
+            leaf id {
+                type identityref {
+                    base base-id;
+                }
+            }
+        }
+        leaf i {
+            type imp:imptype;
+        }
+        $extra
+    }
+    augment "/ex:c" {
+        when "ex:x";
+        leaf y {
+            type decimal64 {
+                fraction-digits 2;
+            }
+        }
+    }
+}
+EOF
+}
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_YANG_CACHE_DIR>$cachedir</CLICON_YANG_CACHE_DIR>
+  <CLICON_SOCK>/usr/local/var/$APPNAME/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/$APPNAME/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+# Parameters:
+# 1: expected inode of backend cache file, or "new" if it is (re)written
+# 2: expected validate of imptype value "abc": ok or error
+function testrun(){
+    inode0=$1
+    imp=$2
+
+    if [ $BE -ne 0 ]; then
+        new "kill old backend"
+        sudo clixon_backend -zf $cfg
+        if [ $? -ne 0 ]; then
+            err
+        fi
+        new "start backend -s init -f $cfg"
+        start_backend -s init -f $cfg
+    fi
+
+    new "wait backend"
+    wait_backend
+
+    new "backend cache file exists"
+    if [ ! -f $cachedir/clixon_backend.yspec ]; then
+        err "$cachedir/clixon_backend.yspec" "No cache file"
+    fi
+    inode=$(stat -c %i $cachedir/clixon_backend.yspec)
+    if [ $BE -ne 0 -a "$inode0" != "new" ]; then
+        new "backend cache file is not rewritten"
+        if [ "$inode" != "$inode0" ]; then
+            err "$inode0" "$inode"
+        fi
+    fi
+
+    new "add list entry"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:cache\"><x><name>x1</name><p>abc</p><id>ex:id1</id></x><y>1.25</y></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "validate ok"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "netconf cache file exists"
+    if [ ! -f $cachedir/clixon_netconf.yspec ]; then
+        err "$cachedir/clixon_netconf.yspec" "No cache file"
+    fi
+
+    new "get-config report-all"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">report-all</with-defaults><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:cache\"><x><name>x1</name><p>abc</p><s>5</s><id>ex:id1</id></x><y>1.25</y></c></data></rpc-reply>"
+
+    new "set out of range value"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:cache\"><x><name>x1</name><s>11</s></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "validate range error"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>bad-element</error-tag><error-info><bad-element>s</bad-element></error-info><error-severity>error</error-severity><error-message>Number 11 out of range: 1 - 10</error-message></rpc-error></rpc-reply>"
+
+    new "set value not matching pattern"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:cache\"><x><name>x1</name><p>A1</p><s>1</s></x></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "validate pattern error"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>bad-element</error-tag><error-info><bad-element>p</bad-element></error-info><error-severity>error</error-severity><error-message>regexp match fail: pattern does not match A1</error-message></rpc-error></rpc-reply>"
+
+    new "discard-changes"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "set imported type value"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:cache\"><i>abc</i></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    if [ "$imp" = "ok" ]; then
+        new "validate imported type ok"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+    else
+        new "validate imported type error"
+        expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>bad-element</error-tag><error-info><bad-element>i</bad-element></error-info>"
+    fi
+
+    new "discard-changes"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    if [ $BE -ne 0 ]; then
+        new "Kill backend"
+        # Check if premature kill
+        pid=$(pgrep -u root -f clixon_backend)
+        if [ -z "$pid" ]; then
+            err "backend already dead"
+        fi
+        # kill backend
+        stop_backend -f $cfg
+    fi
+}
+
+rm -rf $cachedir
+mkdir $cachedir
+chmod 777 $cachedir
+mkdir -p $subdir
+
+genimp 2020-01-01 string
+genyang ""
+
+new "First start: parse yang and write cache"
+testrun new ok
+
+new "Second start: load yang from cache"
+testrun $inode ok
+
+new "Change yang file"
+genyang "leaf z { type string; }"
+
+new "Third start: yang changed, parse yang and rewrite cache"
+testrun new ok
+
+new "Add new revision of imported module in subdirectory"
+genimp 2023-01-01 int32
+
+new "Fourth start: new revision, parse yang and rewrite cache"
+testrun new error
+
+rm -rf $dir
+
+new "endtest"
+endtest
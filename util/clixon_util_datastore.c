@@ -79,7 +79,7 @@ usage(char *argv0)
             "\t-D\t\tDebug\n"
             "\t-d <db>\t\tDatabase name. Default: running. Alt: candidate,startup\n"
             "\t-b <dir>\tDatabase directory. Mandatory\n"
-            "\t-f <fmt>\tDatabase format: xml or json\n"
+            "\t-f <fmt>\tDatabase format: xml, json or binary\n"
             "\t-x <xml>\tXML file. Alternative to put <xml> argument\n"
             "\t-y <file>\tYang file. Mandatory\n"
             "\t-Y <dir> \tYang dirs (can be several)\n"
@@ -88,6 +88,7 @@ usage(char *argv0)
             "\tmget <nr> [<xpath>]\n"
             "\tput (merge|replace|create|delete|remove) [<xml>]\n"
             "\tcopy <todb>\n"
+            "\tconvert (xml|json|binary) <file>\n"
             "\tlock <pid>\n"
             "\tunlock\n"
             "\tunlock_all <pid>\n"
@@ -297,6 +298,29 @@ main(int argc, char **argv)
         if (xmldb_copy(h, db, argv[1]) < 0)
             goto done;
     }
+    else if (strcmp(cmd, "convert")==0){
+        /* Read db in format of -f and write it to file in another format */
+        FILE *fp;
+        if (argc != 3)
+            usage(argv0);
+        if (strcmp(argv[1], "xml") != 0 && strcmp(argv[1], "json") != 0 &&
+            strcmp(argv[1], "binary") != 0){
+            clicon_err(OE_DB, 0, "Unrecognized format: %s", argv[1]);
+            usage(argv0);
+        }
+        if (xmldb_get(h, db, NULL, "/", &xt) < 0)
+            goto done;
+        clicon_option_str_set(h, "CLICON_XMLDB_FORMAT", argv[1]);
+        if ((fp = fopen(argv[2], "w")) == NULL){
+            clicon_err(OE_UNIX, errno, "fopen(%s)", argv[2]);
+            goto done;
+        }
+        if (xmldb_dump(h, fp, xt) < 0){
+            fclose(fp);
+            goto done;
+        }
+        fclose(fp);
+    }
     else if (strcmp(cmd, "lock")==0){
         if (argc != 2)
             usage(argv0);
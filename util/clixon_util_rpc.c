@@ -0,0 +1,250 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+
+  Copyright (C) 2023 Olof Hagsand
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2,
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+* Micro-benchmark of RPC callback dispatch and plugin lookup
+* Registers <nr> RPC callbacks with names rpc<i> in <nrns> namespaces urn:example:ns<i%nrns>
+* and <nr> pseudo plugins with names plugin<i>, then calls an RPC and finds a plugin
+* <calls> times and prints the number of handlers called and the time per call.
+* For example:
+*   clixon_util_rpc -n 1000 -c 100000 -r rpc999
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <syslog.h>
+#include <sys/time.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clixon */
+#include "clixon/clixon.h"
+
+/* Command line options to be passed to getopt(3) */
+#define RPC_OPTS "hD:n:N:c:r:p:d"
+
+static int
+usage(char *argv0)
+{
+    fprintf(stderr, "usage:%s [options]\n"
+            "where options are\n"
+            "\t-h \t\tHelp\n"
+            "\t-D <level> \tDebug\n"
+            "\t-n <nr>    \tNumber of RPCs and plugins to register (default: 100)\n"
+            "\t-N <nr>    \tNumber of RPC namespaces (default: 10)\n"
+            "\t-c <calls> \tNumber of calls (default: 10000)\n"
+            "\t-r <rpc>   \tName of RPC to call (default: last registered)\n"
+            "\t-p <name>  \tName of plugin to find (default: last registered)\n"
+            "\t-d \t\tRegister each RPC callback twice\n",
+            argv0
+            );
+    exit(0);
+}
+
+/*! RPC callback: count calls and reply ok if no reply yet
+ * @param[in]  regarg  Call counter
+ */
+static int
+rpc_cb(clicon_handle h,
+       cxobj        *xe,
+       cbuf         *cbret,
+       void         *arg,
+       void         *regarg)
+{
+    (*(int*)regarg)++;
+    if (cbuf_len(cbret) == 0)
+        cprintf(cbret, "<rpc-reply xmlns=\"%s\"><ok/></rpc-reply>", NETCONF_BASE_NAMESPACE);
+    return 0;
+}
+
+/*! Time difference in microseconds
+ */
+static double
+usecs(struct timeval *t0)
+{
+    struct timeval t1;
+    struct timeval td;
+
+    gettimeofday(&t1, NULL);
+    timersub(&t1, t0, &td);
+    return td.tv_sec*1000000.0 + td.tv_usec;
+}
+
+int
+main(int    argc,
+     char **argv)
+{
+    int              retval = -1;
+    char            *argv0 = argv[0];
+    int              logdst = CLICON_LOG_STDERR;
+    int              dbg = 0;
+    int              c;
+    clicon_handle    h = NULL;
+    yang_stmt       *yspec = NULL;
+    int              nr = 100;
+    int              nrns = 10;
+    int              calls = 10000;
+    int              twice = 0;
+    char            *rpcname = NULL;
+    char            *plgname = NULL;
+    char             name[64];
+    char             ns[64];
+    int              i;
+    int              j;
+    int              count = 0;
+    int              nrh = 0;
+    clixon_plugin_t *cp = NULL;
+    cxobj           *xt = NULL;
+    cbuf            *cb = NULL;
+    cbuf            *cbret = NULL;
+    struct timeval   t0;
+    double           us;
+
+    /* In the startup, logs to stderr & debug flag set later */
+    clicon_log_init("rpc", LOG_DEBUG, logdst);
+    if ((h = clicon_handle_init()) == NULL)
+        goto done;
+    optind = 1;
+    opterr = 0;
+    while ((c = getopt(argc, argv, RPC_OPTS)) != -1)
+        switch (c) {
+        case 'h':
+            usage(argv0);
+            break;
+        case 'D':
+            if (sscanf(optarg, "%d", &dbg) != 1)
+                usage(argv0);
+            break;
+        case 'n':
+            nr = atoi(optarg);
+            break;
+        case 'N':
+            if ((nrns = atoi(optarg)) < 1)
+                usage(argv0);
+            break;
+        case 'c':
+            calls = atoi(optarg);
+            break;
+        case 'r':
+            rpcname = optarg;
+            break;
+        case 'p':
+            plgname = optarg;
+            break;
+        case 'd':
+            twice++;
+            break;
+        default:
+            usage(argv0);
+            break;
+        }
+    clicon_log_init("rpc", dbg?LOG_DEBUG:LOG_INFO, logdst);
+    clicon_debug_init(dbg, NULL);
+    /* Same as option default, dont measure plugin context checks */
+    if (clicon_option_int_set(h, "CLICON_PLUGIN_CALLBACK_CHECK", 0) < 0)
+        goto done;
+    /* Empty spec: rpc reply is checked but has no yang */
+    if ((yspec = yspec_new()) == NULL)
+        goto done;
+    clicon_dbspec_yang_set(h, yspec);
+    if (clixon_plugin_module_init(h) < 0)
+        goto done;
+    for (i=0; i<nr; i++){
+        snprintf(name, sizeof(name), "rpc%d", i);
+        snprintf(ns, sizeof(ns), "urn:example:ns%d", i%nrns);
+        for (j=0; j<(twice?2:1); j++)
+            if (rpc_callback_register(h, rpc_cb, &count, ns, name) < 0)
+                goto done;
+        snprintf(name, sizeof(name), "plugin%d", i);
+        if (clixon_pseudo_plugin(h, name, &cp) < 0)
+            goto done;
+    }
+    /* RPC dispatch */
+    if ((cb = cbuf_new()) == NULL || (cbret = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    i = nr - 1;
+    if (rpcname == NULL){
+        snprintf(name, sizeof(name), "rpc%d", i);
+        rpcname = name;
+    }
+    else if (sscanf(rpcname, "rpc%d", &i) != 1)
+        i = 0;
+    cprintf(cb, "<%s xmlns=\"urn:example:ns%d\"/>", rpcname, i%nrns);
+    if (clixon_xml_parse_string(cbuf_get(cb), YB_NONE, NULL, &xt, NULL) < 0)
+        goto done;
+    gettimeofday(&t0, NULL);
+    for (i=0; i<calls; i++){
+        cbuf_reset(cbret);
+        if (rpc_callback_call(h, xml_child_i(xt, 0), NULL, &nrh, cbret) < 0)
+            goto done;
+    }
+    us = usecs(&t0);
+    fprintf(stdout, "rpc:%s handlers:%d calls:%d usec/call:%.3f\n",
+            rpcname, nrh, calls, calls?us/calls:0.0);
+    /* Plugin lookup */
+    if (plgname == NULL){
+        snprintf(name, sizeof(name), "plugin%d", nr-1);
+        plgname = name;
+    }
+    cp = NULL;
+    gettimeofday(&t0, NULL);
+    for (i=0; i<calls; i++)
+        cp = clixon_plugin_find(h, plgname);
+    us = usecs(&t0);
+    fprintf(stdout, "plugin:%s found:%d calls:%d usec/call:%.3f\n",
+            plgname, cp?1:0, calls, calls?us/calls:0.0);
+    retval = 0;
+ done:
+    if (xt)
+        xml_free(xt);
+    if (cb)
+        cbuf_free(cb);
+    if (cbret)
+        cbuf_free(cbret);
+    if (h){
+        clixon_plugin_module_exit(h);
+        if (yspec)
+            ys_free(yspec);
+        clicon_handle_exit(h);
+    }
+    return retval;
+}
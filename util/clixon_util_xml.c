@@ -67,7 +67,7 @@
 #include "clixon/clixon.h"
 
 /* Command line options passed to getopt(3) */
-#define UTIL_XML_OPTS "hD:f:JjXl:pvoy:Y:t:T:u"
+#define UTIL_XML_OPTS "hD:f:FJjXl:pvoy:Y:t:T:u"
 
 static int
 validate_tree(clicon_handle h,
@@ -116,6 +116,7 @@ usage(char *argv0)
             "\t-h \t\tHelp\n"
             "\t-D <level> \tDebug\n"
             "\t-f <file>\tXML input file (overrides stdin)\n"
+            "\t-F \t\tParse XML with hand-written tokenizer\n"
             "\t-J \t\tInput as JSON\n"
             "\t-j \t\tOutput as JSON\n"
             "\t-X \t\tOutput as TEXT \n"
@@ -192,6 +193,9 @@ main(int    argc,
         case 'f':
             input_filename = optarg;
             break;
+        case 'F':
+            xml_parse_fast(1);
+            break;
         case 'J':
             jsonin++;
             break;
@@ -60,7 +60,7 @@ See https://www.w3.org/TR/xpath/
 #include "clixon/clixon.h"
 
 /* Command line options to be passed to getopt(3) */
-#define XPATH_OPTS "hD:f:p:i:In:cl:y:Y:"
+#define XPATH_OPTS "hD:f:p:i:IBn:cl:y:Y:"
 
 static int
 usage(char *argv0)
@@ -73,6 +73,7 @@ usage(char *argv0)
             "\t-p <xpath> \tPrimary XPATH string\n"
             "\t-i <xpath0>\t(optional) Initial XPATH string\n"
             "\t-I \t\tCheck inverse, map back xml result to xpath and check if equal\n"
+            "\t-B \t\tEvaluate as boolean with compiled xpath and check it is equal to parse tree evaluation\n"
             "\t-n <pfx:id>\tNamespace binding (pfx=NULL for default)\n"
             "\t-c \t\tMap xpath to canonical form\n"
             "\t-l <s|e|o|f<file>> \tLog on (s)yslog, std(e)rr, std(o)ut or (f)ile (stderr is default)\n"
@@ -149,6 +150,7 @@ main(int    argc,
     int         logdst = CLICON_LOG_STDERR;
     int         dbg = 0;
     int         xpath_inverse = 0;
+    int         compiled = 0;
 
     /* In the startup, logs to stderr & debug flag set later */
     clicon_log_init("xpath", LOG_DEBUG, logdst); 
@@ -188,6 +190,9 @@ main(int    argc,
         case 'I': /* Check inverse */
             xpath_inverse++;
             break;
+        case 'B': /* Compiled boolean */
+            compiled++;
+            break;
         case 'n':{ /* Namespace binding */
             char *prefix;
             char *id;
@@ -374,6 +379,29 @@ main(int    argc,
             goto ok; // Parse errors returns OK
     }
 #endif
+    /* Evaluate compiled xpath twice, reusing its stack, and compare with parse tree */
+    if (compiled){
+        xpath_prog *prog = NULL;
+        int         b0;
+        int         b1;
+        int         b2;
+
+        if (xpath_prog_new(xpath, nsc, &prog) < 0)
+            goto done;
+        if (dbg)
+            xpath_prog_print(stderr, prog);
+        b1 = xpath_prog_bool(prog, x);
+        b2 = xpath_prog_bool(prog, x);
+        xpath_prog_free(prog);
+        if ((b0 = xpath_vec_bool(x, nsc, "%s", xpath)) < 0 || b1 < 0 || b2 < 0)
+            goto done;
+        if (b0 != b1 || b1 != b2){
+            fprintf(stderr, "Error: compiled: %d %d parse tree: %d\n", b1, b2, b0);
+            goto done;
+        }
+        fprintf(stdout, "bool:%s\n", b1?"true":"false");
+        goto ok;
+    }
     if (xpath_vec_ctx(x, nsc, xpath, 0, &xc) < 0)
         return -1;
 